@@ -63,6 +63,7 @@ LDFLAGS += -mcpu=cortex-m0plus -mthumb
 LDFLAGS += -Wl,--gc-sections
 LDFLAGS += -Wl,--script=$(TOP)/watch-library/hardware/linker/saml22j18.ld
 LDFLAGS += -Wl,--print-memory-usage
+LDFLAGS += -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
 
 LIBS += -lm
 
@@ -120,6 +121,9 @@ SRCS += \
   $(TOP)/watch-library/hardware/watch/watch_uart.c \
   $(TOP)/watch-library/hardware/watch/watch_storage.c \
   $(TOP)/watch-library/hardware/watch/watch_deepsleep.c \
+  $(TOP)/watch-library/hardware/watch/watch_evsys.c \
+  $(TOP)/watch-library/hardware/watch/watch_profiler.c \
+  $(TOP)/watch-library/hardware/watch/watch_memory.c \
   $(TOP)/watch-library/hardware/watch/watch_private.c \
   $(TOP)/watch-library/hardware/watch/watch_private_cdc.c \
   $(TOP)/watch-library/hardware/watch/watch.c \
@@ -156,6 +160,13 @@ SRCS += \
   $(TOP)/watch-library/shared/driver/spiflash.c \
   $(TOP)/watch-library/shared/watch/watch_private_buzzer.c \
   $(TOP)/watch-library/shared/watch/watch_private_display.c \
+  $(TOP)/watch-library/shared/watch/watch_private_ring.c \
+  $(TOP)/watch-library/shared/watch/watch_private_nvm_queue.c \
+  $(TOP)/watch-library/shared/watch/watch_private_sleep.c \
+  $(TOP)/watch-library/shared/watch/watch_private_performance.c \
+  $(TOP)/watch-library/shared/watch/watch_private_evsys.c \
+  $(TOP)/watch-library/shared/watch/watch_private_profiler.c \
+  $(TOP)/watch-library/shared/watch/watch_private_memory.c \
   $(TOP)/watch-library/shared/watch/watch_utility.c \
 
 DEFINES += \
@@ -195,12 +206,18 @@ SRCS += \
   $(TOP)/watch-library/simulator/watch/watch_uart.c \
   $(TOP)/watch-library/simulator/watch/watch_storage.c \
   $(TOP)/watch-library/simulator/watch/watch_deepsleep.c \
+  $(TOP)/watch-library/simulator/watch/watch_evsys.c \
+  $(TOP)/watch-library/simulator/watch/watch_profiler.c \
   $(TOP)/watch-library/simulator/watch/watch_private.c \
   $(TOP)/watch-library/simulator/watch/watch.c \
   $(TOP)/watch-library/shared/driver/thermistor_driver.c \
   $(TOP)/watch-library/shared/driver/opt3001.c \
   $(TOP)/watch-library/shared/watch/watch_private_buzzer.c \
   $(TOP)/watch-library/shared/watch/watch_private_display.c \
+  $(TOP)/watch-library/shared/watch/watch_private_evsys.c \
+  $(TOP)/watch-library/shared/watch/watch_private_timestamp.c \
+  $(TOP)/watch-library/shared/watch/watch_private_profiler.c \
+  $(TOP)/watch-library/shared/watch/watch_private_memory.c \
   $(TOP)/watch-library/shared/watch/watch_utility.c \
 
 endif
@@ -242,3 +259,8 @@ endif
 ifdef CLOCK_FACE_24H_ONLY
 CFLAGS += -DCLOCK_FACE_24H_ONLY
 endif
+
+# make PROFILER=1 builds in the sampling profiler and its shell command; see watch_profiler.h.
+ifdef PROFILER
+CFLAGS += -DWATCH_PROFILER
+endif
@@ -5,54 +5,21 @@
 #include "filesystem.h"
 #include "watch.h"
 #include "lfs.h"
+#include "lfs_rwwee.h"
 #include "hpl_flash.h"
+#include "xfer.h"
 
-int lfs_storage_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size);
-int lfs_storage_prog(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size);
-int lfs_storage_erase(const struct lfs_config *cfg, lfs_block_t block);
-int lfs_storage_sync(const struct lfs_config *cfg);
-
-int lfs_storage_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size) {
-    (void) cfg;
-    return !watch_storage_read(block, off, (void *)buffer, size);
-}
-
-int lfs_storage_prog(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size) {
-    (void) cfg;
-    return !watch_storage_write(block, off, (void *)buffer, size);
-}
-
-int lfs_storage_erase(const struct lfs_config *cfg, lfs_block_t block) {
-    (void) cfg;
-    return !watch_storage_erase(block);
-}
-
-int lfs_storage_sync(const struct lfs_config *cfg) {
-    (void) cfg;
-    return !watch_storage_sync();
-}
-
-const struct lfs_config cfg = {
-    // block device operations
-    .read  = lfs_storage_read,
-    .prog  = lfs_storage_prog,
-    .erase = lfs_storage_erase,
-    .sync  = lfs_storage_sync,
-
-    // block device configuration
-    .read_size = 16,
-    .prog_size = NVMCTRL_PAGE_SIZE,
-    .block_size = NVMCTRL_ROW_SIZE,
-    .block_count = NVMCTRL_RWWEE_PAGES / 4,
-    .cache_size = NVMCTRL_PAGE_SIZE,
-    .lookahead_size = 16,
-    .block_cycles = 100,
-};
+static const lfs_rwwee_geometry_t geometry = LFS_RWWEE_DEFAULT_GEOMETRY;
+static struct lfs_config cfg;
 
 static lfs_t lfs;
 static lfs_file_t file;
 static struct lfs_info info;
 
+// Kept apart from file, so that filesystem_read_chunks callbacks can use the other functions.
+static lfs_file_t chunk_file;
+static char chunk_buf[FILESYSTEM_CHUNK_SIZE];
+
 static int _traverse_df_cb(void *p, lfs_block_t block) {
     (void) block;
 	uint32_t *nb = p;
@@ -112,6 +79,7 @@ static int filesystem_ls(lfs_t *lfs, const char *path) {
 }
 
 bool filesystem_init(void) {
+    lfs_rwwee_configure(&cfg, &geometry);
     int err = lfs_mount(&lfs, &cfg);
 
     // reformat if we can't mount the filesystem
@@ -120,7 +88,7 @@ bool filesystem_init(void) {
         printf("Ignore that error! Formatting filesystem...\r\n");
         err = lfs_format(&lfs, &cfg);
         if (err < 0) return false;
-        err = lfs_mount(&lfs, &cfg) == LFS_ERR_OK;
+        err = lfs_mount(&lfs, &cfg);
         printf("Filesystem mounted with %ld bytes free.\r\n", filesystem_get_free_space());
     }
 
@@ -144,6 +112,10 @@ bool filesystem_rm(char *filename) {
     }
 }
 
+bool filesystem_rename(char *old_filename, char *new_filename) {
+    return lfs_rename(&lfs, old_filename, new_filename) == LFS_ERR_OK;
+}
+
 int32_t filesystem_get_file_size(char *filename) {
     if (filesystem_file_exists(filename)) {
         return info.size; // info struct was just populated by filesystem_file_exists
@@ -166,6 +138,40 @@ bool filesystem_read_file(char *filename, char *buf, int32_t length) {
     return false;
 }
 
+int32_t filesystem_read_file_at(char *filename, char *buf, int32_t offset, int32_t length) {
+    int err = lfs_file_open(&lfs, &file, filename, LFS_O_RDONLY);
+    if (err < 0) return -1;
+    err = lfs_file_seek(&lfs, &file, offset, LFS_SEEK_SET);
+    if (err < 0) {
+        lfs_file_close(&lfs, &file);
+        return -1;
+    }
+    int32_t bytes_read = lfs_file_read(&lfs, &file, buf, length);
+    if (lfs_file_close(&lfs, &file) != LFS_ERR_OK) return -1;
+    return bytes_read < 0 ? -1 : bytes_read;
+}
+
+int32_t filesystem_read_chunks(char *filename, filesystem_chunk_cb_t cb, void *context) {
+    int err = lfs_file_open(&lfs, &chunk_file, filename, LFS_O_RDONLY);
+    if (err < 0) return -1;
+
+    int32_t offset = 0;
+    while (true) {
+        int32_t bytes_read = lfs_file_read(&lfs, &chunk_file, chunk_buf, FILESYSTEM_CHUNK_SIZE);
+        if (bytes_read < 0) {
+            offset = -1;
+            break;
+        }
+        if (bytes_read == 0) break;
+        bool more = cb(chunk_buf, bytes_read, offset, context);
+        offset += bytes_read;
+        if (!more) break;
+    }
+
+    if (lfs_file_close(&lfs, &chunk_file) != LFS_ERR_OK) return -1;
+    return offset;
+}
+
 bool filesystem_read_line(char *filename, char *buf, int32_t *offset, int32_t length) {
     memset(buf, 0, length + 1);
     int32_t file_size = filesystem_get_file_size(filename);
@@ -189,19 +195,18 @@ bool filesystem_read_line(char *filename, char *buf, int32_t *offset, int32_t le
     return false;
 }
 
+static bool _cat_chunk_cb(const char *chunk, int32_t length, int32_t offset, void *context) {
+    (void) offset;
+    (void) context;
+    fwrite(chunk, 1, length, stdout);
+    return true;
+}
+
 static void filesystem_cat(char *filename) {
-    info.type = 0;
-    lfs_stat(&lfs, filename, &info);
     if (filesystem_file_exists(filename)) {
-        if (info.size > 0) {
-            char *buf = malloc(info.size + 1);
-            filesystem_read_file(filename, buf, info.size);
-            buf[info.size] = '\0';
-            printf("%s\r\n", buf);
-            free(buf);
-        } else {
-            printf("\r\n");
-        }
+        // Streams the file as it's read, so output starts right away and nothing is allocated
+        filesystem_read_chunks(filename, _cat_chunk_cb, NULL);
+        printf("\r\n");
     } else {
         printf("cat: %s: No such file\r\n", filename);
     }
@@ -280,3 +285,111 @@ int filesystem_cmd_echo(int argc, char *argv[]) {
     return 0;
 }
 
+// Binary transfers over the USB shell. See lib/xfer/xfer.h for the protocol.
+
+#define XFER_TEMP_FILE "xfer.tmp"
+
+static int32_t _xfer_read(void *context, uint8_t *buf, uint16_t len, uint16_t timeout_ms) {
+    (void) context;
+    while (true) {
+        int n = read(0, (char *)buf, len);
+        if (n > 0) return n;
+        if (timeout_ms-- == 0) return 0;
+        delay_ms(1);
+    }
+}
+
+static void _xfer_write(void *context, const uint8_t *buf, uint16_t len) {
+    (void) context;
+    fwrite(buf, 1, len, stdout);
+    fflush(stdout);
+}
+
+static int32_t _xfer_source(void *context, uint32_t offset, uint8_t *buf, uint16_t len) {
+    (void) context;
+    if (lfs_file_seek(&lfs, &file, offset, LFS_SEEK_SET) < 0) return -1;
+    return lfs_file_read(&lfs, &file, buf, len);
+}
+
+static bool _xfer_sink(void *context, const uint8_t *buf, uint16_t len) {
+    (void) context;
+    return lfs_file_write(&lfs, &file, buf, len) == len;
+}
+
+static const char *_xfer_result_string(xfer_result_t result) {
+    switch (result) {
+        case XFER_OK: return "ok";
+        case XFER_ERR_TIMEOUT: return "timed out";
+        case XFER_ERR_ABORTED: return "aborted by host";
+        case XFER_ERR_IO: return "filesystem error";
+        case XFER_ERR_CHECKSUM: return "checksum mismatch";
+    }
+    return "unknown error";
+}
+
+static xfer_t *_xfer_begin(void) {
+    static const xfer_io_t io = { _xfer_read, _xfer_write, NULL };
+    xfer_t *x = malloc(sizeof(xfer_t));
+    if (x == NULL) {
+        printf("out of memory\r\n");
+        return NULL;
+    }
+    xfer_init(x, &io);
+    // Anything the shell printed has to be out before the first frame
+    fflush(stdout);
+    return x;
+}
+
+int filesystem_cmd_get(int argc, char *argv[]) {
+    (void) argc;
+
+    xfer_t *x = _xfer_begin();
+    if (x == NULL) return -1;
+
+    xfer_result_t result;
+    if (lfs_file_open(&lfs, &file, argv[1], LFS_O_RDONLY) < 0) {
+        xfer_abort(x, "no such file");
+        result = XFER_ERR_IO;
+    } else {
+        uint32_t size = lfs_file_size(&lfs, &file);
+        xfer_send_hello(x, size);
+        result = xfer_send(x, _xfer_source, NULL, size);
+        lfs_file_close(&lfs, &file);
+    }
+
+    printf("\r\nget: %s\r\n", _xfer_result_string(result));
+    free(x);
+    return result == XFER_OK ? 0 : -1;
+}
+
+int filesystem_cmd_put(int argc, char *argv[]) {
+    (void) argc;
+
+    if (strchr(argv[1], '/')) {
+        printf("subdirectories are not supported\r\n");
+        return -2;
+    }
+
+    xfer_t *x = _xfer_begin();
+    if (x == NULL) return -1;
+
+    // Receive into a temporary file and swap it in at the end, so a failed upload leaves the old file alone
+    xfer_result_t result;
+    uint32_t size = 0;
+    if (lfs_file_open(&lfs, &file, XFER_TEMP_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+        xfer_abort(x, "cannot create file");
+        result = XFER_ERR_IO;
+    } else {
+        xfer_send_hello(x, filesystem_get_free_space());
+        result = xfer_receive(x, _xfer_sink, NULL, &size);
+        if (lfs_file_close(&lfs, &file) < 0 && result == XFER_OK) result = XFER_ERR_IO;
+        if (result == XFER_OK) {
+            if (lfs_rename(&lfs, XFER_TEMP_FILE, argv[1]) < 0) result = XFER_ERR_IO;
+        }
+        if (result != XFER_OK) lfs_remove(&lfs, XFER_TEMP_FILE);
+    }
+
+    printf("\r\nput: %s (%lu bytes)\r\n", _xfer_result_string(result), (unsigned long) size);
+    free(x);
+    return result == XFER_OK ? 0 : -1;
+}
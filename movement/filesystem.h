@@ -50,6 +50,14 @@ bool filesystem_file_exists(char *filename);
   */
 bool filesystem_rm(char *filename);
 
+/** @brief Renames a file on the filesystem, replacing any file that already has the new name.
+  * @param old_filename the file you wish to rename
+  * @param new_filename its new name
+  * @return true if the file was renamed successfully; false otherwise
+  * @note The rename is atomic: after a reset, new_filename names either the old file or the renamed one.
+  */
+bool filesystem_rename(char *old_filename, char *new_filename);
+
 /** @brief Gets the size of a file on the filesystem.
   * @param filename the file whose size you wish to determine
   * @return the file's size in bytes, or -1 if the file does not exist.
@@ -69,6 +77,41 @@ int32_t filesystem_get_file_size(char *filename);
   */
 bool filesystem_read_file(char *filename, char *buf, int32_t length);
 
+/** @brief Reads part of a file from the filesystem into a buffer
+  * @param filename the file you wish to read
+  * @param buf A buffer of at least length bytes; the requested range will be read into this buffer
+  * @param offset The offset into the file at which to start reading
+  * @param length The maximum number of bytes to read
+  * @return the number of bytes read, which may be less than length at the end of the file; or -1 if
+  *         the file could not be read.
+  * @note Unlike filesystem_read_file, this function does not clear the buffer before reading, so you
+  *       can use it to pull fixed-size records out of a larger file without reading the whole thing.
+  */
+int32_t filesystem_read_file_at(char *filename, char *buf, int32_t offset, int32_t length);
+
+/** @brief Size of the buffer filesystem_read_chunks hands to its callback. */
+#define FILESYSTEM_CHUNK_SIZE 64
+
+/** @brief Callback for filesystem_read_chunks.
+  * @param chunk The next chunk of the file. Only valid until the callback returns.
+  * @param length The number of bytes in chunk; at most FILESYSTEM_CHUNK_SIZE.
+  * @param offset The offset of chunk in the file.
+  * @param context The context pointer passed to filesystem_read_chunks.
+  * @return true to keep reading, false to stop.
+  */
+typedef bool (*filesystem_chunk_cb_t)(const char *chunk, int32_t length, int32_t offset, void *context);
+
+/** @brief Reads a file from start to end in small chunks, handing each one to a callback.
+  * @param filename the file you wish to read
+  * @param cb The function to call with each chunk.
+  * @param context Passed through to cb.
+  * @return the number of bytes handed to cb, or -1 if the file could not be read.
+  * @note The file is opened once and read through a single static buffer, so memory use is the same
+  *       however large the file is. The callback may call the other filesystem functions, but must
+  *       not start another filesystem_read_chunks.
+  */
+int32_t filesystem_read_chunks(char *filename, filesystem_chunk_cb_t cb, void *context);
+
 /** @brief Reads a line from a file into a buffer
   * @param filename the file you wish to read
   * @param buf A buffer of at least length + 1 bytes; the file will be read into this buffer,
@@ -101,5 +144,7 @@ int filesystem_cmd_cat(int argc, char *argv[]);
 int filesystem_cmd_df(int argc, char *argv[]);
 int filesystem_cmd_rm(int argc, char *argv[]);
 int filesystem_cmd_echo(int argc, char *argv[]);
+int filesystem_cmd_get(int argc, char *argv[]);
+int filesystem_cmd_put(int argc, char *argv[]);
 
 #endif // FILESYSTEM_H_
@@ -337,41 +337,45 @@ void mbedtls_sha1( const unsigned char *input, size_t ilen, unsigned char output
 void HMAC_SHA1(const uint8_t* key, size_t key_length, const uint8_t *in, size_t n, uint8_t out[SHA1_DIGEST_LENGTH]){
 
   uint8_t i;
-  uint8_t k_ipad[SHA1_BLOCK_LENGTH]; /* inner padding - key XORd with ipad */
-  uint8_t k_opad[SHA1_BLOCK_LENGTH]; /* outer padding - key XORd with opad */
-  uint8_t buffer[SHA1_BLOCK_LENGTH + SHA1_DIGEST_LENGTH];
+  uint8_t k_pad[SHA1_BLOCK_LENGTH]; /* key XORd with ipad, then with opad */
+  mbedtls_sha1_context ctx;
 
-  /* start out by storing key in pads */
-  memset(k_ipad, 0, sizeof(k_ipad));
-  memset(k_opad, 0, sizeof(k_opad));
+  /* start out by storing key in pad */
+  memset(k_pad, 0, sizeof(k_pad));
 
   if (key_length <= SHA1_BLOCK_LENGTH) {
-      memcpy(k_ipad, key, key_length);
-      memcpy(k_opad, key, key_length);
+      memcpy(k_pad, key, key_length);
   }
 
   else {
-      mbedtls_sha1(key, key_length, k_ipad);
-      memcpy(k_opad, k_ipad, SHA1_BLOCK_LENGTH);
+      mbedtls_sha1(key, key_length, k_pad);
   }
 
-  /* XOR key with ipad and opad values */
+  /* XOR key with ipad value */
   for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
-      k_ipad[i] ^= HMAC_IPAD;
-      k_opad[i] ^= HMAC_OPAD;
+      k_pad[i] ^= HMAC_IPAD;
   }
-  
+
   // perform inner SHA1
-  memcpy(buffer, k_ipad, SHA1_BLOCK_LENGTH);
-  memcpy(buffer + SHA1_BLOCK_LENGTH, in, n);
-  mbedtls_sha1(buffer, SHA1_BLOCK_LENGTH + n, out);
-  
-  memset(buffer, 0, SHA1_BLOCK_LENGTH + n);
+  mbedtls_sha1_init(&ctx);
+  mbedtls_sha1_starts(&ctx);
+  mbedtls_sha1_update(&ctx, k_pad, SHA1_BLOCK_LENGTH);
+  mbedtls_sha1_update(&ctx, in, n);
+  mbedtls_sha1_finish(&ctx, out);
+
+  /* flip the pad from ipad to opad */
+  for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
+      k_pad[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+  }
 
   // perform outer SHA1
-  memcpy(buffer, k_opad, SHA1_BLOCK_LENGTH);
-  memcpy(buffer + SHA1_BLOCK_LENGTH, out, SHA1_DIGEST_LENGTH);
-  mbedtls_sha1(buffer, SHA1_BLOCK_LENGTH + SHA1_DIGEST_LENGTH, out);
+  mbedtls_sha1_starts(&ctx);
+  mbedtls_sha1_update(&ctx, k_pad, SHA1_BLOCK_LENGTH);
+  mbedtls_sha1_update(&ctx, out, SHA1_DIGEST_LENGTH);
+  mbedtls_sha1_finish(&ctx, out);
+  mbedtls_sha1_free(&ctx);
+
+  mbedtls_zeroize(k_pad, sizeof(k_pad));
 }
 /*
 * Compute TOTP_HMAC_SHA1 using key, key length, text to hash, size of the text
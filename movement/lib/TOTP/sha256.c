@@ -144,12 +144,19 @@ static const uint32_t K[] =
 #define F0(x,y,z) ((x & y) | (z & (x | y)))
 #define F1(x,y,z) (z ^ (x & (y ^ z)))
 
-#define R(t)                                    \
-(                                               \
-    W[t] = S1(W[t -  2]) + W[t -  7] +          \
-           S0(W[t - 15]) + W[t - 16]            \
+/*
+ * The message schedule lives in a 16-word ring buffer: W[t] only ever depends
+ * on the previous 16 words, so a 64-word array is not needed.
+ */
+#define R(t)                                            \
+(                                                       \
+    W[(t) & 0x0F] += S1(W[((t) -  2) & 0x0F]) +         \
+                     W[((t) -  7) & 0x0F] +             \
+                     S0(W[((t) - 15) & 0x0F])           \
 )
 
+#define X(t) ( (t) < 16 ? W[(t)] : R(t) )
+
 #define P(a,b,c,d,e,f,g,h,x,K)                  \
 {                                               \
     temp1 = h + S3(e) + F1(e,f,g) + K + x;      \
@@ -159,7 +166,7 @@ static const uint32_t K[] =
 
 void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char data[SHA256_BLOCK_LENGTH] )
 {
-    uint32_t temp1, temp2, W[64];
+    uint32_t temp1, temp2, W[16];
     uint32_t A[8];
     unsigned int i;
 
@@ -169,28 +176,18 @@ void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char da
     for( i = 0; i < 16; i++ )
         GET_UINT32_BE( W[i], data, 4 * i );
 
-    for( i = 0; i < 16; i += 8 )
-    {
-        P( A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i+0], K[i+0] );
-        P( A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], W[i+1], K[i+1] );
-        P( A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], W[i+2], K[i+2] );
-        P( A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], W[i+3], K[i+3] );
-        P( A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], W[i+4], K[i+4] );
-        P( A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], W[i+5], K[i+5] );
-        P( A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], W[i+6], K[i+6] );
-        P( A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], W[i+7], K[i+7] );
-    }
-
-    for( i = 16; i < 64; i += 8 )
+    /* One copy of the eight-round body serves all 64 rounds, which keeps
+     * the function small on a core without a barrel-shifted operand. */
+    for( i = 0; i < 64; i += 8 )
     {
-        P( A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], R(i+0), K[i+0] );
-        P( A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], R(i+1), K[i+1] );
-        P( A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], R(i+2), K[i+2] );
-        P( A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], R(i+3), K[i+3] );
-        P( A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], R(i+4), K[i+4] );
-        P( A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], R(i+5), K[i+5] );
-        P( A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], R(i+6), K[i+6] );
-        P( A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], R(i+7), K[i+7] );
+        P( A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], X(i+0), K[i+0] );
+        P( A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], X(i+1), K[i+1] );
+        P( A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], X(i+2), K[i+2] );
+        P( A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], X(i+3), K[i+3] );
+        P( A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], X(i+4), K[i+4] );
+        P( A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], X(i+5), K[i+5] );
+        P( A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], X(i+6), K[i+6] );
+        P( A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], X(i+7), K[i+7] );
     }
 
     for( i = 0; i < 8; i++ )
@@ -303,43 +300,47 @@ void HMAC_SHA256(const uint8_t* key, size_t key_length, const uint8_t *in, size_
   if (is224 == 1) {
     digest_length = SHA224_DIGEST_LENGTH;
   }
-  
+
   uint8_t i;
-  uint8_t k_ipad[SHA256_BLOCK_LENGTH]; /* inner padding - key XORd with ipad */
-  uint8_t k_opad[SHA256_BLOCK_LENGTH]; /* outer padding - key XORd with opad */
-  uint8_t buffer[SHA256_BLOCK_LENGTH + digest_length];
+  uint8_t k_pad[SHA256_BLOCK_LENGTH]; /* key XORd with ipad, then with opad */
+  mbedtls_sha256_context ctx;
 
-  /* start out by storing key in pads */
-  memset(k_ipad, 0, sizeof(k_ipad));
-  memset(k_opad, 0, sizeof(k_opad));
+  /* start out by storing key in pad */
+  memset(k_pad, 0, sizeof(k_pad));
 
   if (key_length <= SHA256_BLOCK_LENGTH) {
-      memcpy(k_ipad, key, key_length);
-      memcpy(k_opad, key, key_length);
+      memcpy(k_pad, key, key_length);
   }
 
   else {
-      mbedtls_sha256(key, key_length, k_ipad, is224);
-      memcpy(k_opad, k_ipad, SHA256_BLOCK_LENGTH);
+      mbedtls_sha256(key, key_length, k_pad, is224);
   }
 
-  /* XOR key with ipad and opad values */
+  /* XOR key with ipad value */
   for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
-      k_ipad[i] ^= HMAC_IPAD;
-      k_opad[i] ^= HMAC_OPAD;
+      k_pad[i] ^= HMAC_IPAD;
   }
-  
+
   // perform inner SHA256
-  memcpy(buffer, k_ipad, SHA256_BLOCK_LENGTH);
-  memcpy(buffer + SHA256_BLOCK_LENGTH, in, n);
-  mbedtls_sha256(buffer, SHA256_BLOCK_LENGTH + n, out, is224);
-  
-  memset(buffer, 0, SHA256_BLOCK_LENGTH + n);
+  mbedtls_sha256_init(&ctx);
+  mbedtls_sha256_starts(&ctx, is224);
+  mbedtls_sha256_update(&ctx, k_pad, SHA256_BLOCK_LENGTH);
+  mbedtls_sha256_update(&ctx, in, n);
+  mbedtls_sha256_finish(&ctx, out);
+
+  /* flip the pad from ipad to opad */
+  for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
+      k_pad[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+  }
 
   // perform outer SHA256
-  memcpy(buffer, k_opad, SHA256_BLOCK_LENGTH);
-  memcpy(buffer + SHA256_BLOCK_LENGTH, out, digest_length);
-  mbedtls_sha256(buffer, SHA256_BLOCK_LENGTH + digest_length, out, is224);
+  mbedtls_sha256_starts(&ctx, is224);
+  mbedtls_sha256_update(&ctx, k_pad, SHA256_BLOCK_LENGTH);
+  mbedtls_sha256_update(&ctx, out, digest_length);
+  mbedtls_sha256_finish(&ctx, out);
+  mbedtls_sha256_free(&ctx);
+
+  mbedtls_zeroize(k_pad, sizeof(k_pad));
 }
 
 /*
@@ -173,29 +173,77 @@ void mbedtls_sha512_starts( mbedtls_sha512_context *ctx, int is384 )
     ctx->is384 = is384;
 }
 
-void mbedtls_sha512_process( mbedtls_sha512_context *ctx, const unsigned char data[SHA512_BLOCK_LENGTH] )
+/*
+ * The SHA-512 sigma functions, written out on 32-bit halves. The Cortex-M0+
+ * has no 64-bit shifts, so a generic 64-bit rotate turns into a shift-and-or
+ * sequence across both words for every term; spelling out which half lands
+ * where lets each rotate collapse to two shifts and an OR per half.
+ */
+static inline uint64_t sha512_join( uint32_t hi, uint32_t lo )
 {
-    int i;
-    uint64_t temp1, temp2, W[80];
-    uint64_t A, B, C, D, E, F, G, H;
+    return ( (uint64_t) hi << 32 ) | lo;
+}
 
-#define SHR(x,n) (x >> n)
-#define ROTR(x,n) (SHR(x,n) | (x << (64 - n)))
+/* ROTR(x,28) ^ ROTR(x,34) ^ ROTR(x,39) */
+static inline uint64_t sha512_S2( uint64_t x )
+{
+    uint32_t hi = (uint32_t) ( x >> 32 ), lo = (uint32_t) x;
+    return sha512_join( ( hi >> 28 | lo <<  4 ) ^ ( lo >>  2 | hi << 30 ) ^ ( lo >>  7 | hi << 25 ),
+                        ( lo >> 28 | hi <<  4 ) ^ ( hi >>  2 | lo << 30 ) ^ ( hi >>  7 | lo << 25 ) );
+}
 
-#define S0(x) (ROTR(x, 1) ^ ROTR(x, 8) ^  SHR(x, 7))
-#define S1(x) (ROTR(x,19) ^ ROTR(x,61) ^  SHR(x, 6))
+/* ROTR(x,14) ^ ROTR(x,18) ^ ROTR(x,41) */
+static inline uint64_t sha512_S3( uint64_t x )
+{
+    uint32_t hi = (uint32_t) ( x >> 32 ), lo = (uint32_t) x;
+    return sha512_join( ( hi >> 14 | lo << 18 ) ^ ( hi >> 18 | lo << 14 ) ^ ( lo >>  9 | hi << 23 ),
+                        ( lo >> 14 | hi << 18 ) ^ ( lo >> 18 | hi << 14 ) ^ ( hi >>  9 | lo << 23 ) );
+}
+
+/* ROTR(x, 1) ^ ROTR(x, 8) ^ SHR(x, 7) */
+static inline uint64_t sha512_S0( uint64_t x )
+{
+    uint32_t hi = (uint32_t) ( x >> 32 ), lo = (uint32_t) x;
+    return sha512_join( ( hi >>  1 | lo << 31 ) ^ ( hi >>  8 | lo << 24 ) ^ ( hi >>  7 ),
+                        ( lo >>  1 | hi << 31 ) ^ ( lo >>  8 | hi << 24 ) ^ ( lo >>  7 | hi << 25 ) );
+}
+
+/* ROTR(x,19) ^ ROTR(x,61) ^ SHR(x, 6) */
+static inline uint64_t sha512_S1( uint64_t x )
+{
+    uint32_t hi = (uint32_t) ( x >> 32 ), lo = (uint32_t) x;
+    return sha512_join( ( hi >> 19 | lo << 13 ) ^ ( lo >> 29 | hi <<  3 ) ^ ( hi >>  6 ),
+                        ( lo >> 19 | hi << 13 ) ^ ( hi >> 29 | lo <<  3 ) ^ ( lo >>  6 | hi << 26 ) );
+}
 
-#define S2(x) (ROTR(x,28) ^ ROTR(x,34) ^ ROTR(x,39))
-#define S3(x) (ROTR(x,14) ^ ROTR(x,18) ^ ROTR(x,41))
+void mbedtls_sha512_process( mbedtls_sha512_context *ctx, const unsigned char data[SHA512_BLOCK_LENGTH] )
+{
+    unsigned int i;
+    uint64_t temp1, temp2, W[16];
+    uint64_t A, B, C, D, E, F, G, H;
 
 #define F0(x,y,z) ((x & y) | (z & (x | y)))
 #define F1(x,y,z) (z ^ (x & (y ^ z)))
 
-#define P(a,b,c,d,e,f,g,h,x,K)                  \
-{                                               \
-    temp1 = h + S3(e) + F1(e,f,g) + K + x;      \
-    temp2 = S2(a) + F0(a,b,c);                  \
-    d += temp1; h = temp1 + temp2;              \
+/*
+ * The message schedule lives in a 16-word ring buffer: W[t] only ever depends
+ * on the previous 16 words, so there is no need for an 80-word array (640
+ * bytes of stack) on a part with 32 KiB of RAM.
+ */
+#define R(t)                                                    \
+(                                                               \
+    W[(t) & 0x0F] += sha512_S1( W[((t) -  2) & 0x0F] ) +        \
+                     W[((t) -  7) & 0x0F] +                     \
+                     sha512_S0( W[((t) - 15) & 0x0F] )          \
+)
+
+#define X(t) ( (t) < 16 ? W[(t)] : R(t) )
+
+#define P(a,b,c,d,e,f,g,h,x,K)                                  \
+{                                                               \
+    temp1 = h + sha512_S3(e) + F1(e,f,g) + K + x;               \
+    temp2 = sha512_S2(a) + F0(a,b,c);                           \
+    d += temp1; h = temp1 + temp2;                              \
 }
 
     for( i = 0; i < 16; i++ )
@@ -203,12 +251,6 @@ void mbedtls_sha512_process( mbedtls_sha512_context *ctx, const unsigned char da
         GET_UINT64_BE( W[i], data, i << 3 );
     }
 
-    for( ; i < 80; i++ )
-    {
-        W[i] = S1(W[i -  2]) + W[i -  7] +
-               S0(W[i - 15]) + W[i - 16];
-    }
-
     A = ctx->state[0];
     B = ctx->state[1];
     C = ctx->state[2];
@@ -217,20 +259,26 @@ void mbedtls_sha512_process( mbedtls_sha512_context *ctx, const unsigned char da
     F = ctx->state[5];
     G = ctx->state[6];
     H = ctx->state[7];
-    i = 0;
 
-    do
+    /* One copy of the eight-round body serves all 80 rounds, which keeps the
+     * function small; the register renaming between rounds is free. */
+    for( i = 0; i < 80; i += 8 )
     {
-        P( A, B, C, D, E, F, G, H, W[i], K[i] ); i++;
-        P( H, A, B, C, D, E, F, G, W[i], K[i] ); i++;
-        P( G, H, A, B, C, D, E, F, W[i], K[i] ); i++;
-        P( F, G, H, A, B, C, D, E, W[i], K[i] ); i++;
-        P( E, F, G, H, A, B, C, D, W[i], K[i] ); i++;
-        P( D, E, F, G, H, A, B, C, W[i], K[i] ); i++;
-        P( C, D, E, F, G, H, A, B, W[i], K[i] ); i++;
-        P( B, C, D, E, F, G, H, A, W[i], K[i] ); i++;
+        P( A, B, C, D, E, F, G, H, X(i + 0), K[i + 0] );
+        P( H, A, B, C, D, E, F, G, X(i + 1), K[i + 1] );
+        P( G, H, A, B, C, D, E, F, X(i + 2), K[i + 2] );
+        P( F, G, H, A, B, C, D, E, X(i + 3), K[i + 3] );
+        P( E, F, G, H, A, B, C, D, X(i + 4), K[i + 4] );
+        P( D, E, F, G, H, A, B, C, X(i + 5), K[i + 5] );
+        P( C, D, E, F, G, H, A, B, X(i + 6), K[i + 6] );
+        P( B, C, D, E, F, G, H, A, X(i + 7), K[i + 7] );
     }
-    while( i < 80 );
+
+#undef F0
+#undef F1
+#undef R
+#undef X
+#undef P
 
     ctx->state[0] += A;
     ctx->state[1] += B;
@@ -240,6 +288,8 @@ void mbedtls_sha512_process( mbedtls_sha512_context *ctx, const unsigned char da
     ctx->state[5] += F;
     ctx->state[6] += G;
     ctx->state[7] += H;
+
+    mbedtls_zeroize( W, sizeof( W ) );
 }
 
 /*
@@ -347,6 +397,9 @@ void mbedtls_sha512( const unsigned char *input, size_t ilen,
 
 /*
 * Compute HMAC_SHA384/512 using key, key length, text to hash, size of the text, output buffer and a switch for SHA384
+*
+* The key block is fed to the streaming API directly, so neither the message nor the inner digest has to be
+* concatenated into a scratch buffer; one block of stack is enough for both passes.
 */
 void HMAC_SHA512(const uint8_t* key, size_t key_length, const uint8_t *in, size_t n, uint8_t* out, int is384){
   int digest_length = SHA512_DIGEST_LENGTH;
@@ -355,41 +408,45 @@ void HMAC_SHA512(const uint8_t* key, size_t key_length, const uint8_t *in, size_
   }
 
   uint8_t i;
-  uint8_t k_ipad[SHA512_BLOCK_LENGTH]; /* inner padding - key XORd with ipad */
-  uint8_t k_opad[SHA512_BLOCK_LENGTH]; /* outer padding - key XORd with opad */
-  uint8_t buffer[SHA512_BLOCK_LENGTH + digest_length];
+  uint8_t k_pad[SHA512_BLOCK_LENGTH]; /* key XORd with ipad, then with opad */
+  mbedtls_sha512_context ctx;
 
-  /* start out by storing key in pads */
-  memset(k_ipad, 0, sizeof(k_ipad));
-  memset(k_opad, 0, sizeof(k_opad));
+  /* start out by storing key in pad */
+  memset(k_pad, 0, sizeof(k_pad));
 
   if (key_length <= SHA512_BLOCK_LENGTH) {
-      memcpy(k_ipad, key, key_length);
-      memcpy(k_opad, key, key_length);
+      memcpy(k_pad, key, key_length);
   }
 
   else {
-      mbedtls_sha512(key, key_length, k_ipad, is384);
-      memcpy(k_opad, k_ipad, SHA512_BLOCK_LENGTH);
+      mbedtls_sha512(key, key_length, k_pad, is384);
   }
 
-  /* XOR key with ipad and opad values */
+  /* XOR key with ipad value */
   for (i = 0; i < SHA512_BLOCK_LENGTH; i++) {
-      k_ipad[i] ^= HMAC_IPAD;
-      k_opad[i] ^= HMAC_OPAD;
+      k_pad[i] ^= HMAC_IPAD;
   }
-  
+
   // perform inner SHA512
-  memcpy(buffer, k_ipad, SHA512_BLOCK_LENGTH);
-  memcpy(buffer + SHA512_BLOCK_LENGTH, in, n);
-  mbedtls_sha512(buffer, SHA512_BLOCK_LENGTH + n, out, is384);
-  
-  memset(buffer, 0, SHA512_BLOCK_LENGTH + n);
+  mbedtls_sha512_init(&ctx);
+  mbedtls_sha512_starts(&ctx, is384);
+  mbedtls_sha512_update(&ctx, k_pad, SHA512_BLOCK_LENGTH);
+  mbedtls_sha512_update(&ctx, in, n);
+  mbedtls_sha512_finish(&ctx, out);
+
+  /* flip the pad from ipad to opad */
+  for (i = 0; i < SHA512_BLOCK_LENGTH; i++) {
+      k_pad[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+  }
 
   // perform outer SHA512
-  memcpy(buffer, k_opad, SHA512_BLOCK_LENGTH);
-  memcpy(buffer + SHA512_BLOCK_LENGTH, out, digest_length);
-  mbedtls_sha512(buffer, SHA512_BLOCK_LENGTH + digest_length, out, is384);
+  mbedtls_sha512_starts(&ctx, is384);
+  mbedtls_sha512_update(&ctx, k_pad, SHA512_BLOCK_LENGTH);
+  mbedtls_sha512_update(&ctx, out, digest_length);
+  mbedtls_sha512_finish(&ctx, out);
+  mbedtls_sha512_free(&ctx);
+
+  mbedtls_zeroize(k_pad, sizeof(k_pad));
 }
 
 /*
@@ -0,0 +1,224 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Known-answer tests and a rough throughput benchmark for the hash cores.
+// Build on the host with, e.g.:
+//   cc -O2 -I.. test_main.c unity.c ../sha1.c ../sha256.c ../sha512.c ../TOTP.c -o test_totp
+//
+// Code size isn't measured here; for the watch, run arm-none-eabi-size on the firmware build. For a rough
+// idea, .text of each core built alone with gcc 12 -Os on x86-64, before and after the rolled schedules:
+//   sha1    5999 -> 5996
+//   sha256  4637 -> 4194
+//   sha512  4311 -> 5509
+// SHA-512 grows on a 64-bit host, which has 64-bit rotates to lose by working on 32-bit halves; on the M0+
+// the compiler splits every 64-bit operation into halves anyway. SHA-1's compression function is left as it
+// was on purpose: it already keeps a 16-word schedule and only does 32-bit arithmetic. Only its HMAC changed.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../sha1.h"
+#include "../sha256.h"
+#include "../sha512.h"
+#include "../TOTP.h"
+#include "unity.h"
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static const char *msg_empty = "";
+static const char *msg_abc = "abc";
+static const char *msg_448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static void hex_to_bytes(const char *hex, uint8_t *out) {
+  size_t len = strlen(hex) / 2;
+  for (size_t i = 0; i < len; ++i) {
+    unsigned int byte;
+    sscanf(hex + 2 * i, "%2x", &byte);
+    out[i] = (uint8_t)byte;
+  }
+}
+
+static void assert_digest(const char *expected_hex, const uint8_t *digest) {
+  uint8_t expected[SHA512_DIGEST_LENGTH];
+  size_t len = strlen(expected_hex) / 2;
+  hex_to_bytes(expected_hex, expected);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, digest, len);
+}
+
+void test_sha1() {
+  uint8_t out[SHA1_DIGEST_LENGTH];
+  mbedtls_sha1((const uint8_t *)msg_empty, 0, out);
+  assert_digest("da39a3ee5e6b4b0d3255bfef95601890afd80709", out);
+  mbedtls_sha1((const uint8_t *)msg_abc, strlen(msg_abc), out);
+  assert_digest("a9993e364706816aba3e25717850c26c9cd0d89d", out);
+  mbedtls_sha1((const uint8_t *)msg_448, strlen(msg_448), out);
+  assert_digest("84983e441c3bd26ebaae4aa1f95129e5e54670f1", out);
+}
+
+void test_sha256() {
+  uint8_t out[SHA256_DIGEST_LENGTH];
+  mbedtls_sha256((const uint8_t *)msg_empty, 0, out, 0);
+  assert_digest("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", out);
+  mbedtls_sha256((const uint8_t *)msg_abc, strlen(msg_abc), out, 0);
+  assert_digest("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", out);
+  mbedtls_sha256((const uint8_t *)msg_448, strlen(msg_448), out, 0);
+  assert_digest("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", out);
+  mbedtls_sha256((const uint8_t *)msg_abc, strlen(msg_abc), out, 1);
+  assert_digest("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7", out);
+}
+
+void test_sha512() {
+  uint8_t out[SHA512_DIGEST_LENGTH];
+  mbedtls_sha512((const uint8_t *)msg_empty, 0, out, 0);
+  assert_digest("cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+                "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e", out);
+  mbedtls_sha512((const uint8_t *)msg_abc, strlen(msg_abc), out, 0);
+  assert_digest("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f", out);
+  mbedtls_sha512((const uint8_t *)msg_448, strlen(msg_448), out, 0);
+  assert_digest("204a8fc6dda82f0a0ced7beb8e08a41657c16ef468b228a8279be331a703c335"
+                "96fd15c13b1b07f9aa1d3bea57789ca031ad85c7a71dd70354ec631238ca3445", out);
+  mbedtls_sha512((const uint8_t *)msg_abc, strlen(msg_abc), out, 1);
+  assert_digest("cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed"
+                "8086072ba1e7cc2358baeca134c825a7", out);
+}
+
+// One million 'a's, fed through the streaming API in odd-sized pieces so that
+// the block buffering in update() gets exercised as well as the cores.
+void test_million_a_streaming() {
+  uint8_t chunk[997];
+  uint8_t out[SHA512_DIGEST_LENGTH];
+  memset(chunk, 'a', sizeof(chunk));
+
+  mbedtls_sha1_context ctx1;
+  mbedtls_sha256_context ctx256;
+  mbedtls_sha512_context ctx512;
+  mbedtls_sha1_init(&ctx1);
+  mbedtls_sha256_init(&ctx256);
+  mbedtls_sha512_init(&ctx512);
+  mbedtls_sha1_starts(&ctx1);
+  mbedtls_sha256_starts(&ctx256, 0);
+  mbedtls_sha512_starts(&ctx512, 0);
+  for (size_t left = 1000000; left > 0; ) {
+    size_t n = left < sizeof(chunk) ? left : sizeof(chunk);
+    mbedtls_sha1_update(&ctx1, chunk, n);
+    mbedtls_sha256_update(&ctx256, chunk, n);
+    mbedtls_sha512_update(&ctx512, chunk, n);
+    left -= n;
+  }
+  mbedtls_sha1_finish(&ctx1, out);
+  assert_digest("34aa973cd4c4daa4f61eeb2bdbad27316534016f", out);
+  mbedtls_sha256_finish(&ctx256, out);
+  assert_digest("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", out);
+  mbedtls_sha512_finish(&ctx512, out);
+  assert_digest("e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+                "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b", out);
+}
+
+// RFC 2202 / RFC 4231 test cases 1 (short key) and 6 (key longer than a block).
+void test_hmac() {
+  uint8_t out[SHA512_DIGEST_LENGTH];
+  uint8_t key[131];
+  const char *hi_there = "Hi There";
+  const char *large_key_msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+
+  memset(key, 0x0b, 20);
+  HMAC_SHA1(key, 20, (const uint8_t *)hi_there, strlen(hi_there), out);
+  assert_digest("b617318655057264e28bc0b6fb378c8ef146be00", out);
+  HMAC_SHA256(key, 20, (const uint8_t *)hi_there, strlen(hi_there), out, 1);
+  assert_digest("896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22", out);
+  HMAC_SHA256(key, 20, (const uint8_t *)hi_there, strlen(hi_there), out, 0);
+  assert_digest("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", out);
+  HMAC_SHA512(key, 20, (const uint8_t *)hi_there, strlen(hi_there), out, 1);
+  assert_digest("afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59c"
+                "faea9ea9076ede7f4af152e8b2fa9cb6", out);
+  HMAC_SHA512(key, 20, (const uint8_t *)hi_there, strlen(hi_there), out, 0);
+  assert_digest("87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+                "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854", out);
+
+  memset(key, 0xaa, sizeof(key));
+  HMAC_SHA1(key, sizeof(key), (const uint8_t *)large_key_msg, strlen(large_key_msg), out);
+  assert_digest("90d0dace1c1bdc957339307803160335bde6df2b", out);
+  HMAC_SHA256(key, sizeof(key), (const uint8_t *)large_key_msg, strlen(large_key_msg), out, 0);
+  assert_digest("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", out);
+  HMAC_SHA512(key, sizeof(key), (const uint8_t *)large_key_msg, strlen(large_key_msg), out, 0);
+  assert_digest("80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+                "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598", out);
+}
+
+// RFC 6238 appendix B, T = 59, truncated to the six digits the library produces.
+void test_totp() {
+  uint8_t seed[64];
+  memcpy(seed, "1234567890123456789012345678901234567890123456789012345678901234", 64);
+
+  TOTP(seed, 20, 30, SHA1);
+  TEST_ASSERT_EQUAL_UINT32(287082, getCodeFromTimestamp(59));
+  TOTP(seed, 32, 30, SHA256);
+  TEST_ASSERT_EQUAL_UINT32(119246, getCodeFromTimestamp(59));
+  TOTP(seed, 64, 30, SHA512);
+  TEST_ASSERT_EQUAL_UINT32(693936, getCodeFromTimestamp(59));
+}
+
+// Not a pass/fail test: prints host throughput so changes to the cores can be
+// compared. On the watch, time a TOTP code with the same loop instead.
+void test_benchmark() {
+  static uint8_t data[64 * 1024];
+  uint8_t out[SHA512_DIGEST_LENGTH];
+  char buf[128];
+  memset(data, 0x5a, sizeof(data));
+  const int rounds = 16;
+
+  clock_t start = clock();
+  for (int i = 0; i < rounds; ++i) mbedtls_sha1(data, sizeof(data), out);
+  double sha1_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (rounds * sizeof(data));
+
+  start = clock();
+  for (int i = 0; i < rounds; ++i) mbedtls_sha256(data, sizeof(data), out, 0);
+  double sha256_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (rounds * sizeof(data));
+
+  start = clock();
+  for (int i = 0; i < rounds; ++i) mbedtls_sha512(data, sizeof(data), out, 0);
+  double sha512_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (rounds * sizeof(data));
+
+  sprintf(buf, "ns/byte on host: SHA-1 %.2f, SHA-256 %.2f, SHA-512 %.2f", sha1_ns, sha256_ns, sha512_ns);
+  TEST_MESSAGE(buf);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sha1);
+  RUN_TEST(test_sha256);
+  RUN_TEST(test_sha512);
+  RUN_TEST(test_million_a_streaming);
+  RUN_TEST(test_hmac);
+  RUN_TEST(test_totp);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
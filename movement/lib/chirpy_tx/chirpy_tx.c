@@ -22,25 +22,56 @@
  * SOFTWARE.
  */
 
-#include <stdlib.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include "chirpy_tx.h"
 
-static const uint32_t chirpy_min_freq = 2500;
-static const uint32_t cirpy_freq_step = 250;
+#define CHIRPY_MIN_FREQ 2500
+#define CHIRPY_FREQ_STEP 250
+#define CHIRPY_TONE_PERIOD(tone) (1000000 / (CHIRPY_MIN_FREQ + (tone) * CHIRPY_FREQ_STEP))
+
+// The fast profile packs 16 data tones into narrower steps, and starts one standard step above the standard
+// profile's control tone, so that none of its tones is ever mistaken for a standard one. Up there a receiver's
+// clock error is more hertz, so the steps aren't as narrow as they could be.
+#define CHIRPY_FAST_MIN_FREQ (CHIRPY_MIN_FREQ + 9 * CHIRPY_FREQ_STEP)
+#define CHIRPY_FAST_FREQ_STEP 200
+#define CHIRPY_FAST_TONE_PERIOD(tone) (1000000 / (CHIRPY_FAST_MIN_FREQ + (tone) * CHIRPY_FAST_FREQ_STEP))
 
 // This many bytes are followed by a CRC and block separator
 // It's a multiple of 3 so no bits are wasted (a tone encodes 3 bits)
 // Last block can be shorter
 static const uint8_t chirpy_default_block_size = 15;
 
+// In the fast profile a byte is exactly two tones, so any block size works.
+static const uint8_t chirpy_fast_block_size = 16;
+
 // The dedicated control tone. This is the highest tone index.
 static const uint8_t chirpy_control_tone = 8;
+static const uint8_t chirpy_fast_control_tone = 16;
+
+// Tone periods, i.e., 1_000_000 / freq, worked out by the compiler.
+static const uint16_t chirpy_tone_periods[] = {
+    CHIRPY_TONE_PERIOD(0), CHIRPY_TONE_PERIOD(1), CHIRPY_TONE_PERIOD(2),
+    CHIRPY_TONE_PERIOD(3), CHIRPY_TONE_PERIOD(4), CHIRPY_TONE_PERIOD(5),
+    CHIRPY_TONE_PERIOD(6), CHIRPY_TONE_PERIOD(7), CHIRPY_TONE_PERIOD(8),
+};
 
-// Pre-computed tone periods. This is allocated and populated on-demand.
-static uint32_t *chirpy_tone_periods = NULL;
+static const uint16_t chirpy_fast_tone_periods[] = {
+    CHIRPY_FAST_TONE_PERIOD(0), CHIRPY_FAST_TONE_PERIOD(1), CHIRPY_FAST_TONE_PERIOD(2),
+    CHIRPY_FAST_TONE_PERIOD(3), CHIRPY_FAST_TONE_PERIOD(4), CHIRPY_FAST_TONE_PERIOD(5),
+    CHIRPY_FAST_TONE_PERIOD(6), CHIRPY_FAST_TONE_PERIOD(7), CHIRPY_FAST_TONE_PERIOD(8),
+    CHIRPY_FAST_TONE_PERIOD(9), CHIRPY_FAST_TONE_PERIOD(10), CHIRPY_FAST_TONE_PERIOD(11),
+    CHIRPY_FAST_TONE_PERIOD(12), CHIRPY_FAST_TONE_PERIOD(13), CHIRPY_FAST_TONE_PERIOD(14),
+    CHIRPY_FAST_TONE_PERIOD(15), CHIRPY_FAST_TONE_PERIOD(16),
+};
+
+// CRC8 (reflected polynomial 0x8C) of each 4-bit value. Two lookups per byte
+// replace the bit-by-bit loop while keeping the table at 16 bytes of flash.
+static const uint8_t chirpy_crc8_nibble_table[16] = {
+    0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8,
+    0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74,
+};
 
 uint8_t chirpy_crc8(const uint8_t *addr, uint16_t len) {
     uint8_t crc = 0;
@@ -50,13 +81,9 @@ uint8_t chirpy_crc8(const uint8_t *addr, uint16_t len) {
 }
 
 uint8_t chirpy_update_crc8(uint8_t next_byte, uint8_t crc) {
-    for (uint8_t j = 0; j < 8; j++) {
-        uint8_t mix = (crc ^ next_byte) & 0x01;
-        crc >>= 1;
-        if (mix)
-            crc ^= 0x8C;
-        next_byte >>= 1;
-    }
+    crc ^= next_byte;
+    crc = (crc >> 4) ^ chirpy_crc8_nibble_table[crc & 0x0F];
+    crc = (crc >> 4) ^ chirpy_crc8_nibble_table[crc & 0x0F];
     return crc;
 }
 
@@ -70,12 +97,27 @@ static void _chirpy_append_tone(chirpy_encoder_state_t *ces, uint8_t tone) {
 }
 
 void chirpy_init_encoder(chirpy_encoder_state_t *ces, chirpy_get_next_byte_t get_next_byte) {
+    chirpy_init_encoder_with_profile(ces, get_next_byte, CHIRPY_PROFILE_STANDARD);
+}
+
+void chirpy_init_encoder_with_profile(chirpy_encoder_state_t *ces, chirpy_get_next_byte_t get_next_byte, chirpy_profile_t profile) {
     memset(ces, 0, sizeof(chirpy_encoder_state_t));
-    ces->block_size = chirpy_default_block_size;
     ces->get_next_byte = get_next_byte;
-    _chirpy_append_tone(ces, 8);
+    ces->profile = profile;
+    if (profile == CHIRPY_PROFILE_FAST) {
+        ces->block_size = chirpy_fast_block_size;
+        ces->bits_per_tone = 4;
+        ces->control_tone = chirpy_fast_control_tone;
+    } else {
+        ces->block_size = chirpy_default_block_size;
+        ces->bits_per_tone = 3;
+        ces->control_tone = chirpy_control_tone;
+    }
+    // The preamble has the same shape in both profiles, but the fast profile's tones are all
+    // frequencies that standard receivers never listen for, so they simply ignore it.
+    _chirpy_append_tone(ces, ces->control_tone);
     _chirpy_append_tone(ces, 0);
-    _chirpy_append_tone(ces, 8);
+    _chirpy_append_tone(ces, ces->control_tone);
     _chirpy_append_tone(ces, 0);
 }
 
@@ -94,13 +136,14 @@ static uint8_t _chirpy_retrieve_next_tone(chirpy_encoder_state_t *ces) {
 }
 
 static void _chirpy_encode_bits(chirpy_encoder_state_t *ces, uint8_t force_partial) {
+    uint8_t bits_per_tone = ces->bits_per_tone;
     while (ces->bit_count > 0) {
-        if (ces->bit_count < 3 && !force_partial) break;
-        uint8_t tone = (uint8_t)(ces->bits >> 13);
+        if (ces->bit_count < bits_per_tone && !force_partial) break;
+        uint8_t tone = (uint8_t)(ces->bits >> (16 - bits_per_tone));
         _chirpy_append_tone(ces, tone);
-        if (ces->bit_count >= 3) {
-            ces->bits <<= 3;
-            ces->bit_count -= 3;
+        if (ces->bit_count >= bits_per_tone) {
+            ces->bits <<= bits_per_tone;
+            ces->bit_count -= bits_per_tone;
         } else {
             ces->bits = 0;
             ces->bit_count = 0;
@@ -109,7 +152,13 @@ static void _chirpy_encode_bits(chirpy_encoder_state_t *ces, uint8_t force_parti
 }
 
 static void _chirpy_finish_block(chirpy_encoder_state_t *ces) {
-    _chirpy_append_tone(ces, chirpy_control_tone);
+    _chirpy_append_tone(ces, ces->control_tone);
+    // In the fast profile, every block carries a 4-bit sequence number, so a receiver that
+    // loses a block to noise can resynchronize at the next one and knows exactly what it missed.
+    if (ces->profile == CHIRPY_PROFILE_FAST) {
+        _chirpy_append_tone(ces, ces->block_seq & 0x0F);
+        ++ces->block_seq;
+    }
     ces->bits = ces->crc;
     ces->bits <<= 8;
     ces->bit_count = 8;
@@ -117,12 +166,12 @@ static void _chirpy_finish_block(chirpy_encoder_state_t *ces) {
     ces->bit_count = 0;
     ces->crc = 0;
     ces->block_len = 0;
-    _chirpy_append_tone(ces, chirpy_control_tone);
+    _chirpy_append_tone(ces, ces->control_tone);
 }
 
 static void _chirpy_finish_transmission(chirpy_encoder_state_t *ces) {
-    _chirpy_append_tone(ces, chirpy_control_tone);
-    _chirpy_append_tone(ces, chirpy_control_tone);
+    _chirpy_append_tone(ces, ces->control_tone);
+    _chirpy_append_tone(ces, ces->control_tone);
 }
 
 uint8_t chirpy_get_next_tone(chirpy_encoder_state_t *ces) {
@@ -162,18 +211,46 @@ uint8_t chirpy_get_next_tone(chirpy_encoder_state_t *ces) {
     return _chirpy_retrieve_next_tone(ces);
 }
 
+uint8_t chirpy_get_next_tones(chirpy_encoder_state_t *ces, uint8_t *tones, uint8_t max_tones) {
+    uint8_t count = 0;
+    while (count < max_tones) {
+        uint8_t tone = chirpy_get_next_tone(ces);
+        if (tone == 255) break;
+        tones[count] = tone;
+        ++count;
+    }
+    return count;
+}
+
 uint16_t chirpy_get_tone_period(uint8_t tone) {
-    // Create pre-computed tone periods array on first use
-    if (chirpy_tone_periods == NULL) {
-      chirpy_tone_periods = malloc((chirpy_control_tone + 1) * sizeof(uint32_t));
-      for (uint8_t i = 0; i < chirpy_control_tone + 1; ++i) {
-        uint32_t freq = chirpy_min_freq + i * cirpy_freq_step;
-        uint16_t period = 1000000 / freq;
-        chirpy_tone_periods[i] = period;
-      }
+    return chirpy_get_profile_tone_period(CHIRPY_PROFILE_STANDARD, tone);
+}
+
+uint16_t chirpy_get_profile_tone_period(chirpy_profile_t profile, uint8_t tone) {
+    // Be paranoid about indexing into array
+    if (profile == CHIRPY_PROFILE_FAST) {
+        if (tone > chirpy_fast_control_tone)
+          tone = chirpy_fast_control_tone;
+        return chirpy_fast_tone_periods[tone];
     }
-    // Return pre-computed value, but be paranoid about indexing into array
     if (tone > chirpy_control_tone)
       tone = chirpy_control_tone;
     return chirpy_tone_periods[tone];
 }
+
+void chirpy_init_tone_queue(chirpy_tone_queue_t *queue) {
+    memset(queue, 0, sizeof(chirpy_tone_queue_t));
+}
+
+uint16_t chirpy_get_next_period(chirpy_tone_queue_t *queue, chirpy_encoder_state_t *ces) {
+    if (queue->pos == queue->count) {
+        // Queue drained: encode the next batch of tones in one go
+        uint8_t tones[CHIRPY_TONE_QUEUE_SIZE];
+        queue->count = chirpy_get_next_tones(ces, tones, CHIRPY_TONE_QUEUE_SIZE);
+        queue->pos = 0;
+        if (queue->count == 0) return 0;
+        for (uint8_t i = 0; i < queue->count; ++i)
+            queue->periods[i] = chirpy_get_profile_tone_period(ces->profile, tones[i]);
+    }
+    return queue->periods[queue->pos++];
+}
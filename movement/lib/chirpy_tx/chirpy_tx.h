@@ -25,6 +25,8 @@
 #ifndef CHIRPY_TX_H
 #define CHIRPY_TX_H
 
+#include <stdint.h>
+
 /** @brief Calculates the CRC of a byte sequence.
  */
 uint8_t chirpy_crc8(const uint8_t *addr, uint16_t len);
@@ -41,6 +43,24 @@ typedef uint8_t (*chirpy_get_next_byte_t)(uint8_t *next_byte);
 
 #define CHIRPY_TONE_BUF_SIZE 16
 
+/** @brief Transmission profiles.
+ * @details CHIRPY_PROFILE_STANDARD is the original format: 3 bits per tone on 9 tones 250 Hz apart, with a
+ *          15-byte block between CRCs. Every chirpy receiver understands it.
+ *          CHIRPY_PROFILE_FAST sends 4 bits per tone on 17 tones 200 Hz apart, with 16-byte blocks that each
+ *          carry a 4-bit sequence number next to their CRC, and is meant to be played with a shorter symbol
+ *          (see CHIRPY_FAST_SYMBOL_TICKS). Its tones sit above the standard ones, from 4750 to 7950 Hz, at
+ *          least a standard step away from any of them, so standard receivers ignore fast transmissions
+ *          rather than decoding garbage.
+ */
+typedef enum {
+    CHIRPY_PROFILE_STANDARD = 0,
+    CHIRPY_PROFILE_FAST,
+} chirpy_profile_t;
+
+// Symbol lengths for each profile, in ticks of a 64 Hz tick (i.e. the tick_compare of chirpy_tick_state_t)
+#define CHIRPY_STANDARD_SYMBOL_TICKS 3
+#define CHIRPY_FAST_SYMBOL_TICKS 2
+
 // Holds state used by the encoder. Do not manipulate directly.
 typedef struct {
     uint8_t tone_buf[CHIRPY_TONE_BUF_SIZE];
@@ -51,6 +71,10 @@ typedef struct {
     uint8_t crc;
     uint16_t bits;
     uint8_t bit_count;
+    uint8_t profile;
+    uint8_t bits_per_tone;
+    uint8_t control_tone;
+    uint8_t block_seq;
     chirpy_get_next_byte_t get_next_byte;
 } chirpy_encoder_state_t;
 
@@ -60,22 +84,69 @@ typedef struct {
  */
 void chirpy_init_encoder(chirpy_encoder_state_t *ces, chirpy_get_next_byte_t get_next_byte);
 
+/** @brief Iniitializes the encoder state for a transmission in the given profile.
+ * @param ces Pointer to encoder state object to be initialized.
+ * @param get_next_byte Pointer to function that the encoder will call to fetch data byte by byte.
+ * @param profile The profile to transmit in. @see chirpy_profile_t
+ */
+void chirpy_init_encoder_with_profile(chirpy_encoder_state_t *ces, chirpy_get_next_byte_t get_next_byte, chirpy_profile_t profile);
+
 /** @brief Returns the next tone to be transmitted.
  * @details This function will call the get_next_byte function stored in the encoder state to
  *          retrieve the next byte to be transmitted as needed. As a single byte is encoded as several tones,
  *          and because the transmission also includes periodic CRC values, not every call to this function
  *          will result in a callback for the next data byte.
  * @param ced Pointer to the encoder state object.
- * @return A tone index from 0 to N (where N is the largest tone index), or 255 if the transmission is over.
+ * @return A tone index from 0 to N (where N is the profile's control tone), or 255 if the transmission is over.
  */
 uint8_t chirpy_get_next_tone(chirpy_encoder_state_t *ces);
 
+/** @brief Encodes up to max_tones tones in one go.
+ * @details Equivalent to calling chirpy_get_next_tone repeatedly, but lets the caller run the encoder
+ *          several symbols ahead of the transmission, outside of its timing-critical tick.
+ * @param ces Pointer to the encoder state object.
+ * @param tones Buffer of at least max_tones bytes that receives the tone indexes.
+ * @param max_tones The maximum number of tones to write.
+ * @return The number of tones written. This is less than max_tones only once the transmission is over.
+ */
+uint8_t chirpy_get_next_tones(chirpy_encoder_state_t *ces, uint8_t *tones, uint8_t max_tones);
+
 /** @brief Returns the period value for buzzing out a tone.
  * @param tone The tone index, 0 thru 8.
  * @return The period for the tone's frequency, i.e., 1_000_000 / freq.
  */
 uint16_t chirpy_get_tone_period(uint8_t tone);
 
+/** @brief Returns the period value for buzzing out a tone in the given profile.
+ * @param profile The profile of the transmission.
+ * @param tone The tone index, 0 thru 8 for the standard profile or 0 thru 16 for the fast profile.
+ * @return The period for the tone's frequency, i.e., 1_000_000 / freq.
+ */
+uint16_t chirpy_get_profile_tone_period(chirpy_profile_t profile, uint8_t tone);
+
+#define CHIRPY_TONE_QUEUE_SIZE 8
+
+// Buzzer periods encoded ahead of the transmission. Do not manipulate directly.
+typedef struct {
+    uint16_t periods[CHIRPY_TONE_QUEUE_SIZE];
+    uint8_t pos;
+    uint8_t count;
+} chirpy_tone_queue_t;
+
+/** @brief Empties a tone queue before a new transmission.
+ * @param queue Pointer to the queue to be initialized.
+ */
+void chirpy_init_tone_queue(chirpy_tone_queue_t *queue);
+
+/** @brief Returns the buzzer period for the next tone to be transmitted.
+ * @details Most calls are a single read from the queue; every CHIRPY_TONE_QUEUE_SIZE tones, the queue is
+ *          refilled from the encoder in one batch. This keeps the work done in a 64 Hz tick to a minimum.
+ * @param queue Pointer to the tone queue.
+ * @param ces Pointer to the encoder state object that feeds the queue.
+ * @return The period to pass to watch_set_buzzer_period, or 0 if the transmission is over.
+ */
+uint16_t chirpy_get_next_period(chirpy_tone_queue_t *queue, chirpy_encoder_state_t *ces);
+
 /** @brief Typedef for a tick handler function.
  */
 typedef void (*chirpy_tick_fun_t)(void *context);
@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Channel simulator for chirpy: encodes a random payload, renders the tones as the buzzer would
+ * (a square wave at 1_000_000 / period Hz), sends them through a simple channel (attenuation,
+ * frequency error, additive white Gaussian noise), detects tones with a bank of windowed Goertzel filters
+ * and decodes the result with the reference receiver. Prints symbol error rate, block error rate
+ * and goodput against SNR and frequency error, for both profiles.
+ *
+ * Build and run from this directory:
+ *   gcc -O2 -o channel_sim channel_sim.c chirpy_rx.c ../chirpy_tx.c -lm && ./channel_sim
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../chirpy_tx.h"
+#include "chirpy_rx.h"
+
+#define SAMPLE_RATE 48000
+#define TICK_HZ 64
+#define PAYLOAD_LEN 160
+#define TRIALS 4
+#define MAX_TONES 2048
+
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double rng_gauss(void) {
+    double u1 = (rng_next() + 1.0) / 4294967297.0;
+    double u2 = (rng_next() + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static const uint8_t *payload;
+static uint16_t payload_pos;
+
+static uint8_t get_next_byte(uint8_t *next_byte) {
+    if (payload_pos == PAYLOAD_LEN) return 0;
+    *next_byte = payload[payload_pos++];
+    return 1;
+}
+
+static double goertzel_power(const float *x, int n, double freq) {
+    double coeff = 2.0 * cos(2.0 * M_PI * freq / SAMPLE_RATE);
+    double s1 = 0, s2 = 0;
+    for (int i = 0; i < n; ++i) {
+        double s = x[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+typedef struct {
+    double symbol_errors;
+    double block_errors;
+    double goodput;
+} sim_result_t;
+
+static sim_result_t simulate(chirpy_profile_t profile, double snr_db, double freq_error) {
+    uint8_t ctrl = profile == CHIRPY_PROFILE_FAST ? 16 : 8;
+    int symbol_ticks = profile == CHIRPY_PROFILE_FAST ? CHIRPY_FAST_SYMBOL_TICKS : CHIRPY_STANDARD_SYMBOL_TICKS;
+    int symbol_len = SAMPLE_RATE * symbol_ticks / TICK_HZ;
+    // The buzzer takes a moment to settle and the receiver's framing is never perfect: skip the edges
+    int guard = symbol_len / 8;
+    int window_len = symbol_len - 2 * guard;
+    double step = profile == CHIRPY_PROFILE_FAST ? 200 : 250;
+    float *samples = malloc(sizeof(float) * symbol_len);
+    float *windowed = malloc(sizeof(float) * window_len);
+    float *window = malloc(sizeof(float) * window_len);
+    for (int i = 0; i < window_len; ++i) window[i] = 0.5 - 0.5 * cos(2.0 * M_PI * i / (window_len - 1));
+    // Square wave of amplitude A has power A^2; noise is scaled to the requested per-sample SNR
+    double amplitude = 0.25;
+    double noise_sigma = amplitude * pow(10.0, -snr_db / 20.0);
+
+    uint8_t data[PAYLOAD_LEN];
+    uint8_t tones[MAX_TONES];
+    uint8_t out[PAYLOAD_LEN];
+    uint32_t symbols = 0, symbol_errors = 0;
+    uint32_t blocks_total = 0, blocks_lost = 0;
+    uint64_t good_bytes = 0;
+    double airtime = 0;
+
+    for (int trial = 0; trial < TRIALS; ++trial) {
+        for (int i = 0; i < PAYLOAD_LEN; ++i) data[i] = rng_next();
+        payload = data;
+        payload_pos = 0;
+        chirpy_encoder_state_t ces;
+        chirpy_init_encoder_with_profile(&ces, get_next_byte, profile);
+        uint16_t tone_count = chirpy_get_next_tones(&ces, tones, 255);
+        while (tone_count < MAX_TONES) {
+            uint8_t count = chirpy_get_next_tones(&ces, &tones[tone_count], 255);
+            if (count == 0) break;
+            tone_count += count;
+        }
+
+        chirpy_rx_t rx;
+        chirpy_rx_init(&rx, profile, out, sizeof(out));
+        for (uint16_t t = 0; t < tone_count; ++t) {
+            double freq = 1000000.0 / chirpy_get_profile_tone_period(profile, tones[t]) * (1.0 + freq_error);
+            // Band-limited square wave: the piezo doesn't alias, so neither should we
+            for (int i = 0; i < symbol_len; ++i) {
+                double w = 2.0 * M_PI * freq * (i + t * symbol_len) / SAMPLE_RATE;
+                double v = 0;
+                for (int h = 1; h * freq < SAMPLE_RATE / 2; h += 2) v += sin(h * w) / h;
+                samples[i] = amplitude * 4.0 / M_PI * v + noise_sigma * rng_gauss();
+            }
+            for (int i = 0; i < window_len; ++i) windowed[i] = samples[guard + i] * window[i];
+            // A tone's score is the best of a few bins around its nominal frequency, so the
+            // receiver tolerates some error in the watch's clock (or in its own)
+            uint8_t best = 0;
+            double best_power = -1;
+            for (uint8_t k = 0; k <= ctrl; ++k) {
+                double f = 1000000.0 / chirpy_get_profile_tone_period(profile, k);
+                for (int o = -1; o <= 1; ++o) {
+                    double p = goertzel_power(windowed, window_len, f + o * step / 4);
+                    if (p > best_power) {
+                        best_power = p;
+                        best = k;
+                    }
+                }
+            }
+            ++symbols;
+            if (best != tones[t]) ++symbol_errors;
+            chirpy_rx_push(&rx, best);
+        }
+        airtime += (double)tone_count * symbol_ticks / TICK_HZ;
+
+        // Count good bytes by position: blocks that got through land in order, lost ones leave gaps
+        uint16_t block_size = profile == CHIRPY_PROFILE_FAST ? 16 : 15;
+        uint16_t blocks = (PAYLOAD_LEN + block_size - 1) / block_size;
+        blocks_total += blocks;
+        blocks_lost += blocks - (rx.blocks_ok < blocks ? rx.blocks_ok : blocks);
+        size_t n = rx.out_len < PAYLOAD_LEN ? rx.out_len : PAYLOAD_LEN;
+        if (rx.blocks_ok == blocks && n == PAYLOAD_LEN && memcmp(out, data, n) == 0) good_bytes += n;
+        else good_bytes += (uint64_t)rx.blocks_ok * block_size;
+    }
+    free(samples);
+    free(windowed);
+    free(window);
+
+    sim_result_t res;
+    res.symbol_errors = (double)symbol_errors / symbols;
+    res.block_errors = (double)blocks_lost / blocks_total;
+    res.goodput = good_bytes * 8.0 / airtime;
+    return res;
+}
+
+int main(void) {
+    const double snrs[] = {-15, -12, -9, -6, -3, 0, 10};
+    const double freq_errors[] = {0, 0.005, 0.01, 0.02};
+    const char *names[] = {"standard", "fast"};
+
+    printf("%-9s %6s %7s %10s %10s %12s\n", "profile", "snr_db", "ferr_%", "sym_err", "block_err", "goodput_bps");
+    for (int p = 0; p < 2; ++p) {
+        for (size_t f = 0; f < sizeof(freq_errors) / sizeof(freq_errors[0]); ++f) {
+            for (size_t s = 0; s < sizeof(snrs) / sizeof(snrs[0]); ++s) {
+                sim_result_t r = simulate((chirpy_profile_t)p, snrs[s], freq_errors[f]);
+                printf("%-9s %6.1f %7.1f %10.4f %10.4f %12.1f\n", names[p], snrs[s], freq_errors[f] * 100,
+                       r.symbol_errors, r.block_errors, r.goodput);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "chirpy_rx.h"
+
+void chirpy_rx_init(chirpy_rx_t *rx, chirpy_profile_t profile, uint8_t *out, size_t out_size) {
+    memset(rx, 0, sizeof(chirpy_rx_t));
+    rx->profile = profile;
+    if (profile == CHIRPY_PROFILE_FAST) {
+        rx->control_tone = 16;
+        rx->bits_per_tone = 4;
+        // sequence number, then the CRC in two tones
+        rx->trailer_len = 3;
+    } else {
+        rx->control_tone = 8;
+        rx->bits_per_tone = 3;
+        // the CRC in three tones, the last one padded
+        rx->trailer_len = 3;
+    }
+    rx->out = out;
+    rx->out_size = out_size;
+}
+
+static void _chirpy_rx_hunt(chirpy_rx_t *rx, uint8_t tone) {
+    // Preamble is ctrl, 0, ctrl, 0
+    uint8_t expected = (rx->preamble_pos & 1) ? 0 : rx->control_tone;
+    if (tone == expected) {
+        ++rx->preamble_pos;
+        if (rx->preamble_pos == 4) {
+            rx->phase = CHIRPY_RX_DATA;
+            rx->block_tone_count = 0;
+        }
+    } else {
+        rx->preamble_pos = (tone == rx->control_tone) ? 1 : 0;
+    }
+}
+
+// Unpacks tones into a bit string, MSB first, and returns the number of whole bytes
+static uint8_t _chirpy_rx_unpack(chirpy_rx_t *rx, const uint8_t *tones, uint8_t count, uint8_t *bytes) {
+    uint16_t bits = 0;
+    uint8_t bit_count = 0;
+    uint8_t byte_count = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        bits = (bits << rx->bits_per_tone) | tones[i];
+        bit_count += rx->bits_per_tone;
+        if (bit_count >= 8) {
+            bytes[byte_count++] = (uint8_t)(bits >> (bit_count - 8));
+            bit_count -= 8;
+            bits &= (1 << bit_count) - 1;
+        }
+    }
+    return byte_count;
+}
+
+static void _chirpy_rx_finish_block(chirpy_rx_t *rx) {
+    uint8_t payload[CHIRPY_RX_MAX_BLOCK_TONES];
+    uint8_t crc_byte;
+    const uint8_t *crc_tones = rx->trailer;
+    uint8_t crc_tone_count = rx->trailer_count;
+
+    if (rx->profile == CHIRPY_PROFILE_FAST) {
+        ++crc_tones;
+        --crc_tone_count;
+    }
+    if (_chirpy_rx_unpack(rx, crc_tones, crc_tone_count, &crc_byte) != 1) {
+        ++rx->blocks_bad;
+        return;
+    }
+    uint8_t len = _chirpy_rx_unpack(rx, rx->block_tones, rx->block_tone_count, payload);
+    if (chirpy_crc8(payload, len) != crc_byte) {
+        ++rx->blocks_bad;
+        return;
+    }
+    if (rx->profile == CHIRPY_PROFILE_FAST) {
+        uint8_t seq = rx->trailer[0];
+        // Every block that didn't arrive intact since the last good one shows up as a gap in the sequence
+        uint8_t gap = (seq - rx->expected_seq) & 0x0F;
+        rx->blocks_missed += gap;
+        rx->expected_seq = seq + 1;
+    }
+    ++rx->blocks_ok;
+    for (uint8_t i = 0; i < len; ++i) {
+        if (rx->out_len < rx->out_size) rx->out[rx->out_len] = payload[i];
+        ++rx->out_len;
+    }
+}
+
+static void _chirpy_rx_lose_sync(chirpy_rx_t *rx) {
+    ++rx->blocks_bad;
+    // We're somewhere in the middle of a run, so the first one we see can't be measured
+    rx->trailer_count = CHIRPY_RX_NO_TONE;
+    rx->phase = CHIRPY_RX_RESYNC;
+}
+
+uint8_t chirpy_rx_push(chirpy_rx_t *rx, uint8_t tone) {
+    switch (rx->phase) {
+        case CHIRPY_RX_HUNTING:
+            _chirpy_rx_hunt(rx, tone);
+            break;
+        case CHIRPY_RX_DATA:
+            if (tone == rx->control_tone) {
+                // A block never has zero data tones: ctrl right after a block is the end marker
+                if (rx->block_tone_count == 0) {
+                    rx->phase = CHIRPY_RX_DONE;
+                    break;
+                }
+                rx->trailer_count = 0;
+                rx->phase = CHIRPY_RX_TRAILER;
+            } else if (tone > rx->control_tone || rx->block_tone_count == CHIRPY_RX_MAX_BLOCK_TONES) {
+                _chirpy_rx_lose_sync(rx);
+            } else {
+                rx->block_tones[rx->block_tone_count++] = tone;
+            }
+            break;
+        case CHIRPY_RX_TRAILER:
+            if (tone == rx->control_tone) {
+                if (rx->trailer_count == rx->trailer_len) _chirpy_rx_finish_block(rx);
+                else ++rx->blocks_bad;
+                rx->block_tone_count = 0;
+                rx->phase = CHIRPY_RX_DATA;
+            } else if (tone > rx->control_tone || rx->trailer_count == rx->trailer_len) {
+                _chirpy_rx_lose_sync(rx);
+            } else {
+                rx->trailer[rx->trailer_count++] = tone;
+            }
+            break;
+        case CHIRPY_RX_RESYNC:
+            // Drop everything until we see a run of tones between two control tones that has the shape
+            // of a block trailer; the next block starts right after it.
+            if (tone == rx->control_tone) {
+                if (rx->trailer_count == rx->trailer_len) {
+                    rx->block_tone_count = 0;
+                    rx->phase = CHIRPY_RX_DATA;
+                }
+                rx->trailer_count = 0;
+            } else if (rx->trailer_count != CHIRPY_RX_NO_TONE) {
+                ++rx->trailer_count;
+            }
+            break;
+        case CHIRPY_RX_DONE:
+            break;
+    }
+    return rx->phase == CHIRPY_RX_DONE;
+}
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CHIRPY_RX_H
+#define CHIRPY_RX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../chirpy_tx.h"
+
+/** @brief Reference chirpy receiver, working at the tone level.
+ * @details Host-side only: this is what the encoder is tested against, and what channel_sim feeds with
+ *          detected tones. Push tone indices one at a time; the decoder finds the preamble, splits the
+ *          stream into blocks at control tones, checks each block's CRC (and in the fast profile, its
+ *          sequence number), and appends the payload of good blocks to the output buffer. A corrupted
+ *          block is dropped and the decoder picks up again at the next control tone.
+ */
+
+#define CHIRPY_RX_MAX_BLOCK_TONES 64
+#define CHIRPY_RX_NO_TONE 255
+
+typedef enum {
+    CHIRPY_RX_HUNTING = 0,
+    CHIRPY_RX_DATA,
+    CHIRPY_RX_TRAILER,
+    CHIRPY_RX_RESYNC,
+    CHIRPY_RX_DONE,
+} chirpy_rx_phase_t;
+
+typedef struct {
+    chirpy_profile_t profile;
+    uint8_t control_tone;
+    uint8_t bits_per_tone;
+    uint8_t trailer_len;
+    chirpy_rx_phase_t phase;
+    uint8_t preamble_pos;
+    uint8_t block_tones[CHIRPY_RX_MAX_BLOCK_TONES];
+    uint8_t block_tone_count;
+    uint8_t trailer[4];
+    uint8_t trailer_count;
+    uint8_t expected_seq;
+    uint8_t *out;
+    size_t out_size;
+    size_t out_len;
+    uint32_t blocks_ok;
+    uint32_t blocks_bad;     // blocks that were seen but failed their CRC or were malformed
+    uint32_t blocks_missed;  // fast profile only: gaps in the block sequence, i.e. blocks that never got through
+} chirpy_rx_t;
+
+/** @brief Resets the receiver, ready to hunt for a preamble.
+ * @param rx The receiver state.
+ * @param profile The profile to listen for. A receiver ignores transmissions in the other profile.
+ * @param out Buffer that receives the payload of every block that passed its CRC.
+ * @param out_size Size of out; payload beyond this is counted but discarded.
+ */
+void chirpy_rx_init(chirpy_rx_t *rx, chirpy_profile_t profile, uint8_t *out, size_t out_size);
+
+/** @brief Feeds the next detected tone into the receiver.
+ * @param rx The receiver state.
+ * @param tone The detected tone index, or CHIRPY_RX_NO_TONE if nothing could be detected.
+ * @return 1 once the end of the transmission has been seen, 0 otherwise.
+ */
+uint8_t chirpy_rx_push(chirpy_rx_t *rx, uint8_t tone);
+
+#endif
@@ -22,10 +22,13 @@
  * SOFTWARE.
  */
 
+#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
-#include "../src/lib/chirpy_tx.h"
+#include "../chirpy_tx.h"
+#include "chirpy_rx.h"
 #include "unity.h"
 
 
@@ -67,6 +70,37 @@ void test_crc8() {
   TEST_ASSERT_EQUAL(7, crc);
 }
 
+// Bit-by-bit reference for the table-driven implementation
+static uint8_t reference_update_crc8(uint8_t next_byte, uint8_t crc) {
+  for (uint8_t j = 0; j < 8; j++) {
+    uint8_t mix = (crc ^ next_byte) & 0x01;
+    crc >>= 1;
+    if (mix)
+      crc ^= 0x8C;
+    next_byte >>= 1;
+  }
+  return crc;
+}
+
+void test_crc8_table() {
+  for (uint16_t crc = 0; crc < 256; ++crc) {
+    for (uint16_t next_byte = 0; next_byte < 256; ++next_byte) {
+      uint8_t expected = reference_update_crc8(next_byte, crc);
+      TEST_ASSERT_EQUAL_UINT8(expected, chirpy_update_crc8(next_byte, crc));
+    }
+  }
+}
+
+void test_tone_periods() {
+  for (uint8_t tone = 0; tone <= 8; ++tone) {
+    uint16_t expected = 1000000 / (2500 + tone * 250);
+    TEST_ASSERT_EQUAL_UINT16(expected, chirpy_get_tone_period(tone));
+  }
+  // Out-of-range tones are clamped to the control tone
+  TEST_ASSERT_EQUAL_UINT16(chirpy_get_tone_period(8), chirpy_get_tone_period(9));
+  TEST_ASSERT_EQUAL_UINT16(chirpy_get_tone_period(8), chirpy_get_tone_period(255));
+}
+
 const uint16_t data_len_01 = 0;
 const uint8_t data_01[] = {};
 const uint16_t tones_len_01 = 6;
@@ -152,9 +186,209 @@ void test_encoder() {
   test_encoder_one(data_05, data_len_05, tones_05, tones_len_05);
 }
 
+void test_block_encoder_one(const uint8_t *data, uint16_t data_len, const uint8_t *tones, uint16_t tones_len, uint8_t chunk) {
+  curr_data = data;
+  curr_data_len = data_len;
+  curr_data_pos = 0;
+  chirpy_encoder_state_t ces;
+  chirpy_init_encoder(&ces, get_next_byte);
+  ces.block_size = 3;
+
+  uint8_t got_tones[256] = {0};
+  uint16_t got_tone_pos = 0;
+  while (got_tone_pos + chunk <= 256) {
+    uint8_t count = chirpy_get_next_tones(&ces, &got_tones[got_tone_pos], chunk);
+    got_tone_pos += count;
+    if (count < chunk) break;
+  }
+  TEST_ASSERT_EQUAL(tones_len, got_tone_pos);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(tones, got_tones, tones_len);
+  // Once over, the encoder keeps reporting an empty batch
+  TEST_ASSERT_EQUAL(0, chirpy_get_next_tones(&ces, got_tones, chunk));
+}
+
+void test_block_encoder() {
+  // Chunk sizes that divide the tone stream evenly, and ones that don't
+  for (uint8_t chunk = 1; chunk <= 9; ++chunk) {
+    test_block_encoder_one(data_01, data_len_01, tones_01, tones_len_01, chunk);
+    test_block_encoder_one(data_02, data_len_02, tones_02, tones_len_02, chunk);
+    test_block_encoder_one(data_03, data_len_03, tones_03, tones_len_03, chunk);
+    test_block_encoder_one(data_04, data_len_04, tones_04, tones_len_04, chunk);
+    test_block_encoder_one(data_05, data_len_05, tones_05, tones_len_05, chunk);
+  }
+}
+
+void test_tone_queue() {
+  curr_data = data_05;
+  curr_data_len = data_len_05;
+  curr_data_pos = 0;
+  chirpy_encoder_state_t ces;
+  chirpy_init_encoder(&ces, get_next_byte);
+  ces.block_size = 3;
+  chirpy_tone_queue_t queue;
+  chirpy_init_tone_queue(&queue);
+
+  for (uint16_t i = 0; i < tones_len_05; ++i) {
+    TEST_ASSERT_EQUAL_UINT16(chirpy_get_tone_period(tones_05[i]), chirpy_get_next_period(&queue, &ces));
+  }
+  TEST_ASSERT_EQUAL_UINT16(0, chirpy_get_next_period(&queue, &ces));
+  TEST_ASSERT_EQUAL_UINT16(0, chirpy_get_next_period(&queue, &ces));
+}
+
+void test_fast_tone_periods() {
+  for (uint8_t tone = 0; tone <= 16; ++tone) {
+    uint16_t expected = 1000000 / (4750 + tone * 200);
+    TEST_ASSERT_EQUAL_UINT16(expected, chirpy_get_profile_tone_period(CHIRPY_PROFILE_FAST, tone));
+  }
+  TEST_ASSERT_EQUAL_UINT16(chirpy_get_profile_tone_period(CHIRPY_PROFILE_FAST, 16),
+                           chirpy_get_profile_tone_period(CHIRPY_PROFILE_FAST, 17));
+  // The standard profile is untouched
+  TEST_ASSERT_EQUAL_UINT16(chirpy_get_tone_period(5), chirpy_get_profile_tone_period(CHIRPY_PROFILE_STANDARD, 5));
+}
+
+void test_fast_tones_clear_standard_tones() {
+  // A receiver matches a tone within a quarter step of its frequency, and allows for a few percent of error
+  // in either clock (see channel_sim.c). Keeping a whole standard step between the profiles leaves room for both.
+  for (uint8_t fast = 0; fast <= 16; ++fast) {
+    double fast_freq = 1000000.0 / chirpy_get_profile_tone_period(CHIRPY_PROFILE_FAST, fast);
+    for (uint8_t standard = 0; standard <= 8; ++standard) {
+      double standard_freq = 1000000.0 / chirpy_get_profile_tone_period(CHIRPY_PROFILE_STANDARD, standard);
+      TEST_ASSERT_TRUE(fabs(fast_freq - standard_freq) >= 250);
+    }
+  }
+}
+
+// Preamble; two tones per byte; ctrl, sequence number, CRC (167) in two tones, ctrl; end
+const uint16_t fast_tones_len_03 = 13;
+const uint8_t fast_tones_03[] = {16, 0, 16, 0, 6, 8, 16, 0, 10, 7, 16, 16, 16};
+
+void test_fast_encoder() {
+  curr_data = data_03;
+  curr_data_len = data_len_03;
+  curr_data_pos = 0;
+  chirpy_encoder_state_t ces;
+  chirpy_init_encoder_with_profile(&ces, get_next_byte, CHIRPY_PROFILE_FAST);
+
+  uint8_t got_tones[64] = {0};
+  uint8_t count = chirpy_get_next_tones(&ces, got_tones, 64);
+  TEST_ASSERT_EQUAL(fast_tones_len_03, count);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(fast_tones_03, got_tones, fast_tones_len_03);
+}
+
+static uint16_t encode_all(chirpy_profile_t profile, const uint8_t *data, uint8_t data_len, uint8_t *tones, uint16_t max_tones) {
+  curr_data = data;
+  curr_data_len = data_len;
+  curr_data_pos = 0;
+  chirpy_encoder_state_t ces;
+  chirpy_init_encoder_with_profile(&ces, get_next_byte, profile);
+  uint16_t count = 0;
+  while (count < max_tones) {
+    uint8_t tone = chirpy_get_next_tone(&ces);
+    if (tone == 255) break;
+    tones[count++] = tone;
+  }
+  return count;
+}
+
+void test_round_trip_one(chirpy_profile_t profile) {
+  uint8_t data[200];
+  uint32_t seed = 12345;
+  for (uint16_t i = 0; i < sizeof(data); ++i) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = seed >> 16;
+  }
+  for (uint16_t len = 0; len <= sizeof(data); len += 7) {
+    uint8_t tones[1024];
+    uint16_t tone_count = encode_all(profile, data, len, tones, sizeof(tones));
+    uint8_t out[256];
+    chirpy_rx_t rx;
+    chirpy_rx_init(&rx, profile, out, sizeof(out));
+    uint8_t done = 0;
+    for (uint16_t i = 0; i < tone_count; ++i) done = chirpy_rx_push(&rx, tones[i]);
+    TEST_ASSERT_EQUAL(1, done);
+    TEST_ASSERT_EQUAL(0, rx.blocks_bad);
+    TEST_ASSERT_EQUAL(0, rx.blocks_missed);
+    TEST_ASSERT_EQUAL(len, rx.out_len);
+    if (len > 0) TEST_ASSERT_EQUAL_UINT8_ARRAY(data, out, len);
+  }
+}
+
+void test_round_trip() {
+  test_round_trip_one(CHIRPY_PROFILE_STANDARD);
+  test_round_trip_one(CHIRPY_PROFILE_FAST);
+}
+
+void test_fast_profile_is_denser() {
+  uint8_t data[120] = {0};
+  uint8_t tones[1024];
+  uint16_t standard = encode_all(CHIRPY_PROFILE_STANDARD, data, sizeof(data), tones, sizeof(tones));
+  uint16_t fast = encode_all(CHIRPY_PROFILE_FAST, data, sizeof(data), tones, sizeof(tones));
+  // Fewer tones, and each one is shorter
+  TEST_ASSERT_TRUE(fast * 5 < standard * 4);
+  TEST_ASSERT_TRUE(CHIRPY_FAST_SYMBOL_TICKS < CHIRPY_STANDARD_SYMBOL_TICKS);
+}
+
+void test_rx_resync() {
+  // Four full blocks; wreck a data tone in the second one
+  uint8_t data[64];
+  for (uint8_t i = 0; i < sizeof(data); ++i) data[i] = i * 7;
+  uint8_t tones[512];
+  uint16_t tone_count = encode_all(CHIRPY_PROFILE_FAST, data, sizeof(data), tones, sizeof(tones));
+  // preamble (4) + block (32 data tones + 5 trailer tones)
+  tones[4 + 37 + 10] ^= 0x05;
+
+  uint8_t out[64];
+  chirpy_rx_t rx;
+  chirpy_rx_init(&rx, CHIRPY_PROFILE_FAST, out, sizeof(out));
+  uint8_t done = 0;
+  for (uint16_t i = 0; i < tone_count; ++i) done = chirpy_rx_push(&rx, tones[i]);
+  TEST_ASSERT_EQUAL(1, done);
+  TEST_ASSERT_EQUAL(3, rx.blocks_ok);
+  TEST_ASSERT_EQUAL(1, rx.blocks_bad);
+  TEST_ASSERT_EQUAL(1, rx.blocks_missed);
+  TEST_ASSERT_EQUAL(48, rx.out_len);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, out, 16);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data + 32, out + 16, 32);
+
+  // Dropping a control tone costs the damaged block and the one after it, then the decoder is back
+  tone_count = encode_all(CHIRPY_PROFILE_FAST, data, sizeof(data), tones, sizeof(tones));
+  tones[4 + 32] = 3;
+  chirpy_rx_init(&rx, CHIRPY_PROFILE_FAST, out, sizeof(out));
+  for (uint16_t i = 0; i < tone_count; ++i) done = chirpy_rx_push(&rx, tones[i]);
+  TEST_ASSERT_EQUAL(1, done);
+  TEST_ASSERT_EQUAL(2, rx.blocks_ok);
+  TEST_ASSERT_EQUAL(2, rx.blocks_missed);
+  TEST_ASSERT_EQUAL(32, rx.out_len);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data + 32, out, 32);
+}
+
+void test_standard_rx_ignores_fast() {
+  uint8_t data[32] = {0};
+  uint8_t tones[512];
+  uint16_t tone_count = encode_all(CHIRPY_PROFILE_FAST, data, sizeof(data), tones, sizeof(tones));
+  uint8_t out[64];
+  chirpy_rx_t rx;
+  chirpy_rx_init(&rx, CHIRPY_PROFILE_STANDARD, out, sizeof(out));
+  uint8_t done = 0;
+  for (uint16_t i = 0; i < tone_count; ++i) done = chirpy_rx_push(&rx, tones[i]);
+  TEST_ASSERT_EQUAL(0, done);
+  TEST_ASSERT_EQUAL(0, rx.out_len);
+}
+
 int main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_crc8);
+  RUN_TEST(test_crc8_table);
+  RUN_TEST(test_tone_periods);
   RUN_TEST(test_encoder);
+  RUN_TEST(test_block_encoder);
+  RUN_TEST(test_tone_queue);
+  RUN_TEST(test_fast_tone_periods);
+  RUN_TEST(test_fast_tones_clear_standard_tones);
+  RUN_TEST(test_fast_encoder);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_fast_profile_is_denser);
+  RUN_TEST(test_rx_resync);
+  RUN_TEST(test_standard_rx_ignores_fast);
   return UNITY_END();
 }
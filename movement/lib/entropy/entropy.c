@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "entropy.h"
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTL(d, 16); \
+    c += d; b ^= c; b = ROTL(b, 12); \
+    a += b; d ^= a; d = ROTL(d, 8); \
+    c += d; b ^= c; b = ROTL(b, 7);
+
+// One ChaCha20 block (RFC 8439) under the current key, with the nonce fixed at zero.
+static void _entropy_block(entropy_t *entropy, uint32_t out[16]) {
+    uint32_t state[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        entropy->key[0], entropy->key[1], entropy->key[2], entropy->key[3],
+        entropy->key[4], entropy->key[5], entropy->key[6], entropy->key[7],
+        entropy->counter, 0, 0, 0,
+    };
+    uint32_t x[16];
+
+    memcpy(x, state, sizeof(x));
+    for (uint8_t i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (uint8_t i = 0; i < 16; i++) out[i] = x[i] + state[i];
+
+    entropy->counter++;
+}
+
+static void _entropy_refill(entropy_t *entropy) {
+    uint32_t block[16];
+
+    _entropy_block(entropy, block);
+    memcpy(entropy->key, block, sizeof(entropy->key));
+    memcpy(entropy->buffer, block + 8, sizeof(entropy->buffer));
+    memset(block, 0, sizeof(block));
+    entropy->available = 8;
+}
+
+void entropy_seed(entropy_t *entropy, const uint32_t seed[ENTROPY_SEED_WORDS]) {
+    memset(entropy, 0, sizeof(entropy_t));
+    memcpy(entropy->key, seed, sizeof(entropy->key));
+}
+
+void entropy_reseed(entropy_t *entropy, const uint32_t seed[ENTROPY_SEED_WORDS]) {
+    for (uint8_t i = 0; i < ENTROPY_SEED_WORDS; i++) entropy->key[i] ^= seed[i];
+    memset(entropy->buffer, 0, sizeof(entropy->buffer));
+    entropy->available = 0;
+    entropy->words_since_reseed = 0;
+}
+
+uint32_t entropy_next(entropy_t *entropy) {
+    if (entropy->available == 0) _entropy_refill(entropy);
+
+    // hand out the buffer in order, and wipe each word as it goes
+    uint8_t i = 8 - entropy->available--;
+    uint32_t value = entropy->buffer[i];
+    entropy->buffer[i] = 0;
+    entropy->words_since_reseed++;
+
+    return value;
+}
+
+void entropy_bytes(entropy_t *entropy, void *buf, size_t len) {
+    uint8_t *bytes = buf;
+
+    while (len >= 4) {
+        uint32_t value = entropy_next(entropy);
+        memcpy(bytes, &value, 4);
+        bytes += 4;
+        len -= 4;
+    }
+    if (len) {
+        uint32_t value = entropy_next(entropy);
+        memcpy(bytes, &value, len);
+    }
+}
+
+uint32_t entropy_uniform(entropy_t *entropy, uint32_t upper_bound) {
+    if (upper_bound < 2) return 0;
+
+    // Lemire's multiply-and-shift: the high word of value * upper_bound is in range, and the low word
+    // tells us whether this value falls in the few that would make some results more likely than others.
+    // The division that finds those only happens when the low word is small enough that it might.
+    uint64_t product = (uint64_t)entropy_next(entropy) * upper_bound;
+    uint32_t low = (uint32_t)product;
+    if (low < upper_bound) {
+        uint32_t threshold = (0 - upper_bound) % upper_bound;
+        while (low < threshold) {
+            product = (uint64_t)entropy_next(entropy) * upper_bound;
+            low = (uint32_t)product;
+        }
+    }
+
+    return product >> 32;
+}
@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ENTROPY_H_
+#define ENTROPY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Random number generator for Movement: ChaCha20 run as a generator, seeded and reseeded with
+ * words from the TRNG.
+ *
+ * Each ChaCha20 block gives 16 words. The first eight become the next key before anything else
+ * is handed out, and only the other eight are output, so nothing in the state can be used to
+ * work out numbers already given out. Reseeding mixes fresh words into the key.
+ *
+ * The generator knows nothing about the TRNG; Movement supplies the seed. The same seed always
+ * gives the same sequence, which is what lets the host tests replay one exactly.
+ */
+
+#define ENTROPY_SEED_WORDS 8
+
+typedef struct {
+    uint32_t key[ENTROPY_SEED_WORDS];
+    uint32_t counter;
+    uint32_t buffer[8];
+    uint8_t available;              // words at the end of buffer not handed out yet
+    uint32_t words_since_reseed;
+} entropy_t;
+
+/// Starts the generator over from a seed.
+void entropy_seed(entropy_t *entropy, const uint32_t seed[ENTROPY_SEED_WORDS]);
+
+/// Mixes fresh words into the key, and drops any output already made from the old one.
+void entropy_reseed(entropy_t *entropy, const uint32_t seed[ENTROPY_SEED_WORDS]);
+
+/// Returns 32 random bits.
+uint32_t entropy_next(entropy_t *entropy);
+
+/// Fills buf with len random bytes.
+void entropy_bytes(entropy_t *entropy, void *buf, size_t len);
+
+/// Returns a number from 0 to upper_bound - 1, each equally likely; 0 if upper_bound is 0 or 1.
+uint32_t entropy_uniform(entropy_t *entropy, uint32_t upper_bound);
+
+#endif // ENTROPY_H_
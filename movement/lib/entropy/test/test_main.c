@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for the entropy generator: the ChaCha20 block against RFC 8439, replaying sequences
+ * from a seed, and the spread of entropy_uniform.
+ * Build and run from this directory:
+ *   gcc -I.. -o test_entropy test_main.c unity.c ../entropy.c && ./test_entropy
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "entropy.h"
+#include "unity.h"
+
+static entropy_t entropy;
+static const uint32_t zero_seed[ENTROPY_SEED_WORDS] = { 0 };
+static const uint32_t test_seed[ENTROPY_SEED_WORDS] = {
+  0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c, 0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+};
+
+void setUp(void) {
+  entropy_seed(&entropy, test_seed);
+}
+
+void tearDown(void) {
+}
+
+void test_first_block_matches_rfc_8439() {
+  // RFC 8439 appendix A.1, test vector 1: all-zero key, nonce and counter. The generator keeps the
+  // first eight words of the block as its next key and hands out the last eight.
+  const uint32_t expected[8] = {
+    0x7c5941da, 0x8d485751, 0x3fe02477, 0x374ad8b8, 0xf4b8436a, 0x1ca11815, 0x69b687c3, 0x8665eeb2,
+  };
+  entropy_seed(&entropy, zero_seed);
+  for (int i = 0; i < 8; i++) TEST_ASSERT_EQUAL_HEX32(expected[i], entropy_next(&entropy));
+  // the second block is made under the new key, with the counter at 1
+  TEST_ASSERT_EQUAL_HEX32(0xfaebeda2, entropy_next(&entropy));
+  TEST_ASSERT_EQUAL_UINT32(9, entropy.words_since_reseed);
+}
+
+void test_same_seed_replays_the_same_sequence() {
+  uint32_t first[100];
+  for (int i = 0; i < 100; i++) first[i] = entropy_next(&entropy);
+  entropy_seed(&entropy, test_seed);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL_HEX32(first[i], entropy_next(&entropy));
+}
+
+void test_reseed_changes_what_comes_next() {
+  entropy_t other;
+  entropy_seed(&other, test_seed);
+  entropy_next(&entropy);
+  entropy_next(&other);
+
+  // even the words left over from the last block are dropped
+  entropy_reseed(&other, zero_seed);
+  TEST_ASSERT_EQUAL_UINT32(0, other.words_since_reseed);
+  int same = 0;
+  for (int i = 0; i < 16; i++) same += entropy_next(&entropy) == entropy_next(&other);
+  TEST_ASSERT_LESS_THAN(2, same);
+}
+
+void test_output_is_wiped_from_the_state() {
+  uint32_t value = entropy_next(&entropy);
+  for (int i = 0; i < 8; i++) TEST_ASSERT_NOT_EQUAL(value, entropy.buffer[i]);
+}
+
+void test_bytes_are_the_words_in_order() {
+  uint8_t bytes[11];
+  entropy_bytes(&entropy, bytes, sizeof(bytes));
+
+  entropy_seed(&entropy, test_seed);
+  uint32_t words[3];
+  for (int i = 0; i < 3; i++) words[i] = entropy_next(&entropy);
+  TEST_ASSERT_EQUAL_MEMORY(words, bytes, sizeof(bytes));
+  TEST_ASSERT_EQUAL_UINT32(3, entropy.words_since_reseed);
+}
+
+void test_uniform_stays_in_range() {
+  TEST_ASSERT_EQUAL_UINT32(0, entropy_uniform(&entropy, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, entropy_uniform(&entropy, 1));
+  const uint32_t bounds[] = { 2, 3, 6, 7, 22, 78, 1000, 0x80000001, 0xffffffff };
+  for (size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++) {
+    for (int i = 0; i < 2000; i++) TEST_ASSERT_LESS_THAN_UINT32(bounds[b], entropy_uniform(&entropy, bounds[b]));
+  }
+}
+
+void test_uniform_is_balanced() {
+  // a die: chi-squared with five degrees of freedom stays under 20.5 in all but 1 run in 1000
+  uint32_t counts[6] = { 0 };
+  const uint32_t rolls = 60000;
+  for (uint32_t i = 0; i < rolls; i++) counts[entropy_uniform(&entropy, 6)]++;
+  double chi_squared = 0;
+  for (int i = 0; i < 6; i++) {
+    double delta = (double)counts[i] - rolls / 6.0;
+    chi_squared += delta * delta / (rolls / 6.0);
+  }
+  TEST_ASSERT_TRUE(chi_squared < 20.5);
+
+  // with a bound of 3 * 2^30, plain modulo would land in the lower half five times out of eight
+  uint32_t lower = 0;
+  for (uint32_t i = 0; i < rolls; i++) lower += entropy_uniform(&entropy, 0xc0000000) < 0x60000000;
+  TEST_ASSERT_UINT32_WITHIN(rolls / 50, rolls / 2, lower);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_block_matches_rfc_8439);
+  RUN_TEST(test_same_seed_replays_the_same_sequence);
+  RUN_TEST(test_reseed_changes_what_comes_next);
+  RUN_TEST(test_output_is_wiped_from_the_state);
+  RUN_TEST(test_bytes_are_the_words_in_order);
+  RUN_TEST(test_uniform_stays_in_range);
+  RUN_TEST(test_uniform_is_balanced);
+  return UNITY_END();
+}
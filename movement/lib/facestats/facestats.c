@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include "facestats.h"
+
+static inline void _facestats_add(uint32_t *counter, uint32_t amount) {
+    *counter = (*counter > UINT32_MAX - amount) ? UINT32_MAX : *counter + amount;
+}
+
+static int8_t _facestats_frequency_index(uint8_t frequency) {
+    if (frequency == 0 || __builtin_popcount(frequency) != 1) return -1;
+    return __builtin_ctz(frequency);
+}
+
+void facestats_record_loop(facestats_t *stats, uint32_t elapsed_us) {
+    _facestats_add(&stats->wakes, 1);
+    _facestats_add(&stats->active_us, elapsed_us);
+    if (elapsed_us > stats->max_us) stats->max_us = elapsed_us;
+}
+
+void facestats_record_background(facestats_t *stats, uint32_t elapsed_us, bool ran) {
+    if (ran) _facestats_add(&stats->background_runs, 1);
+    _facestats_add(&stats->background_us, elapsed_us);
+}
+
+void facestats_record_tick(facestats_t *stats, uint8_t tick_frequency) {
+    int8_t index = _facestats_frequency_index(tick_frequency);
+    if (index < 0) return;
+    _facestats_add(&stats->ticks[index], 1);
+}
+
+uint32_t facestats_seconds_at(const facestats_t *stats, uint8_t frequency) {
+    int8_t index = _facestats_frequency_index(frequency);
+    if (index < 0) return 0;
+    return stats->ticks[index] >> index;
+}
+
+uint32_t facestats_average_us(const facestats_t *stats) {
+    if (stats->wakes == 0) return 0;
+    return stats->active_us / stats->wakes;
+}
+
+int facestats_format(const facestats_t *stats, char *buf, size_t len) {
+    // only the frequencies the face actually used, so a face that sticks to 1 Hz gets a short line.
+    int written = snprintf(buf, len, "wakes %lu, %lu us (avg %lu, max %lu), bg %lu, %lu us",
+                           (unsigned long)stats->wakes, (unsigned long)stats->active_us,
+                           (unsigned long)facestats_average_us(stats), (unsigned long)stats->max_us,
+                           (unsigned long)stats->background_runs, (unsigned long)stats->background_us);
+    for (uint8_t i = 0; i < FACESTATS_NUM_FREQUENCIES && written >= 0; i++) {
+        if (stats->ticks[i] == 0) continue;
+        size_t used = (size_t)written < len ? (size_t)written : len;
+        int more = snprintf(buf + used, len - used, ", %u Hz %lu s", 1 << i, (unsigned long)(stats->ticks[i] >> i));
+        if (more < 0) return more;
+        written += more;
+    }
+
+    return written;
+}
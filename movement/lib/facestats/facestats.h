@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FACESTATS_H_
+#define FACESTATS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Per-face accounting for Movement: how often each face's loop runs, how long it keeps the CPU
+ * awake, how long the face spends at each tick frequency, and what its background tasks cost.
+ *
+ * Movement times each call to a face with the watch's active-time counter and hands the result
+ * here; this file only adds things up, so the host tests can feed it a made-up day and check the
+ * totals. Counters saturate instead of wrapping, so a number that looks stuck at its maximum is
+ * one that has been running for a very long time, not one that has gone back to zero.
+ */
+
+/// Tick frequencies from 1 to 128 Hz, by their power of two.
+#define FACESTATS_NUM_FREQUENCIES 8
+
+typedef struct {
+    uint32_t wakes;                 // calls to the face's loop while it was on screen, low energy updates included
+    uint32_t active_us;             // time spent in those calls
+    uint32_t max_us;                // the longest of them
+    uint32_t background_runs;       // background tasks the face was given, scheduled or not
+    uint32_t background_us;         // time spent in them, and in asking the face whether it wanted one
+    uint32_t ticks[FACESTATS_NUM_FREQUENCIES]; // ticks delivered at 1, 2, 4 ... 128 Hz
+} facestats_t;
+
+/// Counts one call to the face's loop while it was on screen, that took elapsed_us.
+void facestats_record_loop(facestats_t *stats, uint32_t elapsed_us);
+
+/// Counts elapsed_us of background work; ran is false if the face was only asked and said no.
+void facestats_record_background(facestats_t *stats, uint32_t elapsed_us, bool ran);
+
+/// Counts one tick delivered at tick_frequency; frequencies that aren't a power of two are ignored.
+void facestats_record_tick(facestats_t *stats, uint8_t tick_frequency);
+
+/// Returns the whole seconds the face has spent ticking at frequency.
+uint32_t facestats_seconds_at(const facestats_t *stats, uint8_t frequency);
+
+/// Returns the average time per wake, in microseconds; 0 if the face hasn't woken yet.
+uint32_t facestats_average_us(const facestats_t *stats);
+
+/// Writes one line summing up the stats to buf, and returns what snprintf did.
+int facestats_format(const facestats_t *stats, char *buf, size_t len);
+
+#endif // FACESTATS_H_
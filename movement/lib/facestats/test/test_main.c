@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for the face accounting, and a regression benchmark: a made-up day of ticks, low
+ * energy updates and background tasks, with known costs, whose totals shouldn't change.
+ * Build and run from this directory:
+ *   gcc -I.. -o test_facestats test_main.c unity.c ../facestats.c && ./test_facestats
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "facestats.h"
+#include "unity.h"
+
+static facestats_t stats;
+
+void setUp(void) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+void tearDown(void) {
+}
+
+void test_loops_add_up() {
+  facestats_record_loop(&stats, 100);
+  facestats_record_loop(&stats, 300);
+  facestats_record_loop(&stats, 200);
+  TEST_ASSERT_EQUAL_UINT32(3, stats.wakes);
+  TEST_ASSERT_EQUAL_UINT32(600, stats.active_us);
+  TEST_ASSERT_EQUAL_UINT32(300, stats.max_us);
+  TEST_ASSERT_EQUAL_UINT32(200, facestats_average_us(&stats));
+}
+
+void test_average_of_nothing_is_zero() {
+  TEST_ASSERT_EQUAL_UINT32(0, facestats_average_us(&stats));
+}
+
+void test_background_counts_runs_and_questions() {
+  facestats_record_background(&stats, 5, false);
+  facestats_record_background(&stats, 120, true);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.background_runs);
+  TEST_ASSERT_EQUAL_UINT32(125, stats.background_us);
+  // background work isn't a wake of the face on screen
+  TEST_ASSERT_EQUAL_UINT32(0, stats.wakes);
+}
+
+void test_ticks_become_seconds() {
+  for (int i = 0; i < 130; i++) facestats_record_tick(&stats, 4);
+  facestats_record_tick(&stats, 1);
+  facestats_record_tick(&stats, 3);   // not a power of two
+  facestats_record_tick(&stats, 0);
+  TEST_ASSERT_EQUAL_UINT32(32, facestats_seconds_at(&stats, 4));
+  TEST_ASSERT_EQUAL_UINT32(1, facestats_seconds_at(&stats, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, facestats_seconds_at(&stats, 3));
+  TEST_ASSERT_EQUAL_UINT32(0, facestats_seconds_at(&stats, 128));
+}
+
+void test_counters_saturate() {
+  stats.active_us = UINT32_MAX - 10;
+  stats.wakes = UINT32_MAX;
+  facestats_record_loop(&stats, 100);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, stats.active_us);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, stats.wakes);
+}
+
+void test_format_lists_only_used_frequencies() {
+  char buf[128];
+  facestats_record_loop(&stats, 250);
+  facestats_record_loop(&stats, 750);
+  facestats_record_background(&stats, 40, true);
+  for (int i = 0; i < 64; i++) facestats_record_tick(&stats, 16);
+  int written = facestats_format(&stats, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_STRING("wakes 2, 1000 us (avg 500, max 750), bg 1, 40 us, 16 Hz 4 s", buf);
+  TEST_ASSERT_EQUAL_INT((int)strlen(buf), written);
+}
+
+void test_format_truncates_safely() {
+  char buf[16];
+  for (int i = 0; i < 8; i++) facestats_record_tick(&stats, 1 << i);
+  int written = facestats_format(&stats, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT(sizeof(buf) - 1, strlen(buf));
+  TEST_ASSERT_TRUE(written > (int)sizeof(buf));
+}
+
+// A day for a clock face: 10 minutes on screen at 1 Hz, 30 seconds of a stopwatch at 16 Hz, and the
+// rest in low energy mode with one update a minute. Every minute, the face is asked whether it wants
+// a background task, and says yes once an hour. If a change to Movement adds wakes, these move.
+void test_benchmark_one_day() {
+  const uint32_t tick_us = 180, fast_tick_us = 220, le_update_us = 450, ask_us = 6, background_us = 900;
+  uint32_t minute = 0;
+
+  for (uint32_t s = 0; s < 10 * 60; s++) {
+    facestats_record_tick(&stats, 1);
+    facestats_record_loop(&stats, tick_us);
+  }
+  for (uint32_t t = 0; t < 30 * 16; t++) {
+    facestats_record_tick(&stats, 16);
+    facestats_record_loop(&stats, fast_tick_us);
+  }
+  for (minute = 0; minute < 24 * 60; minute++) {
+    if (minute >= 11) facestats_record_loop(&stats, le_update_us);
+    facestats_record_background(&stats, (minute % 60 == 0) ? ask_us + background_us : ask_us, minute % 60 == 0);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(600 + 480 + 1429, stats.wakes);
+  TEST_ASSERT_EQUAL_UINT32(600 * tick_us + 480 * fast_tick_us + 1429 * le_update_us, stats.active_us);
+  TEST_ASSERT_EQUAL_UINT32(le_update_us, stats.max_us);
+  TEST_ASSERT_EQUAL_UINT32(24, stats.background_runs);
+  TEST_ASSERT_EQUAL_UINT32(1440 * ask_us + 24 * background_us, stats.background_us);
+  TEST_ASSERT_EQUAL_UINT32(600, facestats_seconds_at(&stats, 1));
+  TEST_ASSERT_EQUAL_UINT32(30, facestats_seconds_at(&stats, 16));
+  // under a millisecond of CPU a minute, on average, is the budget for a clock face.
+  TEST_ASSERT_TRUE((stats.active_us + stats.background_us) / (24 * 60) < 1000);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_loops_add_up);
+  RUN_TEST(test_average_of_nothing_is_zero);
+  RUN_TEST(test_background_counts_runs_and_questions);
+  RUN_TEST(test_ticks_become_seconds);
+  RUN_TEST(test_counters_saturate);
+  RUN_TEST(test_format_lists_only_used_frequencies);
+  RUN_TEST(test_format_truncates_safely);
+  RUN_TEST(test_benchmark_one_day);
+  return UNITY_END();
+}
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "hibernate.h"
+#include "xfer.h"
+
+static uint32_t _hibernate_crc(const hibernate_header_t *header, const uint8_t *saved, const void *arena) {
+    uint32_t crc = xfer_crc32_update(0, (const uint8_t *)header, offsetof(hibernate_header_t, crc));
+    crc = xfer_crc32_update(crc, saved, header->num_faces);
+    return xfer_crc32_update(crc, (const uint8_t *)arena, header->arena_size);
+}
+
+uint32_t hibernate_layout(const size_t *offsets, const size_t *sizes, uint8_t num_faces) {
+    uint32_t crc = 0;
+    for (uint8_t i = 0; i < num_faces; i++) {
+        // as 32-bit words, so the hash doesn't depend on the width of size_t
+        uint32_t slot[2] = { (uint32_t)offsets[i], (uint32_t)sizes[i] };
+        crc = xfer_crc32_update(crc, (const uint8_t *)slot, sizeof(slot));
+    }
+    return crc;
+}
+
+bool hibernate_save(const hibernate_io_t *io, char *path, hibernate_header_t *header, const uint8_t *saved, const void *arena) {
+    header->magic = HIBERNATE_MAGIC;
+    header->reserved = 0;
+    header->crc = _hibernate_crc(header, saved, arena);
+
+    return io->write(path, (char *)header, sizeof(hibernate_header_t)) &&
+           io->append(path, (char *)saved, header->num_faces) &&
+           io->append(path, (char *)arena, header->arena_size);
+}
+
+bool hibernate_restore(const hibernate_io_t *io, char *path, hibernate_header_t *header, uint32_t layout,
+                       uint8_t num_faces, uint32_t arena_size, uint8_t *saved, void *arena) {
+    int32_t offset = io->read_at(path, (char *)header, 0, sizeof(hibernate_header_t));
+    bool exists = offset >= 0;
+    bool ok = offset == (int32_t)sizeof(hibernate_header_t) &&
+              header->magic == HIBERNATE_MAGIC && header->layout == layout &&
+              header->num_faces == num_faces && header->arena_size == arena_size &&
+              io->read_at(path, (char *)saved, offset, num_faces) == num_faces &&
+              io->read_at(path, (char *)arena, offset + num_faces, arena_size) == (int32_t)arena_size &&
+              header->crc == _hibernate_crc(header, saved, arena);
+
+    if (!ok) {
+        memset(saved, 0, num_faces);
+        memset(arena, 0, arena_size);
+    }
+    if (exists) io->rm(path);
+
+    return ok;
+}
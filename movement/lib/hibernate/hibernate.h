@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HIBERNATE_H_
+#define HIBERNATE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Snapshots of Movement's context arena, for hibernating in BACKUP mode, where RAM is lost.
+ *
+ * A snapshot is one file: a header, then one byte per face saying whether its slot was saved, then
+ * the arena itself, byte for byte. A face's slot is its serialized form, so a face that keeps its
+ * state in the arena needs no code of its own to hibernate; after a restore, Movement calls its
+ * setup with the restored context, which is the resume phase it already has.
+ *
+ * The header carries a hash of the arena's layout, so a snapshot written by a different build (a
+ * face added, or a context that grew) is thrown away rather than restored into the wrong slots.
+ * A CRC-32 covers the header, the flags and the arena.
+ *
+ * Like kvlog, this doesn't talk to the filesystem itself: hibernate_io_t takes functions with the
+ * same signatures as filesystem_write_file, filesystem_append_file, filesystem_read_file_at and
+ * filesystem_rm.
+ */
+
+#define HIBERNATE_MAGIC 0x4E424948 // "HIBN"
+
+typedef struct {
+    bool (*write)(char *path, char *data, int32_t length);
+    bool (*append)(char *path, char *data, int32_t length);
+    int32_t (*read_at)(char *path, char *buf, int32_t offset, int32_t length);
+    bool (*rm)(char *path);
+} hibernate_io_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;                // hibernate_layout of the build that wrote it
+    uint32_t arena_size;
+    uint8_t num_faces;
+    uint8_t current_face_idx;       // the face to come back to
+    uint8_t next_backup_register;   // so faces restored with a register don't see it handed out again
+    uint8_t reserved;
+    uint32_t crc;
+} hibernate_header_t;
+
+/// Returns a hash of the arena's slots, from the offset and size tables in movement_arena.h.
+uint32_t hibernate_layout(const size_t *offsets, const size_t *sizes, uint8_t num_faces);
+
+/** @brief Writes a snapshot of the arena.
+ * @param header Filled in by the caller, all but magic and crc, which this sets.
+ * @param saved One byte per face, nonzero if its slot holds state worth restoring.
+ * @return false if any write failed; the file may then be partial, but won't pass its check.
+ */
+bool hibernate_save(const hibernate_io_t *io, char *path, hibernate_header_t *header, const uint8_t *saved, const void *arena);
+
+/** @brief Reads a snapshot back into the arena, and removes the file, so it's never restored twice.
+ * @details Checks the snapshot against this build's layout, face count and arena size before reading
+ *          the rest of it. If anything is off, saved and the arena are zeroed, as they are at boot.
+ * @param header Receives the header, whose current_face_idx and next_backup_register are the caller's.
+ * @return false if there was no snapshot, or it was from another build, or it was damaged.
+ */
+bool hibernate_restore(const hibernate_io_t *io, char *path, hibernate_header_t *header, uint32_t layout,
+                       uint8_t num_faces, uint32_t arena_size, uint8_t *saved, void *arena);
+
+#endif // HIBERNATE_H_
@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for hibernation snapshots, over an in-memory stand-in for the filesystem.
+ * Build and run from this directory:
+ *   gcc -I.. -I../../xfer -o test_hibernate test_main.c unity.c ../hibernate.c ../../xfer/xfer.c && ./test_hibernate
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "hibernate.h"
+#include "unity.h"
+
+static struct {
+  char data[1024];
+  int32_t size;
+  bool exists;
+  bool fail;
+} file;
+
+static bool mem_write(char *path, char *data, int32_t length) {
+  (void) path;
+  if (file.fail) return false;
+  memcpy(file.data, data, length);
+  file.size = length;
+  file.exists = true;
+  return true;
+}
+
+static bool mem_append(char *path, char *data, int32_t length) {
+  (void) path;
+  if (file.fail) return false;
+  memcpy(file.data + file.size, data, length);
+  file.size += length;
+  file.exists = true;
+  return true;
+}
+
+static int32_t mem_read_at(char *path, char *buf, int32_t offset, int32_t length) {
+  (void) path;
+  if (!file.exists) return -1;
+  if (offset >= file.size) return 0;
+  if (length > file.size - offset) length = file.size - offset;
+  memcpy(buf, file.data + offset, length);
+  return length;
+}
+
+static bool mem_rm(char *path) {
+  (void) path;
+  file.exists = false;
+  file.size = 0;
+  return true;
+}
+
+static const hibernate_io_t io = {
+  .write = mem_write,
+  .append = mem_append,
+  .read_at = mem_read_at,
+  .rm = mem_rm,
+};
+
+// three faces: one with 5 bytes of state, one without a slot, one with 12.
+static const size_t offsets[] = { 0, 8, 8 };
+static const size_t sizes[] = { 5, 0, 12 };
+#define NUM_FACES 3
+#define ARENA_SIZE 20
+
+static uint8_t arena[ARENA_SIZE];
+static uint8_t saved[NUM_FACES];
+static hibernate_header_t header;
+
+void setUp(void) {
+  memset(&file, 0, sizeof(file));
+  for (int i = 0; i < ARENA_SIZE; i++) arena[i] = 3 * i + 1;
+  saved[0] = 1;
+  saved[1] = 0;
+  saved[2] = 1;
+  memset(&header, 0, sizeof(header));
+  header.layout = hibernate_layout(offsets, sizes, NUM_FACES);
+  header.arena_size = ARENA_SIZE;
+  header.num_faces = NUM_FACES;
+  header.current_face_idx = 2;
+  header.next_backup_register = 5;
+}
+
+void tearDown(void) {
+}
+
+static bool restore(void) {
+  memset(arena, 0xAA, sizeof(arena));
+  memset(saved, 0xAA, sizeof(saved));
+  memset(&header, 0, sizeof(header));
+  return hibernate_restore(&io, "hibernate.bin", &header, hibernate_layout(offsets, sizes, NUM_FACES),
+                           NUM_FACES, ARENA_SIZE, saved, arena);
+}
+
+void test_round_trip() {
+  TEST_ASSERT_TRUE(hibernate_save(&io, "hibernate.bin", &header, saved, arena));
+  TEST_ASSERT_EQUAL_INT32(sizeof(hibernate_header_t) + NUM_FACES + ARENA_SIZE, file.size);
+
+  TEST_ASSERT_TRUE(restore());
+  for (int i = 0; i < ARENA_SIZE; i++) TEST_ASSERT_EQUAL_UINT8(3 * i + 1, arena[i]);
+  TEST_ASSERT_EQUAL_UINT8(1, saved[0]);
+  TEST_ASSERT_EQUAL_UINT8(0, saved[1]);
+  TEST_ASSERT_EQUAL_UINT8(1, saved[2]);
+  TEST_ASSERT_EQUAL_UINT8(2, header.current_face_idx);
+  TEST_ASSERT_EQUAL_UINT8(5, header.next_backup_register);
+}
+
+void test_a_snapshot_is_restored_once() {
+  hibernate_save(&io, "hibernate.bin", &header, saved, arena);
+  TEST_ASSERT_TRUE(restore());
+  TEST_ASSERT_FALSE(file.exists);
+  TEST_ASSERT_FALSE(restore());
+}
+
+void test_no_snapshot_leaves_a_clean_arena() {
+  TEST_ASSERT_FALSE(restore());
+  for (int i = 0; i < ARENA_SIZE; i++) TEST_ASSERT_EQUAL_UINT8(0, arena[i]);
+  for (int i = 0; i < NUM_FACES; i++) TEST_ASSERT_EQUAL_UINT8(0, saved[i]);
+}
+
+void test_damage_is_caught() {
+  hibernate_save(&io, "hibernate.bin", &header, saved, arena);
+  file.data[file.size - 3] ^= 0x10;
+  TEST_ASSERT_FALSE(restore());
+  for (int i = 0; i < ARENA_SIZE; i++) TEST_ASSERT_EQUAL_UINT8(0, arena[i]);
+  TEST_ASSERT_FALSE(file.exists);
+}
+
+void test_a_short_file_is_caught() {
+  hibernate_save(&io, "hibernate.bin", &header, saved, arena);
+  file.size -= 4;
+  TEST_ASSERT_FALSE(restore());
+  TEST_ASSERT_FALSE(file.exists);
+}
+
+void test_another_builds_snapshot_is_thrown_away() {
+  static const size_t grown[] = { 5, 0, 13 };
+  header.layout = hibernate_layout(offsets, grown, NUM_FACES);
+  hibernate_save(&io, "hibernate.bin", &header, saved, arena);
+  TEST_ASSERT_FALSE(restore());
+  TEST_ASSERT_FALSE(file.exists);
+}
+
+void test_layout_hash_sees_every_slot() {
+  static const size_t moved[] = { 0, 8, 16 };
+  uint32_t layout = hibernate_layout(offsets, sizes, NUM_FACES);
+  TEST_ASSERT_EQUAL_HEX32(layout, hibernate_layout(offsets, sizes, NUM_FACES));
+  TEST_ASSERT_NOT_EQUAL(layout, hibernate_layout(moved, sizes, NUM_FACES));
+  TEST_ASSERT_NOT_EQUAL(layout, hibernate_layout(offsets, sizes, NUM_FACES - 1));
+}
+
+void test_failed_write_is_reported() {
+  file.fail = true;
+  TEST_ASSERT_FALSE(hibernate_save(&io, "hibernate.bin", &header, saved, arena));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_a_snapshot_is_restored_once);
+  RUN_TEST(test_no_snapshot_leaves_a_clean_arena);
+  RUN_TEST(test_damage_is_caught);
+  RUN_TEST(test_a_short_file_is_caught);
+  RUN_TEST(test_another_builds_snapshot_is_thrown_away);
+  RUN_TEST(test_layout_hash_sees_every_slot);
+  RUN_TEST(test_failed_write_is_reported);
+  return UNITY_END();
+}
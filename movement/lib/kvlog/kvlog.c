@@ -0,0 +1,228 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "kvlog.h"
+
+typedef struct {
+    kvlog_t *kv;
+    uint8_t record[KVLOG_MAX_RECORD];
+    uint8_t have;
+    bool done;
+} kvlog_loader_t;
+
+static uint8_t _kvlog_crc8(const uint8_t *data, uint8_t length) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+static kvlog_entry_t *_kvlog_find(kvlog_t *kv, const char *key) {
+    for (uint8_t i = 0; i < kv->count; i++) {
+        if (strcmp(kv->entries[i].key, key) == 0) return &kv->entries[i];
+    }
+    return NULL;
+}
+
+static kvlog_entry_t *_kvlog_find_or_add(kvlog_t *kv, const char *key) {
+    kvlog_entry_t *entry = _kvlog_find(kv, key);
+    if (entry != NULL || kv->count == KVLOG_MAX_ENTRIES) return entry;
+
+    entry = &kv->entries[kv->count++];
+    memset(entry, 0, sizeof(kvlog_entry_t));
+    strcpy(entry->key, key);
+    return entry;
+}
+
+static uint8_t _kvlog_encode(const kvlog_entry_t *entry, uint8_t *out) {
+    uint8_t key_length = strlen(entry->key);
+    uint8_t length = 0;
+
+    out[length++] = key_length;
+    out[length++] = entry->length;
+    memcpy(out + length, entry->key, key_length);
+    length += key_length;
+    memcpy(out + length, entry->value, entry->length);
+    length += entry->length;
+    out[length] = _kvlog_crc8(out, length);
+
+    return length + 1;
+}
+
+static uint8_t _kvlog_record_length(const uint8_t *record) {
+    return KVLOG_RECORD_OVERHEAD + record[0] + record[1];
+}
+
+static bool _kvlog_load_chunk(const char *chunk, int32_t length, int32_t offset, void *context) {
+    (void) offset;
+    kvlog_loader_t *loader = context;
+    kvlog_t *kv = loader->kv;
+
+    for (int32_t i = 0; i < length; i++) {
+        loader->record[loader->have++] = chunk[i];
+        if (loader->have < 2) continue;
+
+        if (loader->record[0] == 0 || loader->record[0] > KVLOG_MAX_KEY || loader->record[1] > KVLOG_MAX_VALUE) {
+            kv->stats.bad_records++;
+            loader->done = true;
+            return false;
+        }
+        uint8_t record_length = _kvlog_record_length(loader->record);
+        if (loader->have < record_length) continue;
+
+        if (loader->record[record_length - 1] != _kvlog_crc8(loader->record, record_length - 1)) {
+            kv->stats.bad_records++;
+            loader->done = true;
+            return false;
+        }
+
+        char key[KVLOG_MAX_KEY + 1];
+        memcpy(key, loader->record + 2, loader->record[0]);
+        key[loader->record[0]] = 0;
+        kvlog_entry_t *entry = _kvlog_find_or_add(kv, key);
+        if (entry != NULL) {
+            entry->length = loader->record[1];
+            memcpy(entry->value, loader->record + 2 + loader->record[0], entry->length);
+        }
+        kv->log_size += record_length;
+        loader->have = 0;
+    }
+
+    return true;
+}
+
+bool kvlog_init(kvlog_t *kv, const kvlog_io_t *io, char *path) {
+    memset(kv, 0, sizeof(kvlog_t));
+    kv->io = io;
+    kv->path = path;
+
+    kvlog_loader_t loader = { .kv = kv };
+    int32_t result = io->read_chunks(path, _kvlog_load_chunk, &loader);
+    // anything after a bad or torn record is dropped; the next flush compacts it away
+    if (loader.done || loader.have) kv->log_size = KVLOG_COMPACT_SIZE;
+
+    return result >= 0 || kv->count == 0;
+}
+
+int32_t kvlog_get(kvlog_t *kv, const char *key, void *value, uint8_t size) {
+    kvlog_entry_t *entry = _kvlog_find(kv, key);
+    if (entry == NULL) return -1;
+
+    memcpy(value, entry->value, size < entry->length ? size : entry->length);
+    return entry->length;
+}
+
+bool kvlog_put(kvlog_t *kv, const char *key, const void *value, uint8_t size) {
+    uint8_t key_length = strlen(key);
+    if (key_length == 0 || key_length > KVLOG_MAX_KEY || size > KVLOG_MAX_VALUE) return false;
+
+    kvlog_entry_t *entry = _kvlog_find(kv, key);
+    if (entry != NULL && entry->length == size && memcmp(entry->value, value, size) == 0) return true;
+
+    if (entry == NULL) entry = _kvlog_find_or_add(kv, key);
+    if (entry == NULL) return false;
+
+    entry->length = size;
+    memcpy(entry->value, value, size);
+    entry->dirty = true;
+    kv->stats.puts++;
+
+    return true;
+}
+
+bool kvlog_is_dirty(const kvlog_t *kv) {
+    for (uint8_t i = 0; i < kv->count; i++) {
+        if (kv->entries[i].dirty) return true;
+    }
+    return false;
+}
+
+// Encodes the dirty entries, or all of them, and hands them to the filesystem a chunk at a time. With
+// truncate, the first chunk replaces whatever was in the file. written counts the bytes that made it
+// out, even when a later chunk fails.
+static bool _kvlog_write_records(kvlog_t *kv, char *path, bool all, bool truncate, int32_t *written, uint8_t *records) {
+    uint8_t chunk[KVLOG_FLUSH_CHUNK];
+    uint8_t used = 0;
+
+    *written = 0;
+    *records = 0;
+    for (uint8_t i = 0; i <= kv->count; i++) {
+        bool last = i == kv->count;
+        if (!last && !all && !kv->entries[i].dirty) continue;
+
+        if (used > 0 && (last || used + KVLOG_MAX_RECORD > KVLOG_FLUSH_CHUNK)) {
+            bool ok;
+            if (truncate && *written == 0) ok = kv->io->write(path, (char *)chunk, used);
+            else ok = kv->io->append(path, (char *)chunk, used);
+            if (!ok) return false;
+            *written += used;
+            used = 0;
+        }
+        if (last) break;
+
+        used += _kvlog_encode(&kv->entries[i], chunk + used);
+        (*records)++;
+    }
+
+    return true;
+}
+
+bool kvlog_flush(kvlog_t *kv) {
+    int32_t length = 0;
+    for (uint8_t i = 0; i < kv->count; i++) {
+        if (kv->entries[i].dirty) length += KVLOG_RECORD_OVERHEAD + strlen(kv->entries[i].key) + kv->entries[i].length;
+    }
+    if (length == 0) return true;
+
+    int32_t written;
+    uint8_t records;
+    bool compact = kv->log_size + length > KVLOG_COMPACT_SIZE;
+    if (compact) {
+        // one record per live key, into a new file that replaces the log in one go
+        char temp_path[KVLOG_MAX_PATH + 5];
+        size_t path_length = strlen(kv->path);
+        if (path_length > KVLOG_MAX_PATH) return false;
+        memcpy(temp_path, kv->path, path_length);
+        strcpy(temp_path + path_length, ".tmp");
+
+        if (!_kvlog_write_records(kv, temp_path, true, true, &written, &records)) return false;
+        if (!kv->io->rename(temp_path, kv->path)) return false;
+    } else if (!_kvlog_write_records(kv, kv->path, false, false, &written, &records)) {
+        // whatever did get appended is in the log now; the entries stay dirty and go again
+        kv->log_size += written;
+        return false;
+    }
+
+    for (uint8_t i = 0; i < kv->count; i++) kv->entries[i].dirty = false;
+    kv->log_size = compact ? written : kv->log_size + written;
+    kv->stats.records += records;
+    kv->stats.bytes_written += written;
+    kv->stats.flushes++;
+    if (compact) kv->stats.compactions++;
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef KVLOG_H_
+#define KVLOG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Small key-value store kept as an append-only log in one file.
+ *
+ * Every live value is cached in RAM. Puts only touch the cache and mark the entry dirty;
+ * kvlog_flush then appends one record per dirty entry to the log in a single write, so a value
+ * that changes ten times between flushes costs one record, not ten. When the log would grow
+ * past KVLOG_COMPACT_SIZE, the flush rewrites it instead with just the live records.
+ *
+ * A record is [key length][value length][key][value][CRC-8 of everything before it]. On load,
+ * later records win over earlier ones, and a record that fails its check ends the log.
+ *
+ * Records are encoded into a KVLOG_FLUSH_CHUNK buffer on the stack and handed over a chunk at a
+ * time. A compacted log goes to a temporary file (the path plus ".tmp") that is then renamed over
+ * the old one, so a reset partway through a compaction leaves the old log in place.
+ *
+ * The store doesn't talk to the filesystem itself: kvlog_io_t takes functions with the same
+ * signatures as filesystem_read_chunks, filesystem_append_file, filesystem_write_file and
+ * filesystem_rename.
+ */
+
+#define KVLOG_MAX_ENTRIES 16
+#define KVLOG_MAX_KEY 15
+#define KVLOG_MAX_VALUE 16
+#define KVLOG_RECORD_OVERHEAD 3
+#define KVLOG_MAX_RECORD (KVLOG_RECORD_OVERHEAD + KVLOG_MAX_KEY + KVLOG_MAX_VALUE)
+#define KVLOG_COMPACT_SIZE 1024
+#define KVLOG_FLUSH_CHUNK (4 * KVLOG_MAX_RECORD)
+#define KVLOG_MAX_PATH 27
+
+typedef struct {
+    int32_t (*read_chunks)(char *path, bool (*cb)(const char *chunk, int32_t length, int32_t offset, void *context), void *context);
+    bool (*append)(char *path, char *data, int32_t length);
+    bool (*write)(char *path, char *data, int32_t length);
+    bool (*rename)(char *old_path, char *new_path);
+} kvlog_io_t;
+
+typedef struct {
+    char key[KVLOG_MAX_KEY + 1];
+    uint8_t length;
+    bool dirty;
+    uint8_t value[KVLOG_MAX_VALUE];
+} kvlog_entry_t;
+
+typedef struct {
+    uint32_t puts;          // calls to kvlog_put that changed a value
+    uint32_t records;       // records written, including rewrites by compaction
+    uint32_t bytes_written; // bytes handed to the filesystem
+    uint32_t flushes;       // flushes that wrote anything
+    uint32_t compactions;
+    uint32_t bad_records;   // records dropped on load because they failed their check
+} kvlog_stats_t;
+
+typedef struct {
+    const kvlog_io_t *io;
+    char *path;
+    kvlog_entry_t entries[KVLOG_MAX_ENTRIES];
+    uint8_t count;
+    int32_t log_size;
+    kvlog_stats_t stats;
+} kvlog_t;
+
+/** @brief Sets up a store and loads its log, if there is one.
+ * @param path The log's file name, at most KVLOG_MAX_PATH characters.
+ * @return false if the log exists but couldn't be read; the store is empty but usable either way.
+ */
+bool kvlog_init(kvlog_t *kv, const kvlog_io_t *io, char *path);
+
+/** @brief Copies a value out of the store.
+ * @param value Buffer for the value; up to size bytes are copied into it.
+ * @return the length of the stored value, or -1 if the key isn't there.
+ */
+int32_t kvlog_get(kvlog_t *kv, const char *key, void *value, uint8_t size);
+
+/** @brief Sets a value in RAM; it is written out by the next kvlog_flush. Storing a value equal to the
+ *         current one does nothing.
+ * @return false if the key or value is too long, or the store is full.
+ */
+bool kvlog_put(kvlog_t *kv, const char *key, const void *value, uint8_t size);
+
+bool kvlog_is_dirty(const kvlog_t *kv);
+
+/** @brief Writes out every dirty value, compacting the log if it has grown too big.
+ * @return false if the write failed; the values stay dirty and the next flush tries again.
+ */
+bool kvlog_flush(kvlog_t *kv);
+
+#endif // KVLOG_H_
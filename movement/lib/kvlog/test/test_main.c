@@ -0,0 +1,363 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for kvlog, over an in-memory stand-in for the filesystem.
+ * Build and run from this directory:
+ *   gcc -I.. -o test_kvlog test_main.c unity.c ../kvlog.c && ./test_kvlog
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "kvlog.h"
+#include "unity.h"
+
+typedef struct {
+  char data[4096];
+  int32_t size;
+  bool exists;
+  uint16_t appends;
+  uint16_t writes;
+} mem_file_t;
+
+// the log, and the file a compaction builds before it's renamed over the log
+static mem_file_t file;
+static mem_file_t temp;
+static uint16_t renames;
+// the number of appends, writes and renames to let through before failing the rest, or -1
+static int16_t fail_after;
+
+static mem_file_t *mem_file(char *path) {
+  return strcmp(path, "kv.log") == 0 ? &file : &temp;
+}
+
+static bool mem_fail(void) {
+  if (fail_after < 0) return false;
+  if (fail_after == 0) return true;
+  fail_after--;
+  return false;
+}
+
+static int32_t mem_read_chunks(char *path, bool (*cb)(const char *chunk, int32_t length, int32_t offset, void *context), void *context) {
+  mem_file_t *f = mem_file(path);
+  if (!f->exists) return -1;
+  // odd chunk size, so records straddle chunk boundaries
+  int32_t offset = 0;
+  while (offset < f->size) {
+    int32_t n = f->size - offset < 7 ? f->size - offset : 7;
+    if (!cb(f->data + offset, n, offset, context)) break;
+    offset += n;
+  }
+  return offset;
+}
+
+static bool mem_append(char *path, char *data, int32_t length) {
+  mem_file_t *f = mem_file(path);
+  if (mem_fail()) return false;
+  memcpy(f->data + f->size, data, length);
+  f->size += length;
+  f->exists = true;
+  f->appends++;
+  return true;
+}
+
+static bool mem_write(char *path, char *data, int32_t length) {
+  mem_file_t *f = mem_file(path);
+  if (mem_fail()) return false;
+  memcpy(f->data, data, length);
+  f->size = length;
+  f->exists = true;
+  f->writes++;
+  return true;
+}
+
+static bool mem_rename(char *old_path, char *new_path) {
+  mem_file_t *from = mem_file(old_path);
+  mem_file_t *to = mem_file(new_path);
+  if (mem_fail() || !from->exists) return false;
+  memcpy(to->data, from->data, from->size);
+  to->size = from->size;
+  to->exists = true;
+  memset(from, 0, sizeof(mem_file_t));
+  renames++;
+  return true;
+}
+
+static const kvlog_io_t mem_io = {
+  .read_chunks = mem_read_chunks,
+  .append = mem_append,
+  .write = mem_write,
+  .rename = mem_rename,
+};
+
+static kvlog_t kv;
+
+void setUp(void) {
+  memset(&file, 0, sizeof(file));
+  memset(&temp, 0, sizeof(temp));
+  renames = 0;
+  fail_after = -1;
+  kvlog_init(&kv, &mem_io, "kv.log");
+}
+
+void tearDown(void) {
+}
+
+static void reload(void) {
+  TEST_ASSERT_TRUE(kvlog_init(&kv, &mem_io, "kv.log"));
+}
+
+void test_get_missing_key() {
+  uint32_t value = 0;
+  TEST_ASSERT_EQUAL_INT32(-1, kvlog_get(&kv, "nope", &value, sizeof(value)));
+}
+
+void test_put_get_round_trip_through_the_log() {
+  uint32_t value = 0xDEADBEEF;
+  int16_t other = -42;
+  TEST_ASSERT_TRUE(kvlog_put(&kv, "alarm.time", &value, sizeof(value)));
+  TEST_ASSERT_TRUE(kvlog_put(&kv, "tally", &other, sizeof(other)));
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+
+  reload();
+  uint32_t read_value = 0;
+  int16_t read_other = 0;
+  TEST_ASSERT_EQUAL_INT32(4, kvlog_get(&kv, "alarm.time", &read_value, sizeof(read_value)));
+  TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, read_value);
+  TEST_ASSERT_EQUAL_INT32(2, kvlog_get(&kv, "tally", &read_other, sizeof(read_other)));
+  TEST_ASSERT_EQUAL_INT16(-42, read_other);
+}
+
+void test_puts_are_coalesced_until_flush() {
+  for (uint8_t i = 0; i < 100; i++) kvlog_put(&kv, "count", &i, 1);
+  TEST_ASSERT_EQUAL_UINT16(0, file.appends);
+  TEST_ASSERT_TRUE(kvlog_is_dirty(&kv));
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  TEST_ASSERT_EQUAL_UINT16(1, file.appends);
+  TEST_ASSERT_EQUAL_UINT32(1, kv.stats.records);
+  TEST_ASSERT_FALSE(kvlog_is_dirty(&kv));
+
+  reload();
+  uint8_t value = 0;
+  kvlog_get(&kv, "count", &value, 1);
+  TEST_ASSERT_EQUAL_UINT8(99, value);
+}
+
+void test_unchanged_put_writes_nothing() {
+  uint8_t value = 7;
+  kvlog_put(&kv, "k", &value, 1);
+  kvlog_flush(&kv);
+  kvlog_put(&kv, "k", &value, 1);
+  TEST_ASSERT_FALSE(kvlog_is_dirty(&kv));
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  TEST_ASSERT_EQUAL_UINT16(1, file.appends);
+}
+
+void test_later_records_win() {
+  uint8_t value = 1;
+  kvlog_put(&kv, "k", &value, 1);
+  kvlog_flush(&kv);
+  value = 2;
+  kvlog_put(&kv, "k", &value, 1);
+  kvlog_flush(&kv);
+  TEST_ASSERT_EQUAL_UINT16(2, file.appends);
+
+  reload();
+  kvlog_get(&kv, "k", &value, 1);
+  TEST_ASSERT_EQUAL_UINT8(2, value);
+  TEST_ASSERT_EQUAL_UINT8(1, kv.count);
+}
+
+void test_compaction_keeps_only_live_records() {
+  uint32_t value;
+  for (value = 0; value < 200; value++) {
+    kvlog_put(&kv, "a", &value, sizeof(value));
+    kvlog_put(&kv, "b", &value, 2);
+    kvlog_flush(&kv);
+    TEST_ASSERT_TRUE(file.size <= KVLOG_COMPACT_SIZE);
+  }
+  TEST_ASSERT_TRUE(kv.stats.compactions > 0);
+  TEST_ASSERT_EQUAL_UINT16(kv.stats.compactions, renames);
+  TEST_ASSERT_FALSE(temp.exists);
+
+  reload();
+  uint32_t a = 0, b = 0;
+  kvlog_get(&kv, "a", &a, sizeof(a));
+  kvlog_get(&kv, "b", &b, sizeof(b));
+  TEST_ASSERT_EQUAL_UINT32(199, a);
+  TEST_ASSERT_EQUAL_UINT32(199, b);
+}
+
+void test_corrupt_tail_is_dropped_and_compacted_away() {
+  uint8_t value = 5;
+  kvlog_put(&kv, "good", &value, 1);
+  kvlog_flush(&kv);
+  value = 6;
+  kvlog_put(&kv, "bad", &value, 1);
+  kvlog_flush(&kv);
+  file.data[file.size - 1] ^= 0xFF;
+
+  reload();
+  TEST_ASSERT_EQUAL_UINT32(1, kv.stats.bad_records);
+  TEST_ASSERT_EQUAL_INT32(1, kvlog_get(&kv, "good", &value, 1));
+  TEST_ASSERT_EQUAL_UINT8(5, value);
+  TEST_ASSERT_EQUAL_INT32(-1, kvlog_get(&kv, "bad", &value, 1));
+
+  // the next flush rewrites the log instead of appending after the garbage
+  value = 8;
+  kvlog_put(&kv, "new", &value, 1);
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  TEST_ASSERT_EQUAL_UINT16(1, renames);
+  reload();
+  TEST_ASSERT_EQUAL_UINT32(0, kv.stats.bad_records);
+  TEST_ASSERT_EQUAL_INT32(1, kvlog_get(&kv, "good", &value, 1));
+  TEST_ASSERT_EQUAL_INT32(1, kvlog_get(&kv, "new", &value, 1));
+}
+
+void test_failed_flush_stays_dirty() {
+  uint8_t value = 3;
+  kvlog_put(&kv, "k", &value, 1);
+  fail_after = 0;
+  TEST_ASSERT_FALSE(kvlog_flush(&kv));
+  TEST_ASSERT_TRUE(kvlog_is_dirty(&kv));
+  fail_after = -1;
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  TEST_ASSERT_FALSE(kvlog_is_dirty(&kv));
+}
+
+static void fill(uint8_t first_byte) {
+  uint8_t value[KVLOG_MAX_VALUE];
+  char key[KVLOG_MAX_KEY + 1] = "key.that.is.000";
+  memset(value, first_byte, sizeof(value));
+  for (uint8_t i = 0; i < KVLOG_MAX_ENTRIES; i++) {
+    key[13] = '0' + i / 10;
+    key[14] = '0' + i % 10;
+    value[0] = first_byte + i;
+    TEST_ASSERT_TRUE(kvlog_put(&kv, key, value, sizeof(value)));
+  }
+}
+
+static void check_filled(uint8_t first_byte) {
+  uint8_t value[KVLOG_MAX_VALUE];
+  char key[KVLOG_MAX_KEY + 1] = "key.that.is.000";
+  for (uint8_t i = 0; i < KVLOG_MAX_ENTRIES; i++) {
+    key[13] = '0' + i / 10;
+    key[14] = '0' + i % 10;
+    TEST_ASSERT_EQUAL_INT32(KVLOG_MAX_VALUE, kvlog_get(&kv, key, value, sizeof(value)));
+    TEST_ASSERT_EQUAL_UINT8(first_byte + i, value[0]);
+    TEST_ASSERT_EQUAL_UINT8(first_byte, value[1]);
+  }
+}
+
+void test_large_flush_goes_out_in_chunks() {
+  fill(10);
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  // 16 full records don't fit one stack chunk
+  uint16_t per_chunk = KVLOG_FLUSH_CHUNK / KVLOG_MAX_RECORD;
+  TEST_ASSERT_EQUAL_UINT16((KVLOG_MAX_ENTRIES + per_chunk - 1) / per_chunk, file.appends);
+  TEST_ASSERT_EQUAL_INT32(KVLOG_MAX_ENTRIES * KVLOG_MAX_RECORD, file.size);
+  TEST_ASSERT_EQUAL_UINT32(file.size, kv.stats.bytes_written);
+
+  reload();
+  check_filled(10);
+}
+
+void test_chunked_compaction_round_trips() {
+  uint8_t round = 0;
+  while (kv.stats.compactions == 0) {
+    round += 20;
+    fill(round);
+    TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  }
+  TEST_ASSERT_EQUAL_UINT16(1, renames);
+  TEST_ASSERT_FALSE(temp.exists);
+  TEST_ASSERT_EQUAL_INT32(KVLOG_MAX_ENTRIES * KVLOG_MAX_RECORD, file.size);
+
+  reload();
+  check_filled(round);
+}
+
+void test_failed_compaction_leaves_the_old_log() {
+  uint8_t round = 0;
+  do {
+    round += 10;
+    fill(round);
+    TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  } while (kv.log_size + KVLOG_MAX_ENTRIES * KVLOG_MAX_RECORD <= KVLOG_COMPACT_SIZE);
+  int32_t size = file.size;
+
+  // fail at each step of building the new log, and then at the rename
+  uint16_t steps = (KVLOG_MAX_ENTRIES * KVLOG_MAX_RECORD + KVLOG_FLUSH_CHUNK - 1) / KVLOG_FLUSH_CHUNK + 1;
+  for (int16_t allowed = 0; allowed < steps; allowed++) {
+    fill(200);
+    fail_after = allowed;
+    TEST_ASSERT_FALSE(kvlog_flush(&kv));
+    TEST_ASSERT_TRUE(kvlog_is_dirty(&kv));
+    TEST_ASSERT_EQUAL_INT32(size, file.size);
+    fail_after = -1;
+
+    reload();
+    check_filled(round);
+  }
+
+  fill(200);
+  TEST_ASSERT_TRUE(kvlog_flush(&kv));
+  TEST_ASSERT_EQUAL_UINT32(1, kv.stats.compactions);
+  reload();
+  check_filled(200);
+}
+
+void test_limits() {
+  uint8_t big[KVLOG_MAX_VALUE + 1] = {0};
+  TEST_ASSERT_FALSE(kvlog_put(&kv, "k", big, sizeof(big)));
+  TEST_ASSERT_FALSE(kvlog_put(&kv, "this.key.is.too.long", big, 1));
+  TEST_ASSERT_FALSE(kvlog_put(&kv, "", big, 1));
+
+  char key[4] = "k00";
+  for (uint8_t i = 0; i < KVLOG_MAX_ENTRIES; i++) {
+    key[1] = '0' + i / 10;
+    key[2] = '0' + i % 10;
+    TEST_ASSERT_TRUE(kvlog_put(&kv, key, &i, 1));
+  }
+  TEST_ASSERT_FALSE(kvlog_put(&kv, "one.more", big, 1));
+  // existing keys can still change
+  TEST_ASSERT_TRUE(kvlog_put(&kv, "k00", big, 2));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_get_missing_key);
+  RUN_TEST(test_put_get_round_trip_through_the_log);
+  RUN_TEST(test_puts_are_coalesced_until_flush);
+  RUN_TEST(test_unchanged_put_writes_nothing);
+  RUN_TEST(test_later_records_win);
+  RUN_TEST(test_compaction_keeps_only_live_records);
+  RUN_TEST(test_corrupt_tail_is_dropped_and_compacted_away);
+  RUN_TEST(test_failed_flush_stays_dirty);
+  RUN_TEST(test_large_flush_goes_out_in_chunks);
+  RUN_TEST(test_chunked_compaction_round_trips);
+  RUN_TEST(test_failed_compaction_leaves_the_old_log);
+  RUN_TEST(test_limits);
+  return UNITY_END();
+}
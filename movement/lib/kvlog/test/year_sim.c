@@ -0,0 +1,229 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * A year of typical settings traffic against littlefs on an emulated RWWEE area, comparing:
+ *   - one file per value, rewritten on every change (what faces do today);
+ *   - kvlog, flushed on every put;
+ *   - kvlog, with puts coalesced in RAM and flushed after 5 minutes or on entering low energy mode.
+ * For each it reports the erases per row, bytes programmed and write amplification (bytes
+ * programmed per byte of value that actually changed).
+ *
+ * Uses lfs_rwwee, with the stand-in watch_storage.h from its bench, and littlefs, which is a git submodule;
+ * if ../../../../littlefs is empty, fetch it first, from the top of the repo:
+ *   git submodule update --init littlefs
+ * Build and run from here:
+ *   gcc -O2 -I. -I.. -I../../lfs_rwwee -I../../lfs_rwwee/test -I../../../../littlefs year_sim.c \
+ *       ../kvlog.c ../../lfs_rwwee/lfs_rwwee.c ../../../../littlefs/lfs.c ../../../../littlefs/lfs_util.c \
+ *       -o year_sim && ./year_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lfs.h"
+#include "lfs_rwwee.h"
+#include "watch_storage.h"
+#include "kvlog.h"
+
+#define STORAGE_SIZE (NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
+#define ROWS (STORAGE_SIZE / NVMCTRL_ROW_SIZE)
+#define FLUSH_DELAY_S 300
+
+static uint8_t storage[STORAGE_SIZE];
+static uint32_t row_erases[ROWS];
+
+bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    memcpy(buffer, storage + row * NVMCTRL_ROW_SIZE + offset, size);
+    return true;
+}
+
+bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    memcpy(storage + row * NVMCTRL_ROW_SIZE + offset, buffer, size);
+    return true;
+}
+
+bool watch_storage_erase(uint32_t row) {
+    memset(storage + row * NVMCTRL_ROW_SIZE, 0xff, NVMCTRL_ROW_SIZE);
+    row_erases[row]++;
+    return true;
+}
+
+bool watch_storage_sync(void) {
+    return true;
+}
+
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset) {
+    return storage + row * NVMCTRL_ROW_SIZE + offset;
+}
+
+static lfs_t lfs;
+
+static int32_t sim_read_chunks(char *path, bool (*cb)(const char *chunk, int32_t length, int32_t offset, void *context), void *context) {
+    lfs_file_t file;
+    char chunk[64];
+    int32_t offset = 0;
+    if (lfs_file_open(&lfs, &file, path, LFS_O_RDONLY) < 0) return -1;
+    while (true) {
+        lfs_ssize_t n = lfs_file_read(&lfs, &file, chunk, sizeof(chunk));
+        if (n <= 0 || !cb(chunk, n, offset, context)) break;
+        offset += n;
+    }
+    lfs_file_close(&lfs, &file);
+    return offset;
+}
+
+static bool sim_store(char *path, char *data, int32_t length, int flags) {
+    lfs_file_t file;
+    if (lfs_file_open(&lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT | flags) < 0) return false;
+    bool ok = lfs_file_write(&lfs, &file, data, length) == length;
+    return lfs_file_close(&lfs, &file) == 0 && ok;
+}
+
+static bool sim_append(char *path, char *data, int32_t length) {
+    return sim_store(path, data, length, LFS_O_APPEND);
+}
+
+static bool sim_write(char *path, char *data, int32_t length) {
+    return sim_store(path, data, length, LFS_O_TRUNC);
+}
+
+static bool sim_rename(char *old_path, char *new_path) {
+    return lfs_rename(&lfs, old_path, new_path) == 0;
+}
+
+static const kvlog_io_t sim_io = {
+    .read_chunks = sim_read_chunks,
+    .append = sim_append,
+    .write = sim_write,
+    .rename = sim_rename,
+};
+
+typedef enum {
+    STRATEGY_FILE_PER_VALUE,
+    STRATEGY_KVLOG_IMMEDIATE,
+    STRATEGY_KVLOG_DEFERRED,
+    STRATEGY_COUNT
+} strategy_t;
+
+static const char *strategy_names[STRATEGY_COUNT] = { "file per value", "kvlog, flush every put", "kvlog, deferred flush" };
+
+// What a year on the wrist looks like, roughly: key, value size, and changes per waking day
+typedef struct {
+    const char *key;
+    uint8_t size;
+    uint16_t per_day;
+} usage_t;
+
+static const usage_t usage[] = {
+    { "tally.count", 2, 40 },       // counter face, clicked in bursts
+    { "temp.hour", 8, 24 },         // hourly temperature bucket
+    { "stopwatch", 4, 6 },          // last lap
+    { "alarm.time", 4, 1 },
+    { "timer.preset", 4, 1 },
+    { "settings", 4, 1 },
+    { "location", 4, 0 },           // set once, below
+};
+
+#define USAGE_COUNT (sizeof(usage) / sizeof(usage[0]))
+
+static void run(strategy_t strategy) {
+    struct lfs_config cfg;
+    static const lfs_rwwee_geometry_t geometry = LFS_RWWEE_DEFAULT_GEOMETRY;
+    static kvlog_t kv;
+    uint32_t values[USAGE_COUNT] = {0};
+    uint64_t payload = 0;
+    uint32_t dirty_since = 0;
+    bool dirty = false;
+
+    memset(storage, 0xff, sizeof(storage));
+    memset(row_erases, 0, sizeof(row_erases));
+    lfs_rwwee_configure(&cfg, &geometry);
+    lfs_format(&lfs, &cfg);
+    lfs_mount(&lfs, &cfg);
+    kvlog_init(&kv, &sim_io, "kv.log");
+    srand(1);
+
+    // a few other files, so littlefs isn't working with an empty disk
+    static char filler[600];
+    sim_write("totp_uris.txt", filler, sizeof(filler));
+    sim_write("big.txt", filler, 300);
+
+    for (uint32_t t = 0; t < 365 * 86400; t += 60) {
+        uint32_t minute_of_day = (t / 60) % 1440;
+        bool awake = minute_of_day >= 7 * 60 && minute_of_day < 23 * 60;
+
+        for (uint8_t i = 0; i < USAGE_COUNT; i++) {
+            uint32_t per_day = usage[i].per_day;
+            if (t == 0 && i == USAGE_COUNT - 1) per_day = 1440;
+            if (!awake || per_day == 0 || (uint32_t)(rand() % (16 * 60)) >= per_day) continue;
+
+            values[i]++;
+            payload += usage[i].size;
+            switch (strategy) {
+                case STRATEGY_FILE_PER_VALUE:
+                    sim_write((char *)usage[i].key, (char *)&values[i], usage[i].size);
+                    break;
+                case STRATEGY_KVLOG_IMMEDIATE:
+                    kvlog_put(&kv, usage[i].key, &values[i], usage[i].size);
+                    kvlog_flush(&kv);
+                    break;
+                case STRATEGY_KVLOG_DEFERRED:
+                    kvlog_put(&kv, usage[i].key, &values[i], usage[i].size);
+                    if (!dirty) dirty_since = t;
+                    dirty = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // deferred: flush on the timer, or when the watch goes into low energy mode at night
+        if (dirty && (t - dirty_since >= FLUSH_DELAY_S || minute_of_day == 23 * 60)) {
+            kvlog_flush(&kv);
+            dirty = false;
+        }
+    }
+
+    lfs_rwwee_stats_t stats;
+    lfs_rwwee_get_stats(&stats);
+    uint32_t erases = 0, worst = 0;
+    for (uint32_t row = 0; row < ROWS; row++) {
+        erases += row_erases[row];
+        if (row_erases[row] > worst) worst = row_erases[row];
+    }
+    printf("%-24s erases %7u (worst row %6u)  programmed %9u B  payload %8lu B  amplification %6.1fx\n",
+           strategy_names[strategy], erases, worst, stats.prog_bytes, (unsigned long)payload,
+           (double)stats.prog_bytes / payload);
+    if (strategy != STRATEGY_FILE_PER_VALUE) {
+        printf("%24s flushes %u, records %u, compactions %u\n", "", kv.stats.flushes, kv.stats.records, kv.stats.compactions);
+    }
+    lfs_unmount(&lfs);
+    lfs_rwwee_reset_stats();
+}
+
+int main(void) {
+    for (strategy_t s = 0; s < STRATEGY_COUNT; s++) run(s);
+    return 0;
+}
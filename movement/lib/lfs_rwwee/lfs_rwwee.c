@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "lfs_rwwee.h"
+#include "watch_storage.h"
+
+static lfs_rwwee_stats_t lfs_rwwee_stats;
+
+static int lfs_rwwee_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size) {
+    const lfs_rwwee_geometry_t *geometry = cfg->context;
+    lfs_rwwee_stats.reads++;
+    lfs_rwwee_stats.read_bytes += size;
+
+    if (geometry->mapped_reads) {
+        // waits out any write or erase in progress, but leaves their errors for watch_storage_sync
+        const uint8_t *src = watch_storage_get_mapped_address(block, off);
+        if (src == NULL) return LFS_ERR_IO;
+        memcpy(buffer, src, size);
+        return LFS_ERR_OK;
+    }
+
+    return watch_storage_read(block, off, buffer, size) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int lfs_rwwee_prog(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size) {
+    (void) cfg;
+    lfs_rwwee_stats.progs++;
+    lfs_rwwee_stats.prog_bytes += size;
+
+    // watch_storage_write programs one page at a time; a cache bigger than a page hands us several
+    const uint8_t *src = buffer;
+    while (size > 0) {
+        lfs_size_t n = size < NVMCTRL_PAGE_SIZE ? size : NVMCTRL_PAGE_SIZE;
+        if (!watch_storage_write(block, off, src, n)) return LFS_ERR_IO;
+        off += n;
+        src += n;
+        size -= n;
+    }
+    return LFS_ERR_OK;
+}
+
+static int lfs_rwwee_erase(const struct lfs_config *cfg, lfs_block_t block) {
+    (void) cfg;
+    lfs_rwwee_stats.erases++;
+    return watch_storage_erase(block) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int lfs_rwwee_sync(const struct lfs_config *cfg) {
+    (void) cfg;
+    lfs_rwwee_stats.syncs++;
+    // Our programs and erases block until they're done and report their own errors. Calling
+    // watch_storage_sync here would take any _async failure away from whoever queued it.
+    return LFS_ERR_OK;
+}
+
+void lfs_rwwee_configure(struct lfs_config *cfg, const lfs_rwwee_geometry_t *geometry) {
+    memset(cfg, 0, sizeof(struct lfs_config));
+    cfg->context = (void *)geometry;
+
+    // block device operations
+    cfg->read  = lfs_rwwee_read;
+    cfg->prog  = lfs_rwwee_prog;
+    cfg->erase = lfs_rwwee_erase;
+    cfg->sync  = lfs_rwwee_sync;
+
+    // block device configuration
+    cfg->read_size = geometry->read_size;
+    cfg->prog_size = NVMCTRL_PAGE_SIZE;
+    cfg->block_size = NVMCTRL_ROW_SIZE;
+    cfg->block_count = NVMCTRL_RWWEE_PAGES / 4;
+    cfg->cache_size = geometry->cache_size;
+    cfg->lookahead_size = geometry->lookahead_size;
+    cfg->block_cycles = 100;
+}
+
+void lfs_rwwee_get_stats(lfs_rwwee_stats_t *stats) {
+    *stats = lfs_rwwee_stats;
+}
+
+void lfs_rwwee_reset_stats(void) {
+    memset(&lfs_rwwee_stats, 0, sizeof(lfs_rwwee_stats_t));
+}
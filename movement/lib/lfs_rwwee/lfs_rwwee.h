@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LFS_RWWEE_H_
+#define LFS_RWWEE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lfs.h"
+
+/*
+ * littlefs block device for the SAM L22's 8 KiB RWWEE area (see watch_storage.h).
+ *
+ * One littlefs block is one 256-byte row, and programs go in 64-byte pages. Everything else is
+ * a tunable: how big littlefs's caches and lookahead bitmap are, and whether reads go through
+ * watch_storage_read, or straight out of the memory-mapped array with a memcpy.
+ *
+ * test/bench.c runs common workloads against an emulated RWWEE with a range of geometries.
+ */
+
+typedef struct {
+    lfs_size_t read_size;       ///< Smallest read littlefs will issue. Must divide cache_size.
+    lfs_size_t cache_size;      ///< Size of each of littlefs's caches (read, prog, and one per open file). A multiple of the 64-byte page that divides the row.
+    lfs_size_t lookahead_size;  ///< Bytes of block allocation bitmap; a multiple of 8. Each byte covers 8 of the 32 rows.
+    bool mapped_reads;          ///< Read from the memory-mapped array instead of calling watch_storage_read.
+} lfs_rwwee_geometry_t;
+
+// The geometry the filesystem has always used. Change it only with numbers from test/bench.c
+// (and a watch) that show the new one is better.
+#define LFS_RWWEE_DEFAULT_GEOMETRY { \
+    .read_size = 16, \
+    .cache_size = 64, \
+    .lookahead_size = 16, \
+    .mapped_reads = false, \
+}
+
+/// Counts of block device operations since the last reset, for benchmarks and diagnostics.
+typedef struct {
+    uint32_t reads;
+    uint32_t read_bytes;
+    uint32_t progs;
+    uint32_t prog_bytes;
+    uint32_t erases;
+    uint32_t syncs;
+} lfs_rwwee_stats_t;
+
+/** @brief Fills in a littlefs configuration for the RWWEE area with the given geometry.
+ * @param cfg The configuration to fill in. Buffers are left NULL, so littlefs allocates them.
+ * @param geometry The geometry to use; must stay valid for as long as the filesystem is mounted.
+ */
+void lfs_rwwee_configure(struct lfs_config *cfg, const lfs_rwwee_geometry_t *geometry);
+
+void lfs_rwwee_get_stats(lfs_rwwee_stats_t *stats);
+void lfs_rwwee_reset_stats(void);
+
+#endif // LFS_RWWEE_H_
@@ -0,0 +1,227 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host benchmark for the littlefs RWWEE block device.
+ *
+ * Runs a few workloads the watch actually sees against an emulated RWWEE area, once per
+ * candidate geometry, and reports block device traffic, simulated NVM busy time and RAM cost.
+ * The emulation enforces the part's rules (erase a row before programming it, program whole
+ * pages) and charges datasheet-ish costs: ~2.5 ms per page write, ~6 ms per row erase, and a
+ * per-call overhead for reads through watch_storage_read that mapped reads don't pay.
+ *
+ * littlefs is a git submodule; if ../../../../littlefs is empty, fetch it first, from the top of the repo:
+ *   git submodule update --init littlefs
+ * Build and run from this directory:
+ *   gcc -O2 -I. -I.. -I../../../../littlefs bench.c ../lfs_rwwee.c \
+ *       ../../../../littlefs/lfs.c ../../../../littlefs/lfs_util.c -o bench && ./bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lfs.h"
+#include "lfs_rwwee.h"
+#include "watch_storage.h"
+
+#define STORAGE_SIZE (NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
+
+#define PAGE_WRITE_US 2500
+#define ROW_ERASE_US 6000
+#define READ_CALL_US 4      // watch_storage_read: address checks, sync, halfword loop setup
+#define READ_BYTE_NS 250    // halfword loop through watch_storage_read, per byte
+#define MAPPED_BYTE_NS 60   // memcpy out of the mapped array, per byte
+
+static uint8_t storage[STORAGE_SIZE];
+static uint64_t nvm_ns;
+static bool mapped;
+
+bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    uint32_t address = row * NVMCTRL_ROW_SIZE + offset;
+    if (address + size > STORAGE_SIZE) return false;
+    memcpy(buffer, storage + address, size);
+    nvm_ns += READ_CALL_US * 1000 + (uint64_t)size * READ_BYTE_NS;
+    return true;
+}
+
+bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    uint32_t address = row * NVMCTRL_ROW_SIZE + offset;
+    if (address + size > STORAGE_SIZE || offset % NVMCTRL_PAGE_SIZE || size > NVMCTRL_PAGE_SIZE) return false;
+    for (uint32_t i = 0; i < size; i++) {
+        if (storage[address + i] != 0xff) {
+            fprintf(stderr, "program without erase at row %u offset %u\n", row, offset + i);
+            exit(1);
+        }
+        storage[address + i] = buffer[i];
+    }
+    nvm_ns += PAGE_WRITE_US * 1000;
+    return true;
+}
+
+bool watch_storage_erase(uint32_t row) {
+    if ((row + 1) * NVMCTRL_ROW_SIZE > STORAGE_SIZE) return false;
+    memset(storage + row * NVMCTRL_ROW_SIZE, 0xff, NVMCTRL_ROW_SIZE);
+    nvm_ns += ROW_ERASE_US * 1000;
+    return true;
+}
+
+bool watch_storage_sync(void) {
+    return true;
+}
+
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset) {
+    if (row * NVMCTRL_ROW_SIZE + offset >= STORAGE_SIZE) return NULL;
+    mapped = true;
+    return storage + row * NVMCTRL_ROW_SIZE + offset;
+}
+
+typedef struct {
+    const char *name;
+    lfs_rwwee_geometry_t geometry;
+} candidate_t;
+
+static const candidate_t candidates[] = {
+    { "baseline 16/64/16",     { .read_size = 16, .cache_size = 64,  .lookahead_size = 16, .mapped_reads = false } },
+    { "mapped 16/64/16",       { .read_size = 16, .cache_size = 64,  .lookahead_size = 16, .mapped_reads = true } },
+    { "mapped 16/128/16",      { .read_size = 16, .cache_size = 128, .lookahead_size = 16, .mapped_reads = true } },
+    { "copy 16/256/8",         { .read_size = 16, .cache_size = 256, .lookahead_size = 8,  .mapped_reads = false } },
+    { "mapped 16/256/8",       { .read_size = 16, .cache_size = 256, .lookahead_size = 8,  .mapped_reads = true } },
+    { "mapped 64/256/8",       { .read_size = 64, .cache_size = 256, .lookahead_size = 8,  .mapped_reads = true } },
+    { "default",               LFS_RWWEE_DEFAULT_GEOMETRY },
+};
+
+typedef enum {
+    WORKLOAD_APPEND,
+    WORKLOAD_REWRITE,
+    WORKLOAD_LIST,
+    WORKLOAD_READ,
+    WORKLOAD_COUNT
+} workload_t;
+
+static const char *workload_names[WORKLOAD_COUNT] = { "append line x50", "rewrite 1682B x10", "list dir x20", "read 1682B x20" };
+
+static char big_file[1682];
+
+static void check(int err, const char *what) {
+    if (err < 0) {
+        fprintf(stderr, "%s failed: %d\n", what, err);
+        exit(1);
+    }
+}
+
+static void prepare(lfs_t *lfs) {
+    // a filesystem that looks like a watch's: a few small settings files and one bigger one
+    lfs_file_t file;
+    const char *names[] = { "totp_uris.txt", "location.u32", "settings.u32", "birthdate.u32" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        check(lfs_file_open(lfs, &file, names[i], LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC), "open");
+        check(lfs_file_write(lfs, &file, big_file, 40 + i * 20), "write");
+        check(lfs_file_close(lfs, &file), "close");
+    }
+    check(lfs_file_open(lfs, &file, "big.txt", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC), "open");
+    check(lfs_file_write(lfs, &file, big_file, sizeof(big_file)), "write");
+    check(lfs_file_close(lfs, &file), "close");
+}
+
+static void run(lfs_t *lfs, workload_t workload) {
+    lfs_file_t file;
+    static char buf[sizeof(big_file)];
+
+    switch (workload) {
+        case WORKLOAD_APPEND:
+            for (int i = 0; i < 50; i++) {
+                int len = snprintf(buf, sizeof(buf), "%d,23.5,1013\n", i);
+                check(lfs_file_open(lfs, &file, "log.txt", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND), "open");
+                check(lfs_file_write(lfs, &file, buf, len), "write");
+                check(lfs_file_close(lfs, &file), "close");
+            }
+            break;
+        case WORKLOAD_REWRITE:
+            for (int i = 0; i < 10; i++) {
+                check(lfs_file_open(lfs, &file, "big.txt", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC), "open");
+                check(lfs_file_write(lfs, &file, big_file, sizeof(big_file)), "write");
+                check(lfs_file_close(lfs, &file), "close");
+            }
+            break;
+        case WORKLOAD_LIST:
+            for (int i = 0; i < 20; i++) {
+                lfs_dir_t dir;
+                struct lfs_info info;
+                check(lfs_dir_open(lfs, &dir, "/"), "dir_open");
+                while (lfs_dir_read(lfs, &dir, &info) > 0);
+                check(lfs_dir_close(lfs, &dir), "dir_close");
+            }
+            break;
+        case WORKLOAD_READ:
+            for (int i = 0; i < 20; i++) {
+                check(lfs_file_open(lfs, &file, "big.txt", LFS_O_RDONLY), "open");
+                while (lfs_file_read(lfs, &file, buf, 64) > 0);
+                check(lfs_file_close(lfs, &file), "close");
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(big_file); i++) big_file[i] = 'a' + i % 26;
+
+    for (size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); c++) {
+        const candidate_t *candidate = &candidates[c];
+        struct lfs_config cfg;
+        lfs_t lfs;
+
+        lfs_rwwee_configure(&cfg, &candidate->geometry);
+        // two caches, plus one per open file; the benchmark, like the watch, keeps one file open
+        unsigned ram = 3 * cfg.cache_size + cfg.lookahead_size;
+        printf("%s (%u bytes of buffers)\n", candidate->name, ram);
+
+        for (workload_t w = 0; w < WORKLOAD_COUNT; w++) {
+            memset(storage, 0xff, sizeof(storage));
+            check(lfs_format(&lfs, &cfg), "format");
+            check(lfs_mount(&lfs, &cfg), "mount");
+            prepare(&lfs);
+
+            lfs_rwwee_stats_t stats;
+            lfs_rwwee_reset_stats();
+            nvm_ns = 0;
+            mapped = false;
+            clock_t start = clock();
+            run(&lfs, w);
+            double wall_ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+            lfs_rwwee_get_stats(&stats);
+            // mapped reads skip watch_storage_read, so charge them here
+            if (mapped) nvm_ns += (uint64_t)stats.read_bytes * MAPPED_BYTE_NS;
+
+            printf("  %-18s reads %5u (%6u B)  progs %4u  erases %3u  nvm %8.1f ms  host %6.2f ms\n",
+                   workload_names[w], stats.reads, stats.read_bytes, stats.progs, stats.erases,
+                   nvm_ns / 1e6, wall_ms);
+            check(lfs_unmount(&lfs), "unmount");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for movement/filesystem.c's streaming reads, on littlefs over an emulated RWWEE area.
+ * littlefs is a git submodule; if ../../../../littlefs is empty, fetch it first, from the top of the repo:
+ *   git submodule update --init littlefs
+ * Build and run from this directory:
+ *   gcc -I. -I.. -I../../xfer -I../../.. -I../../../../littlefs -o test_filesystem test_main.c unity.c \
+ *       ../../../filesystem.c ../lfs_rwwee.c ../../xfer/xfer.c \
+ *       ../../../../littlefs/lfs.c ../../../../littlefs/lfs_util.c && ./test_filesystem
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "filesystem.h"
+#include "unity.h"
+
+#define STORAGE_SIZE (NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
+
+static uint8_t storage[STORAGE_SIZE];
+
+bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
+  uint32_t address = row * NVMCTRL_ROW_SIZE + offset;
+  if (address + size > STORAGE_SIZE) return false;
+  memcpy(buffer, storage + address, size);
+  return true;
+}
+
+bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+  uint32_t address = row * NVMCTRL_ROW_SIZE + offset;
+  if (address + size > STORAGE_SIZE || offset % NVMCTRL_PAGE_SIZE || size > NVMCTRL_PAGE_SIZE) return false;
+  memcpy(storage + address, buffer, size);
+  return true;
+}
+
+bool watch_storage_erase(uint32_t row) {
+  if ((row + 1) * NVMCTRL_ROW_SIZE > STORAGE_SIZE) return false;
+  memset(storage + row * NVMCTRL_ROW_SIZE, 0xff, NVMCTRL_ROW_SIZE);
+  return true;
+}
+
+bool watch_storage_sync(void) {
+  return true;
+}
+
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset) {
+  if (row * NVMCTRL_ROW_SIZE + offset >= STORAGE_SIZE) return NULL;
+  return storage + row * NVMCTRL_ROW_SIZE + offset;
+}
+
+void delay_ms(const uint16_t ms) {
+  (void) ms;
+}
+
+// What the callback saw, reassembled.
+static struct {
+  char data[1024];
+  int32_t calls;
+  int32_t stop_after;
+  bool bad_offset;
+  bool bad_length;
+} seen;
+
+static bool collect_chunk(const char *chunk, int32_t length, int32_t offset, void *context) {
+  (void) context;
+  int32_t expected = 0;
+  for (int32_t i = 0; i < seen.calls; i++) expected += FILESYSTEM_CHUNK_SIZE;
+  if (offset != expected) seen.bad_offset = true;
+  if (length <= 0 || length > FILESYSTEM_CHUNK_SIZE) seen.bad_length = true;
+  if (offset + length <= (int32_t)sizeof(seen.data)) memcpy(seen.data + offset, chunk, length);
+  seen.calls++;
+  return seen.calls != seen.stop_after;
+}
+
+static char pattern[1024];
+
+static void write_pattern(char *filename, int32_t length) {
+  TEST_ASSERT_TRUE(filesystem_write_file(filename, pattern, length));
+}
+
+void setUp(void) {
+  memset(storage, 0xff, sizeof(storage));
+  TEST_ASSERT_TRUE(filesystem_init());
+  memset(&seen, 0, sizeof(seen));
+  for (size_t i = 0; i < sizeof(pattern); i++) pattern[i] = 'a' + (i * 7) % 26;
+}
+
+void tearDown(void) {
+}
+
+void test_missing_file() {
+  TEST_ASSERT_EQUAL_INT32(-1, filesystem_read_chunks("nope.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(0, seen.calls);
+}
+
+void test_empty_file() {
+  write_pattern("empty.txt", 0);
+  TEST_ASSERT_EQUAL_INT32(0, filesystem_read_chunks("empty.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(0, seen.calls);
+}
+
+void test_short_file() {
+  write_pattern("short.txt", 10);
+  TEST_ASSERT_EQUAL_INT32(10, filesystem_read_chunks("short.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(1, seen.calls);
+  TEST_ASSERT_EQUAL_MEMORY(pattern, seen.data, 10);
+}
+
+void test_exact_chunk_boundary() {
+  // no zero-length call after the last full chunk
+  write_pattern("two.txt", 2 * FILESYSTEM_CHUNK_SIZE);
+  TEST_ASSERT_EQUAL_INT32(2 * FILESYSTEM_CHUNK_SIZE, filesystem_read_chunks("two.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(2, seen.calls);
+  TEST_ASSERT_FALSE(seen.bad_offset);
+  TEST_ASSERT_FALSE(seen.bad_length);
+  TEST_ASSERT_EQUAL_MEMORY(pattern, seen.data, 2 * FILESYSTEM_CHUNK_SIZE);
+}
+
+void test_one_past_chunk_boundary() {
+  write_pattern("three.txt", 2 * FILESYSTEM_CHUNK_SIZE + 1);
+  TEST_ASSERT_EQUAL_INT32(2 * FILESYSTEM_CHUNK_SIZE + 1, filesystem_read_chunks("three.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(3, seen.calls);
+  TEST_ASSERT_FALSE(seen.bad_offset);
+  TEST_ASSERT_FALSE(seen.bad_length);
+  TEST_ASSERT_EQUAL_MEMORY(pattern, seen.data, 2 * FILESYSTEM_CHUNK_SIZE + 1);
+}
+
+void test_file_spanning_blocks() {
+  // bigger than a 256-byte row, so littlefs hands it out of more than one block
+  write_pattern("big.txt", 1000);
+  TEST_ASSERT_EQUAL_INT32(1000, filesystem_read_chunks("big.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32((1000 + FILESYSTEM_CHUNK_SIZE - 1) / FILESYSTEM_CHUNK_SIZE, seen.calls);
+  TEST_ASSERT_FALSE(seen.bad_offset);
+  TEST_ASSERT_FALSE(seen.bad_length);
+  TEST_ASSERT_EQUAL_MEMORY(pattern, seen.data, 1000);
+}
+
+void test_callback_stops_early() {
+  write_pattern("big.txt", 1000);
+  seen.stop_after = 2;
+  TEST_ASSERT_EQUAL_INT32(2 * FILESYSTEM_CHUNK_SIZE, filesystem_read_chunks("big.txt", collect_chunk, NULL));
+  TEST_ASSERT_EQUAL_INT32(2, seen.calls);
+  // and the file was closed: it can be read again from the start
+  memset(&seen, 0, sizeof(seen));
+  TEST_ASSERT_EQUAL_INT32(1000, filesystem_read_chunks("big.txt", collect_chunk, NULL));
+}
+
+static bool compare_chunk(const char *chunk, int32_t length, int32_t offset, void *context) {
+  // the other filesystem calls use their own file handle, so they're fine to make from here
+  char other[FILESYSTEM_CHUNK_SIZE];
+  int32_t read = filesystem_read_file_at((char *)context, other, offset, length);
+  seen.calls++;
+  if (read != length || memcmp(other, chunk, length)) seen.bad_length = true;
+  return true;
+}
+
+void test_callback_can_read_other_files() {
+  write_pattern("a.txt", 300);
+  write_pattern("b.txt", 300);
+  TEST_ASSERT_EQUAL_INT32(300, filesystem_read_chunks("a.txt", compare_chunk, "b.txt"));
+  TEST_ASSERT_EQUAL_INT32(5, seen.calls);
+  TEST_ASSERT_FALSE(seen.bad_length);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_missing_file);
+  RUN_TEST(test_empty_file);
+  RUN_TEST(test_short_file);
+  RUN_TEST(test_exact_chunk_boundary);
+  RUN_TEST(test_one_past_chunk_boundary);
+  RUN_TEST(test_file_spanning_blocks);
+  RUN_TEST(test_callback_stops_early);
+  RUN_TEST(test_callback_can_read_other_files);
+  return UNITY_END();
+}
@@ -128,7 +128,7 @@ void morsecalc_display_stack(morsecalc_state_t * mcs) {
 
     char c = MORSECODE_TREE[mcs->mc]; 
     if('m' == c) { // Display memory 
-        morsecalc_display_float(mcs->cs->mem);
+        morsecalc_display_float(mcs->cs.mem);
         watch_display_character(c, 0);
     } 
     else {
@@ -136,12 +136,12 @@ void morsecalc_display_stack(morsecalc_state_t * mcs) {
         // Otherwise print top of stack
         uint8_t idx = 0;
         if(c >= '0' && c <= '9') idx = c - '0';
-        if(idx >= mcs->cs->s) watch_display_string(" empty", 4); // Stack empty
-        else morsecalc_display_float(mcs->cs->stack[mcs->cs->s-1-idx]); // Print stack item
+        if(idx >= mcs->cs.s) watch_display_string(" empty", 4); // Stack empty
+        else morsecalc_display_float(mcs->cs.stack[mcs->cs.s-1-idx]); // Print stack item
 
         watch_display_character('0'+idx, 0); // Print which stack item this is top center
     }
-    watch_display_character('0'+(mcs->cs->s), 3); // Print the # of stack items top right 
+    watch_display_character('0'+(mcs->cs.s), 3); // Print the # of stack items top right 
     return;
 }
 
@@ -0,0 +1,179 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for tzdb, checking every zone against the system's zoneinfo (through the C library's
+ * localtime_r) across the years the RTC can hold.
+ * Build and run from this directory:
+ *   gcc -O2 -DTZDB_IANA_NAMES -include ../../../../watch-library/shared/watch/test/watch_shim.h -I.. \
+ *       -I../../../../watch-library/shared/watch -o test_tzdb test_main.c unity.c ../tzdb.c ../tzdb_data.c \
+ *       ../../../../watch-library/shared/watch/watch_utility.c -lm && ./test_tzdb
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tzdb.h"
+#include "watch_utility.h"
+#include "unity.h"
+
+#define RANGE_START 1577836800u  // 2020-01-01 00:00:00 UTC
+#define RANGE_END 3597523200u    // 2084-01-01 00:00:00 UTC
+
+extern const char *const tzdb_iana_names[TZDB_NUM_ZONES];
+
+// Movement's table of offsets before it had zones with rules; the fixed zones must keep these.
+static const int16_t old_timezone_offsets[] = {
+    0, 60, 120, 180, 210, 240, 270, 300, 330, 345, 360, 390, 420, 480, 525, 540, 570, 600, 630, 660, 720,
+    765, 780, 825, 840, -720, -660, -600, -570, -540, -480, -420, -360, -300, -270, -240, -210, -180, -150,
+    -120, -60,
+};
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void use_zoneinfo(const char *name) {
+  char tz[64] = ":";
+  strcat(tz, name);
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+static int16_t zoneinfo_offset(uint32_t timestamp) {
+  time_t t = timestamp;
+  struct tm tm;
+  localtime_r(&t, &tm);
+  return tm.tm_gmtoff / 60;
+}
+
+void test_fixed_zones_keep_their_offsets() {
+  TEST_ASSERT_EQUAL(sizeof(old_timezone_offsets) / sizeof(old_timezone_offsets[0]), TZDB_FIRST_RULE_ZONE);
+  for (uint8_t zone = 0; zone < TZDB_FIRST_RULE_ZONE; zone++) {
+    tzdb_span_t span;
+    tzdb_lookup(zone, RANGE_START + zone * 1000000, &span);
+    TEST_ASSERT_EQUAL_INT16(old_timezone_offsets[zone], span.offset);
+    TEST_ASSERT_EQUAL_UINT32(0, span.start);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, span.end);
+  }
+  // indexes past the table read as UTC
+  TEST_ASSERT_EQUAL_INT16(0, tzdb_offset_at(63, RANGE_START));
+  TEST_ASSERT_EQUAL_STRING("UTC", tzdb_zone_name(63));
+}
+
+// Every hour from 2020 through 2083, and the second either side of every transition zoneinfo has.
+void test_rule_zones_match_zoneinfo() {
+  for (uint8_t zone = TZDB_FIRST_RULE_ZONE; zone < TZDB_NUM_ZONES; zone++) {
+    use_zoneinfo(tzdb_iana_names[zone]);
+    int16_t previous = zoneinfo_offset(RANGE_START);
+    for (uint32_t t = RANGE_START; t < RANGE_END; t += 3600) {
+      int16_t expected = zoneinfo_offset(t);
+      if (expected != previous) {
+        uint32_t low = t - 3600, high = t;
+        while (high - low > 1) {
+          uint32_t mid = low + (high - low) / 2;
+          if (zoneinfo_offset(mid) == previous) low = mid;
+          else high = mid;
+        }
+        TEST_ASSERT_EQUAL_INT16_MESSAGE(previous, tzdb_offset_at(zone, high - 1), tzdb_iana_names[zone]);
+        TEST_ASSERT_EQUAL_INT16_MESSAGE(expected, tzdb_offset_at(zone, high), tzdb_iana_names[zone]);
+        previous = expected;
+      }
+      int16_t actual = tzdb_offset_at(zone, t);
+      if (actual != expected) TEST_ASSERT_EQUAL_INT16_MESSAGE(expected, actual, tzdb_iana_names[zone]);
+    }
+  }
+}
+
+// A span's offset holds right up to its end, and the end is a real change or the edge of what was worked out.
+void test_spans_are_exact() {
+  for (uint8_t zone = TZDB_FIRST_RULE_ZONE; zone < TZDB_NUM_ZONES; zone++) {
+    use_zoneinfo(tzdb_iana_names[zone]);
+    uint32_t t = RANGE_START;
+    uint32_t transitions = 0;
+    while (t < RANGE_END - 86400 * 366) {
+      tzdb_span_t span;
+      tzdb_lookup(zone, t, &span);
+      TEST_ASSERT_TRUE(span.start <= t && t < span.end);
+      TEST_ASSERT_EQUAL_INT16(zoneinfo_offset(span.end - 1), span.offset);
+      if (zoneinfo_offset(span.end) != span.offset) transitions++;
+      t = span.end;
+    }
+    // in each zone, every year except Cairo's three years without DST has two
+    TEST_ASSERT_TRUE_MESSAGE(transitions >= 2 * 59, tzdb_iana_names[zone]);
+  }
+}
+
+void test_local_times_resolve_to_the_right_offset() {
+  srand(5);
+  for (uint8_t zone = TZDB_FIRST_RULE_ZONE; zone < TZDB_NUM_ZONES; zone++) {
+    use_zoneinfo(tzdb_iana_names[zone]);
+    for (uint32_t i = 0; i < 20000; i++) {
+      uint32_t utc = RANGE_START + 86400 + (uint32_t)(((uint64_t)rand() * rand()) % (RANGE_END - RANGE_START - 2 * 86400));
+      int16_t offset = zoneinfo_offset(utc);
+      uint32_t local = utc + offset * 60;
+      int16_t resolved = tzdb_offset_for_local(zone, local);
+      // the offset must be one this local time was really given in
+      TEST_ASSERT_EQUAL_INT16(resolved, zoneinfo_offset(local - resolved * 60));
+      // in the hour repeated when clocks go back, it has two readings, and the first (larger) one wins
+      if (resolved != offset) TEST_ASSERT_TRUE(resolved > offset);
+    }
+  }
+}
+
+void test_transition_local_times() {
+  // New York, 2024: clocks went forward at 2:00 on March 10th and back at 2:00 on November 3rd
+  const uint8_t new_york = TZDB_FIRST_RULE_ZONE + 4;
+  TEST_ASSERT_EQUAL_STRING("NYC", tzdb_zone_name(new_york));
+  uint32_t before_gap = watch_utility_convert_to_unix_time(2024, 3, 10, 1, 59, 59, 0);
+  uint32_t in_gap = watch_utility_convert_to_unix_time(2024, 3, 10, 2, 30, 0, 0);
+  uint32_t after_gap = watch_utility_convert_to_unix_time(2024, 3, 10, 3, 0, 0, 0);
+  TEST_ASSERT_EQUAL_INT16(-300, tzdb_offset_for_local(new_york, before_gap));
+  TEST_ASSERT_EQUAL_INT16(-300, tzdb_offset_for_local(new_york, in_gap));
+  TEST_ASSERT_EQUAL_INT16(-240, tzdb_offset_for_local(new_york, after_gap));
+
+  uint32_t repeated = watch_utility_convert_to_unix_time(2024, 11, 3, 1, 30, 0, 0);
+  uint32_t after_repeat = watch_utility_convert_to_unix_time(2024, 11, 3, 2, 0, 0, 0);
+  TEST_ASSERT_EQUAL_INT16(-240, tzdb_offset_for_local(new_york, repeated));
+  TEST_ASSERT_EQUAL_INT16(-300, tzdb_offset_for_local(new_york, after_repeat));
+
+  tzdb_span_t span;
+  tzdb_lookup(new_york, watch_utility_convert_to_unix_time(2024, 7, 1, 0, 0, 0, 0), &span);
+  TEST_ASSERT_EQUAL_UINT32(watch_utility_convert_to_unix_time(2024, 3, 10, 7, 0, 0, 0), span.start);
+  TEST_ASSERT_EQUAL_UINT32(watch_utility_convert_to_unix_time(2024, 11, 3, 6, 0, 0, 0), span.end);
+  TEST_ASSERT_EQUAL_INT16(-240, span.offset);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_zones_keep_their_offsets);
+  RUN_TEST(test_rule_zones_match_zoneinfo);
+  RUN_TEST(test_spans_are_exact);
+  RUN_TEST(test_local_times_resolve_to_the_right_offset);
+  RUN_TEST(test_transition_local_times);
+  return UNITY_END();
+}
@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tzdb.h"
+#include "watch_utility.h"
+
+#define TZDB_NUM_RULE_ZONES (TZDB_NUM_ZONES - TZDB_FIRST_RULE_ZONE)
+
+typedef struct {
+    uint32_t instant;
+    int16_t before;
+    int16_t after;
+} tzdb_transition_t;
+
+static tzdb_span_t _tzdb_cache[TZDB_NUM_RULE_ZONES];
+
+static const uint8_t _tzdb_days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static const tzdb_zone_t *_tzdb_zone(uint8_t zone) {
+    return &tzdb_zones[zone < TZDB_NUM_ZONES ? zone : 0];
+}
+
+static const tzdb_era_t *_tzdb_era(const tzdb_zone_t *zone, uint8_t year) {
+    const tzdb_era_t *era = &tzdb_eras[zone->first_era];
+    for (uint8_t i = 1; i < zone->num_eras && era[1].from_year <= year; i++) era++;
+    return era;
+}
+
+static uint32_t _tzdb_year_start(uint8_t year) {
+    return watch_utility_convert_to_unix_time(year + WATCH_RTC_REFERENCE_YEAR, 1, 1, 0, 0, 0, 0);
+}
+
+static uint32_t _tzdb_rule_instant(const tzdb_rule_t *rule, uint8_t year, int16_t std_offset) {
+    uint16_t full_year = year + WATCH_RTC_REFERENCE_YEAR;
+    uint8_t day = rule->day;
+
+    if (rule->last) {
+        day = _tzdb_days_in_month[rule->month - 1] + (rule->month == 2 && (full_year & 3) == 0);
+        uint8_t back = watch_utility_get_iso8601_weekday_number(full_year, rule->month, day) + 7 - rule->weekday;
+        if (back >= 7) back -= 7;
+        day -= back;
+    } else if (rule->weekday) {
+        uint8_t ahead = rule->weekday + 7 - watch_utility_get_iso8601_weekday_number(full_year, rule->month, day);
+        if (ahead >= 7) ahead -= 7;
+        day += ahead;
+    }
+
+    return watch_utility_convert_to_unix_time(full_year, rule->month, day, 0, 0, 0, 0) + (int32_t)(rule->at - std_offset) * 60;
+}
+
+// Appends a year's transitions, in order, to the list.
+static uint8_t _tzdb_add_transitions(const tzdb_zone_t *zone, uint8_t year, tzdb_transition_t *transitions, uint8_t count) {
+    const tzdb_era_t *era = _tzdb_era(zone, year);
+    if (!era->dst_delta) return count;
+
+    tzdb_transition_t start = { _tzdb_rule_instant(&era->start, year, era->std_offset), era->std_offset, era->std_offset + era->dst_delta };
+    tzdb_transition_t end = { _tzdb_rule_instant(&era->end, year, era->std_offset), era->std_offset + era->dst_delta, era->std_offset };
+    // DST starts before it ends in the northern hemisphere, and after in the southern
+    if (start.instant < end.instant) {
+        transitions[count++] = start;
+        transitions[count++] = end;
+    } else {
+        transitions[count++] = end;
+        transitions[count++] = start;
+    }
+    return count;
+}
+
+static void _tzdb_find_span(const tzdb_zone_t *zone, uint32_t timestamp, tzdb_span_t *span) {
+    watch_date_time date_time = watch_utility_date_time_from_unix_time(timestamp, 0);
+    uint8_t year = date_time.reg ? date_time.unit.year : (timestamp < _tzdb_year_start(0) ? 0 : TZDB_LAST_YEAR);
+
+    // DST transitions fall months apart and nowhere near New Year, so the rules for the year before
+    // and after bound the span on both sides.
+    tzdb_transition_t transitions[6];
+    uint8_t count = 0;
+    if (year > 0) count = _tzdb_add_transitions(zone, year - 1, transitions, count);
+    count = _tzdb_add_transitions(zone, year, transitions, count);
+    if (year < TZDB_LAST_YEAR) count = _tzdb_add_transitions(zone, year + 1, transitions, count);
+
+    span->start = year > 0 ? _tzdb_year_start(year - 1) : 0;
+    span->end = year < TZDB_LAST_YEAR - 1 ? _tzdb_year_start(year + 2) : UINT32_MAX;
+    span->offset = count ? transitions[0].before : _tzdb_era(zone, year)->std_offset;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (transitions[i].instant <= timestamp) {
+            span->start = transitions[i].instant;
+            span->offset = transitions[i].after;
+        } else {
+            span->end = transitions[i].instant;
+            break;
+        }
+    }
+}
+
+const char *tzdb_zone_name(uint8_t zone) {
+    return _tzdb_zone(zone)->name;
+}
+
+void tzdb_lookup(uint8_t zone, uint32_t timestamp, tzdb_span_t *span) {
+    if (zone < TZDB_FIRST_RULE_ZONE || zone >= TZDB_NUM_ZONES) {
+        span->start = 0;
+        span->end = UINT32_MAX;
+        span->offset = tzdb_eras[_tzdb_zone(zone)->first_era].std_offset;
+        return;
+    }
+
+    tzdb_span_t *cached = &_tzdb_cache[zone - TZDB_FIRST_RULE_ZONE];
+    if (timestamp >= cached->end || timestamp < cached->start) _tzdb_find_span(&tzdb_zones[zone], timestamp, cached);
+    *span = *cached;
+}
+
+int16_t tzdb_offset_at(uint8_t zone, uint32_t timestamp) {
+    tzdb_span_t span;
+    tzdb_lookup(zone, timestamp, &span);
+    return span.offset;
+}
+
+int16_t tzdb_offset_for_local(uint8_t zone, uint32_t local_timestamp) {
+    // transitions are months apart, so the offsets a day either side are the only candidates
+    int16_t before = tzdb_offset_at(zone, local_timestamp - 86400);
+    int16_t after = tzdb_offset_at(zone, local_timestamp + 86400);
+
+    // of two readings, the larger offset is the earlier instant
+    int16_t first = before > after ? before : after;
+    int16_t second = before > after ? after : before;
+    if (tzdb_offset_at(zone, local_timestamp - first * 60) == first) return first;
+    if (tzdb_offset_at(zone, local_timestamp - second * 60) == second) return second;
+
+    return before;
+}
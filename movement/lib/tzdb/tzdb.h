@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TZDB_H_
+#define TZDB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tzdb_data.h"
+
+/*
+ * Time zones with daylight saving time, compiled from the tz database for the years the RTC can
+ * hold (2020 through 2083) by utils/tzdb/generate_tzdb.py.
+ *
+ * A zone is a list of eras, each with a standard offset and, if the zone observes DST, the rules
+ * for when it starts and ends. Working out an offset from the rules takes a few calendar
+ * conversions, so each zone with rules caches the offset it last found and the span of time that
+ * offset holds for: from the transition before to the transition after. Until the next transition,
+ * a lookup is two comparisons. Fixed zones have nothing to cache.
+ *
+ * Zones 0 through TZDB_FIRST_RULE_ZONE - 1 are the fixed offsets Movement has always had, at the
+ * same indexes; zones with rules come after them.
+ */
+
+#define TZDB_LAST_YEAR 63  // 2083, as years since WATCH_RTC_REFERENCE_YEAR
+
+typedef struct {
+    uint8_t month;      // 1 - 12
+    uint8_t weekday;    // 1 (Monday) - 7 (Sunday), or 0 for a fixed day of the month
+    uint8_t last;       // if set, the last such weekday of the month
+    uint8_t day;        // the fixed day, or the first day the weekday may fall on
+    int16_t at;         // minutes after midnight, local standard time
+} tzdb_rule_t;
+
+typedef struct {
+    uint8_t from_year;  // the first year this era applies to, as years since WATCH_RTC_REFERENCE_YEAR
+    uint8_t dst_delta;  // minutes added while daylight saving time is in effect; 0 if it never is
+    int16_t std_offset; // minutes east of UTC
+    tzdb_rule_t start;
+    tzdb_rule_t end;
+} tzdb_era_t;
+
+typedef struct {
+    char name[5];
+    uint8_t first_era;
+    uint8_t num_eras;
+} tzdb_zone_t;
+
+/// An offset, and the span of UTC time it holds for: from start up to, but not including, end.
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    int16_t offset;     // minutes east of UTC
+} tzdb_span_t;
+
+extern const tzdb_era_t tzdb_eras[TZDB_NUM_ERAS];
+extern const tzdb_zone_t tzdb_zones[TZDB_NUM_ZONES];
+
+/** @brief Returns a zone's short name, like "UTC" or "NYC"; at most four characters.
+ */
+const char *tzdb_zone_name(uint8_t zone);
+
+/** @brief Finds the offset in effect in a zone at a given time, and when it last changed and next changes.
+ * @param zone The zone's index. Indexes past the end of the table are taken as UTC.
+ * @param timestamp A UNIX timestamp.
+ * @param span Receives the offset and the span it holds for. Fixed zones hold for all time: 0 to UINT32_MAX.
+ */
+void tzdb_lookup(uint8_t zone, uint32_t timestamp, tzdb_span_t *span);
+
+/** @brief Returns the offset in effect in a zone at a given time, in minutes east of UTC.
+ */
+int16_t tzdb_offset_at(uint8_t zone, uint32_t timestamp);
+
+/** @brief Works out which offset a local time in a zone was given in.
+ * @details A local time in the hour repeated when clocks go back is taken to be the first of the
+ *          two, still on daylight saving time. A local time in the hour skipped when clocks go
+ *          forward doesn't exist; for those, this returns the offset from before the gap.
+ * @param local_timestamp The local time, as a UNIX timestamp with a UTC offset of 0.
+ */
+int16_t tzdb_offset_for_local(uint8_t zone, uint32_t local_timestamp);
+
+#endif // TZDB_H_
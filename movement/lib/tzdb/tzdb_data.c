@@ -0,0 +1,207 @@
+// Generated by utils/tzdb/generate_tzdb.py from tzdata 2025b. Do not edit.
+
+#include <stddef.h>
+#include "tzdb.h"
+
+const tzdb_era_t tzdb_eras[TZDB_NUM_ERAS] = {
+    { 0, 0, 0, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  0 UTC 2020
+    { 0, 0, 60, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  1 CET 2020
+    { 0, 0, 120, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  2 SAST 2020
+    { 0, 0, 180, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  3 ARST 2020
+    { 0, 0, 210, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  4 IRST 2020
+    { 0, 0, 240, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  5 GET 2020
+    { 0, 0, 270, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  6 AFT 2020
+    { 0, 0, 300, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  7 PKT 2020
+    { 0, 0, 330, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  8 IST 2020
+    { 0, 0, 345, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, //  9 NPT 2020
+    { 0, 0, 360, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 10 KGT 2020
+    { 0, 0, 390, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 11 MYST 2020
+    { 0, 0, 420, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 12 THA 2020
+    { 0, 0, 480, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 13 CST 2020
+    { 0, 0, 525, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 14 ACWS 2020
+    { 0, 0, 540, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 15 JST 2020
+    { 0, 0, 570, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 16 ACST 2020
+    { 0, 0, 600, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 17 AEST 2020
+    { 0, 0, 630, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 18 LHST 2020
+    { 0, 0, 660, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 19 SBT 2020
+    { 0, 0, 720, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 20 NZST 2020
+    { 0, 0, 765, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 21 CHAS 2020
+    { 0, 0, 780, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 22 TOT 2020
+    { 0, 0, 825, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 23 CHAD 2020
+    { 0, 0, 840, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 24 LINT 2020
+    { 0, 0, -720, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 25 BIT 2020
+    { 0, 0, -660, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 26 NUT 2020
+    { 0, 0, -600, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 27 HST 2020
+    { 0, 0, -570, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 28 MART 2020
+    { 0, 0, -540, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 29 AKST 2020
+    { 0, 0, -480, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 30 PST 2020
+    { 0, 0, -420, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 31 MST 2020
+    { 0, 0, -360, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 32 CST 2020
+    { 0, 0, -300, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 33 EST 2020
+    { 0, 0, -270, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 34 VET 2020
+    { 0, 0, -240, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 35 AST 2020
+    { 0, 0, -210, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 36 NST 2020
+    { 0, 0, -180, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 37 BRT 2020
+    { 0, 0, -150, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 38 NDT 2020
+    { 0, 0, -120, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 39 FNT 2020
+    { 0, 0, -60, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 40 AZOT 2020
+    { 0, 60, 0, { 3, 7, 1, 0, 60 }, { 10, 7, 1, 0, 60 } }, // 41 Europe/London 2020: Mar last Sun 1:00s to Oct last Sun 1:00s
+    { 0, 60, 60, { 3, 7, 1, 0, 120 }, { 10, 7, 1, 0, 120 } }, // 42 Europe/Berlin 2020: Mar last Sun 2:00s to Oct last Sun 2:00s
+    { 0, 60, 120, { 3, 7, 1, 0, 180 }, { 10, 7, 1, 0, 180 } }, // 43 Europe/Athens 2020: Mar last Sun 3:00s to Oct last Sun 3:00s
+    { 0, 60, -60, { 3, 7, 1, 0, 0 }, { 10, 7, 1, 0, 0 } }, // 44 Atlantic/Azores 2020: Mar last Sun 0:00s to Oct last Sun 0:00s
+    { 0, 60, -300, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 45 America/New_York 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -360, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 46 America/Chicago 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -420, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 47 America/Denver 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -480, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 48 America/Los_Angeles 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -540, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 49 America/Anchorage 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -600, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 50 America/Adak 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -240, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 51 America/Halifax 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -210, { 3, 7, 0, 8, 120 }, { 11, 7, 0, 1, 60 } }, // 52 America/St_Johns 2020: Mar Sun>=8 2:00s to Nov Sun>=1 1:00s
+    { 0, 60, -300, { 3, 7, 0, 8, 0 }, { 11, 7, 0, 1, 0 } }, // 53 America/Havana 2020: Mar Sun>=8 0:00s to Nov Sun>=1 0:00s
+    { 0, 60, -240, { 9, 7, 0, 5, 0 }, { 4, 6, 0, 1, 1380 } }, // 54 America/Santiago 2020: Sep Sun>=5 0:00s to Apr Sat>=1 23:00s
+    { 3, 60, -240, { 9, 7, 0, 2, 0 }, { 4, 6, 0, 1, 1380 } }, // 54 America/Santiago 2023: Sep Sun>=2 0:00s to Apr Sat>=1 23:00s
+    { 0, 60, 600, { 10, 7, 0, 1, 120 }, { 4, 7, 0, 1, 120 } }, // 55 Australia/Sydney 2020: Oct Sun>=1 2:00s to Apr Sun>=1 2:00s
+    { 0, 60, 570, { 10, 7, 0, 1, 120 }, { 4, 7, 0, 1, 120 } }, // 56 Australia/Adelaide 2020: Oct Sun>=1 2:00s to Apr Sun>=1 2:00s
+    { 0, 30, 630, { 10, 7, 0, 1, 120 }, { 4, 7, 0, 1, 90 } }, // 57 Australia/Lord_Howe 2020: Oct Sun>=1 2:00s to Apr Sun>=1 1:30s
+    { 0, 60, 720, { 9, 7, 1, 0, 120 }, { 4, 7, 0, 1, 120 } }, // 58 Pacific/Auckland 2020: Sep last Sun 2:00s to Apr Sun>=1 2:00s
+    { 0, 60, 765, { 9, 7, 1, 0, 165 }, { 4, 7, 0, 1, 165 } }, // 59 Pacific/Chatham 2020: Sep last Sun 2:45s to Apr Sun>=1 2:45s
+    { 0, 60, 120, { 3, 5, 0, 23, 120 }, { 10, 7, 1, 0, 60 } }, // 60 Asia/Jerusalem 2020: Mar Fri>=23 2:00s to Oct last Sun 1:00s
+    { 0, 60, 120, { 3, 7, 1, 0, 0 }, { 10, 6, 0, 24, 1380 } }, // 61 Asia/Beirut 2020: Mar last Sun 0:00s to Oct Sat>=24 23:00s
+    { 0, 0, 120, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } }, // 62 Africa/Cairo 2020
+    { 3, 60, 120, { 4, 5, 1, 0, 0 }, { 10, 4, 1, 0, 1380 } }, // 62 Africa/Cairo 2023: Apr last Fri 0:00s to Oct last Thu 23:00s
+};
+
+const tzdb_zone_t tzdb_zones[TZDB_NUM_ZONES] = {
+    { "UTC", 0, 1 },
+    { "CET", 1, 1 },
+    { "SAST", 2, 1 },
+    { "ARST", 3, 1 },
+    { "IRST", 4, 1 },
+    { "GET", 5, 1 },
+    { "AFT", 6, 1 },
+    { "PKT", 7, 1 },
+    { "IST", 8, 1 },
+    { "NPT", 9, 1 },
+    { "KGT", 10, 1 },
+    { "MYST", 11, 1 },
+    { "THA", 12, 1 },
+    { "CST", 13, 1 },
+    { "ACWS", 14, 1 },
+    { "JST", 15, 1 },
+    { "ACST", 16, 1 },
+    { "AEST", 17, 1 },
+    { "LHST", 18, 1 },
+    { "SBT", 19, 1 },
+    { "NZST", 20, 1 },
+    { "CHAS", 21, 1 },
+    { "TOT", 22, 1 },
+    { "CHAD", 23, 1 },
+    { "LINT", 24, 1 },
+    { "BIT", 25, 1 },
+    { "NUT", 26, 1 },
+    { "HST", 27, 1 },
+    { "MART", 28, 1 },
+    { "AKST", 29, 1 },
+    { "PST", 30, 1 },
+    { "MST", 31, 1 },
+    { "CST", 32, 1 },
+    { "EST", 33, 1 },
+    { "VET", 34, 1 },
+    { "AST", 35, 1 },
+    { "NST", 36, 1 },
+    { "BRT", 37, 1 },
+    { "NDT", 38, 1 },
+    { "FNT", 39, 1 },
+    { "AZOT", 40, 1 },
+    { "LON", 41, 1 },
+    { "BER", 42, 1 },
+    { "ATH", 43, 1 },
+    { "AZO", 44, 1 },
+    { "NYC", 45, 1 },
+    { "CHI", 46, 1 },
+    { "DEN", 47, 1 },
+    { "LAX", 48, 1 },
+    { "ANC", 49, 1 },
+    { "ADK", 50, 1 },
+    { "HAL", 51, 1 },
+    { "NFL", 52, 1 },
+    { "HAV", 53, 1 },
+    { "SCL", 54, 2 },
+    { "SYD", 56, 1 },
+    { "ADL", 57, 1 },
+    { "LHI", 58, 1 },
+    { "AKL", 59, 1 },
+    { "CHT", 60, 1 },
+    { "JER", 61, 1 },
+    { "BEY", 62, 1 },
+    { "CAI", 63, 2 },
+};
+
+#ifdef TZDB_IANA_NAMES
+// the zoneinfo zone each entry was generated from, for the host tests
+const char *const tzdb_iana_names[TZDB_NUM_ZONES] = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "Europe/London",
+    "Europe/Berlin",
+    "Europe/Athens",
+    "Atlantic/Azores",
+    "America/New_York",
+    "America/Chicago",
+    "America/Denver",
+    "America/Los_Angeles",
+    "America/Anchorage",
+    "America/Adak",
+    "America/Halifax",
+    "America/St_Johns",
+    "America/Havana",
+    "America/Santiago",
+    "Australia/Sydney",
+    "Australia/Adelaide",
+    "Australia/Lord_Howe",
+    "Pacific/Auckland",
+    "Pacific/Chatham",
+    "Asia/Jerusalem",
+    "Asia/Beirut",
+    "Africa/Cairo",
+};
+#endif
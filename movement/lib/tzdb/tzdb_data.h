@@ -0,0 +1,10 @@
+// Generated by utils/tzdb/generate_tzdb.py from tzdata 2025b. Do not edit.
+
+#ifndef TZDB_DATA_H_
+#define TZDB_DATA_H_
+
+#define TZDB_NUM_ZONES 63
+#define TZDB_FIRST_RULE_ZONE 41
+#define TZDB_NUM_ERAS 65
+
+#endif // TZDB_DATA_H_
@@ -0,0 +1,267 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Build and run from this directory:
+ *   gcc -I.. -o test_xfer test_main.c unity.c ../xfer.c -lpthread && ./test_xfer
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "xfer.h"
+#include "unity.h"
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_crc32() {
+  TEST_ASSERT_EQUAL_HEX32(0, xfer_crc32_update(0, NULL, 0));
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, xfer_crc32_update(0, (const uint8_t *)"123456789", 9));
+  // Feeding it in pieces gives the same result
+  uint32_t crc = xfer_crc32_update(0, (const uint8_t *)"1234", 4);
+  crc = xfer_crc32_update(crc, (const uint8_t *)"56789", 5);
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc);
+}
+
+static void cobs_round_trip(const uint8_t *src, uint16_t len, const uint8_t *expected, uint16_t expected_len) {
+  uint8_t encoded[600];
+  uint8_t decoded[600];
+  uint16_t n = xfer_cobs_encode(src, len, encoded);
+  if (expected) {
+    TEST_ASSERT_EQUAL(expected_len, n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, encoded, n);
+  }
+  for (uint16_t i = 0; i < n; i++) TEST_ASSERT_NOT_EQUAL(0, encoded[i]);
+  TEST_ASSERT_EQUAL(len, xfer_cobs_decode(encoded, n, decoded, sizeof(decoded)));
+  if (len) TEST_ASSERT_EQUAL_HEX8_ARRAY(src, decoded, len);
+}
+
+void test_cobs() {
+  const uint8_t a[] = {0x00};
+  const uint8_t a_enc[] = {0x01, 0x01};
+  cobs_round_trip(a, sizeof(a), a_enc, sizeof(a_enc));
+  const uint8_t b[] = {0x00, 0x00};
+  const uint8_t b_enc[] = {0x01, 0x01, 0x01};
+  cobs_round_trip(b, sizeof(b), b_enc, sizeof(b_enc));
+  const uint8_t c[] = {0x11, 0x22, 0x00, 0x33};
+  const uint8_t c_enc[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+  cobs_round_trip(c, sizeof(c), c_enc, sizeof(c_enc));
+
+  // Runs of 254 and 255 non-zero bytes, with and without a zero after them
+  uint8_t run[300];
+  for (uint16_t i = 0; i < sizeof(run); i++) run[i] = 1 + i % 255;
+  cobs_round_trip(run, 254, NULL, 0);
+  TEST_ASSERT_EQUAL(255, xfer_cobs_encode(run, 254, (uint8_t[300]){0}));
+  cobs_round_trip(run, 255, NULL, 0);
+  run[254] = 0;
+  cobs_round_trip(run, 256, NULL, 0);
+  cobs_round_trip(run, 0, NULL, 0);
+
+  // Garbage is rejected rather than decoded
+  const uint8_t bad[] = {0x05, 0x11, 0x22};
+  uint8_t out[16];
+  TEST_ASSERT_EQUAL(-1, xfer_cobs_decode(bad, sizeof(bad), out, sizeof(out)));
+  TEST_ASSERT_EQUAL(-1, xfer_cobs_decode(c_enc, sizeof(c_enc), out, 2));
+}
+
+// A link between two threads over a socketpair, which can drop or corrupt frames on the way out
+
+typedef struct {
+  int fd;
+  uint32_t seed;
+  uint8_t drop_percent;
+  uint8_t corrupt_percent;
+} link_end_t;
+
+static uint32_t link_random(link_end_t *end) {
+  end->seed = end->seed * 1103515245 + 12345;
+  return (end->seed >> 16) % 100;
+}
+
+static int32_t link_read(void *context, uint8_t *buf, uint16_t len, uint16_t timeout_ms) {
+  link_end_t *end = context;
+  struct pollfd pfd = { end->fd, POLLIN, 0 };
+  if (poll(&pfd, 1, timeout_ms) <= 0) return 0;
+  ssize_t n = read(end->fd, buf, len);
+  return n > 0 ? n : 0;
+}
+
+static void link_write(void *context, const uint8_t *buf, uint16_t len) {
+  link_end_t *end = context;
+  if (link_random(end) < end->drop_percent) return;
+  uint8_t copy[XFER_MAX_ENCODED + 2];
+  memcpy(copy, buf, len);
+  if (link_random(end) < end->corrupt_percent) copy[1 + link_random(end) % (len - 2)] ^= 0x40;
+  ssize_t written = write(end->fd, copy, len);
+  (void)written;
+}
+
+#define FILE_SIZE 5000
+
+static uint8_t source_data[FILE_SIZE];
+static uint8_t sink_data[FILE_SIZE + XFER_CHUNK_SIZE];
+static uint32_t sink_len;
+
+static int32_t test_source(void *context, uint32_t offset, uint8_t *buf, uint16_t len) {
+  (void)context;
+  memcpy(buf, source_data + offset, len);
+  return len;
+}
+
+static bool test_sink(void *context, const uint8_t *buf, uint16_t len) {
+  (void)context;
+  if (sink_len + len > sizeof(sink_data)) return false;
+  memcpy(sink_data + sink_len, buf, len);
+  sink_len += len;
+  return true;
+}
+
+typedef struct {
+  xfer_t x;
+  uint32_t size;
+  xfer_result_t result;
+} sender_job_t;
+
+static void *sender_thread(void *arg) {
+  sender_job_t *job = arg;
+  xfer_send_hello(&job->x, job->size);
+  job->result = xfer_send(&job->x, test_source, NULL, job->size);
+  return NULL;
+}
+
+static void run_transfer(uint32_t size, uint8_t drop_percent, uint8_t corrupt_percent) {
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  link_end_t sender_end = { fds[0], 1, drop_percent, corrupt_percent };
+  link_end_t receiver_end = { fds[1], 2, drop_percent, corrupt_percent };
+  xfer_io_t sender_io = { link_read, link_write, &sender_end };
+  xfer_io_t receiver_io = { link_read, link_write, &receiver_end };
+
+  for (uint32_t i = 0; i < FILE_SIZE; i++) source_data[i] = rand();
+  sink_len = 0;
+
+  static sender_job_t job;
+  xfer_init(&job.x, &sender_io);
+  job.size = size;
+  static xfer_t receiver;
+  xfer_init(&receiver, &receiver_io);
+
+  // The receiver's noise: text on the line before the first frame, like the shell echoing a command
+  ssize_t written = write(fds[0], "get file.bin\r\n", 14);
+  (void)written;
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, sender_thread, &job);
+
+  uint32_t announced = 0;
+  xfer_result_t result;
+  // The HELLO can be lost too; in the protocol, the host would give up and retry the command
+  if (drop_percent == 0) {
+    TEST_ASSERT_EQUAL(XFER_OK, xfer_wait_hello(&receiver, &announced, 1000));
+    TEST_ASSERT_EQUAL(size, announced);
+  }
+  uint32_t received = 0;
+  result = xfer_receive(&receiver, test_sink, NULL, &received);
+  pthread_join(thread, NULL);
+
+  TEST_ASSERT_EQUAL(XFER_OK, result);
+  TEST_ASSERT_EQUAL(XFER_OK, job.result);
+  TEST_ASSERT_EQUAL(size, received);
+  TEST_ASSERT_EQUAL(size, sink_len);
+  if (size) TEST_ASSERT_EQUAL_HEX8_ARRAY(source_data, sink_data, size);
+  if (drop_percent || corrupt_percent) TEST_ASSERT_TRUE(job.x.stats.retransmits > 0);
+  else TEST_ASSERT_EQUAL(0, job.x.stats.retransmits);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+void test_clean_transfer() {
+  run_transfer(0, 0, 0);
+  run_transfer(1, 0, 0);
+  run_transfer(XFER_CHUNK_SIZE, 0, 0);
+  run_transfer(XFER_CHUNK_SIZE * XFER_WINDOW + 1, 0, 0);
+  run_transfer(FILE_SIZE, 0, 0);
+}
+
+void test_lossy_transfer() {
+  run_transfer(FILE_SIZE, 10, 0);
+  run_transfer(FILE_SIZE, 0, 10);
+  run_transfer(FILE_SIZE, 5, 5);
+}
+
+static int32_t bad_source(void *context, uint32_t offset, uint8_t *buf, uint16_t len) {
+  (void)context;
+  (void)buf;
+  return offset < XFER_CHUNK_SIZE * 2 ? len : -1;
+}
+
+static void *bad_sender_thread(void *arg) {
+  sender_job_t *job = arg;
+  job->result = xfer_send(&job->x, bad_source, NULL, job->size);
+  return NULL;
+}
+
+void test_sender_abort() {
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  link_end_t sender_end = { fds[0], 1, 0, 0 };
+  link_end_t receiver_end = { fds[1], 2, 0, 0 };
+  xfer_io_t sender_io = { link_read, link_write, &sender_end };
+  xfer_io_t receiver_io = { link_read, link_write, &receiver_end };
+  static sender_job_t job;
+  xfer_init(&job.x, &sender_io);
+  job.size = FILE_SIZE;
+  static xfer_t receiver;
+  xfer_init(&receiver, &receiver_io);
+  sink_len = 0;
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, bad_sender_thread, &job);
+  uint32_t received = 0;
+  TEST_ASSERT_EQUAL(XFER_ERR_ABORTED, xfer_receive(&receiver, test_sink, NULL, &received));
+  pthread_join(thread, NULL);
+  TEST_ASSERT_EQUAL(XFER_ERR_IO, job.result);
+  TEST_ASSERT_EQUAL_STRING("read failed", receiver.peer_error);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc32);
+  RUN_TEST(test_cobs);
+  RUN_TEST(test_clean_transfer);
+  RUN_TEST(test_lossy_transfer);
+  RUN_TEST(test_sender_abort);
+  return UNITY_END();
+}
@@ -0,0 +1,314 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "xfer.h"
+
+// CRC-32 with the reflected IEEE polynomial 0xEDB88320, a nibble at a time
+static const uint32_t xfer_crc32_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t xfer_crc32_update(uint32_t crc, const uint8_t *data, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ xfer_crc32_table[crc & 0x0F];
+        crc = (crc >> 4) ^ xfer_crc32_table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+uint16_t xfer_cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dst) {
+    uint16_t code_pos = 0;
+    uint16_t out = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            dst[out++] = src[i];
+            code++;
+            if (code == 0xFF && i + 1 < len) {
+                dst[code_pos] = code;
+                code_pos = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_pos] = code;
+
+    return out;
+}
+
+int32_t xfer_cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dst, uint16_t max_len) {
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+        if (code == 0) return -1;
+        for (uint8_t i = 1; i < code; i++) {
+            if (in >= len || src[in] == 0 || out >= max_len) return -1;
+            dst[out++] = src[in++];
+        }
+        // A code of 0xFF means a full run with no zero after it; so does the end of the input
+        if (code != 0xFF && in < len) {
+            if (out >= max_len) return -1;
+            dst[out++] = 0;
+        }
+    }
+
+    return out;
+}
+
+static void _xfer_put_u32(uint8_t *buf, uint32_t value) {
+    buf[0] = value;
+    buf[1] = value >> 8;
+    buf[2] = value >> 16;
+    buf[3] = value >> 24;
+}
+
+static uint32_t _xfer_get_u32(const uint8_t *buf) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+void xfer_init(xfer_t *x, const xfer_io_t *io) {
+    memset(x, 0, sizeof(xfer_t));
+    x->io = *io;
+}
+
+void xfer_send_frame(xfer_t *x, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len) {
+    uint8_t frame[XFER_MAX_FRAME];
+
+    if (len > XFER_CHUNK_SIZE) len = XFER_CHUNK_SIZE;
+    frame[0] = type;
+    frame[1] = seq;
+    if (len) memcpy(frame + 2, payload, len);
+    _xfer_put_u32(frame + 2 + len, xfer_crc32_update(0, frame, 2 + len));
+
+    // Leading delimiter flushes out whatever the receiver may have picked up before this frame
+    x->tx[0] = 0;
+    uint16_t encoded = xfer_cobs_encode(frame, 2 + len + 4, x->tx + 1);
+    x->tx[encoded + 1] = 0;
+    x->io.write(x->io.context, x->tx, encoded + 2);
+    x->stats.frames_sent++;
+}
+
+static bool _xfer_decode_frame(xfer_t *x, xfer_frame_t *frame) {
+    int32_t len = xfer_cobs_decode(x->rx, x->rx_len, x->frame, XFER_MAX_FRAME);
+    if (len < 6) return false;
+    if (xfer_crc32_update(0, x->frame, len - 4) != _xfer_get_u32(x->frame + len - 4)) return false;
+
+    frame->type = x->frame[0];
+    frame->seq = x->frame[1];
+    frame->payload = x->frame + 2;
+    frame->len = len - 6;
+    return true;
+}
+
+bool xfer_read_frame(xfer_t *x, xfer_frame_t *frame, uint16_t timeout_ms) {
+    while (true) {
+        if (x->in_pos == x->in_len) {
+            int32_t n = x->io.read(x->io.context, x->in, sizeof(x->in), timeout_ms);
+            if (n <= 0) return false;
+            x->in_pos = 0;
+            x->in_len = n;
+        }
+
+        uint8_t c = x->in[x->in_pos++];
+        if (c != 0) {
+            if (x->rx_len < XFER_MAX_ENCODED) x->rx[x->rx_len++] = c;
+            else x->rx_overflow = true;
+            continue;
+        }
+
+        // Delimiter: an empty frame is just the gap between two frames
+        if (x->rx_len > 0) {
+            bool ok = !x->rx_overflow && _xfer_decode_frame(x, frame);
+            x->rx_len = 0;
+            x->rx_overflow = false;
+            if (ok) {
+                x->stats.frames_received++;
+                if (frame->type == XFER_FRAME_ABORT) {
+                    uint16_t n = frame->len < sizeof(x->peer_error) - 1 ? frame->len : sizeof(x->peer_error) - 1;
+                    memcpy(x->peer_error, frame->payload, n);
+                    x->peer_error[n] = 0;
+                }
+                return true;
+            }
+            x->stats.bad_frames++;
+        }
+    }
+}
+
+void xfer_send_hello(xfer_t *x, uint32_t value) {
+    uint8_t payload[4];
+    _xfer_put_u32(payload, value);
+    xfer_send_frame(x, XFER_FRAME_HELLO, 0, payload, sizeof(payload));
+}
+
+xfer_result_t xfer_wait_hello(xfer_t *x, uint32_t *value, uint16_t timeout_ms) {
+    xfer_frame_t frame;
+    while (xfer_read_frame(x, &frame, timeout_ms)) {
+        if (frame.type == XFER_FRAME_ABORT) return XFER_ERR_ABORTED;
+        if (frame.type == XFER_FRAME_HELLO && frame.len == 4) {
+            *value = _xfer_get_u32(frame.payload);
+            return XFER_OK;
+        }
+    }
+    return XFER_ERR_TIMEOUT;
+}
+
+void xfer_abort(xfer_t *x, const char *reason) {
+    xfer_send_frame(x, XFER_FRAME_ABORT, 0, (const uint8_t *)reason, strlen(reason));
+}
+
+xfer_result_t xfer_send(xfer_t *x, xfer_source_t source, void *context, uint32_t size) {
+    uint8_t chunk[XFER_CHUNK_SIZE];
+    uint8_t base = 0;
+    uint8_t next = 0;
+    uint32_t base_offset = 0;
+    uint32_t next_offset = 0;
+    // The CRC covers each byte once, the first time it goes out
+    uint32_t crc = 0;
+    uint32_t crc_offset = 0;
+    uint8_t retries = 0;
+    xfer_frame_t frame;
+
+    while (base_offset < size) {
+        // Fill the window
+        while ((uint8_t)(next - base) < XFER_WINDOW && next_offset < size) {
+            uint16_t n = (size - next_offset) < XFER_CHUNK_SIZE ? (size - next_offset) : XFER_CHUNK_SIZE;
+            if (source(context, next_offset, chunk, n) != n) {
+                xfer_abort(x, "read failed");
+                return XFER_ERR_IO;
+            }
+            if (next_offset == crc_offset) {
+                crc = xfer_crc32_update(crc, chunk, n);
+                crc_offset += n;
+            }
+            xfer_send_frame(x, XFER_FRAME_DATA, next, chunk, n);
+            next++;
+            next_offset += n;
+        }
+
+        if (!xfer_read_frame(x, &frame, XFER_ACK_TIMEOUT_MS)) {
+            if (++retries > XFER_MAX_RETRIES) return XFER_ERR_TIMEOUT;
+            // Go back to the oldest frame that hasn't been acknowledged
+            x->stats.retransmits += (uint8_t)(next - base);
+            next = base;
+            next_offset = base_offset;
+            continue;
+        }
+        if (frame.type == XFER_FRAME_ABORT) return XFER_ERR_ABORTED;
+        if (frame.type != XFER_FRAME_ACK) continue;
+
+        // Frames sent before a go-back can still be acknowledged, so accept anything up to what went out
+        uint8_t acked = frame.seq - base;
+        uint8_t highest = (crc_offset - base_offset + XFER_CHUNK_SIZE - 1) / XFER_CHUNK_SIZE;
+        if (acked == 0 || acked > highest) continue;
+        retries = 0;
+        uint8_t in_flight = next - base;
+        base += acked;
+        base_offset += (uint32_t)acked * XFER_CHUNK_SIZE;
+        if (base_offset > size) base_offset = size;
+        if (acked > in_flight) {
+            next = base;
+            next_offset = base_offset;
+        }
+    }
+
+    // All data acknowledged: send END until it's acknowledged too
+    uint8_t payload[8];
+    _xfer_put_u32(payload, size);
+    _xfer_put_u32(payload + 4, crc);
+    retries = 0;
+    xfer_send_frame(x, XFER_FRAME_END, base, payload, sizeof(payload));
+    while (true) {
+        if (!xfer_read_frame(x, &frame, XFER_ACK_TIMEOUT_MS)) {
+            if (++retries > XFER_MAX_RETRIES) return XFER_ERR_TIMEOUT;
+            x->stats.retransmits++;
+            xfer_send_frame(x, XFER_FRAME_END, base, payload, sizeof(payload));
+            continue;
+        }
+        if (frame.type == XFER_FRAME_ABORT) return XFER_ERR_ABORTED;
+        if (frame.type == XFER_FRAME_ACK && frame.seq == (uint8_t)(base + 1)) return XFER_OK;
+    }
+}
+
+static void _xfer_send_ack(xfer_t *x, uint8_t seq) {
+    xfer_send_frame(x, XFER_FRAME_ACK, seq, NULL, 0);
+}
+
+xfer_result_t xfer_receive(xfer_t *x, xfer_sink_t sink, void *context, uint32_t *size) {
+    uint8_t expected = 0;
+    uint32_t received = 0;
+    uint32_t crc = 0;
+    xfer_frame_t frame;
+
+    while (true) {
+        if (!xfer_read_frame(x, &frame, XFER_IDLE_TIMEOUT_MS)) return XFER_ERR_TIMEOUT;
+
+        switch (frame.type) {
+            case XFER_FRAME_ABORT:
+                return XFER_ERR_ABORTED;
+            case XFER_FRAME_DATA:
+                if (frame.seq == expected) {
+                    if (!sink(context, frame.payload, frame.len)) {
+                        xfer_abort(x, "write failed");
+                        return XFER_ERR_IO;
+                    }
+                    crc = xfer_crc32_update(crc, frame.payload, frame.len);
+                    received += frame.len;
+                    expected++;
+                }
+                // Out of order or duplicate: tell the sender again where we are
+                _xfer_send_ack(x, expected);
+                break;
+            case XFER_FRAME_END:
+                if (frame.seq != expected || frame.len != 8) {
+                    _xfer_send_ack(x, expected);
+                    break;
+                }
+                if (_xfer_get_u32(frame.payload) != received || _xfer_get_u32(frame.payload + 4) != crc) {
+                    xfer_abort(x, "checksum mismatch");
+                    return XFER_ERR_CHECKSUM;
+                }
+                _xfer_send_ack(x, expected + 1);
+                // Hang around briefly in case our ACK got lost and the sender repeats END
+                while (xfer_read_frame(x, &frame, XFER_LINGER_MS)) {
+                    if (frame.type == XFER_FRAME_END) _xfer_send_ack(x, expected + 1);
+                }
+                *size = received;
+                return XFER_OK;
+            default:
+                break;
+        }
+    }
+}
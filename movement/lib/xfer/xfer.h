@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef XFER_H_
+#define XFER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Framed binary file transfer over a byte stream (the USB shell, or a pty on the host).
+ *
+ * Every frame is [type][seq][payload...][crc32], COBS-encoded and wrapped in 0x00 delimiters, so
+ * a receiver can always find the start of the next frame, and text that sneaks into the stream
+ * (the shell echoing the command, say) is discarded as a bad frame.
+ *
+ * The sender streams DATA frames of up to XFER_CHUNK_SIZE bytes with 8-bit sequence numbers and up
+ * to XFER_WINDOW frames in flight. The receiver acknowledges cumulatively (ACK carries the next
+ * sequence number it expects) and only accepts frames in order; when an ACK doesn't show up in time,
+ * the sender goes back to the oldest unacknowledged frame. Since data frames are fixed-size, the
+ * sender never buffers what it sent: it reads it again from the source. An END frame carries the
+ * total size and CRC32 of the file, and the receiver acknowledges it only if both match.
+ *
+ * The watch side opens the exchange with a HELLO frame (file size for get, free space for put),
+ * or an ABORT frame with a reason if it can't go ahead.
+ */
+
+#define XFER_CHUNK_SIZE 128
+#define XFER_WINDOW 8
+#define XFER_ACK_TIMEOUT_MS 250
+#define XFER_IDLE_TIMEOUT_MS 3000
+#define XFER_LINGER_MS 300
+#define XFER_MAX_RETRIES 8
+
+// type + seq + payload + crc32
+#define XFER_MAX_FRAME (2 + XFER_CHUNK_SIZE + 4)
+// COBS adds one byte per 254, plus one
+#define XFER_MAX_ENCODED (XFER_MAX_FRAME + XFER_MAX_FRAME / 254 + 1)
+
+typedef enum {
+    XFER_FRAME_HELLO = 'H',
+    XFER_FRAME_DATA = 'D',
+    XFER_FRAME_ACK = 'A',
+    XFER_FRAME_END = 'E',
+    XFER_FRAME_ABORT = 'X',
+} xfer_frame_type_t;
+
+typedef enum {
+    XFER_OK = 0,
+    XFER_ERR_TIMEOUT,   ///< The other end stopped responding
+    XFER_ERR_ABORTED,   ///< The other end sent ABORT; see peer_error
+    XFER_ERR_IO,        ///< Our source or sink failed
+    XFER_ERR_CHECKSUM,  ///< The received file didn't match the sender's size and CRC
+} xfer_result_t;
+
+typedef struct {
+    /// Reads up to len bytes, waiting at most timeout_ms for the first one. Returns the number of bytes read, 0 on timeout.
+    int32_t (*read)(void *context, uint8_t *buf, uint16_t len, uint16_t timeout_ms);
+    /// Writes len bytes.
+    void (*write)(void *context, const uint8_t *buf, uint16_t len);
+    void *context;
+} xfer_io_t;
+
+/// Reads len bytes at offset from the file being sent. Returns the number of bytes read.
+typedef int32_t (*xfer_source_t)(void *context, uint32_t offset, uint8_t *buf, uint16_t len);
+/// Appends len bytes to the file being received. Returns false on failure.
+typedef bool (*xfer_sink_t)(void *context, const uint8_t *buf, uint16_t len);
+
+typedef struct {
+    uint8_t type;
+    uint8_t seq;
+    const uint8_t *payload;
+    uint16_t len;
+} xfer_frame_t;
+
+typedef struct {
+    uint32_t frames_sent;
+    uint32_t frames_received;
+    uint32_t bad_frames;
+    uint32_t retransmits;
+} xfer_stats_t;
+
+typedef struct {
+    xfer_io_t io;
+    uint8_t in[64];
+    uint8_t in_pos;
+    uint8_t in_len;
+    uint8_t rx[XFER_MAX_ENCODED];
+    uint16_t rx_len;
+    bool rx_overflow;
+    uint8_t frame[XFER_MAX_FRAME];
+    uint8_t tx[XFER_MAX_ENCODED + 2];
+    char peer_error[33];
+    xfer_stats_t stats;
+} xfer_t;
+
+void xfer_init(xfer_t *x, const xfer_io_t *io);
+
+/// Sends HELLO, with a value that depends on the command: the file size for get, free space for put.
+void xfer_send_hello(xfer_t *x, uint32_t value);
+/// Waits for HELLO from the other end, skipping anything else. ABORT ends the wait with XFER_ERR_ABORTED.
+xfer_result_t xfer_wait_hello(xfer_t *x, uint32_t *value, uint16_t timeout_ms);
+/// Tells the other end to give up, with a short reason.
+void xfer_abort(xfer_t *x, const char *reason);
+
+/// Sends size bytes from source. Returns once the receiver has acknowledged the END frame.
+xfer_result_t xfer_send(xfer_t *x, xfer_source_t source, void *context, uint32_t size);
+/// Receives a file into sink. Returns once END has been received and checked.
+xfer_result_t xfer_receive(xfer_t *x, xfer_sink_t sink, void *context, uint32_t *size);
+
+/// Sends one frame. Exposed for tests and tools; xfer_send and xfer_receive do this for you.
+void xfer_send_frame(xfer_t *x, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len);
+/// Reads the next good frame, skipping corrupt ones. Returns false on timeout.
+bool xfer_read_frame(xfer_t *x, xfer_frame_t *frame, uint16_t timeout_ms);
+
+uint16_t xfer_cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dst);
+/// Returns the decoded length, or -1 if the input isn't valid COBS or doesn't fit in max_len.
+int32_t xfer_cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dst, uint16_t max_len);
+/// CRC-32 (IEEE 802.3). Start with crc = 0 and feed data in as many pieces as you like.
+uint32_t xfer_crc32_update(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#endif // XFER_H_
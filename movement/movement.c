@@ -32,6 +32,9 @@
 #include <stdio.h>
 #include "watch.h"
 #include "filesystem.h"
+#include "kvlog.h"
+#include "hibernate.h"
+#include "entropy.h"
 #include "movement.h"
 #include "shell.h"
 
@@ -56,6 +59,7 @@
 #endif
 
 #include "movement_custom_signal_tunes.h"
+#include "movement_arena.h"
 
 // Default to no secondary face behaviour.
 #ifndef MOVEMENT_SECONDARY_FACE_INDEX
@@ -95,61 +99,59 @@
 #define MOVEMENT_DEFAULT_LED_DURATION 1
 #endif
 
+// Default to never hibernating on our own
+#ifndef MOVEMENT_HIBERNATE_DAYS
+#define MOVEMENT_HIBERNATE_DAYS 0
+#endif
+
+#ifndef MOVEMENT_KV
+#define MOVEMENT_KV 0
+#endif
+
+#ifndef MOVEMENT_LOW_POWER_IDLE
+#define MOVEMENT_LOW_POWER_IDLE 0
+#endif
+
 #if __EMSCRIPTEN__
+#include <assert.h>
 #include <emscripten.h>
 #endif
 
+// how far along each face is with its setup; see _movement_set_up_face.
+typedef enum {
+    MOVEMENT_FACE_NOT_SET_UP = 0,
+    MOVEMENT_FACE_NEEDS_RESUME,
+    MOVEMENT_FACE_SET_UP,
+} movement_face_setup_state_t;
+
 movement_state_t movement_state;
 void * watch_face_contexts[MOVEMENT_NUM_FACES];
 watch_date_time scheduled_tasks[MOVEMENT_NUM_FACES];
+facestats_t movement_face_stats[MOVEMENT_NUM_FACES];
+static uint8_t face_setup_states[MOVEMENT_NUM_FACES];
+static uint32_t movement_boot_started;
+static uint32_t movement_boot_time;
+movement_arena_t movement_arena;
+static const size_t movement_arena_offsets[] = MOVEMENT_ARENA_OFFSETS;
+static const size_t movement_arena_sizes[] = MOVEMENT_ARENA_SIZES;
+
+_Static_assert(sizeof(movement_arena_sizes) / sizeof(size_t) == MOVEMENT_NUM_FACES, "movement_arena_faces.h is out of date; rebuild it from the face list");
+
+// Backup registers 4 through 7 are for faces. The ones a face declares with <face>_backup_registers are set
+// aside for it by face index, so it gets the same ones after a reset whichever face happens to be set up
+// first; the registers keep their values through a reset, but the faces' record of which is theirs doesn't.
+#define MOVEMENT_FIRST_FACE_BACKUP_REGISTER 4
+#define MOVEMENT_FACE_BACKUP_REGISTERS(index, face) face##_backup_registers,
+#define MOVEMENT_FACE_BACKUP_REGISTERS_SUM(index, face) + face##_backup_registers
+static const uint8_t movement_face_backup_registers[] = { MOVEMENT_ARENA_FACES(MOVEMENT_FACE_BACKUP_REGISTERS) };
+_Static_assert(MOVEMENT_FIRST_FACE_BACKUP_REGISTER MOVEMENT_ARENA_FACES(MOVEMENT_FACE_BACKUP_REGISTERS_SUM) <= 8, "the faces in this firmware declare more backup registers than there are");
+static uint8_t movement_face_backup_registers_claimed[MOVEMENT_NUM_FACES];
+// the face whose setup is running, so movement_claim_backup_register knows whose registers to hand out
+static uint8_t movement_face_in_setup = MOVEMENT_NUM_FACES;
 const int32_t movement_le_inactivity_deadlines[8] = {INT_MAX, 600, 3600, 7200, 21600, 43200, 86400, 604800};
 const int16_t movement_timeout_inactivity_deadlines[4] = {60, 120, 300, 1800};
 movement_event_t event;
 
-const int16_t movement_timezone_offsets[] = {
-    0,      //  0 :   0:00:00 (UTC)
-    60,     //  1 :   1:00:00 (Central European Time)
-    120,    //  2 :   2:00:00 (South African Standard Time)
-    180,    //  3 :   3:00:00 (Arabia Standard Time)
-    210,    //  4 :   3:30:00 (Iran Standard Time)
-    240,    //  5 :   4:00:00 (Georgia Standard Time)
-    270,    //  6 :   4:30:00 (Afghanistan Time)
-    300,    //  7 :   5:00:00 (Pakistan Standard Time)
-    330,    //  8 :   5:30:00 (Indian Standard Time)
-    345,    //  9 :   5:45:00 (Nepal Time)
-    360,    // 10 :   6:00:00 (Kyrgyzstan time)
-    390,    // 11 :   6:30:00 (Myanmar Time)
-    420,    // 12 :   7:00:00 (Thailand Standard Time)
-    480,    // 13 :   8:00:00 (China Standard Time, Australian Western Standard Time)
-    525,    // 14 :   8:45:00 (Australian Central Western Standard Time)
-    540,    // 15 :   9:00:00 (Japan Standard Time, Korea Standard Time)
-    570,    // 16 :   9:30:00 (Australian Central Standard Time)
-    600,    // 17 :  10:00:00 (Australian Eastern Standard Time)
-    630,    // 18 :  10:30:00 (Lord Howe Standard Time)
-    660,    // 19 :  11:00:00 (Solomon Islands Time)
-    720,    // 20 :  12:00:00 (New Zealand Standard Time)
-    765,    // 21 :  12:45:00 (Chatham Standard Time)
-    780,    // 22 :  13:00:00 (Tonga Time)
-    825,    // 23 :  13:45:00 (Chatham Daylight Time)
-    840,    // 24 :  14:00:00 (Line Islands Time)
-    -720,   // 25 : -12:00:00 (Baker Island Time)
-    -660,   // 26 : -11:00:00 (Niue Time)
-    -600,   // 27 : -10:00:00 (Hawaii-Aleutian Standard Time)
-    -570,   // 28 :  -9:30:00 (Marquesas Islands Time)
-    -540,   // 29 :  -9:00:00 (Alaska Standard Time)
-    -480,   // 30 :  -8:00:00 (Pacific Standard Time)
-    -420,   // 31 :  -7:00:00 (Mountain Standard Time)
-    -360,   // 32 :  -6:00:00 (Central Standard Time)
-    -300,   // 33 :  -5:00:00 (Eastern Standard Time)
-    -270,   // 34 :  -4:30:00 (Venezuelan Standard Time)
-    -240,   // 35 :  -4:00:00 (Atlantic Standard Time)
-    -210,   // 36 :  -3:30:00 (Newfoundland Standard Time)
-    -180,   // 37 :  -3:00:00 (Brasilia Time)
-    -150,   // 38 :  -2:30:00 (Newfoundland Daylight Time)
-    -120,   // 39 :  -2:00:00 (Fernando de Noronha Time)
-    -60,    // 40 :  -1:00:00 (Azores Standard Time)
-};
-
 const char movement_valid_position_0_chars[] = " AaBbCcDdEeFGgHhIiJKLMNnOoPQrSTtUuWXYZ-='+\\/0123456789";
 const char movement_valid_position_1_chars[] = " ABCDEFHlJLNORTtUX-='01378";
 
@@ -159,8 +161,101 @@ void cb_alarm_btn_interrupt(void);
 void cb_alarm_btn_extwake(void);
 void cb_alarm_fired(void);
 void cb_fast_tick(void);
+void cb_long_press(void);
 void cb_tick(void);
 
+#if MOVEMENT_KV
+// Settings values that faces store with movement_kv_put, and the file that backs them.
+static kvlog_t movement_kv;
+static const kvlog_io_t movement_kv_io = {
+    .read_chunks = filesystem_read_chunks,
+    .append = filesystem_append_file,
+    .write = filesystem_write_file,
+    .rename = filesystem_rename,
+};
+#endif
+
+// Faces whose contexts live in the arena are saved here while the watch hibernates; see movement_hibernate.
+#define MOVEMENT_HIBERNATE_FILE "hibernate.bin"
+static const hibernate_io_t movement_hibernate_io = {
+    .write = filesystem_write_file,
+    .append = filesystem_append_file,
+    .read_at = filesystem_read_file_at,
+    .rm = filesystem_rm,
+};
+static bool movement_woke_from_backup = false;
+
+// Random numbers for faces come from a generator seeded from the TRNG. A pool of TRNG words is refilled in
+// the background after each use, and mixed in once the generator has handed out enough words since the last.
+#define MOVEMENT_ENTROPY_RESEED_WORDS 1024
+static entropy_t movement_entropy;
+static uint32_t movement_entropy_pool[ENTROPY_SEED_WORDS];
+static volatile bool movement_entropy_pool_full = false;
+static bool movement_entropy_seeded = false;
+
+// The time as of the last tick, shared by every face; see movement_get_now.
+static movement_now_t movement_now;
+
+// The wearer's time zone's offset, and the span of UTC time it holds for. The tick only compares against
+// the span; tzdb is consulted, outside the interrupt, when the zone changes, the clock is set, or a DST
+// transition comes round.
+static tzdb_span_t movement_tz_span;
+static uint8_t movement_tz_zone = 0xFF;
+
+static void _movement_resolve_timezone(watch_date_time local) {
+    uint8_t zone = movement_state.settings.bit.time_zone;
+    uint32_t local_timestamp = watch_utility_date_time_to_unix_time(local, 0);
+    int16_t offset = tzdb_offset_for_local(zone, local_timestamp);
+
+    tzdb_lookup(zone, local_timestamp - offset * 60, &movement_tz_span);
+    if (movement_tz_span.offset != offset) {
+        // the local time fell in the hour skipped when clocks go forward; ending the span at the transition
+        // makes the next update move the clock past it
+        movement_tz_span.end = movement_tz_span.start;
+        movement_tz_span.start = 0;
+        movement_tz_span.offset = offset;
+    }
+    movement_tz_zone = zone;
+}
+
+static void _movement_update_now(watch_date_time date_time) {
+    if (movement_tz_zone != movement_state.settings.bit.time_zone) _movement_resolve_timezone(date_time);
+    watch_utility_clock_update(&movement_now, date_time, movement_tz_span.offset * 60);
+
+    if (movement_now.timestamp >= movement_tz_span.end) {
+        // the clock ran (or slept) into a DST transition: move the RTC to the new local time
+        tzdb_lookup(movement_tz_zone, movement_now.timestamp, &movement_tz_span);
+        date_time = watch_utility_date_time_from_unix_time(movement_now.timestamp, movement_tz_span.offset * 60);
+        watch_rtc_set_date_time(date_time);
+        watch_utility_clock_update(&movement_now, date_time, movement_tz_span.offset * 60);
+    } else if (movement_now.timestamp < movement_tz_span.start) {
+        // the RTC was set back behind Movement's back
+        _movement_resolve_timezone(date_time);
+        watch_utility_clock_update(&movement_now, date_time, movement_tz_span.offset * 60);
+    }
+}
+
+// The tick's share of _movement_update_now, cheap enough for the RTC interrupt: moves movement_now along within
+// the current span, and leaves anything that needs tzdb or the RTC to app_loop.
+static void _movement_tick_now(watch_date_time date_time) {
+    watch_utility_clock_update(&movement_now, date_time, movement_tz_span.offset * 60);
+    if (movement_tz_zone != movement_state.settings.bit.time_zone ||
+        movement_now.timestamp >= movement_tz_span.end || movement_now.timestamp < movement_tz_span.start) {
+        movement_state.needs_timezone_update = true;
+    }
+}
+
+#if __EMSCRIPTEN__
+// On ticks, faces have the time in movement_get_now; in the simulator, stop at any face that reads the RTC anyway.
+static void _movement_check_face_rtc_reads(uint32_t reads_before, movement_event_type_t event_type) {
+    if (event_type != EVENT_TICK && event_type != EVENT_LOW_ENERGY_UPDATE) return;
+    if (watch_rtc_get_uncached_read_count() != reads_before) {
+        printf("Face %d read the RTC on a tick; use movement_get_now() instead.\n", movement_state.current_face_idx);
+    }
+    assert(watch_rtc_get_uncached_read_count() == reads_before);
+}
+#endif
+
 static inline void _movement_reset_inactivity_countdown(void) {
     movement_state.le_mode_ticks = movement_le_inactivity_deadlines[movement_state.settings.bit.le_interval];
     movement_state.timeout_ticks = movement_timeout_inactivity_deadlines[movement_state.settings.bit.to_interval];
@@ -176,35 +271,66 @@ static inline void _movement_enable_fast_tick_if_needed(void) {
 
 static inline void _movement_disable_fast_tick_if_possible(void) {
     if ((movement_state.light_ticks == -1) &&
-        (movement_state.alarm_ticks == -1) &&
-        ((movement_state.light_down_timestamp + movement_state.mode_down_timestamp + movement_state.alarm_down_timestamp) == 0)) {
+        (movement_state.alarm_ticks == -1)) {
         movement_state.fast_tick_enabled = false;
         watch_rtc_disable_periodic_callback(128);
     }
 }
 
+// Calls a face's setup if it's due: the first time Movement needs the face, which is its init, and the first time
+// Movement needs it awake after sleep mode, which is its resume. Faces nobody visits never pay for either. In low
+// energy mode only init is due, since a resume may turn back on the peripherals that sleep mode turned off.
+static void _movement_set_up_face(uint8_t face_idx) {
+    if (face_setup_states[face_idx] == MOVEMENT_FACE_SET_UP) return;
+    if (face_setup_states[face_idx] == MOVEMENT_FACE_NEEDS_RESUME && movement_state.le_mode_ticks == -1) return;
+    movement_face_in_setup = face_idx;
+    watch_faces[face_idx].setup(&movement_state.settings, face_idx, &watch_face_contexts[face_idx]);
+    movement_face_in_setup = MOVEMENT_NUM_FACES;
+    face_setup_states[face_idx] = MOVEMENT_FACE_SET_UP;
+}
+
+// Calls a face's loop, and charges the time it took to that face.
+static bool _movement_call_loop(uint8_t face_idx, movement_event_t loop_event) {
+    uint32_t start = watch_get_active_time();
+    bool can_sleep = watch_faces[face_idx].loop(loop_event, &movement_state.settings, watch_face_contexts[face_idx]);
+    uint32_t elapsed = watch_get_active_time() - start;
+
+    if (loop_event.event_type == EVENT_BACKGROUND_TASK) facestats_record_background(&movement_face_stats[face_idx], elapsed, true);
+    else facestats_record_loop(&movement_face_stats[face_idx], elapsed);
+
+    return can_sleep;
+}
+
 static void _movement_handle_background_tasks(void) {
+    // the minute alarm can fire before the tick that would have updated the clock, and ticks are off in low energy mode
+    _movement_update_now(watch_rtc_get_cached_date_time());
     for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
         // For each face, if the watch face wants a background task...
-        if (watch_faces[i].wants_background_task != NULL && watch_faces[i].wants_background_task(&movement_state.settings, watch_face_contexts[i])) {
+        if (watch_faces[i].wants_background_task == NULL) continue;
+        _movement_set_up_face(i);
+        uint32_t start = watch_get_active_time();
+        bool wants_background_task = watch_faces[i].wants_background_task(&movement_state.settings, watch_face_contexts[i]);
+        facestats_record_background(&movement_face_stats[i], watch_get_active_time() - start, false);
+        if (wants_background_task) {
             // ...we give it one. pretty straightforward!
             movement_event_t background_event = { EVENT_BACKGROUND_TASK, 0 };
-            watch_faces[i].loop(background_event, &movement_state.settings, watch_face_contexts[i]);
+            _movement_call_loop(i, background_event);
         }
     }
     movement_state.needs_background_tasks_handled = false;
 }
 
 static void _movement_handle_scheduled_tasks(void) {
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_now.local;
     uint8_t num_active_tasks = 0;
 
     for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
         if (scheduled_tasks[i].reg) {
             if (scheduled_tasks[i].reg == date_time.reg) {
                 scheduled_tasks[i].reg = 0;
+                _movement_set_up_face(i);
                 movement_event_t background_event = { EVENT_BACKGROUND_TASK, 0 };
-                watch_faces[i].loop(background_event, &movement_state.settings, watch_face_contexts[i]);
+                _movement_call_loop(i, background_event);
                 // check if loop scheduled a new task
                 if (scheduled_tasks[i].reg) {
                     num_active_tasks++;
@@ -238,6 +364,40 @@ void movement_request_tick_frequency(uint8_t freq) {
     watch_rtc_register_periodic_callback(cb_tick, freq);
 }
 
+void movement_request_performance_level(movement_performance_level_t level) {
+#if !MOVEMENT_LOW_POWER_IDLE
+    // stay at PL2, as the watch always has, unless PL0 was asked for in movement_config.h
+    if (level == MOVEMENT_PERFORMANCE_LOW) level = MOVEMENT_PERFORMANCE_NORMAL;
+#endif
+    watch_set_performance_level((watch_performance_level_t)level);
+}
+
+uint8_t movement_get_num_faces(void) {
+    return MOVEMENT_NUM_FACES;
+}
+
+void *movement_get_context_slot(uint8_t watch_face_index) {
+    if (watch_face_index >= MOVEMENT_NUM_FACES || movement_arena_sizes[watch_face_index] == 0) return NULL;
+    return (uint8_t *)&movement_arena + movement_arena_offsets[watch_face_index];
+}
+
+size_t movement_get_arena_size(void) {
+    return sizeof(movement_arena_t);
+}
+
+const facestats_t *movement_get_face_stats(uint8_t face_idx) {
+    if (face_idx >= MOVEMENT_NUM_FACES) return NULL;
+    return &movement_face_stats[face_idx];
+}
+
+uint32_t movement_get_boot_time(void) {
+    return movement_boot_time;
+}
+
+void movement_reset_face_stats(void) {
+    memset(movement_face_stats, 0, sizeof(movement_face_stats));
+}
+
 void movement_illuminate_led(void) {
     if (movement_state.settings.bit.led_duration) {
         watch_set_led_color(movement_state.settings.bit.led_red_color ? (0xF | movement_state.settings.bit.led_red_color << 4) : 0,
@@ -295,7 +455,7 @@ void movement_cancel_background_task(void) {
 }
 
 void movement_schedule_background_task_for_face(uint8_t watch_face_index, watch_date_time date_time) {
-    watch_date_time now = watch_rtc_get_date_time();
+    watch_date_time now = watch_rtc_get_cached_date_time();
     if (date_time.reg > now.reg) {
         movement_state.has_scheduled_background_task = true;
         scheduled_tasks[watch_face_index].reg = date_time.reg;
@@ -361,12 +521,108 @@ void movement_play_alarm_beeps(uint8_t rounds, BuzzerNote alarm_note) {
     _movement_enable_fast_tick_if_needed();
 }
 
+#if MOVEMENT_KV
+int32_t movement_kv_get(const char *key, void *value, uint8_t size) {
+    return kvlog_get(&movement_kv, key, value, size);
+}
+
+bool movement_kv_put(const char *key, const void *value, uint8_t size) {
+    if (!kvlog_put(&movement_kv, key, value, size)) return false;
+    if (kvlog_is_dirty(&movement_kv) && movement_state.kv_flush_ticks == -1) {
+        movement_state.kv_flush_ticks = MOVEMENT_KV_FLUSH_DELAY;
+    }
+
+    return true;
+}
+
+bool movement_kv_flush(void) {
+    if (!kvlog_flush(&movement_kv)) {
+        // try again later rather than on every pass through the loop
+        movement_state.kv_flush_ticks = MOVEMENT_KV_FLUSH_DELAY;
+        return false;
+    }
+    movement_state.kv_flush_ticks = -1;
+
+    return true;
+}
+#else
+// without movement_kv_put there is never anything waiting to be written
+bool movement_kv_flush(void) {
+    return true;
+}
+#endif
+
+static void cb_entropy_pool_full(void) {
+    movement_entropy_pool_full = true;
+}
+
+static entropy_t *_movement_entropy(void) {
+    if (!movement_entropy_seeded) {
+        // the first time, there's nothing to hand out until the TRNG has had its say
+        if (!movement_entropy_pool_full) watch_trng_read(movement_entropy_pool, ENTROPY_SEED_WORDS);
+        entropy_seed(&movement_entropy, movement_entropy_pool);
+        movement_entropy_seeded = true;
+    } else if (movement_entropy_pool_full && movement_entropy.words_since_reseed >= MOVEMENT_ENTROPY_RESEED_WORDS) {
+        entropy_reseed(&movement_entropy, movement_entropy_pool);
+    } else {
+        return &movement_entropy;
+    }
+
+    // the pool has been used; wipe it and start filling it again
+    memset(movement_entropy_pool, 0, sizeof(movement_entropy_pool));
+    movement_entropy_pool_full = false;
+    watch_trng_fill(movement_entropy_pool, ENTROPY_SEED_WORDS, cb_entropy_pool_full);
+
+    return &movement_entropy;
+}
+
+uint32_t movement_random_uniform(uint32_t upper_bound) {
+    return entropy_uniform(_movement_entropy(), upper_bound);
+}
+
+void movement_random_bytes(void *buf, size_t len) {
+    entropy_bytes(_movement_entropy(), buf, len);
+}
+
+const movement_now_t *movement_get_now(void) {
+    return &movement_now;
+}
+
+int32_t movement_get_current_timezone_offset(void) {
+    // the wearer may have just picked another zone; the RTC's local time stays put either way
+    if (movement_tz_zone != movement_state.settings.bit.time_zone) _movement_resolve_timezone(movement_now.local);
+    return movement_tz_span.offset * 60;
+}
+
+int32_t movement_get_current_timezone_offset_for_zone(uint8_t zone_index) {
+    if (zone_index == movement_state.settings.bit.time_zone) return movement_get_current_timezone_offset();
+    return tzdb_offset_at(zone_index, movement_now.timestamp) * 60;
+}
+
+void movement_set_local_date_time(watch_date_time date_time) {
+    watch_rtc_set_date_time(date_time);
+    _movement_resolve_timezone(date_time);
+    _movement_update_now(date_time);
+}
+
 uint8_t movement_claim_backup_register(void) {
+    uint8_t face_idx = movement_face_in_setup;
+    if (face_idx < MOVEMENT_NUM_FACES && movement_face_backup_registers_claimed[face_idx] < movement_face_backup_registers[face_idx]) {
+        uint8_t backup_register = MOVEMENT_FIRST_FACE_BACKUP_REGISTER;
+        for (uint8_t i = 0; i < face_idx; i++) backup_register += movement_face_backup_registers[i];
+        return backup_register + movement_face_backup_registers_claimed[face_idx]++;
+    }
+
+    // faces that didn't declare theirs share what's left, in the order they ask.
     if (movement_state.next_available_backup_register >= 8) return 0;
     return movement_state.next_available_backup_register++;
 }
 
 void app_init(void) {
+    // start counting active time first, so that the boot time counts everything Movement does.
+    watch_enable_active_time();
+    movement_boot_started = watch_get_active_time();
+
 #if defined(NO_FREQCORR)
     watch_rtc_freqcorr_write(0, 0);
 #elif defined(WATCH_IS_BLUE_BOARD)
@@ -386,17 +642,22 @@ void app_init(void) {
     movement_state.settings.bit.led_duration = MOVEMENT_DEFAULT_LED_DURATION;
     movement_state.light_ticks = -1;
     movement_state.alarm_ticks = -1;
-    movement_state.next_available_backup_register = 4;
+    movement_state.next_available_backup_register = MOVEMENT_FIRST_FACE_BACKUP_REGISTER;
+    for (uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) movement_state.next_available_backup_register += movement_face_backup_registers[i];
+    movement_state.kv_flush_ticks = -1;
     _movement_reset_inactivity_countdown();
 
     filesystem_init();
+#if MOVEMENT_KV
+    kvlog_init(&movement_kv, &movement_kv_io, "settings.kv");
+#endif
 
 #if __EMSCRIPTEN__
     int32_t time_zone_offset = EM_ASM_INT({
         return -new Date().getTimezoneOffset();
     });
-    for (int i = 0, count = sizeof(movement_timezone_offsets) / sizeof(movement_timezone_offsets[0]); i < count; i++) {
-        if (movement_timezone_offsets[i] == time_zone_offset) {
+    for (uint8_t i = 0; i < TZDB_FIRST_RULE_ZONE; i++) {
+        if (tzdb_offset_at(i, 0) == time_zone_offset) {
             movement_state.settings.bit.time_zone = i;
             break;
         }
@@ -406,10 +667,90 @@ void app_init(void) {
 
 void app_wake_from_backup(void) {
     movement_state.settings.reg = watch_get_backup_data(0);
+    movement_woke_from_backup = true;
+}
+
+// set up the 1 minute alarm (for background tasks and low power updates)
+static void _movement_register_minute_alarm(void) {
+    watch_date_time alarm_time;
+    alarm_time.reg = 0;
+    alarm_time.unit.second = 59; // after a match, the alarm fires at the next rising edge of CLK_RTC_CNT, so 59 seconds lets us update at :00
+    watch_rtc_register_alarm_callback(cb_alarm_fired, alarm_time, ALARM_MATCH_SS);
+}
+
+static uint32_t _movement_arena_layout(void) {
+    return hibernate_layout(movement_arena_offsets, movement_arena_sizes, MOVEMENT_NUM_FACES);
+}
+
+void movement_hibernate(void) {
+    // scheduled tasks aren't part of the snapshot, and nothing would wake the watch to run them anyway.
+    if (movement_state.has_scheduled_background_task) return;
+    // nor is the timestamp tick counter, which stops in backup mode; a face that's timing something needs it.
+    if (watch_rtc_timestamp_ticks_enabled()) return;
+
+    uint8_t saved[MOVEMENT_NUM_FACES];
+    for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
+        // only contexts in the arena come through; a face that was never set up has nothing to save.
+        saved[i] = face_setup_states[i] != MOVEMENT_FACE_NOT_SET_UP && watch_face_contexts[i] != NULL &&
+                   watch_face_contexts[i] == movement_get_context_slot(i);
+    }
+    hibernate_header_t header = {
+        .layout = _movement_arena_layout(),
+        .arena_size = sizeof(movement_arena),
+        .num_faces = MOVEMENT_NUM_FACES,
+        .current_face_idx = movement_state.current_face_idx,
+        .next_backup_register = movement_state.next_available_backup_register,
+    };
+
+    movement_kv_flush();
+    if (!hibernate_save(&movement_hibernate_io, MOVEMENT_HIBERNATE_FILE, &header, saved, &movement_arena)) {
+        // better to stay awake than to lose everything; don't leave half a snapshot lying around, either.
+        if (filesystem_file_exists(MOVEMENT_HIBERNATE_FILE)) filesystem_rm(MOVEMENT_HIBERNATE_FILE);
+        return;
+    }
+    watch_store_backup_data(movement_state.settings.reg, 0);
+
+    // only the ALARM button wakes us. the minute alarm would just reboot the watch every minute.
+    watch_rtc_disable_alarm_callback();
+    watch_register_extwake_callback(BTN_ALARM, cb_alarm_btn_extwake, true);
+    watch_enter_backup_mode();
+
+    // waking from backup mode is a reset, so only the simulator, which has no backup mode, gets here.
+    // carry on as if nothing happened, and don't try again until another stretch of low energy mode.
+    filesystem_rm(MOVEMENT_HIBERNATE_FILE);
+    _movement_register_minute_alarm();
+    movement_state.le_mode_started = movement_now.timestamp;
+}
+
+// Picks up where movement_hibernate left off. Only a wake from backup mode restores a snapshot: after a power loss
+// the time is gone, and with it the sense of any timer or log the faces were keeping, so the snapshot goes too.
+static void _movement_wake_from_hibernation(void) {
+    if (!movement_woke_from_backup) {
+        if (filesystem_file_exists(MOVEMENT_HIBERNATE_FILE)) filesystem_rm(MOVEMENT_HIBERNATE_FILE);
+        return;
+    }
+
+    hibernate_header_t header;
+    uint8_t saved[MOVEMENT_NUM_FACES];
+    if (!hibernate_restore(&movement_hibernate_io, MOVEMENT_HIBERNATE_FILE, &header, _movement_arena_layout(),
+                           MOVEMENT_NUM_FACES, sizeof(movement_arena), saved, &movement_arena)) return;
+
+    for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
+        if (!saved[i] || movement_get_context_slot(i) == NULL) continue;
+        // setup will see the restored context, so the face resumes rather than starting over.
+        watch_face_contexts[i] = movement_get_context_slot(i);
+        face_setup_states[i] = MOVEMENT_FACE_NEEDS_RESUME;
+    }
+    if (header.current_face_idx < MOVEMENT_NUM_FACES) movement_state.current_face_idx = header.current_face_idx;
+    if (header.next_backup_register > movement_state.next_available_backup_register) {
+        movement_state.next_available_backup_register = header.next_backup_register;
+    }
 }
 
 void app_setup(void) {
     watch_store_backup_data(movement_state.settings.reg, 0);
+    movement_request_performance_level(MOVEMENT_PERFORMANCE_LOW);
+    _movement_update_now(watch_rtc_get_date_time());
 
     static bool is_first_launch = true;
 
@@ -424,11 +765,8 @@ void app_setup(void) {
             is_first_launch = false;
         }
 
-        // set up the 1 minute alarm (for background tasks and low power updates)
-        watch_date_time alarm_time;
-        alarm_time.reg = 0;
-        alarm_time.unit.second = 59; // after a match, the alarm fires at the next rising edge of CLK_RTC_CNT, so 59 seconds lets us update at :00
-        watch_rtc_register_alarm_callback(cb_alarm_fired, alarm_time, ALARM_MATCH_SS);
+        _movement_wake_from_hibernation();
+        _movement_register_minute_alarm();
     }
     if (movement_state.le_mode_ticks != -1) {
         watch_disable_extwake_interrupt(BTN_ALARM);
@@ -444,10 +782,8 @@ void app_setup(void) {
 
         movement_request_tick_frequency(1);
 
-        for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
-            watch_faces[i].setup(&movement_state.settings, i, &watch_face_contexts[i]);
-        }
-
+        // the other faces get set up when they're first needed; see _movement_set_up_face.
+        _movement_set_up_face(movement_state.current_face_idx);
         watch_faces[movement_state.current_face_idx].activate(&movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
         event.subsecond = 0;
         event.event_type = EVENT_ACTIVATE;
@@ -466,9 +802,23 @@ static void _sleep_mode_app_loop(void) {
     while (movement_state.le_mode_ticks == -1) {
         // we also have to handle background tasks here in the mini-runloop
         if (movement_state.needs_background_tasks_handled) _movement_handle_background_tasks();
+        else _movement_update_now(watch_rtc_get_cached_date_time());
 
         event.event_type = EVENT_LOW_ENERGY_UPDATE;
-        watch_faces[movement_state.current_face_idx].loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+#if __EMSCRIPTEN__
+        uint32_t rtc_reads = watch_rtc_get_uncached_read_count();
+#endif
+        _movement_call_loop(movement_state.current_face_idx, event);
+#if __EMSCRIPTEN__
+        _movement_check_face_rtc_reads(rtc_reads, event.event_type);
+#endif
+
+#if MOVEMENT_HIBERNATE_DAYS
+        // after long enough in low energy mode, hibernate (unless a background task is scheduled; see movement_hibernate).
+        if (movement_now.timestamp - movement_state.le_mode_started >= MOVEMENT_HIBERNATE_DAYS * 86400UL) {
+            movement_hibernate();
+        }
+#endif
 
         // if we need to wake immediately, do it!
         if (movement_state.needs_wake) return;
@@ -480,6 +830,13 @@ static void _sleep_mode_app_loop(void) {
 bool app_loop(void) {
     const watch_face_t *wf = &watch_faces[movement_state.current_face_idx];
     bool woke_up_for_buzzer = false;
+
+    // the tick only noticed that the time zone needs another look; take it here, before any face sees the time
+    if (movement_state.needs_timezone_update) {
+        movement_state.needs_timezone_update = false;
+        _movement_update_now(watch_rtc_get_cached_date_time());
+    }
+
     if (movement_state.watch_face_changed) {
         if (movement_state.settings.bit.button_should_sound) {
             // low note for nonzero case, high note for return to watch_face 0
@@ -489,8 +846,10 @@ bool app_loop(void) {
         movement_state.current_face_idx = movement_state.next_face_idx;
         // we have just updated the face idx, so we must recache the watch face pointer.
         wf = &watch_faces[movement_state.current_face_idx];
+        _movement_set_up_face(movement_state.current_face_idx);
         watch_clear_display();
         movement_request_tick_frequency(1);
+        movement_request_performance_level(MOVEMENT_PERFORMANCE_LOW);
         wf->activate(&movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
         event.subsecond = 0;
         event.event_type = EVENT_ACTIVATE;
@@ -515,9 +874,18 @@ bool app_loop(void) {
     // if we have a scheduled background task, handle that here:
     if (event.event_type == EVENT_TICK && movement_state.has_scheduled_background_task) _movement_handle_scheduled_tasks();
 
+    // write out settings that have been sitting in RAM for long enough
+    if (movement_state.kv_flush_ticks == 0) movement_kv_flush();
+
     // if we have timed out of our low energy mode countdown, enter low energy mode.
     if (movement_state.le_mode_ticks == 0) {
         movement_state.le_mode_ticks = -1;
+        movement_state.le_mode_started = movement_now.timestamp;
+        movement_kv_flush();
+        // sleep mode turns off every pin and peripheral, so each face that has been set up needs to resume.
+        for(uint8_t i = 0; i < MOVEMENT_NUM_FACES; i++) {
+            if (face_setup_states[i] == MOVEMENT_FACE_SET_UP) face_setup_states[i] = MOVEMENT_FACE_NEEDS_RESUME;
+        }
         watch_register_extwake_callback(BTN_ALARM, cb_alarm_btn_extwake, true);
         event.event_type = EVENT_NONE;
         event.subsecond = 0;
@@ -542,7 +910,21 @@ bool app_loop(void) {
     if (event.event_type) {
         event.subsecond = movement_state.subsecond;
         // the first trip through the loop overrides the can_sleep state
-        can_sleep = wf->loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+#if __EMSCRIPTEN__
+        uint32_t rtc_reads = watch_rtc_get_uncached_read_count();
+#endif
+        if (event.event_type == EVENT_TICK) facestats_record_tick(&movement_face_stats[movement_state.current_face_idx], movement_state.tick_frequency);
+        can_sleep = _movement_call_loop(movement_state.current_face_idx, event);
+#if __EMSCRIPTEN__
+        _movement_check_face_rtc_reads(rtc_reads, event.event_type);
+#endif
+        // the first event is the first face's activate, so this is when the first screen is up.
+        if (movement_boot_time == 0) {
+            movement_boot_time = watch_get_active_time() - movement_boot_started;
+#if __EMSCRIPTEN__
+            printf("Boot to first display took %lu us.\n", (unsigned long) movement_boot_time);
+#endif
+        }
         event.event_type = EVENT_NONE;
     }
 
@@ -561,7 +943,7 @@ bool app_loop(void) {
         // first trip  | can sleep | cannot sleep | can sleep    | cannot sleep
         // second trip | can sleep | cannot sleep | cannot sleep | can sleep
         //          && | can sleep | cannot sleep | cannot sleep | cannot sleep
-        bool can_sleep2 = wf->loop(event, &movement_state.settings, watch_face_contexts[movement_state.current_face_idx]);
+        bool can_sleep2 = _movement_call_loop(movement_state.current_face_idx, event);
         can_sleep = can_sleep && can_sleep2;
         event.event_type = EVENT_NONE;
         if (movement_state.settings.bit.to_always && movement_state.current_face_idx != 0) {
@@ -611,23 +993,64 @@ bool app_loop(void) {
     return can_sleep;
 }
 
-static movement_event_type_t _figure_out_button_event(bool pin_level, movement_event_type_t button_down_event_type, uint16_t *down_timestamp) {
+static uint32_t *const movement_down_timestamps[] = {
+    &movement_state.light_down_timestamp,
+    &movement_state.mode_down_timestamp,
+    &movement_state.alarm_down_timestamp,
+};
+static const movement_event_type_t movement_long_press_events[] = {
+    EVENT_LIGHT_LONG_PRESS,
+    EVENT_MODE_LONG_PRESS,
+    EVENT_ALARM_LONG_PRESS,
+};
+
+static bool _movement_any_button_down(void) {
+    return movement_state.light_down_timestamp || movement_state.mode_down_timestamp || movement_state.alarm_down_timestamp;
+}
+
+// Long presses used to be found by counting 128 Hz ticks for as long as a button was down. Now the timestamp
+// counter, which counts the RTC's 128 Hz event without the CPU, calls back when the earliest one is due.
+static void _movement_schedule_long_press(void) {
+    uint32_t next = 0;
+    bool found = false;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!(movement_state.long_press_pending & (1 << i))) continue;
+        uint32_t due = *movement_down_timestamps[i] + MOVEMENT_LONG_PRESS_TICKS + 1;
+        if (!found || (int32_t)(due - next) < 0) next = due;
+        found = true;
+    }
+
+    if (found) watch_rtc_register_timestamp_callback(cb_long_press, next);
+    else watch_rtc_disable_timestamp_callback();
+}
+
+static movement_event_type_t _figure_out_button_event(bool pin_level, movement_event_type_t button_down_event_type, uint8_t button) {
+    uint32_t *down_timestamp = movement_down_timestamps[button];
     // force alarm off if the user pressed a button.
     if (movement_state.alarm_ticks) movement_state.alarm_ticks = 0;
 
     if (pin_level) {
         // handle rising edge
-        _movement_enable_fast_tick_if_needed();
-        *down_timestamp = movement_state.fast_ticks + 1;
+        if (*down_timestamp == 0) {
+            if (!_movement_any_button_down()) watch_rtc_enable_timestamp_ticks();
+            *down_timestamp = watch_rtc_get_timestamp_ticks() + 1;
+            movement_state.long_press_pending |= 1 << button;
+            _movement_schedule_long_press();
+        }
         return button_down_event_type;
     } else {
         // this line is hack but it handles the situation where the light button was held for more than 20 seconds.
         // fast tick is disabled by then, and the LED would get stuck on since there's no one left decrementing light_ticks.
         if (movement_state.light_ticks == 1) movement_state.light_ticks = 0;
+        // a release without a press, say of a button held through a reset, is just a button up.
+        if (*down_timestamp == 0) return button_down_event_type + 1;
         // now that that's out of the way, handle falling edge
-        uint16_t diff = movement_state.fast_ticks - *down_timestamp;
+        uint32_t diff = watch_rtc_get_timestamp_ticks() - *down_timestamp;
         *down_timestamp = 0;
-        _movement_disable_fast_tick_if_possible();
+        movement_state.long_press_pending &= ~(1 << button);
+        _movement_schedule_long_press();
+        if (!_movement_any_button_down()) watch_rtc_disable_timestamp_ticks();
         // any press over a half second is considered a long press. Fire the long-up event
         if (diff > MOVEMENT_LONG_PRESS_TICKS) return button_down_event_type + 3;
         else return button_down_event_type + 1;
@@ -637,19 +1060,19 @@ static movement_event_type_t _figure_out_button_event(bool pin_level, movement_e
 void cb_light_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_LIGHT);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_LIGHT_BUTTON_DOWN, &movement_state.light_down_timestamp);
+    event.event_type = _figure_out_button_event(pin_level, EVENT_LIGHT_BUTTON_DOWN, 0);
 }
 
 void cb_mode_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_MODE);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_MODE_BUTTON_DOWN, &movement_state.mode_down_timestamp);
+    event.event_type = _figure_out_button_event(pin_level, EVENT_MODE_BUTTON_DOWN, 1);
 }
 
 void cb_alarm_btn_interrupt(void) {
     bool pin_level = watch_get_pin_level(BTN_ALARM);
     _movement_reset_inactivity_countdown();
-    event.event_type = _figure_out_button_event(pin_level, EVENT_ALARM_BUTTON_DOWN, &movement_state.alarm_down_timestamp);
+    event.event_type = _figure_out_button_event(pin_level, EVENT_ALARM_BUTTON_DOWN, 2);
 }
 
 void cb_alarm_btn_extwake(void) {
@@ -661,22 +1084,23 @@ void cb_alarm_fired(void) {
     movement_state.needs_background_tasks_handled = true;
 }
 
+void cb_long_press(void) {
+    uint32_t now = watch_rtc_get_timestamp_ticks();
+    // Notice: is it possible that two or more buttons have an identical timestamp? In this case
+    // only one of these buttons would receive the long press event. Don't bother for now...
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!(movement_state.long_press_pending & (1 << i))) continue;
+        if ((int32_t)(now - (*movement_down_timestamps[i] + MOVEMENT_LONG_PRESS_TICKS + 1)) < 0) continue;
+        movement_state.long_press_pending &= ~(1 << i);
+        event.event_type = movement_long_press_events[i];
+    }
+    _movement_schedule_long_press();
+}
+
 void cb_fast_tick(void) {
     movement_state.fast_ticks++;
     if (movement_state.light_ticks > 0) movement_state.light_ticks--;
     if (movement_state.alarm_ticks > 0) movement_state.alarm_ticks--;
-    // check timestamps and auto-fire the long-press events
-    // Notice: is it possible that two or more buttons have an identical timestamp? In this case
-    // only one of these buttons would receive the long press event. Don't bother for now...
-    if (movement_state.light_down_timestamp > 0)
-        if (movement_state.fast_ticks - movement_state.light_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_LIGHT_LONG_PRESS;
-    if (movement_state.mode_down_timestamp > 0)
-        if (movement_state.fast_ticks - movement_state.mode_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_MODE_LONG_PRESS;
-    if (movement_state.alarm_down_timestamp > 0)
-        if (movement_state.fast_ticks - movement_state.alarm_down_timestamp == MOVEMENT_LONG_PRESS_TICKS + 1)
-            event.event_type = EVENT_ALARM_LONG_PRESS;
     // this is just a fail-safe; fast tick should be disabled as soon as the button is up, the LED times out, and/or the alarm finishes.
     // but if for whatever reason it isn't, this forces the fast tick off after 20 seconds.
     if (movement_state.fast_ticks >= 128 * 20) {
@@ -687,11 +1111,13 @@ void cb_fast_tick(void) {
 
 void cb_tick(void) {
     event.event_type = EVENT_TICK;
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = watch_rtc_get_cached_date_time();
+    _movement_tick_now(date_time);
     if (date_time.unit.second != movement_state.last_second) {
         // TODO: can we consolidate these two ticks?
         if (movement_state.settings.bit.le_interval && movement_state.le_mode_ticks > 0) movement_state.le_mode_ticks--;
         if (movement_state.timeout_ticks > 0) movement_state.timeout_ticks--;
+        if (movement_state.kv_flush_ticks > 0) movement_state.kv_flush_ticks--;
 
         movement_state.last_second = date_time.unit.second;
         movement_state.subsecond = 0;
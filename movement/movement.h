@@ -27,6 +27,9 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "watch.h"
+#include "watch_utility.h"
+#include "tzdb.h"
+#include "facestats.h"
 
 // Movement Preferences
 // These four 32-bit structs store information about the wearer and their preferences. Tentatively, the plan is
@@ -53,7 +56,7 @@ typedef union {
         uint8_t led_duration : 2;           // how many seconds to shine the LED for (x2), or 0 to disable it.
         uint8_t led_red_color : 4;          // for general purpose illumination, the red LED value (0-15)
         uint8_t led_green_color : 4;        // for general purpose illumination, the green LED value (0-15)
-        uint8_t time_zone : 6;              // an integer representing an index in the time zone table.
+        uint8_t time_zone : 6;              // an index into the time zones in lib/tzdb.
 
         // while Movement itself doesn't implement a clock or display units, it may make sense to include some
         // global settings for watch faces to check. The 12/24 hour preference could inform a clock or a
@@ -127,18 +130,21 @@ typedef struct {
     uint8_t subsecond;
 } movement_event_t;
 
-extern const int16_t movement_timezone_offsets[];
 extern const char movement_valid_position_0_chars[];
 extern const char movement_valid_position_1_chars[];
 
 /** @brief Perform setup for your watch face.
   * @details It's tempting to say this is 'one-time' setup, but technically this function is called more than
-  *          once. When the watch first boots, this function is called with a NULL context_ptr, indicating
-  *          that it is the first run. At this time you should set context_ptr to something non-NULL if you
-  *          need to keep track of any state in your watch face. If your watch face requires any other setup,
-  *          like configuring a pin mode or a peripheral, you may want to do that here too.
-  *          This function will be called again after waking from sleep mode, since sleep mode disables all
-  *          of the device's pins and peripherals.
+  *          once, in two phases:
+  *           - Init: the first call, with a NULL context_ptr. At this time you should set context_ptr to something
+  *             non-NULL if you need to keep track of any state in your watch face. Movement doesn't init every
+  *             face at boot, only when it first needs one: just before it first activates your face, or first
+  *             asks your wants_background_task function. Any expensive one-time work, like reading a file or
+  *             working out sunrise times, belongs in init, or better yet in activate.
+  *           - Resume: later calls, with the context_ptr you set. Sleep mode disables all of the device's pins
+  *             and peripherals, so if your watch face configures a pin mode or a peripheral, do that here too.
+  *             Movement resumes your face the first time it needs it after waking from sleep mode, not at the
+  *             wake itself, so keep this phase cheap, and don't count on it running at any particular time.
   * @param settings A pointer to the global Movement settings. You can use this to inform how you present your
   *                 display to the user (i.e. taking into account whether they have silenced the buttons, or if
   *                 they prefer 12 or 24-hour mode). You can also change these settings if you like.
@@ -258,22 +264,32 @@ typedef struct {
     bool is_buzzing;
     BuzzerNote alarm_note;
 
-    // button tracking for long press
-    uint16_t light_down_timestamp;
-    uint16_t mode_down_timestamp;
-    uint16_t alarm_down_timestamp;
+    // button tracking for long press, in timestamp ticks (plus one, so that 0 means the button is up)
+    uint32_t light_down_timestamp;
+    uint32_t mode_down_timestamp;
+    uint32_t alarm_down_timestamp;
+    uint8_t long_press_pending; // one bit for each held button that hasn't had its long press event yet
 
     // background task handling
     bool needs_background_tasks_handled;
     bool has_scheduled_background_task;
     bool needs_wake;
 
+    // set by the tick when the time zone needs looking at again (a DST transition, a new zone, the clock set
+    // back); app_loop does the looking, since it means tzdb and maybe setting the RTC
+    bool needs_timezone_update;
+
     // low energy mode countdown
     int32_t le_mode_ticks;
+    // when low energy mode began, as a UNIX timestamp; see MOVEMENT_HIBERNATE_DAYS
+    uint32_t le_mode_started;
 
     // app resignation countdown (TODO: consolidate with LE countdown?)
     int16_t timeout_ticks;
 
+    // countdown to writing out dirty key-value settings; -1 when there is nothing to write
+    int16_t kv_flush_ticks;
+
     // stuff for subsecond tracking
     uint8_t tick_frequency;
     uint8_t last_second;
@@ -292,6 +308,23 @@ void movement_illuminate_led(void);
 
 void movement_request_tick_frequency(uint8_t freq);
 
+typedef enum {
+    MOVEMENT_PERFORMANCE_LOW = WATCH_PERFORMANCE_LOW,       // the CPU at 4 MHz, at PL0 with MOVEMENT_LOW_POWER_IDLE; Movement's default
+    MOVEMENT_PERFORMANCE_NORMAL = WATCH_PERFORMANCE_NORMAL, // 4 MHz, at the higher core voltage the watch used to run at
+    MOVEMENT_PERFORMANCE_HIGH = WATCH_PERFORMANCE_HIGH,     // 16 MHz, for heavy computations
+} movement_performance_level_t;
+
+/** @brief Asks Movement to run the CPU faster or slower.
+  * @details Movement runs the CPU at LOW, which is plenty for drawing the screen once a second. If your watch
+  *          face has a computation that keeps the user waiting, request HIGH just before it and LOW again
+  *          right after, so the face finishes sooner and the watch goes back to sleep. HIGH costs more energy
+  *          per instruction, so don't leave it on: Movement falls back to LOW when your face resigns, but until
+  *          then every tick runs at whatever you asked for. Peripherals keep their timing at every level.
+  *          LOW only drops to PL0 if MOVEMENT_LOW_POWER_IDLE is set in movement_config.h; otherwise it runs
+  *          the same as NORMAL.
+  */
+void movement_request_performance_level(movement_performance_level_t level);
+
 // note: watch faces can only schedule a background task when in the foreground, since
 // movement will associate the scheduled task with the currently active face.
 void movement_schedule_background_task(watch_date_time date_time);
@@ -306,10 +339,134 @@ void movement_cancel_background_task_for_face(uint8_t watch_face_index);
 
 void movement_request_wake(void);
 
+/** @brief Saves every face's state, and puts the watch into backup mode, its lowest power state, until the
+  *        user presses ALARM. This is for a watch that's going to sit in a drawer.
+  * @details Every face's context lives in the context arena (see movement_get_context_slot), and the arena is
+  *          saved to the filesystem. When ALARM wakes the watch, it reboots, and Movement puts the contexts back
+  *          and calls each face's setup with its restored context, just as it does when resuming from sleep
+  *          mode. Keep anything that should outlast an activation in the context, not in a file-scope variable,
+  *          which starts over. Nothing runs while the watch hibernates: the display is off, and alarms and
+  *          chimes wait until it wakes. Movement also hibernates by itself after MOVEMENT_HIBERNATE_DAYS of low
+  *          energy mode, if set.
+  * @note Refuses, and returns, while any face has a background task scheduled or the timestamp ticks counting,
+  *       since neither is saved. Otherwise returns only if the snapshot couldn't be written, or in the
+  *       simulator, which has no backup mode.
+  */
+void movement_hibernate(void);
+
 void movement_play_signal(void);
 void movement_play_alarm(void);
 void movement_play_alarm_beeps(uint8_t rounds, BuzzerNote alarm_note);
 
+/** @brief Claims one of the RTC's backup registers, which keep their values through a reset and in backup mode.
+  * @details Call it from your face's setup. Declare how many registers the face claims with
+  *          <face>_backup_registers in its header, like <face>_context_size, and Movement sets them aside by
+  *          the face's position in the face list, so the face finds its old values after a reset. Claims beyond
+  *          what the face declared, or from a face that declares none, come from whatever is left over, in the
+  *          order faces ask, which may differ from one boot to the next.
+  * @return the register, or 0 if there are none left.
+  */
 uint8_t movement_claim_backup_register(void);
 
+/// The current time, kept up to date by Movement. See movement_get_now.
+typedef watch_utility_clock_t movement_now_t;
+
+/** @brief Returns the time as of the latest tick: the raw RTC value (local time), the same instant in UTC,
+  *        and both as UNIX timestamps.
+  * @details Movement reads the RTC once per tick (and once per wake in low energy mode) and advances this
+  *          from the previous value, so reading it costs nothing, where calling watch_rtc_get_date_time waits
+  *          for the RTC to synchronize and converting to UTC costs a dozen software divisions. Use it in your
+  *          loop and background task handlers instead of reading and converting the time yourself. It's
+  *          only as fresh as the latest tick, so after setting the RTC, read it directly. The simulator
+  *          asserts if a face reads the RTC itself on a tick or low energy update.
+  */
+const movement_now_t *movement_get_now(void);
+
+/** @brief Returns the offset from UTC, in seconds, in effect right now in the wearer's time zone.
+  * @details Zones with daylight saving rules (see lib/tzdb) change offset during the year. Movement moves
+  *          the RTC at the moment of each change, so the RTC always holds local time, and this always
+  *          matches it.
+  */
+int32_t movement_get_current_timezone_offset(void);
+
+/// Returns the offset from UTC, in seconds, in effect right now in any time zone in lib/tzdb.
+int32_t movement_get_current_timezone_offset_for_zone(uint8_t zone_index);
+
+/** @brief Sets the RTC to a local time in the wearer's time zone.
+  * @details Use this rather than watch_rtc_set_date_time, so Movement works out afresh whether daylight
+  *          saving time is in effect. A time in the hour skipped when clocks go forward is moved past it.
+  */
+void movement_set_local_date_time(watch_date_time date_time);
+
+// How long, in seconds, a value stored with movement_kv_put can sit in RAM before it is written out.
+#define MOVEMENT_KV_FLUSH_DELAY 300
+
+/** @brief Reads a small value saved with movement_kv_put.
+  * @note The store is only built with MOVEMENT_KV set in movement_config.h; a face that uses it without
+  *       that fails to link.
+  * @param key The key the value was saved under; by convention, prefixed with the face's name, like "tally.count".
+  * @param value Buffer for the value; up to size bytes are copied into it.
+  * @return the length of the saved value, or -1 if there is none.
+  */
+int32_t movement_kv_get(const char *key, void *value, uint8_t size);
+
+/** @brief Saves a small value (up to 16 bytes, with a key of up to 15 characters) that persists across reboots.
+  * @details Values are kept in RAM and written out together, as an append-only log in one file: five
+  *          minutes after the first change, when the watch enters low energy mode, or when you call
+  *          movement_kv_flush. Saving the same value again costs nothing, so it's fine to save on
+  *          every change. Values saved in the last few minutes before a reset are lost; call
+  *          movement_kv_flush if that matters.
+  * @return false if the key or value is too long, or the store is full.
+  */
+bool movement_kv_put(const char *key, const void *value, uint8_t size);
+
+/// Writes out any values saved with movement_kv_put that haven't been written yet.
+bool movement_kv_flush(void);
+
+/** @brief Returns a random number from 0 to upper_bound - 1, each as likely as the others.
+  * @details The numbers come from a ChaCha20 generator that Movement seeds from the TRNG, and reseeds from it
+  *          as it goes, so they're good for anything from a coin toss to a key. The TRNG is only powered for a
+  *          moment each time it refills. In the simulator, set Module.trngSeed before the firmware starts to
+  *          get the same numbers on every run.
+  * @return 0 if upper_bound is 0 or 1.
+  */
+uint32_t movement_random_uniform(uint32_t upper_bound);
+
+/// Fills buf with len random bytes, from the same generator as movement_random_uniform.
+void movement_random_bytes(void *buf, size_t len);
+
+/// Returns how many watch faces this build has.
+uint8_t movement_get_num_faces(void);
+
+/** @brief Returns a face's context from the context arena. Faces take their context from here, not from malloc.
+  * @details The slot is as big as the <face>_context_size macro in the face's header says, starts out zeroed,
+  *          and belongs to the face for as long as the watch runs; see movement_arena.h. Call it from setup
+  *          when *context_ptr is NULL.
+  * @param watch_face_index The index Movement passed to setup.
+  * @return NULL if the face didn't define a context size.
+  */
+void *movement_get_context_slot(uint8_t watch_face_index);
+
+/// Returns the size of the context arena, in bytes.
+size_t movement_get_arena_size(void);
+
+/** @brief Returns what a watch face has cost since boot, or since movement_reset_face_stats.
+  * @details Movement times every call it makes to a face's loop, and to its wants_background_task, and
+  *          counts the ticks it delivers; see facestats.h for what each number means. The counters live
+  *          in RAM, so they carry on through low energy mode, and start over when the watch resets.
+  * @return NULL if face_idx is out of range.
+  */
+const facestats_t *movement_get_face_stats(uint8_t face_idx);
+
+/// Sets every face's counters back to zero.
+void movement_reset_face_stats(void);
+
+/** @brief Returns how long the watch took to boot, in microseconds of active time.
+  * @details Counts from the start of app_init to the end of the first face's EVENT_ACTIVATE, which is when the
+  *          first screen is up. Only the current face is set up before then; the rest wait until Movement first
+  *          needs them. The simulator prints this number too, so configs can be compared in the browser console.
+  * @return 0 until the first screen is up.
+  */
+uint32_t movement_get_boot_time(void);
+
 #endif // MOVEMENT_H_
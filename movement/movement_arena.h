@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MOVEMENT_ARENA_H_
+#define MOVEMENT_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The context arena: one block of RAM, laid out at build time, holding the context of every face.
+ * A face defines <face>_context_size in its header, usually as sizeof its state struct, and takes
+ * its context from movement_get_context_slot in setup; faces don't malloc their contexts. A face
+ * that keeps nothing in RAM between calls defines no size, and gets no room here.
+ *
+ * The build writes movement_arena_faces.h from the firmware's face list with
+ * utils/arena/generate_arena.py. It defines MOVEMENT_ARENA_FACES(X), which calls X(index, face)
+ * for each face in order; the compiler does the rest. Each slot starts on the largest alignment
+ * any type needs, and the arena is an ordinary static variable, so the link map shows its size.
+ *
+ * This header includes nothing of Movement's, so the host tests can lay out every alt_fw face
+ * list with made-up sizes.
+ */
+
+#include "movement_arena_faces.h"
+
+#define MOVEMENT_ARENA_ALIGNMENT __BIGGEST_ALIGNMENT__
+
+#define MOVEMENT_ARENA_SLOT(index, face) uint8_t slot_##index[face##_context_size] __attribute__((aligned(MOVEMENT_ARENA_ALIGNMENT)));
+#define MOVEMENT_ARENA_OFFSET(index, face) offsetof(movement_arena_t, slot_##index),
+#define MOVEMENT_ARENA_SIZE(index, face) face##_context_size,
+
+typedef struct {
+    MOVEMENT_ARENA_FACES(MOVEMENT_ARENA_SLOT)
+} movement_arena_t;
+
+/// Initializers for arrays of each slot's offset and size, in face order.
+#define MOVEMENT_ARENA_OFFSETS { MOVEMENT_ARENA_FACES(MOVEMENT_ARENA_OFFSET) }
+#define MOVEMENT_ARENA_SIZES { MOVEMENT_ARENA_FACES(MOVEMENT_ARENA_SIZE) }
+
+#endif // MOVEMENT_ARENA_H_
@@ -95,4 +95,21 @@ const watch_face_t watch_faces[] = {
  */
 #define MOVEMENT_DEFAULT_LED_DURATION 1
 
+/* Set how many days of low energy mode, with no background task scheduled, before the watch hibernates:
+ * it saves the faces' state and turns everything off but the clock, until you press ALARM.
+ * Alarms and chimes don't sound while it hibernates. 0 means never.
+ */
+#define MOVEMENT_HIBERNATE_DAYS 0
+
+/* Set to 1 if one of your faces saves settings with movement_kv_put. The store keeps its values in
+ * RAM (about 600 bytes), so it is left out unless something uses it.
+ */
+#define MOVEMENT_KV 0
+
+/* Set to 1 to idle the CPU at PL0, the power manager's low voltage level, instead of PL2. It should save
+ * power, but it has yet to be measured on a watch, and USB, the buzzer and the LED haven't been checked
+ * at PL0 either. With 0, the watch runs at PL2 as it always has; faces can still ask for a faster CPU.
+ */
+#define MOVEMENT_LOW_POWER_IDLE 0
+
 #endif // MOVEMENT_CONFIG_H_
@@ -27,13 +27,22 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "filesystem.h"
+#include "movement.h"
 #include "watch.h"
 
 static int help_cmd(int argc, char *argv[]);
 static int flash_cmd(int argc, char *argv[]);
 static int stress_cmd(int argc, char *argv[]);
+static int cdc_cmd(int argc, char *argv[]);
+static int stats_cmd(int argc, char *argv[]);
+static int mem_cmd(int argc, char *argv[]);
+static int hibernate_cmd(int argc, char *argv[]);
+#ifdef WATCH_PROFILER
+static int prof_cmd(int argc, char *argv[]);
+#endif
 
 shell_command_t g_shell_commands[] = {
     {
@@ -92,6 +101,20 @@ shell_command_t g_shell_commands[] = {
         .max_args = 3,
         .cb = filesystem_cmd_echo,
     },
+    {
+        .name = "get",
+        .help = "send FILE in binary framed mode; usage: get FILE (use utils/xfer/swxfer)",
+        .min_args = 1,
+        .max_args = 1,
+        .cb = filesystem_cmd_get,
+    },
+    {
+        .name = "put",
+        .help = "receive FILE in binary framed mode; usage: put FILE (use utils/xfer/swxfer)",
+        .min_args = 1,
+        .max_args = 1,
+        .cb = filesystem_cmd_put,
+    },
     {
         .name = "stress",
         .help = "test CDC write; usage: stress [LEN] [DELAY_MS]",
@@ -99,6 +122,43 @@ shell_command_t g_shell_commands[] = {
         .max_args = 2,
         .cb = stress_cmd,
     },
+    {
+        .name = "cdc",
+        .help = "print CDC buffer statistics",
+        .min_args = 0,
+        .max_args = 0,
+        .cb = cdc_cmd,
+    },
+    {
+        .name = "stats",
+        .help = "print what each watch face has cost; usage: stats [reset]",
+        .min_args = 0,
+        .max_args = 1,
+        .cb = stats_cmd,
+    },
+    {
+        .name = "mem",
+        .help = "print stack and heap usage",
+        .min_args = 0,
+        .max_args = 0,
+        .cb = mem_cmd,
+    },
+    {
+        .name = "hibernate",
+        .help = "save face state and sleep in backup mode until ALARM is pressed",
+        .min_args = 0,
+        .max_args = 0,
+        .cb = hibernate_cmd,
+    },
+#ifdef WATCH_PROFILER
+    {
+        .name = "prof",
+        .help = "sampling profiler; usage: prof start [HZ] | stop | dump (use utils/profiler/symbolize.py)",
+        .min_args = 1,
+        .max_args = 2,
+        .cb = prof_cmd,
+    },
+#endif
 };
 
 const size_t g_num_shell_commands = sizeof(g_shell_commands) / sizeof(shell_command_t);
@@ -157,3 +217,93 @@ static int stress_cmd(int argc, char *argv[]) {
     return 0;
 }
 
+static int cdc_cmd(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    watch_cdc_stats_t stats;
+    watch_cdc_get_stats(&stats);
+    printf("tx: %u/%u bytes, high water %u, %lu stalls, %lu bytes dropped\r\n",
+           stats.tx_used, stats.tx_size, stats.tx_high_water,
+           (unsigned long) stats.tx_stalls, (unsigned long) stats.tx_dropped);
+    printf("rx: %u/%u bytes, high water %u\r\n",
+           stats.rx_used, stats.rx_size, stats.rx_high_water);
+
+    return 0;
+}
+
+static int stats_cmd(int argc, char *argv[]) {
+    if (argc == 2) {
+        if (strcmp(argv[1], "reset") != 0) return -1;
+        movement_reset_face_stats();
+        return 0;
+    }
+
+    printf("boot: %lu us to first display\r\n", (unsigned long) movement_get_boot_time());
+    char line[160];
+    for (uint8_t i = 0; i < movement_get_num_faces(); i++) {
+        facestats_format(movement_get_face_stats(i), line, sizeof(line));
+        printf("%u: %s\r\n", i, line);
+    }
+
+    return 0;
+}
+
+static int mem_cmd(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    watch_memory_stats_t stats;
+    watch_get_memory_stats(&stats);
+    printf("stack: %lu/%lu bytes used at most\r\n",
+           (unsigned long) stats.stack_high_water, (unsigned long) stats.stack_size);
+    printf("heap: %lu bytes taken, %lu more available\r\n",
+           (unsigned long) stats.heap_size, (unsigned long) stats.heap_free);
+    printf("blocks: %lu bytes live, peak %lu, %lu allocs, %lu frees, %lu failed\r\n",
+           (unsigned long) stats.heap.live_bytes, (unsigned long) stats.heap.peak_bytes,
+           (unsigned long) stats.heap.allocations, (unsigned long) stats.heap.frees,
+           (unsigned long) stats.heap.failures);
+    printf("arena: %lu bytes of face contexts\r\n", (unsigned long) movement_get_arena_size());
+
+    return 0;
+}
+
+static int hibernate_cmd(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    movement_hibernate();
+    // if we're still here, a face is busy, the snapshot couldn't be saved, or this is the simulator.
+    printf("hibernate: not hibernating (a face is timing something, or the snapshot wasn't saved)\r\n");
+
+    return -1;
+}
+
+#ifdef WATCH_PROFILER
+static int prof_cmd(int argc, char *argv[]) {
+    if (strcmp(argv[1], "start") == 0) {
+        int frequency = (argc == 3) ? atoi(argv[2]) : 1000;
+        if (frequency <= 0 || frequency > UINT16_MAX || !watch_profiler_start(frequency)) return -1;
+        return 0;
+    }
+    if (argc != 2) return -1;
+    if (strcmp(argv[1], "stop") == 0) {
+        watch_profiler_stop();
+        return 0;
+    }
+    if (strcmp(argv[1], "dump") != 0) return -1;
+
+    // a header, one line per bin that got samples, and a footer, so the host script knows it has it all.
+    const watch_profiler_histogram_t *histogram = watch_profiler_get_histogram();
+    printf("profile base 0x%08lx shift %u samples %lu outside %lu full %u\r\n",
+           (unsigned long)histogram->base, histogram->shift, (unsigned long)histogram->samples,
+           (unsigned long)histogram->outside, histogram->full);
+    for (uint16_t i = 0; i < WATCH_PROFILER_NUM_BINS; i++) {
+        if (histogram->bins[i] == 0) continue;
+        printf("0x%08lx %u\r\n", (unsigned long)watch_profiler_histogram_bin_address(histogram, i), histogram->bins[i]);
+    }
+    printf("end\r\n");
+
+    return 0;
+}
+#endif
@@ -49,6 +49,8 @@ void beats_face_activate(movement_settings_t *settings, void *context);
 bool beats_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void beats_face_resign(movement_settings_t *settings, void *context);
 
+#define beats_face_context_size sizeof(beats_face_state_t)
+
 #define beats_face ((const watch_face_t){ \
     beats_face_setup, \
     beats_face_activate, \
@@ -46,16 +46,6 @@
 #define CLOCK_FACE_24H_ONLY 0
 #endif
 
-typedef struct {
-    struct {
-        watch_date_time previous;
-    } date_time;
-    uint8_t last_battery_check;
-    uint8_t watch_face_index;
-    bool time_signal_enabled;
-    bool battery_low;
-} clock_state_t;
-
 static bool clock_is_in_24h_mode(movement_settings_t *settings) {
     if (CLOCK_FACE_24H_ONLY) { return true; }
     return settings->bit.clock_mode_24h;
@@ -215,10 +205,9 @@ static void clock_stop_tick_tock_animation(void) {
 
 void clock_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(clock_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         clock_state_t *state = (clock_state_t *) *context_ptr;
         state->time_signal_enabled = false;
         state->watch_face_index = watch_face_index;
@@ -247,11 +236,11 @@ bool clock_face_loop(movement_event_t event, movement_settings_t *settings, void
     switch (event.event_type) {
         case EVENT_LOW_ENERGY_UPDATE:
             clock_start_tick_tock_animation();
-            clock_display_low_energy(watch_rtc_get_date_time());
+            clock_display_low_energy(movement_get_now()->local);
             break;
         case EVENT_TICK:
         case EVENT_ACTIVATE:
-            current = watch_rtc_get_date_time();
+            current = movement_get_now()->local;
 
             clock_display_clock(settings, state, current);
 
@@ -285,7 +274,7 @@ bool clock_face_wants_background_task(movement_settings_t *settings, void *conte
     clock_state_t *state = (clock_state_t *) context;
     if (!state->time_signal_enabled) return false;
 
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     return date_time.unit.minute == 0;
 }
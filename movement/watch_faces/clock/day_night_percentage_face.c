@@ -57,12 +57,11 @@ static void recalculate(watch_date_time utc_now, day_night_percentage_state_t *s
 
 void day_night_percentage_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(day_night_percentage_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         day_night_percentage_state_t *state = (day_night_percentage_state_t *)*context_ptr;
-        watch_date_time utc_now = watch_utility_date_time_convert_zone(watch_rtc_get_date_time(), movement_timezone_offsets[settings->bit.time_zone] * 60, 0);
+        watch_date_time utc_now = movement_get_now()->utc;
         recalculate(utc_now, state);
     }
 }
@@ -76,8 +75,8 @@ bool day_night_percentage_face_loop(movement_event_t event, movement_settings_t
     day_night_percentage_state_t *state = (day_night_percentage_state_t *)context;
 
     char buf[12];
-    watch_date_time date_time = watch_rtc_get_date_time();
-    watch_date_time utc_now = watch_utility_date_time_convert_zone(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60, 0);
+    watch_date_time date_time = movement_get_now()->local;
+    watch_date_time utc_now = movement_get_now()->utc;
 
     switch (event.event_type) {
         case EVENT_ACTIVATE:
@@ -54,6 +54,8 @@ void day_night_percentage_face_activate(movement_settings_t *settings, void *con
 bool day_night_percentage_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void day_night_percentage_face_resign(movement_settings_t *settings, void *context);
 
+#define day_night_percentage_face_context_size sizeof(day_night_percentage_state_t)
+
 #define day_night_percentage_face ((const watch_face_t){ \
     day_night_percentage_face_setup, \
     day_night_percentage_face_activate, \
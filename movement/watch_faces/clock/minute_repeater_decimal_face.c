@@ -68,10 +68,9 @@ static void _update_alarm_indicator(bool settings_alarm_enabled, minute_repeater
 
 void minute_repeater_decimal_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(minute_repeater_decimal_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         minute_repeater_decimal_state_t *state = (minute_repeater_decimal_state_t *)*context_ptr;
         state->signal_enabled = false;
         state->watch_face_index = watch_face_index;
@@ -109,7 +108,7 @@ bool minute_repeater_decimal_face_loop(movement_event_t event, movement_settings
         case EVENT_ACTIVATE:
         case EVENT_TICK:
         case EVENT_LOW_ENERGY_UPDATE:
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             previous_date_time = state->previous_date_time;
             state->previous_date_time = date_time.reg;
 
@@ -175,7 +174,7 @@ bool minute_repeater_decimal_face_loop(movement_event_t event, movement_settings
              * boring at 00:00 or 1:00 and very quite musical at 23:59 or 12:59.
              */
 
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             
             
             int hours = date_time.unit.hour;
@@ -232,7 +231,7 @@ bool minute_repeater_decimal_face_wants_background_task(movement_settings_t *set
     minute_repeater_decimal_state_t *state = (minute_repeater_decimal_state_t *)context;
     if (!state->signal_enabled) return false;
 
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     return date_time.unit.minute == 0;
 }
@@ -53,10 +53,9 @@ static void _update_alarm_indicator(bool settings_alarm_enabled, repetition_minu
 
 void repetition_minute_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(repetition_minute_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         repetition_minute_state_t *state = (repetition_minute_state_t *)*context_ptr;
         state->signal_enabled = false;
         state->watch_face_index = watch_face_index;
@@ -94,7 +93,7 @@ bool repetition_minute_face_loop(movement_event_t event, movement_settings_t *se
         case EVENT_ACTIVATE:
         case EVENT_TICK:
         case EVENT_LOW_ENERGY_UPDATE:
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             previous_date_time = state->previous_date_time;
             state->previous_date_time = date_time.reg;
 
@@ -162,7 +161,7 @@ bool repetition_minute_face_loop(movement_event_t event, movement_settings_t *se
              * boring at 00:00 or 1:00 and very quite musical at 23:59 or 12:59.
              */
 
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             
             
             int hours = date_time.unit.hour;
@@ -215,7 +214,7 @@ bool repetition_minute_face_wants_background_task(movement_settings_t *settings,
     repetition_minute_state_t *state = (repetition_minute_state_t *)context;
     if (!state->signal_enabled) return false;
 
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     return date_time.unit.minute == 0;
 }
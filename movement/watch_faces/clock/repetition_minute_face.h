@@ -72,6 +72,8 @@ bool repetition_minute_face_loop(movement_event_t event, movement_settings_t *se
 void repetition_minute_face_resign(movement_settings_t *settings, void *context);
 bool repetition_minute_face_wants_background_task(movement_settings_t *settings, void *context);
 
+#define repetition_minute_face_context_size sizeof(repetition_minute_state_t)
+
 #define repetition_minute_face ((const watch_face_t){ \
     repetition_minute_face_setup, \
     repetition_minute_face_activate, \
@@ -48,7 +48,7 @@ static void _display_left_aligned(uint8_t value) {
 void simple_clock_bin_led_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(simple_clock_bin_led_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(simple_clock_bin_led_state_t));
         simple_clock_bin_led_state_t *state = (simple_clock_bin_led_state_t *)*context_ptr;
         state->watch_face_index = watch_face_index;
@@ -86,7 +86,7 @@ bool simple_clock_bin_led_face_loop(movement_event_t event, movement_settings_t
         case EVENT_ACTIVATE:
         case EVENT_TICK:
         case EVENT_LOW_ENERGY_UPDATE:
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             if (state->flashing_state > 0) {
                 if (state->ticks) {
                     state->ticks--;
@@ -184,7 +184,7 @@ bool simple_clock_bin_led_face_loop(movement_event_t event, movement_settings_t
             break;
         case EVENT_LIGHT_LONG_PRESS:
             if (state->flashing_state == 0) {
-                date_time = watch_rtc_get_date_time();
+                date_time = movement_get_now()->local;
                 state->flashing_state = 1 + 128;
                 state->ticks = 4;
                 if (!settings->bit.clock_mode_24h) {
@@ -216,7 +216,7 @@ bool simple_clock_bin_led_face_wants_background_task(movement_settings_t *settin
     simple_clock_bin_led_state_t *state = (simple_clock_bin_led_state_t *)context;
     if (!state->signal_enabled) return false;
 
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     return date_time.unit.minute == 0;
 }
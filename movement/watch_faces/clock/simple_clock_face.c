@@ -36,10 +36,9 @@ static void _update_alarm_indicator(bool settings_alarm_enabled, simple_clock_st
 
 void simple_clock_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(simple_clock_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         simple_clock_state_t *state = (simple_clock_state_t *)*context_ptr;
         state->signal_enabled = false;
         state->watch_face_index = watch_face_index;
@@ -77,7 +76,7 @@ bool simple_clock_face_loop(movement_event_t event, movement_settings_t *setting
         case EVENT_ACTIVATE:
         case EVENT_TICK:
         case EVENT_LOW_ENERGY_UPDATE:
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             previous_date_time = state->previous_date_time;
             state->previous_date_time = date_time.reg;
 
@@ -155,7 +154,5 @@ bool simple_clock_face_wants_background_task(movement_settings_t *settings, void
     simple_clock_state_t *state = (simple_clock_state_t *)context;
     if (!state->signal_enabled) return false;
 
-    watch_date_time date_time = watch_rtc_get_date_time();
-
-    return date_time.unit.minute == 0;
+    return movement_get_now()->local.unit.minute == 0;
 }
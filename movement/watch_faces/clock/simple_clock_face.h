@@ -51,6 +51,8 @@ bool simple_clock_face_loop(movement_event_t event, movement_settings_t *setting
 void simple_clock_face_resign(movement_settings_t *settings, void *context);
 bool simple_clock_face_wants_background_task(movement_settings_t *settings, void *context);
 
+#define simple_clock_face_context_size sizeof(simple_clock_state_t)
+
 #define simple_clock_face ((const watch_face_t){ \
     simple_clock_face_setup, \
     simple_clock_face_activate, \
@@ -39,51 +39,6 @@ static bool refresh_face;
 /* Activate refresh of time */
 #define REFRESH_TIME        0xffffffff
 
-/* List of all time zone names */
-const char *zone_names[] = {
-    "UTC",	//  0 :   0:00:00 (UTC)
-    "CET",	//  1 :   1:00:00 (Central European Time)
-    "SAST",	//  2 :   2:00:00 (South African Standard Time)
-    "ARST",	//  3 :   3:00:00 (Arabia Standard Time)
-    "IRST",	//  4 :   3:30:00 (Iran Standard Time)
-    "GET",	//  5 :   4:00:00 (Georgia Standard Time)
-    "AFT",	//  6 :   4:30:00 (Afghanistan Time)
-    "PKT",	//  7 :   5:00:00 (Pakistan Standard Time)
-    "IST",	//  8 :   5:30:00 (Indian Standard Time)
-    "NPT",	//  9 :   5:45:00 (Nepal Time)
-    "KGT",	// 10 :   6:00:00 (Kyrgyzstan time)
-    "MYST",	// 11 :   6:30:00 (Myanmar Time)
-    "THA",	// 12 :   7:00:00 (Thailand Standard Time)
-    "CST",	// 13 :   8:00:00 (China Standard Time, Australian Western Standard Time)
-    "ACWS",	// 14 :   8:45:00 (Australian Central Western Standard Time)
-    "JST",	// 15 :   9:00:00 (Japan Standard Time, Korea Standard Time)
-    "ACST",	// 16 :   9:30:00 (Australian Central Standard Time)
-    "AEST",	// 17 :  10:00:00 (Australian Eastern Standard Time)
-    "LHST",	// 18 :  10:30:00 (Lord Howe Standard Time)
-    "SBT",	// 19 :  11:00:00 (Solomon Islands Time)
-    "NZST",	// 20 :  12:00:00 (New Zealand Standard Time)
-    "CHAS",	// 21 :  12:45:00 (Chatham Standard Time)
-    "TOT",	// 22 :  13:00:00 (Tonga Time)
-    "CHAD",	// 23 :  13:45:00 (Chatham Daylight Time)
-    "LINT",	// 24 :  14:00:00 (Line Islands Time)
-    "BIT",	// 25 : -12:00:00 (Baker Island Time)
-    "NUT",	// 26 : -11:00:00 (Niue Time)
-    "HST",	// 27 : -10:00:00 (Hawaii-Aleutian Standard Time)
-    "MART",	// 28 :  -9:30:00 (Marquesas Islands Time)
-    "AKST",	// 29 :  -9:00:00 (Alaska Standard Time)
-    "PST",	// 30 :  -8:00:00 (Pacific Standard Time)
-    "MST",	// 31 :  -7:00:00 (Mountain Standard Time)
-    "CST",	// 32 :  -6:00:00 (Central Standard Time)
-    "EST",	// 33 :  -5:00:00 (Eastern Standard Time)
-    "VET",	// 34 :  -4:30:00 (Venezuelan Standard Time)
-    "AST",	// 35 :  -4:00:00 (Atlantic Standard Time)
-    "NST",	// 36 :  -3:30:00 (Newfoundland Standard Time)
-    "BRT",	// 37 :  -3:00:00 (Brasilia Time)
-    "NDT",	// 38 :  -2:30:00 (Newfoundland Daylight Time)
-    "FNT",	// 39 :  -2:00:00 (Fernando de Noronha Time)
-    "AZOT",	// 40 :  -1:00:00 (Azores Standard Time)
-};
-
 /* Modulo function */
 static inline unsigned int mod(int a, int b)
 {
@@ -124,10 +79,9 @@ static void beep_disable() {
 void world_clock2_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr)
 {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(world_clock2_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(world_clock2_state_t));
 
         /* Start in settings mode */
@@ -182,9 +136,9 @@ static bool mode_display(movement_event_t event, movement_settings_t *settings,
             }
 
             /* Determine current time at time zone and store date/time */
-	    date_time = watch_rtc_get_date_time();
-	    timestamp = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60);
-	    date_time = watch_utility_date_time_from_unix_time(timestamp, movement_timezone_offsets[state->current_zone] * 60);
+	    date_time = movement_get_now()->local;
+	    timestamp = watch_utility_date_time_to_unix_time(date_time, movement_get_current_timezone_offset());
+	    date_time = watch_utility_date_time_from_unix_time(timestamp, movement_get_current_timezone_offset_for_zone(state->current_zone));
 	    previous_date_time = state->previous_date_time;
 	    state->previous_date_time = date_time.reg;
 
@@ -216,13 +170,13 @@ static bool mode_display(movement_event_t event, movement_settings_t *settings,
 			watch_start_tick_animation(500);
 
 		    sprintf(buf, "%.2s%2d%2d%02d  ",
-                            zone_names[state->current_zone],
+                            tzdb_zone_name(state->current_zone),
                             date_time.unit.day,
                             date_time.unit.hour,
                             date_time.unit.minute);
 		} else {
 		    sprintf(buf, "%.2s%2d%2d%02d%02d",
-			    zone_names[state->current_zone],
+			    tzdb_zone_name(state->current_zone),
                             date_time.unit.day,
                             date_time.unit.hour,
                             date_time.unit.minute,
@@ -284,7 +238,7 @@ static bool mode_settings(movement_event_t event, movement_settings_t *settings,
                 watch_clear_indicator(WATCH_INDICATOR_PM);
                 refresh_face = false;
             }
-	    result = div(movement_timezone_offsets[state->current_zone], 60);
+	    result = div(movement_get_current_timezone_offset_for_zone(state->current_zone) / 60, 60);
 	    hours = result.quot;
 	    minutes = result.rem;
 
@@ -294,7 +248,7 @@ static bool mode_settings(movement_event_t event, movement_settings_t *settings,
 	     * corresponding compiler warnings.
 	     */
 	    sprintf(buf, "%.2s%2d %c%02d%02d",
-                    zone_names[state->current_zone],
+                    tzdb_zone_name(state->current_zone),
                     state->current_zone % 100,
                     hours < 0 ? '-' : '+',
                     abs(hours) % 24,
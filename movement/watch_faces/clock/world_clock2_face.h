@@ -53,7 +53,7 @@
  * following buttons:
  *  * The ALARM button moves forward to the next time zone, while the LIGHT
  *    button moves backward to the previous zone. This way, the user can
- *    cycle through all 41 supported time zones.
+ *    cycle through all supported time zones.
  *  * A long press on the LIGHT button selects the current time zone, and
  *    the signal indicator appears at the top left. Another long press of
  *    the LIGHT button deselects the time zone.
@@ -85,8 +85,8 @@
  *    watch.
  */
 
-/* Number of zones. See movement_timezone_offsets. */
-#define NUM_TIME_ZONES  41
+/* Number of zones. See lib/tzdb. */
+#define NUM_TIME_ZONES  TZDB_NUM_ZONES
 
 #include "movement.h"
 
@@ -111,6 +111,8 @@ void world_clock2_face_activate(movement_settings_t *settings, void *context);
 bool world_clock2_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void world_clock2_face_resign(movement_settings_t *settings, void *context);
 
+#define world_clock2_face_context_size sizeof(world_clock2_state_t)
+
 #define world_clock2_face ((const watch_face_t){ \
     world_clock2_face_setup, \
     world_clock2_face_activate, \
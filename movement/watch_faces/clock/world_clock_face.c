@@ -30,9 +30,8 @@
 
 void world_clock_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(world_clock_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(world_clock_state_t));
         uint8_t backup_register = movement_claim_backup_register();
         if (backup_register) {
@@ -66,9 +65,8 @@ static bool world_clock_face_do_display_mode(movement_event_t event, movement_se
             // fall through
         case EVENT_TICK:
         case EVENT_LOW_ENERGY_UPDATE:
-            date_time = watch_rtc_get_date_time();
-            timestamp = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60);
-            date_time = watch_utility_date_time_from_unix_time(timestamp, movement_timezone_offsets[state->settings.bit.timezone_index] * 60);
+            timestamp = movement_get_now()->timestamp;
+            date_time = watch_utility_date_time_from_unix_time(timestamp, movement_get_current_timezone_offset_for_zone(state->settings.bit.timezone_index));
             previous_date_time = state->previous_date_time;
             state->previous_date_time = date_time.reg;
 
@@ -156,7 +154,7 @@ static bool _world_clock_face_do_settings_mode(movement_event_t event, movement_
                     break;
                 case 3:
                     state->settings.bit.timezone_index++;
-                    if (state->settings.bit.timezone_index > 40) state->settings.bit.timezone_index = 0;
+                    if (state->settings.bit.timezone_index >= TZDB_NUM_ZONES) state->settings.bit.timezone_index = 0;
                     break;
             }
             break;
@@ -168,11 +166,12 @@ static bool _world_clock_face_do_settings_mode(movement_event_t event, movement_
     }
 
     char buf[13];
+    int16_t tz_offset = movement_get_current_timezone_offset_for_zone(state->settings.bit.timezone_index) / 60;
     sprintf(buf, "%c%c %3d%02d  ",
         movement_valid_position_0_chars[state->settings.bit.char_0],
         movement_valid_position_1_chars[state->settings.bit.char_1],
-        (int8_t) (movement_timezone_offsets[state->settings.bit.timezone_index] / 60),
-        (int8_t) (movement_timezone_offsets[state->settings.bit.timezone_index] % 60) * (movement_timezone_offsets[state->settings.bit.timezone_index] < 0 ? -1 : 1));
+        (int8_t) (tz_offset / 60),
+        (int8_t) (tz_offset % 60) * (tz_offset < 0 ? -1 : 1));
     watch_set_colon();
     watch_clear_indicator(WATCH_INDICATOR_PM);
 
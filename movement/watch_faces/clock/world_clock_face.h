@@ -42,8 +42,9 @@
  * zones. Press LIGHT one last time to return to the world clock display.
  *
  * Note that the second slot cannot display all letters or numbers. Also note
- * that at this time, time zones do not automatically update for daylight saving
- * time; you will need to manually adjust this field each spring and fall.
+ * that the first 41 time zones are fixed offsets, which you will need to
+ * adjust by hand each spring and fall; the zones after them follow their
+ * region's daylight saving rules.
  */
 
 #include "movement.h"
@@ -71,6 +72,9 @@ void world_clock_face_resign(movement_settings_t *settings, void *context);
 
 uint8_t world_clock_face_get_weekday(uint16_t day, uint16_t month, uint16_t year);
 
+#define world_clock_face_context_size sizeof(world_clock_state_t)
+#define world_clock_face_backup_registers 1
+
 #define world_clock_face ((const watch_face_t){ \
     world_clock_face_setup, \
     world_clock_face_activate, \
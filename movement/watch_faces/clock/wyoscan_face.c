@@ -92,9 +92,8 @@ static const int32_t clock_mapping[6][7][2] = {
 
 void wyoscan_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(wyoscan_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(wyoscan_state_t));
         // Do any one-time tasks in here; the inside of this conditional happens only at boot.
     }
@@ -117,7 +116,7 @@ bool wyoscan_face_loop(movement_event_t event, movement_settings_t *settings, vo
             break;
         case EVENT_TICK:            
             if (!state->animate) {
-                date_time = watch_rtc_get_date_time();
+                date_time = movement_get_now()->local;
                 state->start = 0; 
                 state->end = 0;
                 state->animation = 0;
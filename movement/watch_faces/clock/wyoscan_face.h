@@ -79,6 +79,8 @@ bool wyoscan_face_loop(movement_event_t event, movement_settings_t *settings, vo
 void wyoscan_face_resign(movement_settings_t *settings, void *context);
 bool wyoscan_face_wants_background_task(movement_settings_t *settings, void *context);
 
+#define wyoscan_face_context_size sizeof(wyoscan_state_t)
+
 #define wyoscan_face ((const watch_face_t){ \
     wyoscan_face_setup, \
     wyoscan_face_activate, \
@@ -72,98 +72,24 @@ static const uint8_t num_enabled_activities = sizeof(enabled_activities) / sizeo
 // End configurable section
 // ===========================================================================
 
-// One logged activity
-typedef struct __attribute__((__packed__)) {
-    // Activity's start time
-    watch_date_time start_time;
-
-    // Total duration of activity, including time spend in paus
-    uint16_t total_sec;
-
-    // Number of seconds the activity was paused
-    uint16_t pause_sec;
-
-    // Type of activity (index in activity_names)
-    uint8_t activity_type;
-
-} activity_item_t;
-
 #define MAX_ACTIVITY_SECONDS 28800 // 8 hours = 28800 sec
 
-// Size of (fixed) buffer to log activites. Takes up x9 bytes in SRAM if face is installed.
-#define ACTIVITY_LOG_SZ 99
-
-// Number of activities in buffer.
-static uint8_t activity_log_count = 0;
-
-// Buffer with all logged activities.
-static activity_item_t activity_log_buffer[ACTIVITY_LOG_SZ];
-
 #define CHIRPY_PREFIX_LEN 2
-// First two bytes chirped out, to identify transmission as from the activity face
-static const uint8_t activity_chirpy_prefix[CHIRPY_PREFIX_LEN] = {0x27, 0x00};
-
-// The face's different UI modes (views).
-typedef enum {
-    ACTM_CHOOSE = 0,
-    ACTM_LOGGING,
-    ACTM_PAUSED,
-    ACTM_DONE,
-    ACTM_LOGSIZE,
-    ACTM_CHIRP,
-    ACTM_CHIRPING,
-    ACTM_CLEAR,
-    ACTM_CLEAR_CONFIRM,
-    ACTM_CLEAR_DONE,
-} activity_mode_t;
-
-// The full state of the activity face
-typedef struct {
-    // Current mode (which secondary face, or ongoing operation like logging)
-    activity_mode_t mode;
-
-    // Index of currently selected activity in enabled_activities
-    uint8_t type_ix;
-
-    // Used for different things depending on mode
-    // In ACTM_DONE: countdown for animation, before returning to start face
-    // In ACTM_LOGGING and ACTM_PAUSED: drives blinking colon and alternating time display
-    // In ACTM_LOGSIZE, ACTM_CLEAR: enables timeout return to choose screen
-    uint16_t counter;
-
-    // Start of currently logged activity, if any
-    watch_date_time start_time;
-
-    // Total seconds elapsed since logging started
-    uint16_t curr_total_sec;
-
-    // Total paused seconds in current log
-    uint16_t curr_pause_sec;
-
-    // Helps us handle 1/64 ticks during transmission; including countdown timer
-    chirpy_tick_state_t chirpy_tick_state;
-
-    // Used by chirpy encoder during transmission
-    chirpy_encoder_state_t chirpy_encoder_state;
-
-    // 0: Running normally
-    // 1: In LE mode
-    // 2: Just woke up from LE mode. Will go to 0 after ignoring ALARM_BUTTON_UP.
-    uint8_t le_state;
-
-} activity_state_t;
+// First byte chirped out, to identify transmission as from the activity face
+// The second byte announces the profile the transmission is in (chirpy_profile_t)
+#define ACTIVITY_CHIRPY_MAGIC 0x27
 
 #define ACTIVITY_BUF_SZ 14
 
 // Temp buffer used for sprintf'ing content for the display.
 char activity_buf[ACTIVITY_BUF_SZ];
 
-// Needed by _activity_get_next_byte to keep track of where we are in transmission
-uint16_t *activity_seq_pos;
+// Needed by _activity_get_next_byte to get at the log and keep track of where we are in transmission
+static activity_state_t *activity_chirping_state;
 
-static void _activity_clear_buffers() {
+static void _activity_clear_buffers(activity_state_t *state) {
     // Clear activity buffer; 0xcd is good for diagnostics
-    memset(activity_log_buffer, 0xcd, ACTIVITY_LOG_SZ * sizeof(activity_item_t));
+    memset(state->log, 0xcd, ACTIVITY_LOG_SZ * sizeof(activity_item_t));
     // Clear display buffer
     memset(activity_buf, 0, ACTIVITY_BUF_SZ);
 }
@@ -174,12 +100,11 @@ static uint8_t _activity_get_next_byte(uint8_t *next_byte);
 
 void activity_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr) {
     (void)settings;
-    (void)watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(activity_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(activity_state_t));
         // This happens only at boot
-        _activity_clear_buffers();
+        _activity_clear_buffers((activity_state_t *)*context_ptr);
     }
     // Do any pin or peripheral setup here; this will be called whenever the watch wakes from deep sleep.
 }
@@ -199,7 +124,7 @@ static void _activity_activate(movement_settings_t *settings, activity_state_t *
     // Those are not up-to-date because ticks have not been coming
     if (state->le_state != 0 && state->mode == ACTM_LOGGING) {
         state->le_state = 2;
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         uint32_t now_timestamp = watch_utility_date_time_to_unix_time(now, 0);
         uint32_t start_timestamp = watch_utility_date_time_to_unix_time(state->start_time, 0);
         uint32_t total_seconds = now_timestamp - start_timestamp;
@@ -218,7 +143,7 @@ static void _activity_activate(movement_settings_t *settings, activity_state_t *
 static void _activity_display_choice(activity_state_t *state) {
     watch_display_string("AC", 0);
     // If buffer is full: We say "FULL"
-    if (activity_log_count >= ACTIVITY_LOG_SZ) {
+    if (state->log_count >= ACTIVITY_LOG_SZ) {
         watch_display_string(" FULL ", 4);
     }
     // Otherwise, we show currently activity
@@ -246,7 +171,7 @@ static void _activity_update_logging_screen(movement_settings_t *settings, activ
 
     // If we're in LE state: per-minute update is special
     if (state->le_state == 1) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         uint32_t now_timestamp = watch_utility_date_time_to_unix_time(now, 0);
         uint32_t start_timestamp = watch_utility_date_time_to_unix_time(state->start_time, 0);
         uint32_t total_seconds = now_timestamp - start_timestamp;
@@ -294,7 +219,7 @@ static void _activity_update_logging_screen(movement_settings_t *settings, activ
     // Briefly, show time without seconds
     else {
         watch_clear_indicator(WATCH_INDICATOR_LAP);
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         uint8_t hour = now.unit.hour;
         if (!settings->bit.clock_mode_24h) {
             watch_clear_indicator(WATCH_INDICATOR_24H);
@@ -315,6 +240,10 @@ static void _activity_update_logging_screen(movement_settings_t *settings, activ
     }
 }
 
+static void _activity_display_chirp(activity_state_t *state) {
+    watch_display_string(state->chirpy_profile == CHIRPY_PROFILE_FAST ? "AC FCHIRP " : "AC  CHIRP ", 0);
+}
+
 static void _activity_quit_chirping() {
     watch_clear_indicator(WATCH_INDICATOR_BELL);
     watch_set_buzzer_off();
@@ -324,16 +253,15 @@ static void _activity_quit_chirping() {
 static void _activity_chirp_tick_transmit(void *context) {
     activity_state_t *state = (activity_state_t *)context;
 
-    uint8_t tone = chirpy_get_next_tone(&state->chirpy_encoder_state);
+    uint16_t period = chirpy_get_next_period(&state->chirpy_tone_queue, &state->chirpy_encoder_state);
     // Transmission over?
-    if (tone == 255) {
+    if (period == 0) {
         _activity_quit_chirping();
         state->mode = ACTM_CHIRP;
         state->counter = 0;
-        watch_display_string("AC  CHIRP ", 0);
+        _activity_display_chirp(state);
         return;
     }
-    uint16_t period = chirpy_get_tone_period(tone);
     watch_set_buzzer_period(period);
     watch_set_buzzer_on();
 }
@@ -343,8 +271,11 @@ static void _activity_chirp_tick_countdown(void *context) {
 
     // Countdown over: start actual broadcast
     if (state->chirpy_tick_state.seq_pos == 8 * 3) {
-        state->chirpy_tick_state.tick_compare = 3;
-        state->chirpy_tick_state.tick_count = 2;  // tick_compare - 1, so it starts immediately
+        if (state->chirpy_profile == CHIRPY_PROFILE_FAST)
+            state->chirpy_tick_state.tick_compare = CHIRPY_FAST_SYMBOL_TICKS;
+        else
+            state->chirpy_tick_state.tick_compare = CHIRPY_STANDARD_SYMBOL_TICKS;
+        state->chirpy_tick_state.tick_count = state->chirpy_tick_state.tick_compare - 1;  // so it starts immediately
         state->chirpy_tick_state.seq_pos = 0;
         state->chirpy_tick_state.tick_fun = _activity_chirp_tick_transmit;
         return;
@@ -367,12 +298,13 @@ static void _activity_chirp_tick_countdown(void *context) {
 }
 
 static uint8_t _activity_get_next_byte(uint8_t *next_byte) {
-    uint16_t num_bytes = 2 + activity_log_count * sizeof(activity_item_t);
-    uint16_t pos = *activity_seq_pos;
+    activity_state_t *state = activity_chirping_state;
+    uint16_t num_bytes = CHIRPY_PREFIX_LEN + state->log_count * sizeof(activity_item_t);
+    uint16_t pos = state->chirpy_tick_state.seq_pos;
 
     // Init counter
     if (pos == 0) {
-        sprintf(activity_buf, "%3d", activity_log_count);
+        sprintf(activity_buf, "%3d", state->log_count);
         watch_display_string(activity_buf, 5);
     }
 
@@ -380,19 +312,22 @@ static uint8_t _activity_get_next_byte(uint8_t *next_byte) {
         return 0;
     }
     // Two-byte prefix
-    if (pos < 2) {
-        (*next_byte) = activity_chirpy_prefix[pos];
+    if (pos == 0) {
+        (*next_byte) = ACTIVITY_CHIRPY_MAGIC;
+    }
+    else if (pos == 1) {
+        (*next_byte) = state->chirpy_profile;
     }
     // Data
     else {
-        pos -= 2;
+        pos -= CHIRPY_PREFIX_LEN;
         uint16_t ix = pos / sizeof(activity_item_t);
-        const activity_item_t *itm = &activity_log_buffer[ix];
+        const activity_item_t *itm = &state->log[ix];
         uint16_t ofs = pos % sizeof(activity_item_t);
 
         // Update counter when starting new item
         if (ofs == 0) {
-            sprintf(activity_buf, "%3d", activity_log_count - ix);
+            sprintf(activity_buf, "%3d", state->log_count - ix);
             watch_display_string(activity_buf, 5);
         }
 
@@ -423,7 +358,7 @@ static uint8_t _activity_get_next_byte(uint8_t *next_byte) {
             val = itm->activity_type;
         (*next_byte) = val;
     }
-    ++(*activity_seq_pos);
+    ++state->chirpy_tick_state.seq_pos;
     return 1;
 }
 
@@ -431,13 +366,13 @@ static void _activity_finish_logging(activity_state_t *state) {
     // Save this activity
     // If shorter than minimum for log: don't save
     // Sanity check about buffer length. This should never happen, but also we never want to overrun by error
-    if (state->curr_total_sec >= activity_min_length_sec && activity_log_count + 1 < ACTIVITY_LOG_SZ) {
-        activity_item_t *itm = &activity_log_buffer[activity_log_count];
+    if (state->curr_total_sec >= activity_min_length_sec && state->log_count + 1 < ACTIVITY_LOG_SZ) {
+        activity_item_t *itm = &state->log[state->log_count];
         itm->start_time = state->start_time;
         itm->total_sec = state->curr_total_sec;
         itm->pause_sec = state->curr_pause_sec;
         itm->activity_type = state->type_ix;
-        ++activity_log_count;
+        ++state->log_count;
     }
 
     // Go to DONE animation
@@ -540,10 +475,10 @@ static void _activity_alarm_long(movement_settings_t *settings, activity_state_t
     // On choose face: start logging activity
     if (state->mode == ACTM_CHOOSE) {
         // If buffer is full: Ignore this long press
-        if (activity_log_count >= ACTIVITY_LOG_SZ)
+        if (state->log_count >= ACTIVITY_LOG_SZ)
             return;
         // OK, we go ahead and start logging
-        state->start_time = watch_rtc_get_date_time();
+        state->start_time = movement_get_now()->local;
         state->curr_total_sec = 0;
         state->curr_pause_sec = 0;
         state->counter = -1;
@@ -558,13 +493,14 @@ static void _activity_alarm_long(movement_settings_t *settings, activity_state_t
     // If chirp: kick off chirping
     else if (state->mode == ACTM_CHIRP) {
         // Set up our tick handling for countdown beeps
-        activity_seq_pos = &state->chirpy_tick_state.seq_pos;
+        activity_chirping_state = state;
         state->chirpy_tick_state.tick_compare = 8;
         state->chirpy_tick_state.tick_count = 7;  // tick_compare - 1, so it starts immediately
         state->chirpy_tick_state.seq_pos = 0;
         state->chirpy_tick_state.tick_fun = _activity_chirp_tick_countdown;
         // Set up chirpy encoder
-        chirpy_init_encoder(&state->chirpy_encoder_state, _activity_get_next_byte);
+        chirpy_init_encoder_with_profile(&state->chirpy_encoder_state, _activity_get_next_byte, state->chirpy_profile);
+        chirpy_init_tone_queue(&state->chirpy_tone_queue);
         // Show bell; switch to 64/sec ticks
         watch_set_indicator(WATCH_INDICATOR_BELL);
         movement_request_tick_frequency(64);
@@ -572,7 +508,7 @@ static void _activity_alarm_long(movement_settings_t *settings, activity_state_t
     }
     // If clear: confirm (unless empty)
     else if (state->mode == ACTM_CLEAR) {
-        if (activity_log_count == 0)
+        if (state->log_count == 0)
             return;
         state->mode = ACTM_CLEAR_CONFIRM;
         state->counter = -1;
@@ -580,8 +516,8 @@ static void _activity_alarm_long(movement_settings_t *settings, activity_state_t
     }
     // If clear confirm: do clear.
     else if (state->mode == ACTM_CLEAR_CONFIRM) {
-        _activity_clear_buffers();
-        activity_log_count = 0;
+        _activity_clear_buffers(state);
+        state->log_count = 0;
         state->mode = ACTM_CLEAR_DONE;
         state->counter = -1;
         watch_display_string("0     ", 4);
@@ -607,12 +543,21 @@ static void _activity_alarm_short(movement_settings_t *settings, activity_state_
         state->counter = 0;
         _activity_update_logging_screen(settings, state);
     }
+    // If chirp: switch between the standard and fast profiles
+    else if (state->mode == ACTM_CHIRP) {
+        if (state->chirpy_profile == CHIRPY_PROFILE_STANDARD)
+            state->chirpy_profile = CHIRPY_PROFILE_FAST;
+        else
+            state->chirpy_profile = CHIRPY_PROFILE_STANDARD;
+        state->counter = 0;
+        _activity_display_chirp(state);
+    }
     // If chirping: stoppit
     else if (state->mode == ACTM_CHIRPING) {
         _activity_quit_chirping();
         state->mode = ACTM_CHIRP;
         state->counter = 0;
-        watch_display_string("AC  CHIRP ", 0);
+        _activity_display_chirp(state);
     }
 }
 
@@ -621,14 +566,14 @@ static void _activity_light_short(activity_state_t *state) {
     if (state->mode == ACTM_CHOOSE) {
         state->mode = ACTM_LOGSIZE;
         state->counter = 0;
-        sprintf(activity_buf, "AC  L#g%3d", activity_log_count);
+        sprintf(activity_buf, "AC  L#g%3d", state->log_count);
         watch_display_string(activity_buf, 0);
     }
     // If log size face: move to chirp
     else if (state->mode == ACTM_LOGSIZE) {
         state->mode = ACTM_CHIRP;
         state->counter = 0;
-        watch_display_string("AC  CHIRP ", 0);
+        _activity_display_chirp(state);
     }
     // If chirp face: move to clear
     else if (state->mode == ACTM_CHIRP) {
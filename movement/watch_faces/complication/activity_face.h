@@ -36,6 +36,8 @@
  * using the watch's piezo buzzer as a modem, then clear the log in the watch.
  * To record and decode a chirpy transmission on your computer, you can use the web app here:
  * https://jealousmarkup.xyz/off/chirpy/rx/
+ * A transmission starts with 0x27, which says it's from the activity face, then the profile it was
+ * sent in (0 for standard, 1 for fast), then 9 bytes for each activity.
  * 
  * Using the face
  * 
@@ -50,6 +52,9 @@
  * When you're not loggin, you can press LIGHT to access the secondary faces.
  * LIGHT #1 => Shows the size of the log (how many activities have been recorded).
  * LIGHT #2 => The screen to chirp out the data. Press LONG ALARM to start chirping.
+ *             ALARM switches between the standard chirpy profile and the fast one (an F shows next to AC),
+ *             which takes about half as long, but which the web app below doesn't decode; the reference
+ *             receiver in lib/chirpy_tx/test decodes both.
  * LIGHT #3 => The screen to clear the log in the watch. Press LONG ALARM twice to clear data.
  *
  * Quirky details
@@ -70,12 +75,96 @@
  */
 
 #include "movement.h"
+#include "chirpy_tx.h"
+
+// One logged activity
+typedef struct __attribute__((__packed__)) {
+    // Activity's start time
+    watch_date_time start_time;
+
+    // Total duration of activity, including time spend in paus
+    uint16_t total_sec;
+
+    // Number of seconds the activity was paused
+    uint16_t pause_sec;
+
+    // Type of activity (index in activity_names)
+    uint8_t activity_type;
+
+} activity_item_t;
+
+// Size of (fixed) buffer to log activites. Takes up x9 bytes in SRAM if face is installed.
+#define ACTIVITY_LOG_SZ 99
+
+// The face's different UI modes (views).
+typedef enum {
+    ACTM_CHOOSE = 0,
+    ACTM_LOGGING,
+    ACTM_PAUSED,
+    ACTM_DONE,
+    ACTM_LOGSIZE,
+    ACTM_CHIRP,
+    ACTM_CHIRPING,
+    ACTM_CLEAR,
+    ACTM_CLEAR_CONFIRM,
+    ACTM_CLEAR_DONE,
+} activity_mode_t;
+
+// The full state of the activity face
+typedef struct {
+    // Current mode (which secondary face, or ongoing operation like logging)
+    activity_mode_t mode;
+
+    // Index of currently selected activity in enabled_activities
+    uint8_t type_ix;
+
+    // Used for different things depending on mode
+    // In ACTM_DONE: countdown for animation, before returning to start face
+    // In ACTM_LOGGING and ACTM_PAUSED: drives blinking colon and alternating time display
+    // In ACTM_LOGSIZE, ACTM_CLEAR: enables timeout return to choose screen
+    uint16_t counter;
+
+    // Start of currently logged activity, if any
+    watch_date_time start_time;
+
+    // Total seconds elapsed since logging started
+    uint16_t curr_total_sec;
+
+    // Total paused seconds in current log
+    uint16_t curr_pause_sec;
+
+    // Helps us handle 1/64 ticks during transmission; including countdown timer
+    chirpy_tick_state_t chirpy_tick_state;
+
+    // Used by chirpy encoder during transmission
+    chirpy_encoder_state_t chirpy_encoder_state;
+
+    // Tones encoded ahead of the transmission
+    chirpy_tone_queue_t chirpy_tone_queue;
+
+    // Profile to chirp the log out in
+    chirpy_profile_t chirpy_profile;
+
+    // 0: Running normally
+    // 1: In LE mode
+    // 2: Just woke up from LE mode. Will go to 0 after ignoring ALARM_BUTTON_UP.
+    uint8_t le_state;
+
+    // Number of activities in the log
+    uint8_t log_count;
+
+    // All logged activities; kept here, with the rest of the state, so they're saved when the watch hibernates
+    activity_item_t log[ACTIVITY_LOG_SZ];
+
+} activity_state_t;
 
 void activity_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
 void activity_face_activate(movement_settings_t *settings, void *context);
 bool activity_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void activity_face_resign(movement_settings_t *settings, void *context);
 
+#define activity_face_context_size sizeof(activity_state_t)
+
 #define activity_face ((const watch_face_t){ \
     activity_face_setup, \
     activity_face_activate, \
@@ -145,7 +145,7 @@ static void _alarm_update_alarm_enabled(movement_settings_t *settings, alarm_sta
             break;
             } else {
                 if (!now_init) {
-                    now = watch_rtc_get_date_time();
+                    now = movement_get_now()->local;
                     now_init = true;
                     weekday_idx = _get_weekday_idx(now);
                     now_minutes_of_day = now.unit.hour * 60 + now.unit.minute;
@@ -198,10 +198,9 @@ static void _abort_quick_ticks(alarm_state_t *state) {
 
 void alarm_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(alarm_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         alarm_state_t *state = (alarm_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(alarm_state_t));
         // initialize the default alarm values
@@ -234,7 +233,7 @@ void alarm_face_resign(movement_settings_t *settings, void *context) {
 bool alarm_face_wants_background_task(movement_settings_t *settings, void *context) {
     (void) settings;
     alarm_state_t *state = (alarm_state_t *)context;
-    watch_date_time now = watch_rtc_get_date_time();
+    watch_date_time now = movement_get_now()->local;
     // just a failsafe: never fire more than one alarm within a minute
     if (state->alarm_handled_minute == now.unit.minute) return false;
     state->alarm_handled_minute = now.unit.minute;
@@ -60,6 +60,7 @@ static const char astronomy_celestial_body_names[NUM_AVAILABLE_BODIES][3] = {
 };
 
 static void _astronomy_face_recalculate(movement_settings_t *settings, astronomy_state_t *state) {
+    (void) settings;
 #if __EMSCRIPTEN__
     int16_t browser_lat = EM_ASM_INT({
         return lat;
@@ -79,9 +80,7 @@ static void _astronomy_face_recalculate(movement_settings_t *settings, astronomy
     }
 #endif
 
-    watch_date_time date_time = watch_rtc_get_date_time();
-    uint32_t timestamp = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60);
-    date_time = watch_utility_date_time_from_unix_time(timestamp, 0);
+    watch_date_time date_time = movement_get_now()->utc;
     double jd = astro_convert_date_to_julian_date(date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day, date_time.unit.hour, date_time.unit.minute, date_time.unit.second);
 
     astro_equatorial_coordinates_t radec_precession = astro_get_ra_dec(jd, astronomy_available_celestial_bodies[state->active_body_index], state->latitude_radians, state->longitude_radians, true);
@@ -150,7 +149,9 @@ static void _astronomy_face_update(movement_event_t event, movement_settings_t *
             watch_clear_display();
              // this takes a moment and locks the UI, flash C for "Calculating"
             watch_start_character_blink('C', 100);
+            movement_request_performance_level(MOVEMENT_PERFORMANCE_HIGH);
             _astronomy_face_recalculate(settings, state);
+            movement_request_performance_level(MOVEMENT_PERFORMANCE_LOW);
             watch_stop_blink();
             state->mode = ASTRONOMY_MODE_DISPLAYING_ALT;
             // fall through
@@ -190,9 +191,8 @@ static void _astronomy_face_update(movement_event_t event, movement_settings_t *
 
 void astronomy_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(astronomy_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(astronomy_state_t));
     }
 }
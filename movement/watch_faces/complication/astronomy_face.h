@@ -98,6 +98,8 @@ void astronomy_face_activate(movement_settings_t *settings, void *context);
 bool astronomy_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void astronomy_face_resign(movement_settings_t *settings, void *context);
 
+#define astronomy_face_context_size sizeof(astronomy_state_t)
+
 #define astronomy_face ((const watch_face_t){ \
     astronomy_face_setup, \
     astronomy_face_activate, \
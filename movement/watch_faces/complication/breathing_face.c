@@ -27,11 +27,6 @@
 #include "breathing_face.h"
 #include "watch.h"
 
-typedef struct {
-    uint8_t current_stage;
-    bool sound_on;
-} breathing_state_t;
-
 static void beep_in (void);
 static void beep_in_hold (void);
 static void beep_out (void);
@@ -41,11 +36,10 @@ void breathing_face_setup(movement_settings_t *settings, uint8_t watch_face_inde
     // These next two lines just silence the compiler warnings associated with unused parameters.
     // We have no use for the settings or the watch_face_index, so we make that explicit here.
     (void) settings;
-    (void) watch_face_index;
     // At boot, context_ptr will be NULL indicating that we don't have anyplace to store our context.
     if (*context_ptr == NULL) {
         // in this case, we allocate an area of memory sufficient to store the stuff we need to track.
-        *context_ptr = malloc(sizeof(breathing_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
     }
 }
 
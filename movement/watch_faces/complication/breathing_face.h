@@ -38,11 +38,18 @@
 
 #include "movement.h"
 
+typedef struct {
+    uint8_t current_stage;
+    bool sound_on;
+} breathing_state_t;
+
 void breathing_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
 void breathing_face_activate(movement_settings_t *settings, void *context);
 bool breathing_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void breathing_face_resign(movement_settings_t *settings, void *context);
 
+#define breathing_face_context_size sizeof(breathing_state_t)
+
 #define breathing_face ((const watch_face_t){ \
     breathing_face_setup, \
     breathing_face_activate, \
@@ -45,7 +45,8 @@ static void abort_quick_ticks(countdown_state_t *state) {
 }
 
 static inline int32_t get_tz_offset(movement_settings_t *settings) {
-    return movement_timezone_offsets[settings->bit.time_zone] * 60;
+    (void) settings;
+    return movement_get_current_timezone_offset();
 }
 
 static inline void store_countdown(countdown_state_t *state) {
@@ -69,10 +70,8 @@ static inline void button_beep(movement_settings_t *settings) {
 }
 
 static void start(countdown_state_t *state, movement_settings_t *settings) {
-    watch_date_time now = watch_rtc_get_date_time();
-
     state->mode = cd_running;
-    state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
+    state->now_ts = movement_get_now()->timestamp;
     state->target_ts = watch_utility_offset_timestamp(state->now_ts, state->hours, state->minutes, state->seconds);
     watch_date_time target_dt = watch_utility_date_time_from_unix_time(state->target_ts, get_tz_offset(settings));
     movement_schedule_background_task(target_dt);
@@ -159,10 +158,9 @@ static void settings_increment(countdown_state_t *state) {
 
 void countdown_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(countdown_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         countdown_state_t *state = (countdown_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(countdown_state_t));
         state->minutes = DEFAULT_MINUTES;
@@ -175,8 +173,7 @@ void countdown_face_activate(movement_settings_t *settings, void *context) {
     (void) settings;
     countdown_state_t *state = (countdown_state_t *)context;
     if(state->mode == cd_running) {
-        watch_date_time now = watch_rtc_get_date_time();
-        state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
+        state->now_ts = movement_get_now()->timestamp;
         watch_set_indicator(WATCH_INDICATOR_BELL);
     }
     watch_set_colon();
@@ -70,6 +70,8 @@ void countdown_face_activate(movement_settings_t *settings, void *context);
 bool countdown_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void countdown_face_resign(movement_settings_t *settings, void *context);
 
+#define countdown_face_context_size sizeof(countdown_state_t)
+
 #define countdown_face ((const watch_face_t){ \
     countdown_face_setup, \
     countdown_face_activate, \
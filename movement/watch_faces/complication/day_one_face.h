@@ -72,6 +72,8 @@ void day_one_face_activate(movement_settings_t *settings, void *context);
 bool day_one_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void day_one_face_resign(movement_settings_t *settings, void *context);
 
+#define day_one_face_context_size sizeof(day_one_state_t)
+
 #define day_one_face ((const watch_face_t){ \
     day_one_face_setup, \
     day_one_face_activate, \
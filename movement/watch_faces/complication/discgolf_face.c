@@ -148,10 +148,9 @@ static inline void store_best(discgolf_state_t *state) {
 /* Configuration at boot, the high score array can be initialized with your high scores if they're known */
 void discgolf_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-       *context_ptr = malloc(sizeof(discgolf_state_t));
+       *context_ptr = movement_get_context_slot(watch_face_index);
        discgolf_state_t *state = (discgolf_state_t *)*context_ptr;
        memset(*context_ptr, 0, sizeof(discgolf_state_t));
        state->hole = 1;
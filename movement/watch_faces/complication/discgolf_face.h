@@ -83,6 +83,8 @@ void discgolf_face_activate(movement_settings_t *settings, void *context);
 bool discgolf_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void discgolf_face_resign(movement_settings_t *settings, void *context);
 
+#define discgolf_face_context_size sizeof(discgolf_state_t)
+
 #define discgolf_face ((const watch_face_t){ \
     discgolf_face_setup, \
     discgolf_face_activate, \
@@ -30,93 +30,35 @@
 #include "watch_utility.h"
 #include "watch_rtc.h"
 
-/*
- * IMPORTANT: This watch face uses the same TC2 callback counter as the Stock Stopwatch
- * watch-face. It works through calling a global handler function. The two watch-faces
- * therefore can't coexist within the same firmware. If you want to compile this watch-face
- * then you need to remove the line <../watch_faces/complication/stock_stopwatch_face.c \>
- * from the Makefile.
- */
-
 // FROM stock_stopwatch_face.c ////////////////////////////////////////////////
 // Copyright (c) 2022 Andreas Nebinger
 
-#if __EMSCRIPTEN__
-#include <emscripten.h>
-#include <emscripten/html5.h>
-#else
-#include "../../../watch-library/hardware/include/saml22j18a.h"
-#include "../../../watch-library/hardware/include/component/tc.h"
-#include "../../../watch-library/hardware/hri/hri_tc_l22.h"
-#endif
-
 static const watch_date_time distant_future = {.unit = {0, 0, 0, 1, 1, 63}};
 static bool _is_running;
 static uint32_t _ticks;
-
-#if __EMSCRIPTEN__
-
-static long _em_interval_id = 0;
-
-void em_dual_timer_cb_handler(void *userData) {
-    // interrupt handler for emscripten 128 Hz callbacks
-    (void) userData;
-    _ticks++;
-}
-
-static void _dual_timer_cb_initialize() { }
-
-static inline void _dual_timer_cb_stop() {
-    emscripten_clear_interval(_em_interval_id);
-    _em_interval_id = 0;
-    _is_running = false;
-}
+static uint32_t _timestamp;
 
 static inline void _dual_timer_cb_start() {
-    // initiate 128 hz callback
-    _em_interval_id = emscripten_set_interval(em_dual_timer_cb_handler, (double)(1000/128), (void *)NULL);
+    // count 128 Hz ticks from now on, without being interrupted for each of them
+    watch_rtc_enable_timestamp_ticks();
+    _timestamp = watch_rtc_get_timestamp_ticks();
+    _is_running = true;
 }
 
-#else
-
-static inline void _dual_timer_cb_start() {
-    // start the TC2 timer
-    hri_tc_set_CTRLA_ENABLE_bit(TC2);
-    _is_running = true;
+static void _dual_timer_update_ticks() {
+    // add the ticks that have passed since the last update
+    if (!_is_running) return;
+    uint32_t timestamp = watch_rtc_get_timestamp_ticks();
+    _ticks += timestamp - _timestamp;
+    _timestamp = timestamp;
 }
 
 static inline void _dual_timer_cb_stop() {
-    // stop the TC2 timer
-    hri_tc_clear_CTRLA_ENABLE_bit(TC2);
+    _dual_timer_update_ticks();
+    watch_rtc_disable_timestamp_ticks();
     _is_running = false;
 }
 
-static void _dual_timer_cb_initialize() {
-    // setup and initialize TC2 for a 64 Hz interrupt
-    hri_mclk_set_APBCMASK_TC2_bit(MCLK);
-    hri_gclk_write_PCHCTRL_reg(GCLK, TC2_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK3 | GCLK_PCHCTRL_CHEN);
-    _dual_timer_cb_stop();
-    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC2, TC_SYNCBUSY_SWRST);
-    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_PRESCALER_DIV64 | // 32 Khz divided by 64 divided by 4 results in a 128 Hz interrupt
-                           TC_CTRLA_MODE_COUNT8 | 
-                           TC_CTRLA_RUNSTDBY);
-    hri_tccount8_write_PER_reg(TC2, 3);
-    hri_tc_set_INTEN_OVF_bit(TC2);
-    NVIC_ClearPendingIRQ(TC2_IRQn);
-    NVIC_EnableIRQ (TC2_IRQn);
-}
-
-// you need to take stock_stopwatch.c out of the Makefile or this will create a conflict
-// you have to choose between one of the stopwatches
- void TC2_Handler(void) {
-    // interrupt handler for TC2 (globally!)
-    _ticks++;
-    TC2->COUNT8.INTFLAG.reg |= TC_INTFLAG_OVF;
-}
-
-#endif
-
 // STATIC FUNCTIONS ///////////////////////////////////////////////////////////
 
 /** @brief converts tick counts to duration struct for time display 
@@ -153,7 +95,6 @@ static dual_timer_duration_t ticks_to_duration(uint32_t ticks) {
 static void start_timer(dual_timer_state_t *state, bool timer) {
     // if it is not running yet, run it
     if ( !_is_running ) {
-        _is_running = true;
         movement_request_tick_frequency(16);
         state->start_ticks[timer] = 0;
         state->stop_ticks[timer] = 0;
@@ -179,7 +120,6 @@ static void stop_timer(dual_timer_state_t *state, bool timer) {
     state->running[timer] = false;
     // if the other timer is not running, stop callback
     if ( state->running[!timer] == false ) {
-        _is_running = false;
         _dual_timer_cb_stop();
         movement_request_tick_frequency(1);
         movement_cancel_background_task();
@@ -228,15 +168,11 @@ static void dual_timer_display(dual_timer_state_t *state) {
 
 void dual_timer_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(dual_timer_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(dual_timer_state_t));
         _ticks = 0;
     }
-    if (!_is_running) {
-        _dual_timer_cb_initialize();
-    }
 }
 
 void dual_timer_face_activate(movement_settings_t *settings, void *context) {
@@ -250,6 +186,8 @@ void dual_timer_face_activate(movement_settings_t *settings, void *context) {
 bool dual_timer_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
     dual_timer_state_t *state = (dual_timer_state_t *)context;
 
+    _dual_timer_update_ticks();
+
     // timers stop at 99:23:59:59:99
     if ( (_ticks - state->start_ticks[0]) >= 1105919999 )
         stop_timer(state, 0);
@@ -72,10 +72,9 @@ static void _throw_animation(geomancy_state_t *state);
 // WATCH FACE FUNCTIONS ///////////////////////////////////////////////////////
 
 void geomancy_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
-    (void) watch_face_index;
     (void) settings;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(geomancy_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(geomancy_state_t));
     }
 }
@@ -87,6 +87,8 @@ void geomancy_face_activate(movement_settings_t *settings, void *context);
 bool geomancy_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void geomancy_face_resign(movement_settings_t *settings, void *context);
 
+#define geomancy_face_context_size sizeof(geomancy_state_t)
+
 #define geomancy_face ((const watch_face_t){ \
     geomancy_face_setup, \
     geomancy_face_activate, \
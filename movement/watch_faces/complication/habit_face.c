@@ -31,7 +31,7 @@
 #include <string.h>
 
 static inline uint32_t today_unix(const uint32_t utc_offset) {
-  const watch_date_time dt = watch_rtc_get_date_time();
+  const watch_date_time dt = movement_get_now()->local;
   return watch_utility_convert_to_unix_time(dt.unit.year + 2020, dt.unit.month,
                                             dt.unit.day, 0, 0, 0, utc_offset);
 }
@@ -41,19 +41,11 @@ static inline uint32_t days_since_unix(const uint32_t since,
   return (until - since) / (60 * 60 * 24);
 }
 
-typedef struct {
-  uint16_t total_count;
-  uint8_t lookback;
-  uint32_t last_update;
-  bool display_total;
-} habit_state_t;
-
 void habit_face_setup(movement_settings_t *settings, uint8_t watch_face_index,
                       void **context_ptr) {
   (void)settings;
-  (void)watch_face_index;
   if (*context_ptr == NULL) {
-    *context_ptr = malloc(sizeof(habit_state_t));
+    *context_ptr = movement_get_context_slot(watch_face_index);
     memset(*context_ptr, 0, sizeof(habit_state_t));
     habit_state_t *state = (habit_state_t *)*context_ptr;
     state->lookback = 0;
@@ -36,12 +36,21 @@
 
 #include "movement.h"
 
+typedef struct {
+  uint16_t total_count;
+  uint8_t lookback;
+  uint32_t last_update;
+  bool display_total;
+} habit_state_t;
+
 void habit_face_setup(movement_settings_t *settings, uint8_t watch_face_index,
                       void **context_ptr);
 void habit_face_activate(movement_settings_t *settings, void *context);
 bool habit_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void habit_face_resign(movement_settings_t *settings, void *context);
 
+#define habit_face_context_size sizeof(habit_state_t)
+
 #define habit_face ((const watch_face_t){ \
     habit_face_setup, \
     habit_face_activate, \
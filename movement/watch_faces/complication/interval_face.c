@@ -79,12 +79,7 @@ static const int8_t _sound_seq_finish[] = {BUZZER_NOTE_C7, 6, BUZZER_NOTE_E7, 6,
 static interval_setting_idx_t _setting_idx;
 static int8_t _ticks;
 static bool _erase_timer_flag;
-static uint32_t _target_ts;
 static uint32_t _now_ts;
-static uint32_t _paused_ts;
-static uint8_t _timer_work_round;
-static uint8_t _timer_full_round;
-static uint8_t _timer_run_state;
 
 static inline void _inc_uint8(uint8_t *value, uint8_t step, uint8_t max) {
     *value += step;
@@ -93,8 +88,7 @@ static inline void _inc_uint8(uint8_t *value, uint8_t step, uint8_t max) {
 
 static uint32_t _get_now_ts() {
     // returns the current date time as unix timestamp
-    watch_date_time now = watch_rtc_get_date_time();
-    return watch_utility_date_time_to_unix_time(now, 0);
+    return movement_get_now()->local_timestamp;
 }
 
 static inline void _button_beep(movement_settings_t *settings) {
@@ -187,14 +181,14 @@ static void _face_draw(interval_face_state_t *state, uint8_t subsecond) {
         else 
             watch_clear_indicator(WATCH_INDICATOR_LAP);
     } else if (state->face_state == interval_state_running || state->face_state == interval_state_pausing) {
-        tmp = _timer_full_round;
-        switch (_timer_run_state) {
+        tmp = state->timer_full_round;
+        switch (state->timer_run_state) {
         case 0:
             sprintf(buf, INTERVAL_FACE_STATE_WARMUP);
             break;
         case 1:
             sprintf(buf, INTERVAL_FACE_STATE_WORK);
-            if (state->timer[state->timer_idx].work_rounds > 1) tmp = _timer_work_round;
+            if (state->timer[state->timer_idx].work_rounds > 1) tmp = state->timer_work_round;
             break;
         case 2:
             sprintf(buf, INTERVAL_FACE_STATE_BREAK);
@@ -209,13 +203,13 @@ static void _face_draw(interval_face_state_t *state, uint8_t subsecond) {
         
         if (state->face_state == interval_state_pausing) {
             // pausing
-            delta = div(_target_ts - _paused_ts, 60);
+            delta = div(state->target_ts - state->paused_ts, 60);
             // blink the bell icon
             if (_now_ts % 2) watch_set_indicator(WATCH_INDICATOR_BELL);
             else watch_clear_indicator(WATCH_INDICATOR_BELL);
         } else
             // running
-            delta = div(_target_ts - _now_ts, 60);
+            delta = div(state->target_ts - _now_ts, 60);
         sprintf(&buf[2], " %1d%02d%02d%2d", state->timer_idx + 1, delta.quot, delta.rem, tmp + 1);
     }
     // write out to lcd
@@ -306,7 +300,7 @@ static void _set_next_timestamp(interval_face_state_t *state) {
     uint16_t delta = 0;
     int8_t *sound_seq;
     interval_timer_setting_t timer = state->timer[state->timer_idx];
-    switch (_timer_run_state) {
+    switch (state->timer_run_state) {
     case 0:
         delta = timer.warmup_minutes * 60 + timer.warmup_seconds;
         sound_seq = (int8_t *)_sound_seq_warmup;
@@ -329,9 +323,9 @@ static void _set_next_timestamp(interval_face_state_t *state) {
     }
     // failsafe
     if (delta <= 0) delta = 1;
-    _target_ts += delta;
+    state->target_ts += delta;
     // schedule next background task
-    watch_date_time target_dt = watch_utility_date_time_from_unix_time(_target_ts, 0);
+    watch_date_time target_dt = watch_utility_date_time_from_unix_time(state->target_ts, 0);
     movement_schedule_background_task_for_face(state->face_idx, target_dt);
     // play sound
     watch_buzzer_play_sequence(sound_seq, NULL);
@@ -351,9 +345,9 @@ static void _init_timer_info(interval_face_state_t *state) {
     if (state->is_active) movement_request_tick_frequency(2);
 }
 
-static void _abort_running_timer() {
-    _timer_work_round = _timer_full_round = 0;
-    _timer_run_state = 0;
+static void _abort_running_timer(interval_face_state_t *state) {
+    state->timer_work_round = state->timer_full_round = 0;
+    state->timer_run_state = 0;
     movement_cancel_background_task();
     watch_clear_indicator(WATCH_INDICATOR_BELL);
     watch_buzzer_play_note(BUZZER_NOTE_C8, 100);
@@ -362,8 +356,8 @@ static void _abort_running_timer() {
 static void _resume_paused_timer(interval_face_state_t *state) {
     // resume paused timer
     _now_ts = _get_now_ts();
-    _target_ts += _now_ts - _paused_ts;
-    watch_date_time target_dt = watch_utility_date_time_from_unix_time(_target_ts, 0);
+    state->target_ts += _now_ts - state->paused_ts;
+    watch_date_time target_dt = watch_utility_date_time_from_unix_time(state->target_ts, 0);
     movement_schedule_background_task_for_face(state->face_idx, target_dt);
     state->face_state = interval_state_running;
     watch_set_indicator(WATCH_INDICATOR_BELL);
@@ -373,7 +367,7 @@ void interval_face_setup(movement_settings_t *settings, uint8_t watch_face_index
     (void) settings;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(interval_face_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         interval_face_state_t *state = (interval_face_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(interval_face_state_t));
         state->face_idx = watch_face_index;
@@ -486,7 +480,7 @@ bool interval_face_loop(movement_event_t event, movement_settings_t *settings, v
         if (state->face_state == interval_state_setting) {
             _resume_setting(state, event.subsecond);
         } else {
-            if (state->face_state >= interval_state_running ) _abort_running_timer();
+            if (state->face_state >= interval_state_running ) _abort_running_timer(state);
             _initiate_setting(state, event.subsecond);
         }
         break;
@@ -506,7 +500,7 @@ bool interval_face_loop(movement_event_t event, movement_settings_t *settings, v
         case interval_state_running:
             // pause timer
             _button_beep(settings);
-            _paused_ts = _get_now_ts();
+            state->paused_ts = _get_now_ts();
             state->face_state = interval_state_pausing;
             movement_cancel_background_task();
             _face_draw(state, event.subsecond);
@@ -535,14 +529,14 @@ bool interval_face_loop(movement_event_t event, movement_settings_t *settings, v
                 _init_timer_info(state);
             } else {
                 // set initial state and start timer
-                _timer_work_round = _timer_full_round = 0;
-                if (timer->warmup_minutes + timer->warmup_seconds) _timer_run_state = 0;
-                else if (timer->work_minutes + timer->work_seconds) _timer_run_state = 1;
-                else if (timer->break_minutes + timer->break_seconds) _timer_run_state = 2;
-                else if (timer->cooldown_minutes + timer->cooldown_seconds) _timer_run_state = 3;
+                state->timer_work_round = state->timer_full_round = 0;
+                if (timer->warmup_minutes + timer->warmup_seconds) state->timer_run_state = 0;
+                else if (timer->work_minutes + timer->work_seconds) state->timer_run_state = 1;
+                else if (timer->break_minutes + timer->break_seconds) state->timer_run_state = 2;
+                else if (timer->cooldown_minutes + timer->cooldown_seconds) state->timer_run_state = 3;
                 movement_request_tick_frequency(1);
                 _now_ts = _get_now_ts();
-                _target_ts = _now_ts;
+                state->target_ts = _now_ts;
                 _set_next_timestamp(state);
                 state->face_state = interval_state_running;
                 watch_set_indicator(WATCH_INDICATOR_BELL);
@@ -550,7 +544,7 @@ bool interval_face_loop(movement_event_t event, movement_settings_t *settings, v
             }
         } else if (state->face_state == interval_state_running) {
             // stop the timer
-            _abort_running_timer();
+            _abort_running_timer(state);
             _init_timer_info(state);
         } else if (state->face_state == interval_state_pausing) {
             // resume paused timer
@@ -564,43 +558,43 @@ bool interval_face_loop(movement_event_t event, movement_settings_t *settings, v
         break;
     case EVENT_BACKGROUND_TASK:
         // find the next timestamp or end the timer
-        if (_timer_run_state == 0) {
+        if (state->timer_run_state == 0) {
             // warmup finished
-            if (timer->work_minutes + timer->work_seconds) _timer_run_state = 1;
-            else if (timer->break_minutes + timer->break_seconds) _timer_run_state = 2;
-            else if (timer->cooldown_minutes + timer->cooldown_seconds) _timer_run_state = 3;
-            else _timer_run_state = 4;
-        } else if (_timer_run_state == 1) {
+            if (timer->work_minutes + timer->work_seconds) state->timer_run_state = 1;
+            else if (timer->break_minutes + timer->break_seconds) state->timer_run_state = 2;
+            else if (timer->cooldown_minutes + timer->cooldown_seconds) state->timer_run_state = 3;
+            else state->timer_run_state = 4;
+        } else if (state->timer_run_state == 1) {
             // work finished
-            _timer_work_round++;
-            if (_timer_work_round == timer->work_rounds) {
-                _timer_work_round = 0;
+            state->timer_work_round++;
+            if (state->timer_work_round == timer->work_rounds) {
+                state->timer_work_round = 0;
                 if (timer->break_minutes + timer->break_seconds && (timer->full_rounds == 0 
-                    || (timer->full_rounds && _timer_full_round + 1 < timer->full_rounds))) _timer_run_state = 2;
+                    || (timer->full_rounds && state->timer_full_round + 1 < timer->full_rounds))) state->timer_run_state = 2;
                 else {
-                    _timer_full_round++;
-                    if (timer->full_rounds && _timer_full_round == timer->full_rounds) {
-                        if (timer->cooldown_minutes + timer->cooldown_seconds) _timer_run_state = 3;
-                        else _timer_run_state = 4;
-                    } else _timer_run_state = 1;
+                    state->timer_full_round++;
+                    if (timer->full_rounds && state->timer_full_round == timer->full_rounds) {
+                        if (timer->cooldown_minutes + timer->cooldown_seconds) state->timer_run_state = 3;
+                        else state->timer_run_state = 4;
+                    } else state->timer_run_state = 1;
                 }
             }
-        } else if (_timer_run_state == 2) {
+        } else if (state->timer_run_state == 2) {
             // break finished
-            _timer_full_round++;
-            _timer_work_round = 0;
-            if (timer->full_rounds && _timer_full_round == timer->full_rounds) {
-                if (timer->cooldown_minutes + timer->cooldown_seconds) _timer_run_state = 3;
-                else _timer_run_state = 4;
-                _timer_full_round--;
+            state->timer_full_round++;
+            state->timer_work_round = 0;
+            if (timer->full_rounds && state->timer_full_round == timer->full_rounds) {
+                if (timer->cooldown_minutes + timer->cooldown_seconds) state->timer_run_state = 3;
+                else state->timer_run_state = 4;
+                state->timer_full_round--;
             } else {
-                if (timer->work_minutes + timer->work_seconds) _timer_run_state = 1;
+                if (timer->work_minutes + timer->work_seconds) state->timer_run_state = 1;
             }
-        } else if (_timer_run_state == 3)
+        } else if (state->timer_run_state == 3)
             // cooldown finished
-            _timer_run_state = 4;
+            state->timer_run_state = 4;
         // set next timestamp or play final sound sequence
-        if (_timer_run_state < 4) {
+        if (state->timer_run_state < 4) {
             // transition to next timer phase
             _set_next_timestamp(state);
         } else {
@@ -109,6 +109,11 @@ typedef struct {
     uint8_t timer_running_idx;
     interval_timer_state_t face_state;
     interval_timer_setting_t timer[INTERVAL_TIMERS];
+    uint32_t target_ts;
+    uint32_t paused_ts;
+    uint8_t timer_work_round;
+    uint8_t timer_full_round;
+    uint8_t timer_run_state;
 } interval_face_state_t;
 
 void interval_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
@@ -116,6 +121,8 @@ void interval_face_activate(movement_settings_t *settings, void *context);
 bool interval_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void interval_face_resign(movement_settings_t *settings, void *context);
 
+#define interval_face_context_size sizeof(interval_face_state_t)
+
 #define interval_face ((const watch_face_t) { \
     interval_face_setup, \
     interval_face_activate, \
@@ -22,11 +22,6 @@
  * SOFTWARE.
  */
 
-// Emulator only: need time() to seed the random number generator
-#if __EMSCRIPTEN__
-#include <time.h>
-#endif
-
 #include <stdlib.h>
 #include <string.h>
 #include "watch_private_display.h"
@@ -84,11 +79,7 @@ static uint16_t _score;                 // score of the current game
 
 /// @brief return a random number. 0 <= return_value < num_values
 static inline uint8_t _get_rand_num(uint8_t num_values) {
-#if __EMSCRIPTEN__
-    return rand() % num_values;
-#else
-    return arc4random_uniform(num_values);
-#endif
+    return movement_random_uniform(num_values);
 }
 
 /// @brief callback function to re-enable light and alarm buttons after playing a sound sequence
@@ -205,19 +196,13 @@ static bool _move_invaders() {
 
 void invaders_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(invaders_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(invaders_state_t));
         invaders_state_t *state = (invaders_state_t *)*context_ptr;
         // default: sound on
         state->sound_on = true;
     }
-#if __EMSCRIPTEN__
-    // simulator only: seed the randon number generator
-    time_t t;
-    srand((unsigned) time(&t));
-#endif
 }
 
 void invaders_face_activate(movement_settings_t *settings, void *context) {
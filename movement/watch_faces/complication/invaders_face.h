@@ -70,6 +70,8 @@ void invaders_face_activate(movement_settings_t *settings, void *context);
 bool invaders_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void invaders_face_resign(movement_settings_t *settings, void *context);
 
+#define invaders_face_context_size sizeof(invaders_state_t)
+
 #define invaders_face ((const watch_face_t){ \
     invaders_face_setup, \
     invaders_face_activate, \
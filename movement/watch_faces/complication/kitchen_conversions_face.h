@@ -76,6 +76,8 @@ void kitchen_conversions_face_activate(movement_settings_t *settings, void *cont
 bool kitchen_conversions_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void kitchen_conversions_face_resign(movement_settings_t *settings, void *context);
 
+#define kitchen_conversions_face_context_size sizeof(kitchen_conversions_state_t)
+
 #define kitchen_conversions_face ((const watch_face_t){ \
     kitchen_conversions_face_setup,                     \
     kitchen_conversions_face_activate,                  \
@@ -43,9 +43,8 @@ static const float phase_changes[] = {0, 1, 6.38264692644, 8.38264692644, 13.765
 
 void moon_phase_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(moon_phase_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(moon_phase_state_t));
     }
 }
@@ -56,11 +55,11 @@ void moon_phase_face_activate(movement_settings_t *settings, void *context) {
 }
 
 static void _update(movement_settings_t *settings, moon_phase_state_t *state, uint32_t offset) {
+    (void) settings;
     (void)state;
     char buf[11];
-    watch_date_time date_time = watch_rtc_get_date_time();
-    uint32_t now = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60) + offset;
-    date_time = watch_utility_date_time_from_unix_time(now, movement_timezone_offsets[settings->bit.time_zone] * 60);
+    uint32_t now = movement_get_now()->timestamp + offset;
+    watch_date_time date_time = watch_utility_date_time_from_unix_time(now, movement_get_current_timezone_offset());
     double currentfrac = fmod(now - FIRST_MOON, LUNAR_SECONDS) / LUNAR_SECONDS;
     double currentday = currentfrac * LUNAR_DAYS;
     uint8_t phase_index = 0;
@@ -142,13 +141,13 @@ bool moon_phase_face_loop(movement_event_t event, movement_settings_t *settings,
             break;
         case EVENT_TICK:
             // only update once an hour
-            date_time = watch_rtc_get_date_time();
+            date_time = movement_get_now()->local;
             if ((date_time.unit.minute == 0) && (date_time.unit.second == 0)) _update(settings, state, state->offset);
             break;
         case EVENT_LOW_ENERGY_UPDATE:
             // update at the top of the hour OR if we're entering sleep mode with an offset.
             // also, in sleep mode, always show the current moon phase (offset = 0).
-            if (state->offset || (watch_rtc_get_date_time().unit.minute == 0)) _update(settings, state, 0);
+            if (state->offset || (movement_get_now()->local.unit.minute == 0)) _update(settings, state, 0);
             // and kill the offset so when the wearer wakes up, it matches what's on screen.
             state->offset = 0;
             // finally: clear out the last two digits and replace them with the sleep mode indicator
@@ -66,7 +66,7 @@ void morsecalc_input(morsecalc_state_t * mcs) {
         case ' ': // Submit token to calculator
             if(mcs->idxt > 0) {
                 mcs->token[mcs->idxt] = '\0';
-                status = calc_input(mcs->cs, mcs->token);
+                status = calc_input(&mcs->cs, mcs->token);
                 morsecalc_reset_token(mcs); 
             } 
             morsecalc_display_stack(mcs);   
@@ -108,14 +108,12 @@ void morsecalc_input(morsecalc_state_t * mcs) {
 
 void morsecalc_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(morsecalc_state_t)); 
+        *context_ptr = movement_get_context_slot(watch_face_index); 
         morsecalc_state_t *mcs = (morsecalc_state_t *)*context_ptr;
         morsecalc_reset_token(mcs); 
         
-        mcs->cs = (calc_state_t *) malloc(sizeof(calc_state_t));
-        calc_init(mcs->cs); 
+        calc_init(&mcs->cs); 
         mcs->mc = 0;
         mcs->led_is_on = 0;
     }
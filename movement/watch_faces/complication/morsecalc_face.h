@@ -142,7 +142,7 @@ bool morsecalc_face_loop(movement_event_t event, movement_settings_t *settings,
 void morsecalc_face_resign(movement_settings_t *settings, void *context);
 
 typedef struct {
-	calc_state_t *cs;
+	calc_state_t cs;
 	unsigned int mc; // Morse code character
 	char token[MORSECALC_TOKEN_LEN];
 	uint8_t idxt;
@@ -152,6 +152,8 @@ typedef struct {
 void morsecalc_reset_token(morsecalc_state_t *mcs);
 void morsecalc_input(morsecalc_state_t *mcs);
 
+#define morsecalc_face_context_size sizeof(morsecalc_state_t)
+
 #define morsecalc_face ((const watch_face_t){ \
     morsecalc_face_setup, \
     morsecalc_face_activate, \
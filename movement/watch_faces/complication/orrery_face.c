@@ -47,8 +47,9 @@ static const char orrery_celestial_body_names[NUM_AVAILABLE_BODIES][3] = {
 };
 
 static void _orrery_face_recalculate(movement_settings_t *settings, orrery_state_t *state) {
-    watch_date_time date_time = watch_rtc_get_date_time();
-    uint32_t timestamp = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60);
+    (void) settings;
+    watch_date_time date_time = movement_get_now()->local;
+    uint32_t timestamp = watch_utility_date_time_to_unix_time(date_time, movement_get_current_timezone_offset());
     date_time = watch_utility_date_time_from_unix_time(timestamp, 0);
     double jd = astro_convert_date_to_julian_date(date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day, date_time.unit.hour, date_time.unit.minute, date_time.unit.second);
     double et = astro_convert_jd_to_julian_millenia_since_j2000(jd);
@@ -127,7 +128,9 @@ static void _orrery_face_update(movement_event_t event, movement_settings_t *set
             watch_clear_display();
              // this takes a moment and locks the UI, flash C for "Calculating"
             watch_start_character_blink('C', 100);
+            movement_request_performance_level(MOVEMENT_PERFORMANCE_HIGH);
             _orrery_face_recalculate(settings, state);
+            movement_request_performance_level(MOVEMENT_PERFORMANCE_LOW);
             watch_stop_blink();
             state->mode = ORRERY_MODE_DISPLAYING_X;
             // fall through
@@ -151,9 +154,8 @@ static void _orrery_face_update(movement_event_t event, movement_settings_t *set
 
 void orrery_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(orrery_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(orrery_state_t));
     }
 }
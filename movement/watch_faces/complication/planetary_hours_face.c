@@ -114,6 +114,7 @@ static void _planetary_icon(uint8_t planet) {
  *  It also calculates the start of the next following phase.
  */
 static void _planetary_solar_phases(movement_settings_t *settings, planetary_hours_state_t *state) {
+    (void) settings;
     uint8_t phase, h;
     double sunrise, sunset;
     double hour_duration, next_hour_duration;
@@ -133,8 +134,7 @@ static void _planetary_solar_phases(movement_settings_t *settings, planetary_hou
     // location detected
     state->no_location = false;
 
-    watch_date_time date_time = watch_rtc_get_date_time(); // the current local date / time
-    watch_date_time utc_now = watch_utility_date_time_convert_zone(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60, 0); // the current date / time in UTC
+    watch_date_time utc_now = movement_get_now()->utc; // the current date / time in UTC
     watch_date_time scratch_time; // scratchpad, contains different values at different times
     watch_date_time midnight;
     scratch_time.reg = midnight.reg = utc_now.reg;
@@ -147,7 +147,7 @@ static void _planetary_solar_phases(movement_settings_t *settings, planetary_hou
     double lon = (double)lon_centi / 100.0;
 
     // save UTC offset
-    state->utc_offset = ((double)movement_timezone_offsets[settings->bit.time_zone]) / 60.0;
+    state->utc_offset = ((double)movement_get_current_timezone_offset()) / 3600.0;
 
     // calculate sunrise and sunset of current day in decimal hours after midnight
     sun_rise_set(scratch_time.unit.year + WATCH_RTC_REFERENCE_YEAR, scratch_time.unit.month, scratch_time.unit.day, lon, lat, &sunrise, &sunset);
@@ -236,8 +236,7 @@ static void _planetary_hours(movement_settings_t *settings, planetary_hours_stat
     }
 
     // get current time
-    watch_date_time date_time = watch_rtc_get_date_time(); // the current local date / time
-    watch_date_time utc_now = watch_utility_date_time_convert_zone(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60, 0); // the current date / time in UTC
+    watch_date_time utc_now = movement_get_now()->utc; // the current date / time in UTC
     current_hour_epoch = watch_utility_date_time_to_unix_time(utc_now, 0);
     
     // set the current planetary hour as default screen
@@ -335,10 +334,9 @@ static void _planetary_hours(movement_settings_t *settings, planetary_hours_stat
 // PUBLIC WATCH FACE FUNCTIONS ////////////////////////////////////////////////
 
 void planetary_hours_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
-    (void) watch_face_index;
     (void) settings;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(planetary_hours_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(planetary_hours_state_t));
     }
 }
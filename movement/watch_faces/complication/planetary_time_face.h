@@ -98,6 +98,8 @@ void planetary_time_face_activate(movement_settings_t *settings, void *context);
 bool planetary_time_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void planetary_time_face_resign(movement_settings_t *settings, void *context);
 
+#define planetary_time_face_context_size sizeof(planetary_time_state_t)
+
 #define planetary_time_face ((const watch_face_t){ \
     planetary_time_face_setup, \
     planetary_time_face_activate, \
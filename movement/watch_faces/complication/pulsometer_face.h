@@ -71,11 +71,20 @@
 
 #include "movement.h"
 
+typedef struct {
+    bool measuring;
+    int16_t pulses;
+    int16_t ticks;
+    int8_t calibration;
+} pulsometer_state_t;
+
 void pulsometer_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
 void pulsometer_face_activate(movement_settings_t *settings, void *context);
 bool pulsometer_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void pulsometer_face_resign(movement_settings_t *settings, void *context);
 
+#define pulsometer_face_context_size sizeof(pulsometer_state_t)
+
 #define pulsometer_face ((const watch_face_t){ \
     pulsometer_face_setup, \
     pulsometer_face_activate, \
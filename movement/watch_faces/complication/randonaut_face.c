@@ -22,13 +22,6 @@
  * SOFTWARE.
  */
 
-// Emulator only: need time() to seed the random number generator.
-#if __EMSCRIPTEN__
-#include <time.h>
-#else
-#include "saml22j18a.h"
-#endif
-
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -52,9 +45,8 @@ static void _get_entropy(randonaut_state_t *state);
 
 void randonaut_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(randonaut_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(randonaut_state_t));
         // Do any one-time tasks in here; the inside of this conditional happens only at boot.
     }
@@ -339,28 +331,15 @@ static void _generate_blindspot(randonaut_state_t *state) {
 /** @brief pseudo random number generator
  */
 static uint32_t _get_pseudo_entropy(uint32_t max) {
-    #if __EMSCRIPTEN__
-    return rand() % max;
-    #else
-    return arc4random_uniform(max);
-    #endif
+    return movement_random_uniform(max);
 }
 
 /** @brief true random number generator
  */
 static uint32_t _get_true_entropy(void) {
-    #if __EMSCRIPTEN__
-    return rand() % INT32_MAX;
-    #else
-    hri_mclk_set_APBCMASK_TRNG_bit(MCLK);
-    hri_trng_set_CTRLA_ENABLE_bit(TRNG);
-
-    while (!hri_trng_get_INTFLAG_reg(TRNG, TRNG_INTFLAG_DATARDY)); // Wait for TRNG data to be ready
-
-    watch_disable_TRNG();
-    hri_mclk_clear_APBCMASK_TRNG_bit(MCLK);
-    return hri_trng_read_DATA_reg(TRNG); // Read a single 32-bit word from TRNG and return it
-    #endif
+    uint32_t entropy;
+    watch_trng_read(&entropy, 1); // Read a single 32-bit word from the TRNG
+    return entropy;
 }
 
 /** @brief get location from place.loc
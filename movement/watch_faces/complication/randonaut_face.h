@@ -58,7 +58,7 @@
  * - The radius can be set in 500 meter steps between 1000 and 10,000 meters
  * 
  * - The RNG can be set to "true" which utilizes the SAML22J's internal True Random Number Generator
- * - Setting it to "psudo" will use the pseudorandom number generation algorithm arc4random
+ * - Setting it to "psudo" will use Movement's pseudorandom number generator (ChaCha20, seeded from the TRNG)
  * - Setting it to "chance" will randomly chose either of the RNGs for each generation (default)
  *
  * LONG PRESSING ALARM toggles DATA mode in which the currently generated Blind Spot coordinate can
@@ -101,6 +101,8 @@ void randonaut_face_activate(movement_settings_t *settings, void *context);
 bool randonaut_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void randonaut_face_resign(movement_settings_t *settings, void *context);
 
+#define randonaut_face_context_size sizeof(randonaut_state_t)
+
 #define randonaut_face ((const watch_face_t){ \
     randonaut_face_setup, \
     randonaut_face_activate, \
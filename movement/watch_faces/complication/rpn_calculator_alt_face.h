@@ -84,6 +84,8 @@ void rpn_calculator_alt_face_activate(movement_settings_t *settings, void *conte
 bool rpn_calculator_alt_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void rpn_calculator_alt_face_resign(movement_settings_t *settings, void *context);
 
+#define rpn_calculator_alt_face_context_size sizeof(calculator_state_t)
+
 #define rpn_calculator_alt_face ((const watch_face_t){ \
     rpn_calculator_alt_face_setup, \
     rpn_calculator_alt_face_activate, \
@@ -234,9 +234,8 @@ static void draw(rpn_calculator_state_t *state, uint8_t subsecond) {
 
 void rpn_calculator_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(rpn_calculator_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(rpn_calculator_state_t));
         // Do any one-time tasks in here; the inside of this conditional happens only at boot.
         rpn_calculator_state_t *state = *context_ptr;
@@ -34,10 +34,10 @@
 #define DEFAULT_MINUTES { 5,4,1,0,0,0 }
 
 static inline int32_t get_tz_offset(movement_settings_t *settings) {
-    return movement_timezone_offsets[settings->bit.time_zone] * 60;
+    (void) settings;
+    return movement_get_current_timezone_offset();
 }
 
-static int lap = 0;
 bool ringflag = false;
 int8_t double_beep[] = {BUZZER_NOTE_C8, 4, BUZZER_NOTE_REST, 5, BUZZER_NOTE_C8, 5, 0};
 int8_t single_beep[] = {BUZZER_NOTE_C8, 4, 0};
@@ -142,7 +142,7 @@ static void draw(sailing_state_t *state, uint8_t subsecond, movement_settings_t
                 result = div(delta, 60);
                 min = result.quot;
                 sec = result.rem;
-                sprintf(buf, "SL%2d%2d%02d%02d", lap, hrs, min, sec);//implement counting
+                sprintf(buf, "SL%2d%2d%02d%02d", state->lap, hrs, min, sec);//implement counting
                 if (hrs > 23) {
                     reset(state);
                 }
@@ -193,7 +193,7 @@ static void start(sailing_state_t *state, movement_settings_t *settings) {//gets
         beepflag++;
     }
     if (state->index > 5 || state->minutes[state->index] == 0) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
         state->target_ts = state->now_ts;
         if (alarmflag != 0){
@@ -204,7 +204,7 @@ static void start(sailing_state_t *state, movement_settings_t *settings) {//gets
     }
     movement_request_tick_frequency(1); //synchronises tick with the moment the button was pressed. Solves 1s offset between sound and display, solves up to +-0.5s offset between button action and display.
     state->mode = sl_running;
-    watch_date_time now = watch_rtc_get_date_time();
+    watch_date_time now = movement_get_now()->local;
     state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
     state->target_ts = watch_utility_offset_timestamp(state->now_ts, 0, state->minutes[state->index], 0);
     ring(state, settings);
@@ -236,10 +236,9 @@ static void settings_increment(sailing_state_t *state) {
 
 void sailing_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(sailing_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         sailing_state_t *state = (sailing_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(sailing_state_t));
         static const uint8_t default_minutes[6] = DEFAULT_MINUTES;
@@ -252,11 +251,11 @@ void sailing_face_activate(movement_settings_t *settings, void *context) {
     (void) settings;
     sailing_state_t *state = (sailing_state_t *)context;
     if(state->mode == sl_running) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
     }
     if(state->mode == sl_counting) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
         watch_set_indicator(WATCH_INDICATOR_LAP);
     }
@@ -364,8 +363,8 @@ bool sailing_face_loop(movement_event_t event, movement_settings_t *settings, vo
                     break;
                 case sl_counting:
                     //implement lap counting up to 39
-                    if (lap <39){
-                        lap++;
+                    if (state->lap <39){
+                        state->lap++;
                     }
                     break;
             }
@@ -383,7 +382,7 @@ bool sailing_face_loop(movement_event_t event, movement_settings_t *settings, vo
                     break;
             }
             if (state->mode == sl_counting) {
-                lap = 0;
+                state->lap = 0;
             }
             break;
         case EVENT_TIMEOUT:
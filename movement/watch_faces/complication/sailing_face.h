@@ -78,6 +78,7 @@ typedef struct {
     uint8_t minutes[6];
     uint8_t selection;
     sailing_mode_t mode;
+    uint8_t lap;
 } sailing_state_t;
 
 
@@ -86,6 +87,8 @@ void sailing_face_activate(movement_settings_t *settings, void *context);
 bool sailing_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void sailing_face_resign(movement_settings_t *settings, void *context);
 
+#define sailing_face_context_size sizeof(sailing_state_t)
+
 #define sailing_face ((const watch_face_t){ \
     sailing_face_setup, \
     sailing_face_activate, \
@@ -22,12 +22,6 @@
  * SOFTWARE.
  */
 
-#if __EMSCRIPTEN__
-#include <time.h>
-#else
-#include "saml22j18a.h"
-#endif
-
 #include <stdlib.h>
 #include <string.h>
 #include "simple_coin_flip_face.h"
@@ -36,9 +30,8 @@
 
 void simple_coin_flip_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(simple_coin_flip_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(simple_coin_flip_state_t));
     }
 }
@@ -49,11 +42,7 @@ void simple_coin_flip_face_activate(movement_settings_t *settings, void *context
 }
 
 static uint32_t get_random(uint32_t max) {
-    #if __EMSCRIPTEN__
-    return rand() % max;
-    #else
-    return arc4random_uniform(max);
-    #endif
+    return movement_random_uniform(max);
 }
 
 static void animation_0() {
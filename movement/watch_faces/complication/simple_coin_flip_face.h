@@ -50,6 +50,8 @@ void simple_coin_flip_face_activate(movement_settings_t *settings, void *context
 bool simple_coin_flip_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void simple_coin_flip_face_resign(movement_settings_t *settings, void *context);
 
+#define simple_coin_flip_face_context_size sizeof(simple_coin_flip_state_t)
+
 #define simple_coin_flip_face ((const watch_face_t){ \
     simple_coin_flip_face_setup, \
     simple_coin_flip_face_activate, \
@@ -52,6 +52,8 @@ void solstice_face_activate(movement_settings_t *settings, void *context);
 bool solstice_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void solstice_face_resign(movement_settings_t *settings, void *context);
 
+#define solstice_face_context_size sizeof(solstice_state_t)
+
 #define solstice_face ((const watch_face_t){ \
     solstice_face_setup, \
     solstice_face_activate, \
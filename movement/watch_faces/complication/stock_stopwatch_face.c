@@ -39,90 +39,39 @@
        turns on on each button press or it doesn't.
 */
 
-#if __EMSCRIPTEN__
-#include <emscripten.h>
-#include <emscripten/html5.h>
-#else
-#include "../../../watch-library/hardware/include/saml22j18a.h"
-#include "../../../watch-library/hardware/include/component/tc.h"
-#include "../../../watch-library/hardware/hri/hri_tc_l22.h"
-#endif
-
 // distant future for background task: January 1, 2083
 static const watch_date_time distant_future = {
     .unit = {0, 0, 0, 1, 1, 63}
 };
 
-static uint32_t _ticks;
-static uint32_t _lap_ticks;
+static uint32_t _timestamp;
 static uint8_t _blink_ticks;
 static uint32_t _old_seconds;
 static uint8_t _old_minutes;
-static uint8_t _hours;
 static bool _colon;
 static bool _is_running;
 
-#if __EMSCRIPTEN__
-
-static long _em_interval_id = 0;
-
-void em_cb_handler(void *userData) {
-    // interrupt handler for emscripten 128 Hz callbacks
-    (void) userData;
-    _ticks++;
-}
-
-static void _cb_initialize() { }
-
-static inline void _cb_stop() {
-    emscripten_clear_interval(_em_interval_id);
-    _em_interval_id = 0;
-    _is_running = false;
-}
-
 static inline void _cb_start() {
-    // initiate 128 hz callback
-    _em_interval_id = emscripten_set_interval(em_cb_handler, (double)(1000/128), (void *)NULL);
-}
-
-#else
-
-static inline void _cb_start() {
-    // start the TC2 timer
-    hri_tc_set_CTRLA_ENABLE_bit(TC2);
+    // count 128 Hz ticks from now on, without being interrupted for each of them
+    watch_rtc_enable_timestamp_ticks();
+    _timestamp = watch_rtc_get_timestamp_ticks();
     _is_running = true;
 }
 
-static inline void _cb_stop() {
-    // stop the TC2 timer
-    hri_tc_clear_CTRLA_ENABLE_bit(TC2);
-    _is_running = false;
-}
-
-static void _cb_initialize() {
-    // setup and initialize TC2 for a 64 Hz interrupt
-    hri_mclk_set_APBCMASK_TC2_bit(MCLK);
-    hri_gclk_write_PCHCTRL_reg(GCLK, TC2_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK3 | GCLK_PCHCTRL_CHEN);
-    _cb_stop();
-    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC2, TC_SYNCBUSY_SWRST);
-    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_PRESCALER_DIV64 | // 32 Khz divided by 64 divided by 4 results in a 128 Hz interrupt
-                           TC_CTRLA_MODE_COUNT8 | 
-                           TC_CTRLA_RUNSTDBY);
-    hri_tccount8_write_PER_reg(TC2, 3);
-    hri_tc_set_INTEN_OVF_bit(TC2);
-    NVIC_ClearPendingIRQ(TC2_IRQn);
-    NVIC_EnableIRQ (TC2_IRQn);
+static void _update_ticks(stock_stopwatch_state_t *state) {
+    // add the ticks that have passed since the last update
+    if (!_is_running) return;
+    uint32_t timestamp = watch_rtc_get_timestamp_ticks();
+    state->ticks += timestamp - _timestamp;
+    _timestamp = timestamp;
 }
 
-void TC2_Handler(void) {
-    // interrupt handler for TC2 (globally!)
-    _ticks++;
-    TC2->COUNT8.INTFLAG.reg |= TC_INTFLAG_OVF;
+static inline void _cb_stop(stock_stopwatch_state_t *state) {
+    _update_ticks(state);
+    watch_rtc_disable_timestamp_ticks();
+    _is_running = false;
 }
 
-#endif
-
 static inline void _button_beep(movement_settings_t *settings) {
     // play a beep as confirmation for a button press (if applicable)
     if (settings->bit.button_should_sound) watch_buzzer_play_note(BUZZER_NOTE_C7, 50);
@@ -131,25 +80,25 @@ static inline void _button_beep(movement_settings_t *settings) {
 /// @brief Display minutes, seconds and fractions derived from 128 Hz tick counter
 ///        on the lcd.
 /// @param ticks
-static void _display_ticks(uint32_t ticks) {
+static void _display_ticks(stock_stopwatch_state_t *state, uint32_t ticks) {
     char buf[14];
     uint8_t sec_100 = (ticks & 0x7F) * 100 / 128;
     uint32_t seconds = ticks >> 7;
     uint32_t minutes = seconds / 60;
-    if (_hours)
-        sprintf(buf, "%2u%02lu%02lu%02u", _hours, minutes, (seconds % 60), sec_100);
+    if (state->hours)
+        sprintf(buf, "%2u%02lu%02lu%02u", state->hours, minutes, (seconds % 60), sec_100);
     else
         sprintf(buf, "  %02lu%02lu%02u", minutes, (seconds % 60), sec_100);
     watch_display_string(buf, 2);
 }
 
 /// @brief Displays the current stopwatch time on the LCD (more optimized than _display_ticks())
-static void _draw() {
-    if (_lap_ticks == 0) {
+static void _draw(stock_stopwatch_state_t *state) {
+    if (state->lap_ticks == 0) {
         char buf[14];
-        uint8_t sec_100 = (_ticks & 0x7F) * 100 / 128;
+        uint8_t sec_100 = (state->ticks & 0x7F) * 100 / 128;
         if (_is_running) {
-            uint32_t seconds = _ticks >> 7;
+            uint32_t seconds = state->ticks >> 7;
             if (seconds != _old_seconds) {
                 // seconds have changed
                 _old_seconds = seconds;
@@ -159,9 +108,9 @@ static void _draw() {
                     // minutes have changed, draw everything
                     _old_minutes = minutes;
                     minutes %= 60;
-                    if (_hours)
+                    if (state->hours)
                         // with hour indicator
-                        sprintf(buf, "%2u%02u%02lu%02u", _hours, minutes, seconds, sec_100);
+                        sprintf(buf, "%2u%02u%02lu%02u", state->hours, minutes, seconds, sec_100);
                     else
                         // no hour indicator
                         sprintf(buf, "  %02u%02lu%02u", minutes, seconds, sec_100);
@@ -177,12 +126,12 @@ static void _draw() {
                 watch_display_string(buf, 8);
             }
         } else {
-            _display_ticks(_ticks);
+            _display_ticks(state, state->ticks);
         }
     }
     if (_is_running) {
         // blink the colon every half second
-        uint8_t blink_ticks = ((_ticks >> 6) & 1);
+        uint8_t blink_ticks = ((state->ticks >> 6) & 1);
         if (blink_ticks != _blink_ticks) {
             _blink_ticks = blink_ticks;
             _colon = !_colon;
@@ -192,8 +141,8 @@ static void _draw() {
     }
 }
 
-static inline void _update_lap_indicator() {
-    if (_lap_ticks) watch_set_indicator(WATCH_INDICATOR_LAP);
+static inline void _update_lap_indicator(stock_stopwatch_state_t *state) {
+    if (state->lap_ticks) watch_set_indicator(WATCH_INDICATOR_LAP);
     else  watch_clear_indicator(WATCH_INDICATOR_LAP);
 }
 
@@ -204,19 +153,14 @@ static inline void _set_colon() {
 
 void stock_stopwatch_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(stock_stopwatch_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(stock_stopwatch_state_t));
         stock_stopwatch_state_t *state = (stock_stopwatch_state_t *)*context_ptr;
-        _ticks = _lap_ticks = _blink_ticks = _old_minutes = _old_seconds = _hours = 0;
+        state->ticks = state->lap_ticks = _blink_ticks = _old_minutes = _old_seconds = state->hours = 0;
     _is_running = _colon = false;
         state->light_on_button = true;
     }
-    if (!_is_running) {
-        // prepare the 128 Hz callback source
-        _cb_initialize();
-    }
 }
 
 void stock_stopwatch_face_activate(movement_settings_t *settings, void *context) {
@@ -231,11 +175,13 @@ void stock_stopwatch_face_activate(movement_settings_t *settings, void *context)
 bool stock_stopwatch_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
     stock_stopwatch_state_t *state = (stock_stopwatch_state_t *)context;
 
+    _update_ticks(state);
+
     // handle overflow of fast ticks
-    while (_ticks >= (128 * 60 * 60)) {
-        _ticks -= (128 * 60 * 60);
-        _hours++;
-        if (_hours >= 24) _hours -= 24;
+    while (state->ticks >= (128 * 60 * 60)) {
+        state->ticks -= (128 * 60 * 60);
+        state->hours++;
+        if (state->hours >= 24) state->hours -= 24;
         // initiate a re-draw
         _old_minutes = 59;
     }
@@ -244,12 +190,12 @@ bool stock_stopwatch_face_loop(movement_event_t event, movement_settings_t *sett
         case EVENT_ACTIVATE:
             _set_colon();
             watch_display_string("ST  ", 0);
-            _update_lap_indicator();
+            _update_lap_indicator(state);
             if (_is_running) movement_request_tick_frequency(16);
-            _display_ticks(_lap_ticks ? _lap_ticks : _ticks);
+            _display_ticks(state, state->lap_ticks ? state->lap_ticks : state->ticks);
             break;
         case EVENT_TICK:
-            _draw();
+            _draw(state);
             break;
         case EVENT_LIGHT_LONG_PRESS:
             // kind od hidden feature: long press toggles light on or off
@@ -258,56 +204,55 @@ bool stock_stopwatch_face_loop(movement_event_t event, movement_settings_t *sett
             else watch_set_led_off();
             break;
         case EVENT_ALARM_BUTTON_DOWN:
-            _is_running = !_is_running;
-            if (_is_running) {
+            if (!_is_running) {
                 // start or continue stopwatch
                 movement_request_tick_frequency(16);
-                // register 128 hz callback for time measuring
+                // start the 128 hz tick counter for time measuring
                 _cb_start();
                 // schedule the keepalive task when running
                 movement_schedule_background_task(distant_future);
             } else {
                 // stop the stopwatch
-                _cb_stop();
+                _cb_stop(state);
                 movement_request_tick_frequency(1);
                 _set_colon();
                 // cancel the keepalive task
                 movement_cancel_background_task();
             }
-            _draw();
+            _draw(state);
             _button_beep(settings);
             break;
         case EVENT_LIGHT_BUTTON_DOWN:
             if (state->light_on_button) movement_illuminate_led();
             if (_is_running) {
-                if (_lap_ticks) {
+                if (state->lap_ticks) {
                     // clear lap and continue running
-                    _lap_ticks = 0;
+                    state->lap_ticks = 0;
                     movement_request_tick_frequency(16);
                 } else {
                     // set lap ticks and stop updating the display
-                    _lap_ticks = _ticks;
+                    state->lap_ticks = state->ticks;
                     movement_request_tick_frequency(2);
                     _set_colon();
                 }
             } else {
-                if (_lap_ticks) {
+                if (state->lap_ticks) {
                     // clear lap and show running stopwatch
-                    _lap_ticks = 0;
-                } else if (_ticks) {
+                    state->lap_ticks = 0;
+                } else if (state->ticks) {
                     // reset stopwatch
-                    _ticks = _lap_ticks = _blink_ticks = _old_minutes = _old_seconds = _hours = 0;
+                    state->ticks = state->lap_ticks = _blink_ticks = _old_minutes = _old_seconds = state->hours = 0;
                     _button_beep(settings);
                 }
             }
-            _display_ticks(_ticks);
-            _update_lap_indicator();
+            _display_ticks(state, state->ticks);
+            _update_lap_indicator(state);
             break;
         case EVENT_TIMEOUT:
             if (!_is_running) movement_move_to_face(0);
             break;
         case EVENT_LOW_ENERGY_UPDATE:
-            _draw();
+            _draw(state);
             break;
         default:
             movement_default_loop_handler(event, settings);
@@ -37,17 +37,15 @@ static const watch_date_time distant_future = {
 
 void stopwatch_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(stopwatch_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(stopwatch_state_t));
     }
 }
 
 static void _stopwatch_face_update_display(stopwatch_state_t *stopwatch_state, bool show_seconds) {
     if (stopwatch_state->running) {
-        watch_date_time now = watch_rtc_get_date_time();
-        uint32_t now_timestamp = watch_utility_date_time_to_unix_time(now, 0);
+        uint32_t now_timestamp = movement_get_now()->local_timestamp;
         uint32_t start_timestamp = watch_utility_date_time_to_unix_time(stopwatch_state->start_time, 0);
         stopwatch_state->seconds_counted = now_timestamp - start_timestamp;
     }
@@ -124,11 +122,11 @@ bool stopwatch_face_loop(movement_event_t event, movement_settings_t *settings,
                 // we're running now, so we need to set the start_time.
                 if (stopwatch_state->start_time.reg == 0) {
                     // if starting from the reset state, easy: we start now.
-                    stopwatch_state->start_time = watch_rtc_get_date_time();
+                    stopwatch_state->start_time = movement_get_now()->local;
                 } else {
                     // if resuming with time already on the clock, the original start time isn't valid anymore!
                     // so let's fetch the current time...
-                    uint32_t timestamp = watch_utility_date_time_to_unix_time(watch_rtc_get_date_time(), 0);
+                    uint32_t timestamp = movement_get_now()->local_timestamp;
                     // ...subtract the seconds we've already counted...
                     timestamp -= stopwatch_state->seconds_counted;
                     // and resume from the "virtual" start time that's that many seconds ago.
@@ -62,6 +62,8 @@ void sunrise_sunset_face_activate(movement_settings_t *settings, void *context);
 bool sunrise_sunset_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void sunrise_sunset_face_resign(movement_settings_t *settings, void *context);
 
+#define sunrise_sunset_face_context_size sizeof(sunrise_sunset_state_t)
+
 #define sunrise_sunset_face ((const watch_face_t){ \
     sunrise_sunset_face_setup, \
     sunrise_sunset_face_activate, \
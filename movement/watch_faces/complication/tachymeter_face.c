@@ -40,9 +40,8 @@ static uint32_t _distance_from_struct(distance_digits_t dist_digits) {
 
 void tachymeter_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void)settings;
-    (void)watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(tachymeter_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(tachymeter_state_t));
         tachymeter_state_t *state = (tachymeter_state_t *)*context_ptr;
         // Default distance
@@ -173,7 +172,7 @@ bool tachymeter_face_loop(movement_event_t event, movement_settings_t *settings,
                 if (!state->editing) {
                     // Start running
                     state->running = true;
-                    state->start_seconds = watch_rtc_get_date_time();
+                    state->start_seconds = movement_get_now()->local;
                     state->start_subsecond = event.subsecond;
                     state->total_time = 0;
                 } else {
@@ -205,7 +204,7 @@ bool tachymeter_face_loop(movement_event_t event, movement_settings_t *settings,
                 }
                 // Stop running
                 state->running = false;
-                watch_date_time now = watch_rtc_get_date_time();
+                watch_date_time now = movement_get_now()->local;
                 uint32_t now_timestamp = watch_utility_date_time_to_unix_time(now, 0);
                 uint32_t start_timestamp = watch_utility_date_time_to_unix_time(state->start_seconds, 0);
                 // Total time in centiseconds
@@ -97,6 +97,8 @@ void tachymeter_face_activate(movement_settings_t *settings, void *context);
 bool tachymeter_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void tachymeter_face_resign(movement_settings_t *settings, void *context);
 
+#define tachymeter_face_context_size sizeof(tachymeter_state_t)
+
 #define tachymeter_face ((const watch_face_t){ \
     tachymeter_face_setup, \
     tachymeter_face_activate, \
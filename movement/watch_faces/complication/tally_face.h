@@ -49,6 +49,8 @@ void tally_face_resign(movement_settings_t *settings, void *context);
 
 void print_tally(tally_state_t *state);
 
+#define tally_face_context_size sizeof(tally_state_t)
+
 #define tally_face ((const watch_face_t){ \
     tally_face_setup, \
     tally_face_activate, \
@@ -23,11 +23,6 @@
  * SOFTWARE.
  */
 
-// Emulator only: need time() to seed the random number generator.
-#if __EMSCRIPTEN__
-#include <time.h>
-#endif
-
 #include <stdlib.h>
 #include <string.h>
 #include "tarot_face.h"
@@ -139,12 +134,7 @@ static void tarot_display(tarot_state_t *state) {
 }
 
 static uint8_t get_rand_num(uint8_t num_values) {
-    // Emulator: use rand. Hardware: use arc4random.
-#if __EMSCRIPTEN__
-    return rand() % num_values;
-#else
-    return arc4random_uniform(num_values);
-#endif
+    return movement_random_uniform(num_values);
 }
 
 static uint8_t draw_one_card(tarot_state_t *state) {
@@ -210,15 +200,10 @@ static void display_animation(tarot_state_t *state) {
 // ---------------------------
 void tarot_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(tarot_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(tarot_state_t));
     }
-    // Emulator only: Seed random number generator
-    #if __EMSCRIPTEN__
-    srand(time(NULL));
-    #endif
 }
 
 void tarot_face_activate(movement_settings_t *settings, void *context) {
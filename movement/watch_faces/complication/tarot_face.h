@@ -78,6 +78,8 @@ void tarot_face_activate(movement_settings_t *settings, void *context);
 bool tarot_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void tarot_face_resign(movement_settings_t *settings, void *context);
 
+#define tarot_face_context_size sizeof(tarot_state_t)
+
 #define tarot_face ((const watch_face_t){ \
     tarot_face_setup, \
     tarot_face_activate, \
@@ -44,17 +44,20 @@ void tempchart_face_setup(movement_settings_t *settings, uint8_t watch_face_inde
     // These next two lines just silence the compiler warnings associated with unused parameters.
     // We have no use for the settings or the watch_face_index, so we make that explicit here.
     (void) settings;
-    (void) context_ptr;
     (void) watch_face_index;
     // At boot, context_ptr will be NULL indicating that we don't have anyplace to store our context.
-    if (filesystem_get_file_size("tempchart.ini") != sizeof(tempchart_state)) {
-        // No previous ini or old version of ini file - create new config file
-        tempchart_state.num_div = 0;
-        for (int i = 0; i < 24 * 70; i++)
-            tempchart_state.stat[i] = 0;
-        tempchart_save();
-    } else
-        filesystem_read_file("tempchart.ini", (char*)&tempchart_state, sizeof(tempchart_state));
+    if (*context_ptr == NULL) {
+        if (filesystem_get_file_size("tempchart.ini") != sizeof(tempchart_state)) {
+            // No previous ini or old version of ini file - create new config file
+            tempchart_state.num_div = 0;
+            for (int i = 0; i < 24 * 70; i++)
+                tempchart_state.stat[i] = 0;
+            tempchart_save();
+        } else
+            filesystem_read_file("tempchart.ini", (char*)&tempchart_state, sizeof(tempchart_state));
+
+        *context_ptr = (void *)1; // No need to re-read from filesystem when exiting low power mode
+    }
 
 }
 
@@ -104,7 +107,7 @@ bool tempchart_face_loop(movement_event_t event, movement_settings_t *settings,
             thermistor_driver_enable();
             float temperature_c = thermistor_driver_get_temperature();
             thermistor_driver_disable();
-            watch_date_time date_time = watch_rtc_get_date_time();
+            watch_date_time date_time = movement_get_now()->local;
 
             int temp = round(temperature_c * 2);
             if ((temp < 0) || (temp >= 70)) break;
@@ -140,7 +143,7 @@ void tempchart_face_resign(movement_settings_t *settings, void *context) {
 bool tempchart_face_wants_background_task(movement_settings_t *settings, void *context) {
     (void) settings;
     (void) context;
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     //Updating data every 5 minutes
     return date_time.unit.minute % 5 == 0;
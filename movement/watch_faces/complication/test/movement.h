@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Just enough of movement.h for watch faces to build on the host, against test_totp_face_lfs.c.
+
+#ifndef MOVEMENT_H_
+#define MOVEMENT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "watch.h"
+#include "watch_utility.h"
+
+typedef union {
+    uint32_t reg;
+} movement_settings_t;
+
+typedef enum {
+    EVENT_NONE = 0,
+    EVENT_ACTIVATE,
+    EVENT_TICK,
+    EVENT_TIMEOUT,
+    EVENT_LIGHT_BUTTON_DOWN,
+    EVENT_LIGHT_BUTTON_UP,
+    EVENT_LIGHT_LONG_PRESS,
+    EVENT_ALARM_BUTTON_DOWN,
+    EVENT_ALARM_BUTTON_UP,
+    EVENT_ALARM_LONG_PRESS,
+} movement_event_type_t;
+
+typedef struct {
+    uint8_t event_type;
+    uint8_t subsecond;
+} movement_event_t;
+
+typedef void (*watch_face_setup)(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
+typedef void (*watch_face_activate)(movement_settings_t *settings, void *context);
+typedef bool (*watch_face_loop)(movement_event_t event, movement_settings_t *settings, void *context);
+typedef void (*watch_face_resign)(movement_settings_t *settings, void *context);
+typedef bool (*watch_face_wants_background_task)(movement_settings_t *settings, void *context);
+
+typedef struct {
+    watch_face_setup setup;
+    watch_face_activate activate;
+    watch_face_loop loop;
+    watch_face_resign resign;
+    watch_face_wants_background_task wants_background_task;
+} watch_face_t;
+
+bool movement_default_loop_handler(movement_event_t event, movement_settings_t *settings);
+void movement_move_to_face(uint8_t watch_face_index);
+void movement_illuminate_led(void);
+void *movement_get_context_slot(uint8_t watch_face_index);
+
+typedef watch_utility_clock_t movement_now_t;
+const movement_now_t *movement_get_now(void);
+
+#endif
@@ -0,0 +1,301 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for the TOTP-LFS face: compiles fixture URI files through an in-memory stand-in for
+ * the filesystem and checks what ends up in totp_uris.bin and on the display.
+ * Build and run from this directory:
+ *   gcc -I. -I../../.. -I../../../lib/TOTP -I../../../lib/base32 -o test_totp_face_lfs \
+ *       test_totp_face_lfs.c unity.c ../../../lib/TOTP/TOTP.c ../../../lib/TOTP/sha1.c \
+ *       ../../../lib/TOTP/sha256.c ../../../lib/TOTP/sha512.c ../../../lib/base32/base32.c && ./test_totp_face_lfs
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "unity.h"
+
+// the face keeps its record count and current record to itself, so build it in here to get at them.
+#include "../totp_face_lfs.c"
+
+#define MEM_FILES 2
+#define MEM_FILE_SIZE 2048
+
+static struct {
+  char name[16];
+  char data[MEM_FILE_SIZE];
+  int32_t size;
+  bool exists;
+} files[MEM_FILES];
+
+static int appends_until_failure;
+static int bin_writes;
+static uint32_t now;
+static char display[16];
+
+static void *find_file(char *filename) {
+  for (int i = 0; i < MEM_FILES; i++) {
+    if (files[i].exists && !strcmp(files[i].name, filename)) return &files[i];
+  }
+  return NULL;
+}
+
+static void put_file(const char *filename, const char *text) {
+  for (int i = 0; i < MEM_FILES; i++) {
+    if (!files[i].exists || !strcmp(files[i].name, filename)) {
+      strcpy(files[i].name, filename);
+      memcpy(files[i].data, text, strlen(text));
+      files[i].size = strlen(text);
+      files[i].exists = true;
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("out of files");
+}
+
+bool filesystem_file_exists(char *filename) {
+  return find_file(filename) != NULL;
+}
+
+bool filesystem_rm(char *filename) {
+  typeof(&files[0]) file = find_file(filename);
+  if (file == NULL) return false;
+  file->exists = false;
+  return true;
+}
+
+int32_t filesystem_get_file_size(char *filename) {
+  typeof(&files[0]) file = find_file(filename);
+  return file ? file->size : -1;
+}
+
+int32_t filesystem_read_file_at(char *filename, char *buf, int32_t offset, int32_t length) {
+  typeof(&files[0]) file = find_file(filename);
+  if (file == NULL || offset > file->size) return -1;
+  if (length > file->size - offset) length = file->size - offset;
+  memcpy(buf, file->data + offset, length);
+  return length;
+}
+
+int32_t filesystem_read_chunks(char *filename, filesystem_chunk_cb_t cb, void *context) {
+  typeof(&files[0]) file = find_file(filename);
+  if (file == NULL) return -1;
+  int32_t offset = 0;
+  while (offset < file->size) {
+    int32_t length = file->size - offset < 64 ? file->size - offset : 64;
+    bool more = cb(file->data + offset, length, offset, context);
+    offset += length;
+    if (!more) break;
+  }
+  return offset;
+}
+
+bool filesystem_read_line(char *filename, char *buf, int32_t *offset, int32_t length) {
+  // same contract as the real one: fills buf from offset up to the newline, and moves offset past it.
+  memset(buf, 0, length + 1);
+  typeof(&files[0]) file = find_file(filename);
+  if (file == NULL || file->size <= 0) return false;
+  int32_t available = file->size - *offset;
+  if (available > length - 1) available = length - 1;
+  if (available > 0) memcpy(buf, file->data + *offset, available);
+  for (int i = 0; i < length; i++) {
+    (*offset)++;
+    if (buf[i] == '\n') {
+      buf[i] = 0;
+      break;
+    }
+  }
+  return true;
+}
+
+bool filesystem_write_file(char *filename, char *text, int32_t length) {
+  if (!strcmp(filename, TOTP_BIN_FILE)) bin_writes++;
+  filesystem_rm(filename);
+  for (int i = 0; i < MEM_FILES; i++) {
+    if (!files[i].exists) {
+      strcpy(files[i].name, filename);
+      memcpy(files[i].data, text, length);
+      files[i].size = length;
+      files[i].exists = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool filesystem_append_file(char *filename, char *text, int32_t length) {
+  typeof(&files[0]) file = find_file(filename);
+  if (file == NULL) return filesystem_write_file(filename, text, length);
+  if (appends_until_failure-- == 0 || file->size + length > MEM_FILE_SIZE) return false;
+  memcpy(file->data + file->size, text, length);
+  file->size += length;
+  return true;
+}
+
+const movement_now_t *movement_get_now(void) {
+  static movement_now_t clock;
+  clock.timestamp = now;
+  return &clock;
+}
+
+void watch_display_string(char *string, uint8_t position) {
+  (void) position;
+  strncpy(display, string, sizeof(display) - 1);
+}
+
+bool movement_default_loop_handler(movement_event_t event, movement_settings_t *settings) {
+  (void) event;
+  (void) settings;
+  return true;
+}
+
+void movement_move_to_face(uint8_t watch_face_index) {
+  (void) watch_face_index;
+}
+
+void movement_illuminate_led(void) {
+}
+
+static totp_lfs_state_t state;
+
+void *movement_get_context_slot(uint8_t watch_face_index) {
+  (void) watch_face_index;
+  return &state;
+}
+
+// RFC 6238's SHA1 test key, "12345678901234567890"; at T=59 its 8-digit code is 94287082.
+#define RFC_SECRET "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ"
+#define URI_RFC "otpauth://totp/RFC:test?secret=" RFC_SECRET "&issuer=RFC&period=30\n"
+#define URI_EXAMPLE "otpauth://totp/Example:alice@google.com?secret=JBSWY3DPEHPK3PXP&issuer=Example\n"
+#define URI_BAD_START "http://example.com/?secret=JBSWY3DPEHPK3PXP\n"
+#define URI_NO_SECRET "otpauth://totp/None?issuer=None\n"
+
+static movement_settings_t settings;
+
+void setUp(void) {
+  memset(files, 0, sizeof(files));
+  appends_until_failure = -1;
+  bin_writes = 0;
+  now = 59;
+  num_totp_records = 0;
+  memset(display, 0, sizeof(display));
+}
+
+void tearDown(void) {
+}
+
+static void activate(void) {
+  totp_face_lfs_activate(&settings, &state);
+  movement_event_t event = { .event_type = EVENT_ACTIVATE, .subsecond = 0 };
+  totp_face_lfs_loop(event, &settings, &state);
+}
+
+static char *secret_of_length(size_t length) {
+  static char uri[256];
+  strcpy(uri, "otpauth://totp/Long?issuer=Long&secret=");
+  for (size_t i = 0; i < length; i++) strcat(uri, "A");
+  strcat(uri, "\n");
+  return uri;
+}
+
+void test_fixture_compiles_valid_records(void) {
+  put_file(TOTP_FILE, URI_BAD_START URI_RFC URI_NO_SECRET URI_EXAMPLE);
+  activate();
+
+  TEST_ASSERT_EQUAL_INT(2, num_totp_records);
+  TEST_ASSERT_EQUAL_INT32(sizeof(totp_bin_header_t) + 2 * sizeof(struct totp_record), filesystem_get_file_size(TOTP_BIN_FILE));
+  TEST_ASSERT_EQUAL_STRING("RF 1287082", display);
+
+  movement_event_t event = { .event_type = EVENT_ALARM_BUTTON_UP, .subsecond = 0 };
+  totp_face_lfs_loop(event, &settings, &state);
+  TEST_ASSERT_EQUAL_UINT8(1, state.current_index);
+  TEST_ASSERT_EQUAL_CHAR('E', display[0]);
+  TEST_ASSERT_EQUAL_CHAR('x', display[1]);
+}
+
+void test_unchanged_text_reuses_compiled_file(void) {
+  put_file(TOTP_FILE, URI_RFC URI_EXAMPLE);
+  activate();
+  TEST_ASSERT_EQUAL_INT(1, bin_writes);
+
+  num_totp_records = 0;
+  activate();
+  TEST_ASSERT_EQUAL_INT(1, bin_writes);
+  TEST_ASSERT_EQUAL_INT(2, num_totp_records);
+  TEST_ASSERT_EQUAL_STRING("RF 1287082", display);
+}
+
+void test_edited_text_rebuilds_compiled_file(void) {
+  put_file(TOTP_FILE, URI_RFC URI_EXAMPLE);
+  activate();
+
+  put_file(TOTP_FILE, URI_EXAMPLE);
+  num_totp_records = 0;
+  activate();
+  TEST_ASSERT_EQUAL_INT(2, bin_writes);
+  TEST_ASSERT_EQUAL_INT(1, num_totp_records);
+  TEST_ASSERT_EQUAL_CHAR('E', display[0]);
+}
+
+void test_secret_length_limit(void) {
+  // 76 characters make a 47 byte key, but the decoder writes all 48 bytes of secret[]; 77 would spill past it.
+  put_file(TOTP_FILE, secret_of_length(MAX_TOTP_SECRET_SIZE * 8 / 5));
+  activate();
+  TEST_ASSERT_EQUAL_INT(1, num_totp_records);
+  TEST_ASSERT_EQUAL_UINT8(47, current_record.secret_size);
+
+  put_file(TOTP_FILE, secret_of_length(MAX_TOTP_SECRET_SIZE * 8 / 5 + 1));
+  num_totp_records = 0;
+  activate();
+  TEST_ASSERT_EQUAL_INT(0, num_totp_records);
+
+  put_file(TOTP_FILE, secret_of_length(79));
+  num_totp_records = 0;
+  activate();
+  TEST_ASSERT_EQUAL_INT(0, num_totp_records);
+}
+
+void test_failed_append_leaves_no_compiled_file(void) {
+  put_file(TOTP_FILE, URI_RFC URI_EXAMPLE);
+  appends_until_failure = 1;
+  activate();
+  TEST_ASSERT_EQUAL_INT(0, num_totp_records);
+  TEST_ASSERT_FALSE(filesystem_file_exists(TOTP_BIN_FILE));
+  TEST_ASSERT_EQUAL_STRING("No2F Codes", display);
+
+  // and the next look parses the text again rather than trusting half a file.
+  appends_until_failure = -1;
+  activate();
+  TEST_ASSERT_EQUAL_INT(2, num_totp_records);
+  TEST_ASSERT_EQUAL_INT32(sizeof(totp_bin_header_t) + 2 * sizeof(struct totp_record), filesystem_get_file_size(TOTP_BIN_FILE));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixture_compiles_valid_records);
+  RUN_TEST(test_unchanged_text_reuses_compiled_file);
+  RUN_TEST(test_edited_text_rebuilds_compiled_file);
+  RUN_TEST(test_secret_length_limit);
+  RUN_TEST(test_failed_append_leaves_no_compiled_file);
+  return UNITY_END();
+}
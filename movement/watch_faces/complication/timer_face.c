@@ -37,7 +37,8 @@ static const int8_t _sound_seq_start[] = {BUZZER_NOTE_C8, 2, 0};
 static uint8_t _beeps_to_play;    // temporary counter for ring signals playing
 
 static inline int32_t _get_tz_offset(movement_settings_t *settings) {
-    return movement_timezone_offsets[settings->bit.time_zone] * 60;
+    (void) settings;
+    return movement_get_current_timezone_offset();
 }
 
 static void _signal_callback() {
@@ -49,7 +50,7 @@ static void _signal_callback() {
 
 static void _start(timer_state_t *state, movement_settings_t *settings, bool with_beep) {
     if (state->timers[state->current_timer].value == 0) return;
-    watch_date_time now = watch_rtc_get_date_time();
+    watch_date_time now = movement_get_now()->local;
     state->now_ts = watch_utility_date_time_to_unix_time(now, _get_tz_offset(settings));
     if (state->mode == pausing)
         state->target_ts = state->now_ts + state->paused_left;
@@ -193,7 +194,7 @@ void timer_face_setup(movement_settings_t *settings, uint8_t watch_face_index, v
     (void) settings;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(timer_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         timer_state_t *state = (timer_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(timer_state_t));
         state->watch_face_index = watch_face_index;
@@ -209,7 +210,7 @@ void timer_face_activate(movement_settings_t *settings, void *context) {
     watch_display_string("TR", 0);
     watch_set_colon();
     if(state->mode == running) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         state->now_ts = watch_utility_date_time_to_unix_time(now, _get_tz_offset(settings));
         watch_set_indicator(WATCH_INDICATOR_BELL);
     } else {
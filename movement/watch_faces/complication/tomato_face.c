@@ -31,7 +31,8 @@ static uint8_t focus_min = 25;
 static uint8_t break_min = 5;
 
 static inline int32_t get_tz_offset(movement_settings_t *settings) {
-    return movement_timezone_offsets[settings->bit.time_zone] * 60;
+    (void) settings;
+    return movement_get_current_timezone_offset();
 }
 
 static uint8_t get_length(tomato_state_t *state) {
@@ -46,11 +47,10 @@ static uint8_t get_length(tomato_state_t *state) {
 }
 
 static void tomato_start(tomato_state_t *state, movement_settings_t *settings) {
-    watch_date_time now = watch_rtc_get_date_time();
     int8_t length = (int8_t) get_length(state);
 
     state->mode = tomato_run;
-    state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
+    state->now_ts = movement_get_now()->timestamp;
     state->target_ts = watch_utility_offset_timestamp(state->now_ts, 0, length, 0);
     watch_date_time target_dt = watch_utility_date_time_from_unix_time(state->target_ts, get_tz_offset(settings));
     movement_schedule_background_task(target_dt);
@@ -109,10 +109,9 @@ static void tomato_ring(tomato_state_t *state) {
 
 void tomato_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(tomato_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         tomato_state_t *state = (tomato_state_t*)*context_ptr;
         memset(*context_ptr, 0, sizeof(tomato_state_t));
         state->mode=tomato_ready;
@@ -123,10 +122,10 @@ void tomato_face_setup(movement_settings_t *settings, uint8_t watch_face_index,
 }
 
 void tomato_face_activate(movement_settings_t *settings, void *context) {
+    (void) settings;
     tomato_state_t *state = (tomato_state_t *)context;
     if (state->mode == tomato_run) {
-        watch_date_time now = watch_rtc_get_date_time();
-        state->now_ts = watch_utility_date_time_to_unix_time(now, get_tz_offset(settings));
+        state->now_ts = movement_get_now()->timestamp;
         watch_set_indicator(WATCH_INDICATOR_BELL);
     }
     watch_set_colon();
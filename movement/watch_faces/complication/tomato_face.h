@@ -72,6 +72,8 @@ void tomato_face_activate(movement_settings_t *settings, void *context);
 bool tomato_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void tomato_face_resign(movement_settings_t *settings, void *context);
 
+#define tomato_face_context_size sizeof(tomato_state_t)
+
 #define tomato_face ((const watch_face_t){ \
     tomato_face_setup, \
     tomato_face_activate, \
@@ -100,6 +100,8 @@ void toss_up_face_activate(movement_settings_t *settings, void *context);
 bool toss_up_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void toss_up_face_resign(movement_settings_t *settings, void *context);
 
+#define toss_up_face_context_size sizeof(toss_up_state_t)
+
 #define toss_up_face ((const watch_face_t){ \
     toss_up_face_setup, \
     toss_up_face_activate, \
@@ -39,10 +39,6 @@
 #include "TOTP.h"
 #include "base32.h"
 
-#ifndef TOTP_FACE_MAX_KEY_LENGTH
-#define TOTP_FACE_MAX_KEY_LENGTH 128
-#endif
-
 typedef struct {
     unsigned char labels[2];
     hmac_alg algorithm;
@@ -158,18 +154,16 @@ static void totp_generate_and_display(totp_state_t *totp_state) {
 }
 
 static inline uint32_t totp_compute_base_timestamp(movement_settings_t *settings) {
-    return watch_utility_date_time_to_unix_time(watch_rtc_get_date_time(), movement_timezone_offsets[settings->bit.time_zone] * 60);
+    (void) settings;
+    return movement_get_now()->timestamp;
 }
 
 void totp_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
-
-    totp_validate_key_lengths();
 
     if (*context_ptr == NULL) {
-        totp_state_t *totp = malloc(sizeof(totp_state_t));
-        totp->current_decoded_key = malloc(TOTP_FACE_MAX_KEY_LENGTH);
+        totp_validate_key_lengths();
+        totp_state_t *totp = movement_get_context_slot(watch_face_index);
         *context_ptr = totp;
     }
 }
@@ -184,7 +178,6 @@ void totp_face_activate(movement_settings_t *settings, void *context) {
     totp->current_code = 0;
     totp->current_index = 0;
     totp->current_decoded_key_length = 0;
-    // totp->current_decoded_key is already initialized in setup
 
     totp_generate_and_display(totp);
 }
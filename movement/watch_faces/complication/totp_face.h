@@ -65,12 +65,16 @@
 
 #include "movement.h"
 
+#ifndef TOTP_FACE_MAX_KEY_LENGTH
+#define TOTP_FACE_MAX_KEY_LENGTH 128
+#endif
+
 typedef struct {
     uint32_t timestamp;
     uint8_t steps;
     uint32_t current_code;
     uint8_t current_index;
-    uint8_t *current_decoded_key;
+    uint8_t current_decoded_key[TOTP_FACE_MAX_KEY_LENGTH];
     size_t current_decoded_key_length;
 } totp_state_t;
 
@@ -79,6 +83,8 @@ void totp_face_activate(movement_settings_t *settings, void *context);
 bool totp_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void totp_face_resign(movement_settings_t *settings, void *context);
 
+#define totp_face_context_size sizeof(totp_state_t)
+
 #define totp_face ((const watch_face_t){ \
     totp_face_setup, \
     totp_face_activate, \
@@ -38,26 +38,45 @@
 #define MAX_TOTP_RECORDS 20
 #define MAX_TOTP_SECRET_SIZE 48
 #define TOTP_FILE "totp_uris.txt"
+#define TOTP_BIN_FILE "totp_uris.bin"
+#define TOTP_BIN_MAGIC 0x504F5454 // "TTOP", little endian
+#define TOTP_BIN_VERSION 1
 
 const char* TOTP_URI_START = "otpauth://totp/";
 
+// One record of the compiled credential file. Records are fixed size, so record n lives at
+// sizeof(totp_bin_header_t) + n * sizeof(struct totp_record), and we only ever read the one we need.
 struct totp_record {
-    uint8_t *secret;
-    size_t secret_size;
-    char label[2];
     uint32_t period;
-    hmac_alg algorithm;
+    uint8_t algorithm;
+    uint8_t digits;
+    char label[2];
+    uint8_t secret_size;
+    uint8_t secret[MAX_TOTP_SECRET_SIZE];
 };
 
-static struct totp_record totp_records[MAX_TOTP_RECORDS];
+// Header of the compiled credential file. The source size and checksum let us notice when
+// totp_uris.txt has been edited, in which case the binary file is rebuilt from the text.
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t record_size;
+    int32_t source_size;
+    uint32_t source_checksum;
+} totp_bin_header_t;
+
+// Only the selected record is kept in RAM; the TOTP library holds a pointer to its secret.
+static struct totp_record current_record;
 static int num_totp_records = 0;
 
 static void init_totp_record(struct totp_record *totp_record) {
-    totp_record->secret_size = 0;
+    memset(totp_record, 0, sizeof(struct totp_record));
     totp_record->label[0] = 'A';
     totp_record->label[1] = 'A';
     totp_record->period = 30;
     totp_record->algorithm = SHA1;
+    totp_record->digits = 6;
 }
 
 static bool totp_face_lfs_read_param(struct totp_record *totp_record, char *param, char *value) {
@@ -69,22 +88,23 @@ static bool totp_face_lfs_read_param(struct totp_record *totp_record, char *para
         totp_record->label[0] = value[0];
         totp_record->label[1] = value[1];
     } else if (!strcmp(param, "secret")) {
-        if (UNBASE32_LEN(strlen(value)) > MAX_TOTP_SECRET_SIZE) {
+        // base32_decode writes a partial block's worth of bytes past the last whole one, so bound
+        // the text rather than UNBASE32_LEN, which rounds down.
+        if (strlen(value) > MAX_TOTP_SECRET_SIZE * 8 / 5) {
             printf("TOTP secret too long: %s\n", value);
             return false;
         }
-        totp_record->secret = malloc(UNBASE32_LEN(strlen(value)));
         totp_record->secret_size = base32_decode((unsigned char *)value, totp_record->secret);
         if (totp_record->secret_size == 0) {
-            free(totp_record->secret);
             printf("TOTP can't decode secret: %s\n", value);
             return false;
         }
     } else if (!strcmp(param, "digits")) {
-        if (!strcmp(param, "6")) {
+        if (strcmp(value, "6")) {
             printf("TOTP got %s, not 6 digits\n", value);
             return false;
         }
+        totp_record->digits = 6;
     } else if (!strcmp(param, "period")) {
         totp_record->period = atoi(value);
         if (totp_record->period == 0) {
@@ -116,19 +136,38 @@ static bool totp_face_lfs_read_param(struct totp_record *totp_record, char *para
     return true;
 }
 
-static void totp_face_lfs_read_file(char *filename) {
+static bool totp_face_lfs_checksum_chunk(const char *chunk, int32_t length, int32_t offset, void *context) {
+    (void) offset;
+    // FNV-1a
+    uint32_t *checksum = (uint32_t *)context;
+    for (int32_t i = 0; i < length; i++) {
+        *checksum ^= (uint8_t)chunk[i];
+        *checksum *= 16777619UL;
+    }
+    return true;
+}
+
+static uint32_t totp_face_lfs_checksum_file(char *filename) {
+    uint32_t checksum = 2166136261UL;
+    filesystem_read_chunks(filename, totp_face_lfs_checksum_chunk, &checksum);
+    return checksum;
+}
+
+static int totp_face_lfs_compile_file(char *filename, totp_bin_header_t *header) {
     // For 'format' of file, see comment at top.
     const size_t uri_start_len = strlen(TOTP_URI_START);
+    int num_records = 0;
 
-    if (!filesystem_file_exists(filename)) {
-        printf("TOTP file error: %s\n", filename);
-        return;
+    if (!filesystem_write_file(TOTP_BIN_FILE, (char *)header, sizeof(totp_bin_header_t))) {
+        printf("TOTP can't write %s\n", TOTP_BIN_FILE);
+        filesystem_rm(TOTP_BIN_FILE);
+        return 0;
     }
 
     char line[256];
     int32_t offset = 0;
     while (filesystem_read_line(filename, line, &offset, 255) && strlen(line)) {
-        if (num_totp_records == MAX_TOTP_RECORDS) {
+        if (num_records == MAX_TOTP_RECORDS) {
             printf("TOTP max records: %d\n", MAX_TOTP_RECORDS);
             break;
         }
@@ -149,52 +188,94 @@ static void totp_face_lfs_read_file(char *filename) {
         }
 
         // Process the parameters and put them in the record
-        init_totp_record(&totp_records[num_totp_records]);
+        struct totp_record record;
+        init_totp_record(&record);
         bool error = false;
-        param = strtok_r(params + 1, "&", &param_saveptr);
-        do {
+        for (param = strtok_r(params + 1, "&", &param_saveptr); param != NULL; param = strtok_r(NULL, "&", &param_saveptr)) {
             char *param_middle = strchr(param, '=');
+            if (param_middle == NULL) continue;
             *param_middle = '\0';
-            error = error || !totp_face_lfs_read_param(&totp_records[num_totp_records], param, param_middle + 1);
-        } while ((param = strtok_r(NULL, "&", &param_saveptr)));
-
-        if (error) {
-            totp_records[num_totp_records].secret_size = 0;
-            continue;
+            error = error || !totp_face_lfs_read_param(&record, param, param_middle + 1);
         }
 
+        if (error) continue;
+
         // If we found a probably valid TOTP record, keep it.
-        if (totp_records[num_totp_records].secret_size) {
-            num_totp_records += 1;
+        if (record.secret_size) {
+            if (!filesystem_append_file(TOTP_BIN_FILE, (char *)&record, sizeof(struct totp_record))) {
+                // The header already claims this file matches the text, so a short one would be
+                // trusted on the next load. Get rid of it and parse again next time.
+                printf("TOTP can't write %s\n", TOTP_BIN_FILE);
+                filesystem_rm(TOTP_BIN_FILE);
+                return 0;
+            }
+            num_records += 1;
         } else {
             printf("TOTP missing secret: %s\n", line);
         }
     }
+
+    return num_records;
+}
+
+static void totp_face_lfs_load(char *filename) {
+    num_totp_records = 0;
+
+    int32_t source_size = filesystem_get_file_size(filename);
+    if (source_size <= 0) {
+        printf("TOTP file error: %s\n", filename);
+        return;
+    }
+
+    totp_bin_header_t expected = {
+        .magic = TOTP_BIN_MAGIC,
+        .version = TOTP_BIN_VERSION,
+        .record_size = sizeof(struct totp_record),
+        .source_size = source_size,
+        .source_checksum = totp_face_lfs_checksum_file(filename),
+    };
+
+    // If the compiled file was built from this exact text file, just count its records.
+    totp_bin_header_t header;
+    int32_t bin_size = filesystem_get_file_size(TOTP_BIN_FILE);
+    if (bin_size >= (int32_t)sizeof(totp_bin_header_t) &&
+        filesystem_read_file_at(TOTP_BIN_FILE, (char *)&header, 0, sizeof(totp_bin_header_t)) == sizeof(totp_bin_header_t) &&
+        !memcmp(&header, &expected, sizeof(totp_bin_header_t))) {
+        num_totp_records = (bin_size - sizeof(totp_bin_header_t)) / sizeof(struct totp_record);
+        return;
+    }
+
+    // Otherwise parse the URIs once, and stash the result for next time.
+    num_totp_records = totp_face_lfs_compile_file(filename, &expected);
+}
+
+static bool totp_face_lfs_read_record(int i) {
+    int32_t offset = sizeof(totp_bin_header_t) + i * sizeof(struct totp_record);
+    return filesystem_read_file_at(TOTP_BIN_FILE, (char *)&current_record, offset, sizeof(struct totp_record)) == sizeof(struct totp_record);
 }
 
 void totp_face_lfs_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(totp_lfs_state_t));
-    }
-
-#if !(__EMSCRIPTEN__)
-    if (num_totp_records == 0) {
-        totp_face_lfs_read_file(TOTP_FILE);
+        *context_ptr = movement_get_context_slot(watch_face_index);
     }
-#endif
 }
 
 static void totp_face_set_record(totp_lfs_state_t *totp_state, int i) {
-    if (num_totp_records == 0 && i >= num_totp_records) {
+    if (num_totp_records == 0 || i >= num_totp_records) {
+        return;
+    }
+
+    if (!totp_face_lfs_read_record(i)) {
+        printf("TOTP can't read record %d\n", i);
+        num_totp_records = 0;
         return;
     }
 
     totp_state->current_index = i;
-    TOTP(totp_records[i].secret, totp_records[i].secret_size, totp_records[i].period, totp_records[i].algorithm);
+    TOTP(current_record.secret, current_record.secret_size, current_record.period, current_record.algorithm);
     totp_state->current_code = getCodeFromTimestamp(totp_state->timestamp);
-    totp_state->steps = totp_state->timestamp / totp_records[i].period;
+    totp_state->steps = totp_state->timestamp / current_record.period;
 }
 
 void totp_face_lfs_activate(movement_settings_t *settings, void *context) {
@@ -202,20 +283,17 @@ void totp_face_lfs_activate(movement_settings_t *settings, void *context) {
     memset(context, 0, sizeof(totp_lfs_state_t));
     totp_lfs_state_t *totp_state = (totp_lfs_state_t *)context;
 
-#if __EMSCRIPTEN__
     if (num_totp_records == 0) {
-        // Doing this here rather than in setup makes things a bit more pleasant in the simulator, since there's no easy way to trigger
-        // setup again after uploading the data.
-        totp_face_lfs_read_file(TOTP_FILE);
+        // Doing this here rather than in setup means we only parse the file when someone looks at their codes,
+        // and pick it up without a reboot if it was uploaded after boot.
+        totp_face_lfs_load(TOTP_FILE);
     }
-#endif
 
-    totp_state->timestamp = watch_utility_date_time_to_unix_time(watch_rtc_get_date_time(), movement_timezone_offsets[settings->bit.time_zone] * 60);
+    totp_state->timestamp = movement_get_now()->timestamp;
     totp_face_set_record(totp_state, 0);
 }
 
 static void totp_face_display(totp_lfs_state_t *totp_state) {
-    uint8_t index = totp_state->current_index;
     char buf[14];
 
     if (num_totp_records == 0) {
@@ -223,14 +301,14 @@ static void totp_face_display(totp_lfs_state_t *totp_state) {
         return;
     }
 
-    div_t result = div(totp_state->timestamp, totp_records[index].period);
+    div_t result = div(totp_state->timestamp, current_record.period);
     if (result.quot != totp_state->steps) {
         totp_state->current_code = getCodeFromTimestamp(totp_state->timestamp);
         totp_state->steps = result.quot;
     }
-    uint8_t valid_for = totp_records[index].period - result.rem;
+    uint8_t valid_for = current_record.period - result.rem;
 
-    sprintf(buf, "%c%c%2d%06lu", totp_records[index].label[0], totp_records[index].label[1], valid_for, totp_state->current_code);
+    sprintf(buf, "%c%c%2d%06lu", current_record.label[0], current_record.label[1], valid_for, totp_state->current_code);
 
     watch_display_string(buf, 0);
 }
@@ -37,6 +37,12 @@
  * This is also the same as what Aegis exports in plain-text format.
  * This face performs minimal sanitisation of input, however.
  *
+ * The text file is only parsed when it changes: the face compiles it into
+ * "totp_uris.bin", a file of fixed-size binary records tagged with the size
+ * and checksum of the text it came from. After that, only the record being
+ * displayed is read from the filesystem and kept in memory. You don't need
+ * to touch the .bin file; delete it if you ever want to force a rebuild.
+ *
  * At the moment, to get the records onto the filesystem, start a serial connection and do:
  *   echo otpauth://totp/Example:alice@google.com?secret=JBSWY3DPEHPK3PXP&issuer=Example > totp_uris.txt
  *   echo otpauth://totp/ACME%20Co:john.doe@email.com?secret=HXDMVJECJJWSRB3HWIZR4IFUGFTMXBOZ&issuer=ACME%20Co&algorithm=SHA1&digits=6&period=30 >> totp_uris.txt
@@ -65,6 +71,8 @@ void totp_face_lfs_activate(movement_settings_t *settings, void *context);
 bool totp_face_lfs_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void totp_face_lfs_resign(movement_settings_t *settings, void *context);
 
+#define totp_face_lfs_context_size sizeof(totp_lfs_state_t)
+
 #define totp_face_lfs ((const watch_face_t){ \
     totp_face_lfs_setup, \
     totp_face_lfs_activate, \
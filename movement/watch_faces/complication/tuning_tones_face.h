@@ -45,6 +45,8 @@ void tuning_tones_face_activate(movement_settings_t *settings, void *context);
 bool tuning_tones_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void tuning_tones_face_resign(movement_settings_t *settings, void *context);
 
+#define tuning_tones_face_context_size sizeof(tuning_tones_state_t)
+
 #define tuning_tones_face ((const watch_face_t){ \
     tuning_tones_face_setup, \
     tuning_tones_face_activate, \
@@ -62,10 +62,9 @@ void _wake_face_update_display(movement_settings_t *settings, wake_face_state_t
 
 void wake_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr) {
     (void) settings;
-    (void) watch_face_index;
 
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(wake_face_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         wake_face_state_t *state = (wake_face_state_t *)*context_ptr;
         memset(*context_ptr, 0, sizeof(wake_face_state_t));
 
@@ -90,7 +89,7 @@ bool wake_face_wants_background_task(movement_settings_t *settings, void *contex
 
     bool rc = false;
     if ( state->mode ) {
-        watch_date_time now = watch_rtc_get_date_time();
+        watch_date_time now = movement_get_now()->local;
         rc = state->hour==now.unit.hour && state->minute==now.unit.minute;
         // We’re at the mercy of the wants_background_task handler
         // In Safari, the emulator triggers at the ›end‹ of the minute
@@ -29,8 +29,7 @@
 
 void character_set_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
-    if (*context_ptr == NULL) *context_ptr = malloc(sizeof(char));
+    if (*context_ptr == NULL) *context_ptr = movement_get_context_slot(watch_face_index);
 }
 
 void character_set_face_activate(movement_settings_t *settings, void *context) {
@@ -43,6 +43,8 @@ void character_set_face_activate(movement_settings_t *settings, void *context);
 bool character_set_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void character_set_face_resign(movement_settings_t *settings, void *context);
 
+#define character_set_face_context_size sizeof(char)
+
 #define character_set_face ((const watch_face_t){ \
     character_set_face_setup, \
     character_set_face_activate, \
@@ -28,33 +28,6 @@
 #include "chirpy_tx.h"
 #include "filesystem.h"
 
-typedef enum {
-    CDM_CHOOSE = 0,
-    CDM_CHIRPING,
-} chirpy_demo_mode_t;
-
-typedef enum {
-    CDP_SCALE = 0,
-    CDP_INFO_SHORT,
-    CDP_INFO_LONG,
-    CDP_INFO_NANOSEC,
-} chirpy_demo_program_t;
-
-typedef struct {
-    // Current mode
-    chirpy_demo_mode_t mode;
-
-    // Selected program
-    chirpy_demo_program_t program;
-
-    // Helps us handle 1/64 ticks during transmission; including countdown timer
-    chirpy_tick_state_t tick_state;
-
-    // Used by chirpy encoder during transmission
-    chirpy_encoder_state_t encoder_state;
-
-} chirpy_demo_state_t;
-
 static uint8_t long_data_str[] =
     "There once was a ship that put to sea\n"
     "The name of the ship was the Billy of Tea\n"
@@ -98,9 +71,8 @@ static uint16_t nanosec_buffer_size = 0;
 
 void chirpy_demo_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void **context_ptr) {
     (void)settings;
-    (void)watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(chirpy_demo_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(chirpy_demo_state_t));
         // Do any one-time tasks in here; the inside of this conditional happens only at boot.
     }
@@ -138,6 +110,7 @@ void chirpy_demo_face_activate(movement_settings_t *settings, void *context) {
 
 static void _cdf_update_lcd(chirpy_demo_state_t *state) {
     watch_display_string("CH", 0);
+    watch_display_string(state->profile == CHIRPY_PROFILE_FAST ? " F" : "  ", 2);
     if (state->program == CDP_SCALE)
         watch_display_string(" SCALE", 4);
     else if (state->program == CDP_INFO_SHORT)
@@ -176,13 +149,12 @@ static void _cdf_scale_tick(void *context) {
 static void _cdf_data_tick(void *context) {
     chirpy_demo_state_t *state = (chirpy_demo_state_t *)context;
 
-    uint8_t tone = chirpy_get_next_tone(&state->encoder_state);
+    uint16_t period = chirpy_get_next_period(&state->tone_queue, &state->encoder_state);
     // Transmission over?
-    if (tone == 255) {
+    if (period == 0) {
         _cdf_quit_chirping(state);
         return;
     }
-    uint16_t period = chirpy_get_tone_period(tone);
     watch_set_buzzer_period(period);
     watch_set_buzzer_on();
 }
@@ -205,7 +177,7 @@ static void _cdf_countdown_tick(void *context) {
 
     // Countdown over: start actual broadcast
     if (tick_state->seq_pos == 8 * 3) {
-        tick_state->tick_compare = 3;
+        tick_state->tick_compare = CHIRPY_STANDARD_SYMBOL_TICKS;
         tick_state->tick_count = -1;
         tick_state->seq_pos = 0;
         // We'll be chirping out a scale
@@ -215,7 +187,10 @@ static void _cdf_countdown_tick(void *context) {
         // We'll be chirping out data
         else {
             // Set up the encoder
-            chirpy_init_encoder(&state->encoder_state, _cdf_get_next_byte);
+            chirpy_init_encoder_with_profile(&state->encoder_state, _cdf_get_next_byte, state->profile);
+            chirpy_init_tone_queue(&state->tone_queue);
+            if (state->profile == CHIRPY_PROFILE_FAST)
+                tick_state->tick_compare = CHIRPY_FAST_SYMBOL_TICKS;
             tick_state->tick_fun = _cdf_data_tick;
             // Set up the data
             curr_data_ix = 0;
@@ -269,7 +244,14 @@ bool chirpy_demo_face_loop(movement_event_t event, movement_settings_t *settings
             }
             break;
         case EVENT_LIGHT_BUTTON_UP:
-            // We don't do light.
+            // We don't do light. If in choose mode: switch between the standard and fast profiles
+            if (state->mode == CDM_CHOOSE) {
+                if (state->profile == CHIRPY_PROFILE_STANDARD)
+                    state->profile = CHIRPY_PROFILE_FAST;
+                else
+                    state->profile = CHIRPY_PROFILE_STANDARD;
+                _cdf_update_lcd(state);
+            }
             break;
         case EVENT_ALARM_BUTTON_UP:
             // If in choose mode: select next program
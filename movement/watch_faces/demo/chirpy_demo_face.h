@@ -45,18 +45,60 @@
  * famous sea shanty.
  * 
  * Select the transmission you want with ALARM, the press LONG ALARM to chirp.
+ *
+ * LIGHT switches data transmissions between the standard profile and the
+ * fast one (an F shows next to CH), which carries 4 bits per tone with a
+ * shorter symbol, roughly doubling throughput. The web app below only
+ * decodes the standard profile; the reference receiver in
+ * lib/chirpy_tx/test decodes both.
  * 
  * To record and decode a chirpy transmission on your computer, you can use the web app here:
  * https://jealousmarkup.xyz/off/chirpy/rx/
  */
 
 #include "movement.h"
+#include "chirpy_tx.h"
+
+typedef enum {
+    CDM_CHOOSE = 0,
+    CDM_CHIRPING,
+} chirpy_demo_mode_t;
+
+typedef enum {
+    CDP_SCALE = 0,
+    CDP_INFO_SHORT,
+    CDP_INFO_LONG,
+    CDP_INFO_NANOSEC,
+} chirpy_demo_program_t;
+
+typedef struct {
+    // Current mode
+    chirpy_demo_mode_t mode;
+
+    // Selected program
+    chirpy_demo_program_t program;
+
+    // Transmission profile for data programs
+    chirpy_profile_t profile;
+
+    // Helps us handle 1/64 ticks during transmission; including countdown timer
+    chirpy_tick_state_t tick_state;
+
+    // Used by chirpy encoder during transmission
+    chirpy_encoder_state_t encoder_state;
+
+    // Tones encoded ahead of the transmission
+    chirpy_tone_queue_t tone_queue;
+
+} chirpy_demo_state_t;
 
 void chirpy_demo_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
 void chirpy_demo_face_activate(movement_settings_t *settings, void *context);
 bool chirpy_demo_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void chirpy_demo_face_resign(movement_settings_t *settings, void *context);
 
+#define chirpy_demo_face_context_size sizeof(chirpy_demo_state_t)
+
 #define chirpy_demo_face ((const watch_face_t){ \
     chirpy_demo_face_setup, \
     chirpy_demo_face_activate, \
@@ -71,9 +71,8 @@ static void _disable_output() {
 
 void frequency_correction_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(frequency_correction_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         frequency_correction_state_t *state = (frequency_correction_state_t *)*context_ptr;
         state->period_event_output = 0;
     }
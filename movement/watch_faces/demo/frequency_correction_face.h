@@ -48,6 +48,8 @@ void frequency_correction_face_activate(movement_settings_t *settings, void *con
 bool frequency_correction_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void frequency_correction_face_resign(movement_settings_t *settings, void *context);
 
+#define frequency_correction_face_context_size sizeof(frequency_correction_state_t)
+
 #define frequency_correction_face ((const watch_face_t){ \
     frequency_correction_face_setup, \
     frequency_correction_face_activate, \
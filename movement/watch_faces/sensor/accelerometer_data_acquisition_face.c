@@ -67,10 +67,9 @@ static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw
 
 void accelerometer_data_acquisition_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     accelerometer_data_acquisition_state_t *state = (accelerometer_data_acquisition_state_t *)*context_ptr;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(accelerometer_data_acquisition_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(accelerometer_data_acquisition_state_t));
         state = (accelerometer_data_acquisition_state_t *)*context_ptr;
         state->beep_with_countdown = true;
@@ -430,6 +429,7 @@ static void log_data_point(accelerometer_data_acquisition_state_t *state, lis2dw
 }
 
 static void start_reading(accelerometer_data_acquisition_state_t *state, movement_settings_t *settings) {
+    (void) settings;
     printf("Start reading\n");
     watch_enable_i2c();
     lis2dw_begin();
@@ -441,8 +441,8 @@ static void start_reading(accelerometer_data_acquisition_state_t *state, movemen
     lis2dw_enable_fifo();
 
     accelerometer_data_acquisition_record_t record;
-    watch_date_time date_time = watch_rtc_get_date_time();
-    state->starting_timestamp = watch_utility_date_time_to_unix_time(date_time, movement_timezone_offsets[settings->bit.time_zone] * 60);
+    watch_date_time date_time = movement_get_now()->local;
+    state->starting_timestamp = watch_utility_date_time_to_unix_time(date_time, movement_get_current_timezone_offset());
     record.header.info.record_type = ACCELEROMETER_DATA_ACQUISITION_HEADER;
     record.header.info.range = ACCELEROMETER_RANGE;
     record.header.info.temperature = lis2dw_get_temperature();
@@ -33,9 +33,8 @@ uint16_t lightmeter_mod(uint16_t m, uint16_t n) { return (m%n + n)%n; }
 
 void lightmeter_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(lightmeter_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         lightmeter_state_t *state = (lightmeter_state_t*) *context_ptr;
         state->waiting_for_conversion = 0;
         state->lux = 0.0;
@@ -180,6 +180,8 @@ void lightmeter_face_resign(movement_settings_t *settings, void *context);
 
 static const uint8_t lightmeter_addr = 0x44;
 
+#define lightmeter_face_context_size sizeof(lightmeter_state_t)
+
 #define lightmeter_face ((const watch_face_t){ \
     lightmeter_face_setup, \
     lightmeter_face_activate, \
@@ -76,6 +76,8 @@ bool thermistor_logging_face_loop(movement_event_t event, movement_settings_t *s
 void thermistor_logging_face_resign(movement_settings_t *settings, void *context);
 bool thermistor_logging_face_wants_background_task(movement_settings_t *settings, void *context);
 
+#define thermistor_logging_face_context_size sizeof(thermistor_logger_state_t)
+
 #define thermistor_logging_face ((const watch_face_t){ \
     thermistor_logging_face_setup, \
     thermistor_logging_face_activate, \
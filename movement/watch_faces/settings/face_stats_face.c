@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "face_stats_face.h"
+
+static const char face_stats_labels[FACE_STATS_NUM_METRICS][3] = { "WA", "AC", "PE", "bC" };
+
+static uint32_t _face_stats_value(const facestats_t *stats, face_stats_metric_t metric) {
+    switch (metric) {
+        case FACE_STATS_WAKES:
+            return stats->wakes;
+        case FACE_STATS_ACTIVE:
+            return stats->active_us / 1000;
+        case FACE_STATS_PEAK:
+            return stats->max_us;
+        case FACE_STATS_BACKGROUND:
+            return stats->background_us / 1000;
+        default:
+            return 0;
+    }
+}
+
+static void _face_stats_face_update_display(face_stats_state_t *state) {
+    char buf[11];
+    uint32_t value = _face_stats_value(movement_get_face_stats(state->face_idx), state->metric);
+
+    if (value > 999999) value = 999999;
+    sprintf(buf, "%s%2d%6lu", face_stats_labels[state->metric], state->face_idx % 100, (unsigned long)value);
+    watch_display_string(buf, 0);
+}
+
+void face_stats_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
+    (void) settings;
+    if (*context_ptr == NULL) {
+        *context_ptr = movement_get_context_slot(watch_face_index);
+        memset(*context_ptr, 0, sizeof(face_stats_state_t));
+    }
+}
+
+void face_stats_face_activate(movement_settings_t *settings, void *context) {
+    (void) settings;
+    (void) context;
+}
+
+bool face_stats_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
+    face_stats_state_t *state = (face_stats_state_t *)context;
+
+    switch (event.event_type) {
+        case EVENT_ACTIVATE:
+        case EVENT_TICK:
+            _face_stats_face_update_display(state);
+            break;
+        case EVENT_LIGHT_BUTTON_UP:
+            state->metric = (state->metric + 1) % FACE_STATS_NUM_METRICS;
+            _face_stats_face_update_display(state);
+            break;
+        case EVENT_LIGHT_BUTTON_DOWN:
+            // don't light up the LED; LIGHT changes the number shown.
+            break;
+        case EVENT_ALARM_BUTTON_UP:
+            state->face_idx = (state->face_idx + 1) % movement_get_num_faces();
+            _face_stats_face_update_display(state);
+            break;
+        case EVENT_ALARM_LONG_PRESS:
+            movement_reset_face_stats();
+            _face_stats_face_update_display(state);
+            break;
+        case EVENT_TIMEOUT:
+            movement_move_to_face(0);
+            break;
+        default:
+            return movement_default_loop_handler(event, settings);
+    }
+
+    return true;
+}
+
+void face_stats_face_resign(movement_settings_t *settings, void *context) {
+    (void) settings;
+    (void) context;
+}
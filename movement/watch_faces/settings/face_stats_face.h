@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FACE_STATS_FACE_H_
+#define FACE_STATS_FACE_H_
+
+#include "movement.h"
+
+/*
+ * FACE STATS face
+ *
+ * Shows what each watch face has cost since the watch was reset: how often
+ * Movement has woken it, and how long it kept the CPU awake. This is for
+ * finding the face that is draining your battery; the same numbers are
+ * printed by the "stats" command on the USB serial shell.
+ *
+ * The number in the top right is the position of the face being shown, the
+ * first face being 0. Press ALARM to move on to the next face. Press LIGHT to
+ * move on to the next number, labeled in the top left:
+ *
+ *  WA - Wakes: how many times the face's loop ran while it was on screen.
+ *  AC - Active: milliseconds spent in those calls.
+ *  PE - Peak: microseconds spent in the longest of them.
+ *  bC - Background cost: milliseconds spent on the face's background tasks.
+ *
+ * Long press ALARM to set every face's numbers back to zero. Numbers too big
+ * for the display show as 999999.
+ */
+
+typedef enum {
+    FACE_STATS_WAKES = 0,
+    FACE_STATS_ACTIVE,
+    FACE_STATS_PEAK,
+    FACE_STATS_BACKGROUND,
+    FACE_STATS_NUM_METRICS
+} face_stats_metric_t;
+
+typedef struct {
+    uint8_t face_idx;
+    face_stats_metric_t metric;
+} face_stats_state_t;
+
+void face_stats_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
+void face_stats_face_activate(movement_settings_t *settings, void *context);
+bool face_stats_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
+void face_stats_face_resign(movement_settings_t *settings, void *context);
+
+#define face_stats_face_context_size sizeof(face_stats_state_t)
+
+#define face_stats_face ((const watch_face_t){ \
+    face_stats_face_setup, \
+    face_stats_face_activate, \
+    face_stats_face_loop, \
+    face_stats_face_resign, \
+    NULL, \
+})
+
+#endif // FACE_STATS_FACE_H_
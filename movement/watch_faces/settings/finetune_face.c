@@ -52,7 +52,7 @@ void finetune_face_activate(movement_settings_t *settings, void *context) {
 }
 
 static float finetune_get_hours_passed(void) {
-    uint32_t current_time = watch_utility_date_time_to_unix_time(watch_rtc_get_date_time(), 0);
+    uint32_t current_time = movement_get_now()->local_timestamp;
     return (current_time - nanosec_state.last_correction_time) / 3600.0f;
 }
 
@@ -65,7 +65,7 @@ static void finetune_update_display(void) {
 
     if (finetune_page == 0) {
         watch_display_string("FT", 0);
-        watch_date_time date_time = watch_rtc_get_date_time();
+        watch_date_time date_time = movement_get_now()->local;
         sprintf(buf, "%02d", date_time.unit.second);
         watch_display_string(buf, 8);
 
@@ -147,7 +147,7 @@ bool finetune_face_loop(movement_event_t event, movement_settings_t *settings, v
             // We flash green LED once per minute to measure clock error, when we are not on first screen
             if (finetune_page!=0) {
                 watch_date_time date_time;
-                date_time = watch_rtc_get_date_time();
+                date_time = movement_get_now()->local;
                 if (date_time.unit.second == 0) {
                     watch_set_led_green();
                     #ifndef __EMSCRIPTEN__
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "memory_stats_face.h"
+
+static const char memory_stats_labels[MEMORY_STATS_NUM_METRICS][3] = { "St", "HE", "PE", "HF", "ER" };
+
+static uint32_t _memory_stats_value(const watch_memory_stats_t *stats, memory_stats_metric_t metric) {
+    switch (metric) {
+        case MEMORY_STATS_STACK:
+            return stats->stack_high_water;
+        case MEMORY_STATS_HEAP_LIVE:
+            return stats->heap.live_bytes;
+        case MEMORY_STATS_HEAP_PEAK:
+            return stats->heap.peak_bytes;
+        case MEMORY_STATS_HEAP_FREE:
+            return stats->heap_free;
+        case MEMORY_STATS_FAILURES:
+            return stats->heap.failures;
+        default:
+            return 0;
+    }
+}
+
+static void _memory_stats_face_update_display(memory_stats_state_t *state) {
+    char buf[11];
+    watch_memory_stats_t stats;
+    watch_get_memory_stats(&stats);
+
+    uint32_t value = _memory_stats_value(&stats, state->metric);
+    if (value > 999999) value = 999999;
+    sprintf(buf, "%s  %6lu", memory_stats_labels[state->metric], (unsigned long)value);
+    watch_display_string(buf, 0);
+}
+
+void memory_stats_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
+    (void) settings;
+    if (*context_ptr == NULL) {
+        *context_ptr = movement_get_context_slot(watch_face_index);
+        memset(*context_ptr, 0, sizeof(memory_stats_state_t));
+    }
+}
+
+void memory_stats_face_activate(movement_settings_t *settings, void *context) {
+    (void) settings;
+    (void) context;
+}
+
+bool memory_stats_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
+    memory_stats_state_t *state = (memory_stats_state_t *)context;
+
+    switch (event.event_type) {
+        case EVENT_ACTIVATE:
+        case EVENT_TICK:
+            _memory_stats_face_update_display(state);
+            break;
+        case EVENT_LIGHT_BUTTON_UP:
+            state->metric = (state->metric + 1) % MEMORY_STATS_NUM_METRICS;
+            _memory_stats_face_update_display(state);
+            break;
+        case EVENT_LIGHT_BUTTON_DOWN:
+            // don't light up the LED; LIGHT changes the number shown.
+            break;
+        case EVENT_TIMEOUT:
+            movement_move_to_face(0);
+            break;
+        default:
+            return movement_default_loop_handler(event, settings);
+    }
+
+    return true;
+}
+
+void memory_stats_face_resign(movement_settings_t *settings, void *context) {
+    (void) settings;
+    (void) context;
+}
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MEMORY_STATS_FACE_H_
+#define MEMORY_STATS_FACE_H_
+
+#include "movement.h"
+
+/*
+ * MEMORY STATS face
+ *
+ * Shows how much of the watch's 32 KB of RAM is in use, for checking that a
+ * firmware with many faces has room to spare. The same numbers are printed
+ * by the "mem" command on the USB serial shell. Press LIGHT to move on to the
+ * next number, labeled in the top left; all are in bytes, except ER:
+ *
+ *  St - Stack: the deepest the stack has been since the watch was reset.
+ *  HE - Heap: memory handed out by malloc and not freed yet.
+ *  PE - Peak: the most that HE has been.
+ *  HF - Heap free: RAM the heap can still grow into.
+ *  ER - Errors: how many times malloc had nothing left to give.
+ */
+
+typedef enum {
+    MEMORY_STATS_STACK = 0,
+    MEMORY_STATS_HEAP_LIVE,
+    MEMORY_STATS_HEAP_PEAK,
+    MEMORY_STATS_HEAP_FREE,
+    MEMORY_STATS_FAILURES,
+    MEMORY_STATS_NUM_METRICS
+} memory_stats_metric_t;
+
+typedef struct {
+    memory_stats_metric_t metric;
+} memory_stats_state_t;
+
+void memory_stats_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr);
+void memory_stats_face_activate(movement_settings_t *settings, void *context);
+bool memory_stats_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
+void memory_stats_face_resign(movement_settings_t *settings, void *context);
+
+#define memory_stats_face_context_size sizeof(memory_stats_state_t)
+
+#define memory_stats_face ((const watch_face_t){ \
+    memory_stats_face_setup, \
+    memory_stats_face_activate, \
+    memory_stats_face_loop, \
+    memory_stats_face_resign, \
+    NULL, \
+})
+
+#endif // MEMORY_STATS_FACE_H_
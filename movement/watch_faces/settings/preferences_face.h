@@ -83,6 +83,8 @@ void preferences_face_activate(movement_settings_t *settings, void *context);
 bool preferences_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void preferences_face_resign(movement_settings_t *settings, void *context);
 
+#define preferences_face_context_size sizeof(uint8_t)
+
 #define preferences_face ((const watch_face_t){ \
     preferences_face_setup, \
     preferences_face_activate, \
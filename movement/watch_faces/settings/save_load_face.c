@@ -38,7 +38,7 @@ static void save(save_load_state_t *state) {
         watch_get_backup_data(5),
         watch_get_backup_data(6),
         watch_get_backup_data(7),
-        watch_rtc_get_date_time(),
+        movement_get_now()->local,
     };
     state->slot[state->index] = savefile;
     char filename[23];
@@ -75,9 +75,8 @@ static void load_saves_to_state(save_load_state_t *state) {
 
 void save_load_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
     if (*context_ptr == NULL) {
-        *context_ptr = malloc(sizeof(save_load_state_t));
+        *context_ptr = movement_get_context_slot(watch_face_index);
         memset(*context_ptr, 0, sizeof(save_load_state_t));
     }
 }
@@ -70,6 +70,8 @@ void save_load_face_activate(movement_settings_t *settings, void *context);
 bool save_load_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void save_load_face_resign(movement_settings_t *settings, void *context);
 
+#define save_load_face_context_size sizeof(save_load_state_t)
+
 #define save_load_face ((const watch_face_t){ \
     save_load_face_setup, \
     save_load_face_activate, \
@@ -64,10 +64,10 @@ static void _handle_alarm_button(movement_settings_t *settings, watch_date_time
         }
         case 6: // time zone
             settings->bit.time_zone++;
-            if (settings->bit.time_zone > 40) settings->bit.time_zone = 0;
+            if (settings->bit.time_zone >= TZDB_NUM_ZONES) settings->bit.time_zone = 0;
             break;
     }
-    watch_rtc_set_date_time(date_time);
+    movement_set_local_date_time(date_time);
 }
 
 static void _abort_quick_ticks() {
@@ -79,8 +79,7 @@ static void _abort_quick_ticks() {
 
 void set_time_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
-    if (*context_ptr == NULL) *context_ptr = malloc(sizeof(uint8_t));
+    if (*context_ptr == NULL) *context_ptr = movement_get_context_slot(watch_face_index);
 }
 
 void set_time_face_activate(movement_settings_t *settings, void *context) {
@@ -92,7 +91,7 @@ void set_time_face_activate(movement_settings_t *settings, void *context) {
 
 bool set_time_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
     uint8_t current_page = *((uint8_t *)context);
-    watch_date_time date_time = watch_rtc_get_date_time();
+    watch_date_time date_time = movement_get_now()->local;
 
     switch (event.event_type) {
         case EVENT_TICK:
@@ -152,7 +151,8 @@ bool set_time_face_loop(movement_event_t event, movement_settings_t *settings, v
             sprintf(buf, "%s        ", set_time_face_titles[current_page]);
         } else {
             watch_set_colon();
-            sprintf(buf, "%s %3d%02d  ", set_time_face_titles[current_page], (int8_t) (movement_timezone_offsets[settings->bit.time_zone] / 60), (int8_t) (movement_timezone_offsets[settings->bit.time_zone] % 60) * (movement_timezone_offsets[settings->bit.time_zone] < 0 ? -1 : 1));
+            int16_t tz_offset = movement_get_current_timezone_offset() / 60;
+            sprintf(buf, "%s %3d%02d  ", set_time_face_titles[current_page], (int8_t) (tz_offset / 60), (int8_t) (tz_offset % 60) * (tz_offset < 0 ? -1 : 1));
         }
     }
 
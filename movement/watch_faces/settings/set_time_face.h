@@ -37,9 +37,13 @@
  *
  * For features like World Clock and Sunrise/Sunset to work correctly, you
  * must set the time to your local time, and the time zone to your local time
- * zone. This allows Sensor Watch to correctly offset the time. This also
- * means that when daylight savings time starts or ends, you must update
- * both the time and the time zone on this screen.
+ * zone. This allows Sensor Watch to correctly offset the time.
+ *
+ * The first 41 time zones are fixed offsets from UTC; if you pick one of
+ * those, you must update both the time and the time zone on this screen
+ * when daylight saving time starts or ends. The zones after them follow a
+ * region's daylight saving rules (New York, London, Sydney and so on), and
+ * the watch moves its clock forward and back on its own.
  */
 
 #include "movement.h"
@@ -49,6 +53,8 @@ void set_time_face_activate(movement_settings_t *settings, void *context);
 bool set_time_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void set_time_face_resign(movement_settings_t *settings, void *context);
 
+#define set_time_face_context_size sizeof(uint8_t)
+
 #define set_time_face ((const watch_face_t){ \
     set_time_face_setup, \
     set_time_face_activate, \
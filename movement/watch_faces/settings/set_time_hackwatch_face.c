@@ -34,15 +34,14 @@ watch_date_time date_time_settings;
 
 void set_time_hackwatch_face_setup(movement_settings_t *settings, uint8_t watch_face_index, void ** context_ptr) {
     (void) settings;
-    (void) watch_face_index;
-    if (*context_ptr == NULL) *context_ptr = malloc(sizeof(uint8_t));
+    if (*context_ptr == NULL) *context_ptr = movement_get_context_slot(watch_face_index);
 }
 
 void set_time_hackwatch_face_activate(movement_settings_t *settings, void *context) {
     (void) settings;
     *((uint8_t *)context) = 3;
     movement_request_tick_frequency(32);
-    date_time_settings = watch_rtc_get_date_time();
+    date_time_settings = movement_get_now()->local;
 }
 
 bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *settings, void *context) {
@@ -50,7 +49,7 @@ bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *s
     const uint8_t days_in_month[12] = {31, 28, 31, 30, 31, 30, 30, 31, 30, 31, 30, 31};
 
     if (event.subsecond == 15) // Delay displayed time update by ~0.5 seconds, to align phase exactly to main clock at 1Hz
-        date_time_settings = watch_rtc_get_date_time();
+        date_time_settings = movement_get_now()->local;
 
     static int8_t seconds_reset_sequence;
 
@@ -93,7 +92,7 @@ bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *s
                     }
                 }
                 date_time_settings.unit.second = 0;
-                watch_rtc_set_date_time(date_time_settings);
+                movement_set_local_date_time(date_time_settings);
             }
             break;
         case EVENT_ALARM_BUTTON_DOWN:
@@ -130,12 +129,12 @@ bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *s
                     if (settings->bit.time_zone > 0) {
                         settings->bit.time_zone--;
                     } else {
-                        settings->bit.time_zone = 40;
+                        settings->bit.time_zone = TZDB_NUM_ZONES - 1;
                     }
                     break;
             }
             if (current_page != 2) // Do not set time when we are at seconds, it was already set previously
-                watch_rtc_set_date_time(date_time_settings);
+                movement_set_local_date_time(date_time_settings);
             break;
         
         case EVENT_ALARM_LONG_UP://Setting seconds on long release
@@ -175,11 +174,11 @@ bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *s
                     break;
                 case 6: // time zone
                     settings->bit.time_zone++;
-                    if (settings->bit.time_zone > 40) settings->bit.time_zone = 0;
+                    if (settings->bit.time_zone >= TZDB_NUM_ZONES) settings->bit.time_zone = 0;
                     break;
             }
             if (current_page != 2) // Do not set time when we are at seconds, it was already set previously
-                watch_rtc_set_date_time(date_time_settings);
+                movement_set_local_date_time(date_time_settings);
             //TODO: Do not update whole RTC, just what we are changing
             break;
         case EVENT_TIMEOUT:
@@ -233,11 +232,12 @@ bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *s
             sprintf(buf, "%s        ", set_time_hackwatch_face_titles[current_page]);
         } else {
             watch_set_colon();
+            int16_t tz_offset = movement_get_current_timezone_offset() / 60;
             sprintf(buf,
                     "%s %3d%02d  ",
                     set_time_hackwatch_face_titles[current_page],
-                    (int8_t)(movement_timezone_offsets[settings->bit.time_zone] / 60),
-                    (int8_t)(movement_timezone_offsets[settings->bit.time_zone] % 60) * (movement_timezone_offsets[settings->bit.time_zone] < 0 ? -1 : 1));
+                    (int8_t)(tz_offset / 60),
+                    (int8_t)(tz_offset % 60) * (tz_offset < 0 ? -1 : 1));
         }
     }
 
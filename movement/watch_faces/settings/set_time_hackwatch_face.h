@@ -55,6 +55,8 @@ void set_time_hackwatch_face_activate(movement_settings_t *settings, void *conte
 bool set_time_hackwatch_face_loop(movement_event_t event, movement_settings_t *settings, void *context);
 void set_time_hackwatch_face_resign(movement_settings_t *settings, void *context);
 
+#define set_time_hackwatch_face_context_size sizeof(uint8_t)
+
 #define set_time_hackwatch_face ((const watch_face_t){ \
     set_time_hackwatch_face_setup, \
     set_time_hackwatch_face_activate, \
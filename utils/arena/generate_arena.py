@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Writes movement_arena_faces.h, the face list that Movement's context arena is laid out from.
+
+Movement keeps every face's context in one statically allocated arena instead of on the heap;
+see movement/movement_arena.h. The arena has a slot for each entry in the firmware's watch_faces
+array, in order, sized by the <face>_context_size macro in the face's header. This script reads
+that array out of movement_config.h (or an alt_fw header) and writes the list as an X macro, so
+the compiler can do the sizing and the layout. Faces that don't define a size keep no context, and
+get 0. Movement uses the same list to set aside backup registers for the
+faces that declare <face>_backup_registers; faces that don't get 0.
+
+The build runs this whenever the config changes; the output goes in the build directory, and
+shouldn't be committed.
+
+Usage: python3 generate_arena.py path/to/movement_config.h path/to/movement_arena_faces.h
+"""
+
+import os
+import re
+import sys
+
+
+def read_face_list(text):
+    """Returns the names in the watch_faces array initializer, in order."""
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    match = re.search(r"watch_faces\s*\[\s*\]\s*=\s*\{(.*?)\}\s*;", text, flags=re.S)
+    if match is None:
+        raise ValueError("no watch_faces array found")
+    faces = [name.strip() for name in match.group(1).split(",") if name.strip()]
+    for name in faces:
+        if not re.fullmatch(r"[A-Za-z_][A-Za-z0-9_]*", name):
+            raise ValueError("can't lay out a face that isn't a plain name: %r" % name)
+    if not faces:
+        raise ValueError("watch_faces is empty")
+    return faces
+
+
+def render(faces, source):
+    lines = [
+        "// Generated from %s by utils/arena/generate_arena.py; don't edit." % source,
+        "",
+        "#ifndef MOVEMENT_ARENA_FACES_H_",
+        "#define MOVEMENT_ARENA_FACES_H_",
+        "",
+        "// faces that keep no context take no room in the arena, and faces that don't declare backup",
+        "// registers get none set aside.",
+    ]
+    for name in dict.fromkeys(faces):
+        lines += [
+            "#ifndef %s_context_size" % name,
+            "#define %s_context_size 0" % name,
+            "#endif",
+            "#ifndef %s_backup_registers" % name,
+            "#define %s_backup_registers 0" % name,
+            "#endif",
+        ]
+    lines += ["", "#define MOVEMENT_ARENA_FACES(X) \\"]
+    lines += ["    X(%d, %s) \\" % (index, name) for index, name in enumerate(faces)]
+    lines += ["", "#endif // MOVEMENT_ARENA_FACES_H_", ""]
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__.strip().splitlines()[-1])
+    config, output = sys.argv[1], sys.argv[2]
+    with open(config) as f:
+        faces = read_face_list(f.read())
+    text = render(faces, os.path.basename(config))
+    # leave the file alone if nothing changed, so make doesn't rebuild everything that includes it.
+    if os.path.exists(output):
+        with open(output) as f:
+            if f.read() == text:
+                return
+    with open(output, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,370 @@
+#!/usr/bin/env python3
+"""
+Host tests for generate_arena.py: reading face lists, and laying out the arena for the standard
+firmware and every alt_fw one, to check that no two slots overlap, and that every face's slot comes
+back intact from a hibernation snapshot (movement/lib/hibernate), and that the real faces in the
+arena resume from it rather than starting over. The harnesses include the listed faces' headers, so
+the sizes are the real sizeof of each face's state, as the host compiler lays it out; on the watch,
+pointers and some alignments are smaller.
+Run from this directory: python3 -m unittest test_generate_arena
+"""
+
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import unittest
+
+import generate_arena
+
+TOP = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..")
+MOVEMENT = os.path.join(TOP, "movement")
+CONFIGS = [os.path.join(MOVEMENT, "movement_config.h")] + sorted(glob.glob(os.path.join(MOVEMENT, "alt_fw", "*.h")))
+CC = shutil.which("cc") or shutil.which("gcc")
+
+# What the face headers need to compile on the host: Movement's and the simulator build's include
+# paths (see movement/make/Makefile and make.mk), plus the chip headers that watch.h pulls in.
+LIBRARY = os.path.join(TOP, "watch-library")
+INCLUDES = [MOVEMENT] + sorted(glob.glob(os.path.join(MOVEMENT, "watch_faces", "*"))) + sorted(glob.glob(os.path.join(MOVEMENT, "lib", "*"))) + [
+    os.path.join(TOP, "boards", "OSO-SWAT-A1-05"),
+    os.path.join(LIBRARY, "shared", "driver"),
+    os.path.join(LIBRARY, "shared", "config"),
+    os.path.join(LIBRARY, "shared", "watch"),
+    os.path.join(LIBRARY, "simulator", "watch"),
+    os.path.join(LIBRARY, "simulator", "hpl", "port"),
+    os.path.join(LIBRARY, "hardware", "include"),
+    os.path.join(LIBRARY, "hardware", "include", "component"),
+    os.path.join(LIBRARY, "hardware", "hri"),
+    os.path.join(LIBRARY, "hardware", "hal", "include"),
+    os.path.join(LIBRARY, "hardware", "hal", "utils", "include"),
+    os.path.join(LIBRARY, "hardware", "hpl", "slcd"),
+    os.path.join(LIBRARY, "hardware", "hw"),
+]
+
+HARNESS = """\
+#include <stdio.h>
+%s
+#include "movement_arena.h"
+
+int main(void) {
+    static const size_t offsets[] = MOVEMENT_ARENA_OFFSETS;
+    static const size_t sizes[] = MOVEMENT_ARENA_SIZES;
+    printf("%%zu %%zu\\n", sizeof(movement_arena_t), (size_t)MOVEMENT_ARENA_ALIGNMENT);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) printf("%%zu %%zu\\n", offsets[i], sizes[i]);
+    return 0;
+}
+"""
+
+# A RAM file for the hibernation snapshot, in the shape of movement/lib/hibernate's io hooks.
+MEM_IO = """\
+static char file[65536];
+static int32_t file_size = -1;
+
+static bool mem_write(char *path, char *data, int32_t length) {
+    (void) path;
+    memcpy(file, data, length);
+    file_size = length;
+    return true;
+}
+
+static bool mem_append(char *path, char *data, int32_t length) {
+    (void) path;
+    memcpy(file + file_size, data, length);
+    file_size += length;
+    return true;
+}
+
+static int32_t mem_read_at(char *path, char *buf, int32_t offset, int32_t length) {
+    (void) path;
+    if (file_size < 0) return -1;
+    if (offset + length > file_size) length = file_size - offset;
+    memcpy(buf, file + offset, length);
+    return length;
+}
+
+static bool mem_rm(char *path) {
+    (void) path;
+    file_size = -1;
+    return true;
+}
+
+static const hibernate_io_t io = { mem_write, mem_append, mem_read_at, mem_rm };
+"""
+
+# Fills every slot with a pattern of its own, saves a snapshot to a RAM file, wipes the arena, and
+# restores it. Prints the index of each face whose slot didn't come back, then "done".
+ROUND_TRIP = """\
+#include <stdio.h>
+#include <string.h>
+#include "hibernate.h"
+%s
+#include "movement_arena.h"
+
+""" + MEM_IO + """static movement_arena_t arena;
+
+int main(void) {
+    static const size_t offsets[] = MOVEMENT_ARENA_OFFSETS;
+    static const size_t sizes[] = MOVEMENT_ARENA_SIZES;
+    const uint8_t num_faces = sizeof(sizes) / sizeof(sizes[0]);
+    uint8_t saved[256];
+    uint8_t *bytes = (uint8_t *)&arena;
+
+    for (uint8_t i = 0; i < num_faces; i++) {
+        saved[i] = sizes[i] != 0;
+        for (size_t j = 0; j < sizes[i]; j++) bytes[offsets[i] + j] = (uint8_t)(i * 31 + j + 1);
+    }
+    hibernate_header_t header = { 0 };
+    header.layout = hibernate_layout(offsets, sizes, num_faces);
+    header.arena_size = sizeof(arena);
+    header.num_faces = num_faces;
+    if (!hibernate_save(&io, "hibernate.bin", &header, saved, &arena)) return 1;
+
+    memset(&arena, 0, sizeof(arena));
+    memset(saved, 0, sizeof(saved));
+    if (!hibernate_restore(&io, "hibernate.bin", &header, hibernate_layout(offsets, sizes, num_faces),
+                           num_faces, sizeof(arena), saved, &arena)) return 2;
+
+    for (uint8_t i = 0; i < num_faces; i++) {
+        bool intact = saved[i] == (sizes[i] != 0);
+        for (size_t j = 0; j < sizes[i]; j++) intact = intact && bytes[offsets[i] + j] == (uint8_t)(i * 31 + j + 1);
+        if (!intact) printf("%%u\\n", i);
+    }
+    printf("done\\n");
+    return 0;
+}
+"""
+
+
+# Hibernates the real faces the way movement_hibernate and app_setup do: sets up every face that has a
+# slot, as at first boot, then stands in for its running by filling the slot with a pattern of its own,
+# saves, wipes the arena, restores, and sets each face up again with its restored context. Prints the
+# index of each face that didn't take its slot or that reset its state on the second setup, then
+# "done". Only the faces' setup is called, so the link leaves out most of the watch library; what the
+# setups still reach for is stubbed below.
+FACE_ROUND_TRIP = """\
+#include <stdio.h>
+#include <string.h>
+#include "hibernate.h"
+%s
+#include "movement_arena.h"
+#include "spiflash.h"
+#include "lis2dw.h"
+
+""" + MEM_IO + """static movement_arena_t arena;
+static const size_t offsets[] = MOVEMENT_ARENA_OFFSETS;
+static const size_t sizes[] = MOVEMENT_ARENA_SIZES;
+#define FACE_SETUP(index, face) face##_context_size ? face##_setup : NULL,
+static const watch_face_setup setups[] = { MOVEMENT_ARENA_FACES(FACE_SETUP) };
+#define NUM_FACES (sizeof(setups) / sizeof(setups[0]))
+
+// what the arena faces' setup asks of Movement and the watch library
+void *movement_get_context_slot(uint8_t watch_face_index) {
+    return sizes[watch_face_index] ? (uint8_t *)&arena + offsets[watch_face_index] : NULL;
+}
+uint8_t movement_claim_backup_register(void) { return 4; }
+uint32_t watch_get_backup_data(uint8_t reg) { (void) reg; return 0; }
+void watch_store_backup_data(uint32_t data, uint8_t reg) { (void) data; (void) reg; }
+const movement_now_t *movement_get_now(void) { static movement_now_t now; return &now; }
+int32_t movement_get_current_timezone_offset(void) { return 0; }
+
+// and what the sensor and logging faces' setup asks of hardware that isn't there
+void delay_ms(const uint16_t ms);
+void delay_ms(const uint16_t ms) { (void) ms; }
+void watch_set_pin_level(const uint8_t pin, const bool level) { (void) pin; (void) level; }
+void watch_enable_i2c(void) {}
+void spi_flash_init(void) {}
+bool spi_flash_command(uint8_t command) { (void) command; return false; }
+bool spi_flash_read_command(uint8_t command, uint8_t *response, uint32_t length) { (void) command; memset(response, 0, length); return false; }
+bool spi_flash_write_data(uint32_t address, uint8_t *data, uint32_t data_length) { (void) address; (void) data; (void) data_length; return false; }
+bool spi_flash_read_data(uint32_t address, uint8_t *data, uint32_t data_length) { (void) address; memset(data, 0xff, data_length); return false; }
+bool lis2dw_begin(void) { return false; }
+void lis2dw_set_range(lis2dw_range_t range) { (void) range; }
+void lis2dw_set_data_rate(lis2dw_data_rate_t dataRate) { (void) dataRate; }
+void lis2dw_set_low_power_mode(lis2dw_low_power_mode_t mode) { (void) mode; }
+void lis2dw_set_low_noise_mode(bool on) { (void) on; }
+void lis2dw_configure_wakeup_int1(uint8_t threshold, bool latch, bool active_state) { (void) threshold; (void) latch; (void) active_state; }
+
+int main(void) {
+    movement_settings_t settings = { 0 };
+    void *contexts[NUM_FACES] = { 0 };
+    uint8_t saved[NUM_FACES];
+    uint8_t *bytes = (uint8_t *)&arena;
+
+    for (uint8_t i = 0; i < NUM_FACES; i++) {
+        if (setups[i] == NULL) continue;
+        setups[i](&settings, i, &contexts[i]);
+        if (contexts[i] != movement_get_context_slot(i)) printf("%%u\\n", i);
+        for (size_t j = 0; j < sizes[i]; j++) bytes[offsets[i] + j] = (uint8_t)(i * 31 + j + 1);
+    }
+    for (uint8_t i = 0; i < NUM_FACES; i++) saved[i] = contexts[i] != NULL && contexts[i] == movement_get_context_slot(i);
+    hibernate_header_t header = { 0 };
+    header.layout = hibernate_layout(offsets, sizes, NUM_FACES);
+    header.arena_size = sizeof(arena);
+    header.num_faces = NUM_FACES;
+    if (!hibernate_save(&io, "hibernate.bin", &header, saved, &arena)) return 1;
+
+    // the reboot
+    memset(&arena, 0, sizeof(arena));
+    memset(saved, 0, sizeof(saved));
+    memset(contexts, 0, sizeof(contexts));
+    if (!hibernate_restore(&io, "hibernate.bin", &header, hibernate_layout(offsets, sizes, NUM_FACES),
+                           NUM_FACES, sizeof(arena), saved, &arena)) return 2;
+
+    for (uint8_t i = 0; i < NUM_FACES; i++) {
+        if (setups[i] == NULL) continue;
+        if (saved[i]) contexts[i] = movement_get_context_slot(i);
+        setups[i](&settings, i, &contexts[i]);
+        bool resumed = saved[i] && contexts[i] == movement_get_context_slot(i);
+        for (size_t j = 0; j < sizes[i]; j++) resumed = resumed && bytes[offsets[i] + j] == (uint8_t)(i * 31 + j + 1);
+        if (!resumed) printf("%%u\\n", i);
+    }
+    printf("done\\n");
+    return 0;
+}
+"""
+
+
+class TestReadFaceList(unittest.TestCase):
+    def test_comments_and_whitespace_are_ignored(self):
+        text = """
+            const watch_face_t watch_faces[] = {
+                simple_clock_face, // the clock
+                /* world_clock_face, */
+                stopwatch_face,
+            };
+        """
+        self.assertEqual(generate_arena.read_face_list(text), ["simple_clock_face", "stopwatch_face"])
+
+    def test_anything_but_names_is_an_error(self):
+        with self.assertRaises(ValueError):
+            generate_arena.read_face_list("const watch_face_t watch_faces[] = { f(1) };")
+        with self.assertRaises(ValueError):
+            generate_arena.read_face_list("int x;")
+
+    def test_every_config_has_a_list(self):
+        for config in CONFIGS:
+            with open(config) as f:
+                self.assertTrue(generate_arena.read_face_list(f.read()), config)
+
+
+class TestFaces(unittest.TestCase):
+    """Every face takes its context from the arena, so that the arena accounts for all of it."""
+
+    def setups(self):
+        for source in sorted(glob.glob(os.path.join(MOVEMENT, "watch_faces", "*", "*.c"))):
+            with open(source) as f:
+                text = f.read()
+            for match in re.finditer(r"void\s+(\w+)_setup\s*\(", text):
+                yield source, match.group(1), text[match.start():text.index("\n}", match.start())]
+
+    def test_no_face_allocates_its_context(self):
+        for source, face, body in self.setups():
+            self.assertNotRegex(body, r"\b(malloc|calloc)\s*\(", "%s mallocs in setup" % face)
+
+    def test_every_face_that_takes_a_slot_declares_its_size(self):
+        for source, face, body in self.setups():
+            if "movement_get_context_slot" not in body:
+                continue
+            with open(source[:-2] + ".h") as f:
+                self.assertRegex(f.read(), r"#define\s+%s_context_size\b" % face, face)
+
+@unittest.skipUnless(CC, "needs a C compiler")
+class TestLayout(unittest.TestCase):
+    def run_harness(self, faces, harness, sources=()):
+        headers = "\n".join('#include "%s.h"' % name for name in dict.fromkeys(faces))
+        with tempfile.TemporaryDirectory() as tmp:
+            with open(os.path.join(tmp, "movement_arena_faces.h"), "w") as f:
+                f.write(generate_arena.render(faces, "test"))
+            with open(os.path.join(tmp, "harness.c"), "w") as f:
+                f.write(harness % headers)
+            binary = os.path.join(tmp, "harness")
+            includes = ["-I" + path for path in [tmp] + INCLUDES]
+            subprocess.run([CC, "-std=gnu99", "-D__SAML22J18A__"] + includes + ["-o", binary, os.path.join(tmp, "harness.c")] + list(sources), check=True)
+            lines = subprocess.run([binary], check=True, capture_output=True, text=True).stdout.split("\n")
+        return lines
+
+    def moved_to_arena(self, face):
+        """Whether the face's header gives it a slot, going by the header rather than the harness."""
+        for path in INCLUDES:
+            header = os.path.join(path, face + ".h")
+            if os.path.exists(header):
+                with open(header) as f:
+                    return re.search(r"#define\s+%s_context_size\b" % face, f.read()) is not None
+        self.fail("no header for %s" % face)
+
+    def lay_out(self, faces):
+        lines = self.run_harness(faces, HARNESS)
+        total, alignment = map(int, lines[0].split())
+        slots = [tuple(map(int, line.split())) for line in lines[1:] if line]
+        return total, alignment, slots
+
+    def check(self, faces, name):
+        total, alignment, slots = self.lay_out(faces)
+        self.assertEqual(len(slots), len(faces), name)
+        end = 0
+        for face, (offset, size) in zip(faces, slots):
+            self.assertEqual(size != 0, self.moved_to_arena(face), "%s: %s" % (name, face))
+            if size == 0:
+                continue
+            self.assertEqual(offset % alignment, 0, name)
+            self.assertGreaterEqual(offset, end, "%s: %s overlaps the slot before it" % (name, face))
+            end = offset + size
+        self.assertLessEqual(end, total, name)
+        # the padding never costs more than an alignment's worth per slot
+        self.assertLessEqual(total, sum(size for offset, size in slots) + alignment * len(faces), name)
+
+    def test_slots_do_not_overlap_in_any_config(self):
+        for config in CONFIGS:
+            with open(config) as f:
+                self.check(generate_arena.read_face_list(f.read()), os.path.basename(config))
+
+    def test_every_face_survives_hibernation_in_every_config(self):
+        sources = [os.path.join(MOVEMENT, "lib", "hibernate", "hibernate.c"), os.path.join(MOVEMENT, "lib", "xfer", "xfer.c")]
+        for config in CONFIGS:
+            with open(config) as f:
+                faces = generate_arena.read_face_list(f.read())
+            lines = self.run_harness(faces, ROUND_TRIP, sources)
+            broken = [faces[int(line)] for line in lines if line and line != "done"]
+            self.assertIn("done", lines, os.path.basename(config))
+            self.assertEqual(broken, [], os.path.basename(config))
+
+    def check_resumes_after_hibernation(self, faces, name):
+        sources = [os.path.join(MOVEMENT, "lib", "hibernate", "hibernate.c"), os.path.join(MOVEMENT, "lib", "xfer", "xfer.c")]
+        arena_faces = [face for face in dict.fromkeys(faces) if self.moved_to_arena(face)]
+        face_sources = [glob.glob(os.path.join(MOVEMENT, "watch_faces", "*", face + ".c"))[0] for face in arena_faces]
+        # the libraries the faces' setup calls into, where they build on the host
+        sources += [os.path.join(LIBRARY, "shared", "watch", "watch_utility.c"),
+                    os.path.join(MOVEMENT, "lib", "morsecalc", "calc.c"),
+                    os.path.join(MOVEMENT, "lib", "sunriset", "sunriset.c")]
+        # drops the faces' activate, loop and so on, and with them their calls into the watch library
+        flags = ["-ffunction-sections", "-fdata-sections", "-Wl,--gc-sections", "-lm"]
+        lines = self.run_harness(faces, FACE_ROUND_TRIP, sources + face_sources + flags)
+        reset = [faces[int(line)] for line in lines if line and line != "done"]
+        self.assertIn("done", lines, name)
+        self.assertEqual(reset, [], name)
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "needs GNU ld's --gc-sections")
+    def test_every_arena_face_resumes_after_hibernation_in_every_config(self):
+        for config in CONFIGS:
+            with open(config) as f:
+                self.check_resumes_after_hibernation(generate_arena.read_face_list(f.read()), os.path.basename(config))
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "needs GNU ld's --gc-sections")
+    def test_every_face_resumes_after_hibernation(self):
+        faces = []
+        for header in sorted(glob.glob(os.path.join(MOVEMENT, "watch_faces", "*", "*.h"))):
+            with open(header) as f:
+                faces += re.findall(r"#define\s+(\w+)\s+\(\(const watch_face_t\)", f.read())
+        self.check_resumes_after_hibernation(faces, "every face")
+
+    def test_a_face_listed_twice_gets_two_slots(self):
+        total, alignment, slots = self.lay_out(["simple_clock_face", "world_clock_face", "world_clock_face"])
+        self.assertNotEqual(slots[1][0], slots[2][0])
+        self.assertEqual(slots[1][1], slots[2][1])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Turns a histogram printed by the watch's "prof dump" shell command into a list of functions,
+busiest first, using the symbols in the firmware's ELF file.
+
+Build with `make PROFILER=1`, then on the watch's USB serial shell run `prof start`, use the
+watch for a while, `prof stop`, and `prof dump`. Save what it printed, from the "profile" line to
+the "end" line, to a file.
+
+Each bin covers a range of addresses; a bin that spans more than one function has its samples
+shared out between them by how much of the bin each one covers. Samples that land outside any
+function are put down to "(unknown)".
+
+Usage: python3 symbolize.py path/to/watch.elf dump.txt [--nm path/to/arm-none-eabi-nm]
+       python3 symbolize.py --symbols symbols.txt dump.txt
+where symbols.txt is the output of `arm-none-eabi-nm -n -S --defined-only watch.elf`.
+"""
+
+import argparse
+import subprocess
+import sys
+
+
+def parse_dump(lines):
+    """Returns (header, bins) from the lines of a dump; bins is a list of (address, count)."""
+    header = None
+    bins = []
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == "profile":
+            header = {words[i]: int(words[i + 1], 0) for i in range(1, len(words) - 1, 2)}
+            bins = []
+        elif words[0] == "end":
+            if header is None:
+                break
+            return header, bins
+        elif header is not None:
+            bins.append((int(words[0], 0), int(words[1])))
+    raise ValueError("no complete dump found; it starts with a 'profile' line and ends with 'end'")
+
+
+def parse_symbols(lines):
+    """Returns a sorted list of (start, end, name) for the functions in nm -n -S output."""
+    functions = []
+    for line in lines:
+        words = line.split()
+        # address, size, type, name; symbols without a size have no extent to attribute samples to.
+        if len(words) != 4 or words[2] not in "tTwW":
+            continue
+        start = int(words[0], 16) & ~1  # Thumb function addresses have their lowest bit set
+        size = int(words[1], 16)
+        if size:
+            functions.append((start, start + size, words[3]))
+    functions.sort()
+    return functions
+
+
+def attribute(header, bins, functions):
+    """Returns {name: samples} with each bin shared out between the functions it overlaps."""
+    width = 1 << header["shift"]
+    totals = {}
+    for address, count in bins:
+        end = address + width
+        covered = 0
+        for start, stop, name in functions:
+            if start >= end:
+                break
+            overlap = min(stop, end) - max(start, address)
+            if overlap > 0:
+                totals[name] = totals.get(name, 0) + count * overlap / width
+                covered += overlap
+        if covered < width:
+            totals["(unknown)"] = totals.get("(unknown)", 0) + count * (width - covered) / width
+    return totals
+
+
+def report(header, totals, out):
+    samples = header.get("samples", 0)
+    out.write("%d samples in %d-byte bins, %d outside" % (samples, 1 << header["shift"], header.get("outside", 0)))
+    if header.get("full"):
+        out.write("; a bin filled up, and sampling stopped early")
+    out.write("\n")
+    for name, count in sorted(totals.items(), key=lambda item: (-item[1], item[0])):
+        percent = 100.0 * count / samples if samples else 0
+        out.write("%6.2f%% %9.1f  %s\n" % (percent, count, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolizes a profiler dump from the watch.")
+    parser.add_argument("elf", nargs="?", help="the firmware's ELF file")
+    parser.add_argument("dump", help="what 'prof dump' printed")
+    parser.add_argument("--symbols", help="nm -n -S output to use instead of the ELF file")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="the nm to run on the ELF file")
+    args = parser.parse_args()
+
+    if args.symbols:
+        with open(args.symbols) as f:
+            symbol_lines = f.readlines()
+    elif args.elf:
+        symbol_lines = subprocess.run([args.nm, "-n", "-S", "--defined-only", args.elf],
+                                      check=True, capture_output=True, text=True).stdout.splitlines()
+    else:
+        parser.error("give the ELF file, or --symbols")
+
+    with open(args.dump) as f:
+        header, bins = parse_dump(f)
+    report(header, attribute(header, bins, parse_symbols(symbol_lines)), sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
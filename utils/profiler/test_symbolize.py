@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Host tests for symbolize.py, with made-up symbols and samples.
+Run from this directory: python3 -m unittest test_symbolize
+"""
+
+import io
+import unittest
+
+import symbolize
+
+SYMBOLS = """\
+00002000 00000100 T Reset_Handler
+00002101 00000080 T watch_rtc_get_date_time
+00002181 00000180 t _recalculate
+00002400 00000010 R some_table
+00002410 W weak_without_size
+"""
+
+DUMP = """\
+> prof dump
+profile base 0x00002000 shift 8 samples 100 outside 3 full 0
+0x00002000 10
+0x00002100 40
+0x00002200 50
+end
+$ 
+"""
+
+
+class TestSymbolize(unittest.TestCase):
+    def setUp(self):
+        self.header, self.bins = symbolize.parse_dump(DUMP.splitlines())
+        self.functions = symbolize.parse_symbols(SYMBOLS.splitlines())
+
+    def test_parse_dump(self):
+        self.assertEqual(self.header, {"base": 0x2000, "shift": 8, "samples": 100, "outside": 3, "full": 0})
+        self.assertEqual(self.bins, [(0x2000, 10), (0x2100, 40), (0x2200, 50)])
+
+    def test_incomplete_dump_is_an_error(self):
+        with self.assertRaises(ValueError):
+            symbolize.parse_dump(DUMP.splitlines()[:3])
+
+    def test_parse_symbols_keeps_sized_functions_only(self):
+        self.assertEqual(self.functions, [
+            (0x2000, 0x2100, "Reset_Handler"),
+            (0x2100, 0x2180, "watch_rtc_get_date_time"),
+            (0x2180, 0x2300, "_recalculate"),
+        ])
+
+    def test_bins_are_shared_out_by_overlap(self):
+        totals = symbolize.attribute(self.header, self.bins, self.functions)
+        self.assertAlmostEqual(totals["Reset_Handler"], 10)
+        # 0x2100 is half watch_rtc_get_date_time, half _recalculate; 0x2200 is all _recalculate.
+        self.assertAlmostEqual(totals["watch_rtc_get_date_time"], 20)
+        self.assertAlmostEqual(totals["_recalculate"], 70)
+        self.assertNotIn("(unknown)", totals)
+
+    def test_samples_outside_functions_are_unknown(self):
+        totals = symbolize.attribute(self.header, [(0x2300, 8)], self.functions)
+        self.assertEqual(totals, {"(unknown)": 8})
+
+    def test_report_is_busiest_first(self):
+        out = io.StringIO()
+        symbolize.report(self.header, symbolize.attribute(self.header, self.bins, self.functions), out)
+        lines = out.getvalue().splitlines()
+        self.assertEqual(lines[0], "100 samples in 256-byte bins, 3 outside")
+        self.assertTrue(lines[1].endswith("_recalculate"))
+        self.assertTrue(lines[3].endswith("Reset_Handler"))
+
+
+if __name__ == "__main__":
+    unittest.main()
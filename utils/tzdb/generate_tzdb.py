@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""
+Generates movement/lib/tzdb/tzdb_data.c and tzdb_data.h from the system's zoneinfo.
+
+Each zone becomes a list of eras. An era holds from its first year until the next era's, and
+gives a standard offset, a daylight saving delta, and the rules for when daylight saving time
+starts and ends, in the style of zic's: "the last Sunday of March", "the first Sunday on or
+after the 8th of March", or a fixed day, each at a time of day in local standard time. Years
+where the rules change (a country dropping DST, or moving it for a year) get eras of their own.
+
+Only the years the RTC can hold, 2020 through 2083, are covered. Every era is checked against
+zoneinfo before anything is written; a zone whose transitions don't fit the rule format stops
+the script rather than being approximated.
+
+Zone indexes are stored in the watch's settings, so never reorder or remove zones; add new
+ones at the end, up to 64 in all.
+
+Usage: python3 generate_tzdb.py [path/to/movement/lib/tzdb]
+"""
+
+import os
+import sys
+from datetime import datetime, timedelta, timezone
+from zoneinfo import ZoneInfo
+
+FIRST_YEAR = 2020
+LAST_YEAR = 2083
+MAX_ZONES = 64
+
+# The fixed offsets Movement has always offered, at the indexes it always had.
+FIXED_ZONES = [
+    ("UTC", 0), ("CET", 60), ("SAST", 120), ("ARST", 180), ("IRST", 210), ("GET", 240),
+    ("AFT", 270), ("PKT", 300), ("IST", 330), ("NPT", 345), ("KGT", 360), ("MYST", 390),
+    ("THA", 420), ("CST", 480), ("ACWS", 525), ("JST", 540), ("ACST", 570), ("AEST", 600),
+    ("LHST", 630), ("SBT", 660), ("NZST", 720), ("CHAS", 765), ("TOT", 780), ("CHAD", 825),
+    ("LINT", 840), ("BIT", -720), ("NUT", -660), ("HST", -600), ("MART", -570), ("AKST", -540),
+    ("PST", -480), ("MST", -420), ("CST", -360), ("EST", -300), ("VET", -270), ("AST", -240),
+    ("NST", -210), ("BRT", -180), ("NDT", -150), ("FNT", -120), ("AZOT", -60),
+]
+
+# Zones that follow their region's daylight saving rules. Names are at most four characters;
+# faces with little room show the first two.
+RULE_ZONES = [
+    ("LON", "Europe/London"),
+    ("BER", "Europe/Berlin"),
+    ("ATH", "Europe/Athens"),
+    ("AZO", "Atlantic/Azores"),
+    ("NYC", "America/New_York"),
+    ("CHI", "America/Chicago"),
+    ("DEN", "America/Denver"),
+    ("LAX", "America/Los_Angeles"),
+    ("ANC", "America/Anchorage"),
+    ("ADK", "America/Adak"),
+    ("HAL", "America/Halifax"),
+    ("NFL", "America/St_Johns"),
+    ("HAV", "America/Havana"),
+    ("SCL", "America/Santiago"),
+    ("SYD", "Australia/Sydney"),
+    ("ADL", "Australia/Adelaide"),
+    ("LHI", "Australia/Lord_Howe"),
+    ("AKL", "Pacific/Auckland"),
+    ("CHT", "Pacific/Chatham"),
+    ("JER", "Asia/Jerusalem"),
+    ("BEY", "Asia/Beirut"),
+    ("CAI", "Africa/Cairo"),
+]
+
+UTC = timezone.utc
+
+
+def offset_at(zone, t):
+    """Offset in minutes east of UTC at Unix time t."""
+    return int(datetime.fromtimestamp(t, zone).utcoffset().total_seconds()) // 60
+
+
+def transitions(zone, year):
+    """(Unix time, offset before, offset after) for each change of offset during a UTC year."""
+    start = int(datetime(year, 1, 1, tzinfo=UTC).timestamp())
+    end = int(datetime(year + 1, 1, 1, tzinfo=UTC).timestamp())
+    found = []
+    t = start
+    previous = offset_at(zone, start - 1)
+    while t < end:
+        step = min(t + 6 * 3600, end)
+        current = offset_at(zone, step - 1)
+        if current != previous:
+            low, high = t, step - 1
+            while low < high:
+                mid = (low + high) // 2
+                if offset_at(zone, mid) != previous:
+                    high = mid
+                else:
+                    low = mid + 1
+            found.append((low, previous, offset_at(zone, low)))
+            previous = offset_at(zone, low)
+            t = low + 1
+        else:
+            t = step
+    return found
+
+
+def days_in_month(year, month):
+    return ((datetime(year + month // 12, month % 12 + 1, 1) - datetime(year, month, 1)).days)
+
+
+def date_rules(year, month, day):
+    """Every rule that picks out this date, best first: (weekday, last, day)."""
+    weekday = datetime(year, month, day).isoweekday()
+    length = days_in_month(year, month)
+    rules = []
+    if day + 7 > length:
+        rules.append((weekday, 1, 0))
+    windows = [d for d in range(max(1, day - 6), day + 1) if d + 6 <= length]
+    rules += [(weekday, 0, d) for d in windows if d in (1, 8, 15, 22)]
+    rules += [(weekday, 0, d) for d in windows if d not in (1, 8, 15, 22)]
+    rules.append((0, 0, day))
+    return rules
+
+
+def rule_candidates(instant, std):
+    """Rules for a transition at this instant, as (month, at, [date rules])."""
+    local = datetime.fromtimestamp(instant + std * 60, UTC)
+    at = local.hour * 60 + local.minute
+    assert local.second == 0
+    return (local.month, at, date_rules(local.year, local.month, local.day))
+
+
+def describe_year(zone, year):
+    """The year's standard offset, DST delta and start/end rule candidates, or None if no DST."""
+    changes = transitions(zone, year)
+    offsets = {offset_at(zone, int(datetime(year, m, 15, tzinfo=UTC).timestamp())) for m in range(1, 13)}
+    for _, before, after in changes:
+        offsets |= {before, after}
+    if len(offsets) == 1:
+        return (offsets.pop(), 0, None, None)
+    if len(offsets) != 2:
+        raise ValueError(f"{year}: more than two offsets {sorted(offsets)}")
+    std, dst = min(offsets), max(offsets)
+    start = [rule_candidates(t, std) for t, before, after in changes if after == dst]
+    end = [rule_candidates(t, std) for t, before, after in changes if after == std]
+    if len(start) != 1 or len(end) != 1:
+        raise ValueError(f"{year}: expected one start and one end of DST, got {len(start)} and {len(end)}")
+    return (std, dst - std, start[0], end[0])
+
+
+def merge(rule, candidates):
+    """Narrow a rule's date candidates to those that also fit this year, or None if it doesn't."""
+    if rule[0] != candidates[0] or rule[1] != candidates[1]:
+        return None
+    common = [r for r in rule[2] if r in candidates[2]]
+    return (rule[0], rule[1], common) if common else None
+
+
+def fit_eras(zone):
+    eras = []
+    for year in range(FIRST_YEAR, LAST_YEAR + 1):
+        std, delta, start, end = describe_year(zone, year)
+        if eras:
+            era = eras[-1]
+            if era["std"] == std and era["delta"] == delta:
+                if delta == 0:
+                    continue
+                merged_start, merged_end = merge(era["start"], start), merge(era["end"], end)
+                if merged_start and merged_end:
+                    era["start"], era["end"] = merged_start, merged_end
+                    continue
+        eras.append({"year": year, "std": std, "delta": delta, "start": start, "end": end})
+    return eras
+
+
+def rule_date(year, rule):
+    month, at, dates = rule
+    weekday, last, day = dates[0]
+    if last:
+        day = days_in_month(year, month)
+        while datetime(year, month, day).isoweekday() != weekday:
+            day -= 1
+    elif weekday:
+        while datetime(year, month, day).isoweekday() != weekday:
+            day += 1
+    return datetime(year, month, day, tzinfo=UTC)
+
+
+def check_eras(name, zone, eras):
+    """Recomputes every transition from the eras and compares it with zoneinfo."""
+    for i, era in enumerate(eras):
+        last_year = eras[i + 1]["year"] - 1 if i + 1 < len(eras) else LAST_YEAR
+        for year in range(era["year"], last_year + 1):
+            expected = sorted(t for t, _, _ in transitions(zone, year))
+            # local standard dates near New Year can land in the neighbouring UTC year
+            actual = []
+            if era["delta"]:
+                for rule in (era["start"], era["end"]):
+                    instant = int((rule_date(year, rule) + timedelta(minutes=rule[1] - era["std"])).timestamp())
+                    actual.append(instant)
+            actual = sorted(t for t in actual if datetime(year, 1, 1, tzinfo=UTC).timestamp() <= t < datetime(year + 1, 1, 1, tzinfo=UTC).timestamp())
+            if expected != actual:
+                raise ValueError(f"{name} {year}: zoneinfo has {expected}, the eras give {actual}")
+
+
+def c_rule(rule):
+    if rule is None:
+        return "{ 0, 0, 0, 0, 0 }"
+    month, at, dates = rule
+    weekday, last, day = dates[0]
+    return "{ %d, %d, %d, %d, %d }" % (month, weekday, last, day, at)
+
+
+def describe_rule(rule):
+    names = ["", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"]
+    months = ["", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"]
+    month, at, dates = rule
+    weekday, last, day = dates[0]
+    if last:
+        when = "last %s" % names[weekday]
+    elif weekday:
+        when = "%s>=%d" % (names[weekday], day)
+    else:
+        when = "%d" % day
+    return "%s %s %d:%02ds" % (months[month], when, at // 60, at % 60)
+
+
+def tzdata_version():
+    for path in ("/usr/share/zoneinfo/tzdata.zi", "/usr/share/zoneinfo/+VERSION"):
+        try:
+            with open(path) as f:
+                line = f.readline().strip()
+                return line.replace("# version ", "")
+        except OSError:
+            pass
+    return "unknown"
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "..", "..", "movement", "lib", "tzdb")
+    zones = [(name, None, [{"year": FIRST_YEAR, "std": offset, "delta": 0, "start": None, "end": None}]) for name, offset in FIXED_ZONES]
+    for name, iana in RULE_ZONES:
+        zone = ZoneInfo(iana)
+        eras = fit_eras(zone)
+        check_eras(iana, zone, eras)
+        zones.append((name, iana, eras))
+    assert len(zones) <= MAX_ZONES
+    assert all(len(name) <= 4 for name, _, _ in zones)
+
+    version = tzdata_version()
+    header = "// Generated by utils/tzdb/generate_tzdb.py from tzdata %s. Do not edit.\n\n" % version
+
+    with open(os.path.join(out, "tzdb_data.h"), "w") as f:
+        f.write(header)
+        f.write("#ifndef TZDB_DATA_H_\n#define TZDB_DATA_H_\n\n")
+        f.write("#define TZDB_NUM_ZONES %d\n" % len(zones))
+        f.write("#define TZDB_FIRST_RULE_ZONE %d\n" % len(FIXED_ZONES))
+        f.write("#define TZDB_NUM_ERAS %d\n\n" % sum(len(e) for _, _, e in zones))
+        f.write("#endif // TZDB_DATA_H_\n")
+
+    with open(os.path.join(out, "tzdb_data.c"), "w") as f:
+        f.write(header)
+        f.write('#include <stddef.h>\n#include "tzdb.h"\n\n')
+        f.write("const tzdb_era_t tzdb_eras[TZDB_NUM_ERAS] = {\n")
+        first = []
+        for index, (name, iana, eras) in enumerate(zones):
+            first.append(sum(len(e) for _, _, e in zones[:index]))
+            for era in eras:
+                comment = "%2d %s %d" % (index, iana or name, era["year"])
+                if era["delta"]:
+                    comment += ": %s to %s" % (describe_rule(era["start"]), describe_rule(era["end"]))
+                f.write("    { %d, %d, %d, %s, %s }, // %s\n" % (era["year"] - FIRST_YEAR, era["delta"], era["std"], c_rule(era["start"]), c_rule(era["end"]), comment))
+        f.write("};\n\n")
+        f.write("const tzdb_zone_t tzdb_zones[TZDB_NUM_ZONES] = {\n")
+        for index, (name, iana, eras) in enumerate(zones):
+            f.write('    { "%s", %d, %d },\n' % (name, first[index], len(eras)))
+        f.write("};\n\n")
+        f.write("#ifdef TZDB_IANA_NAMES\n")
+        f.write("// the zoneinfo zone each entry was generated from, for the host tests\n")
+        f.write("const char *const tzdb_iana_names[TZDB_NUM_ZONES] = {\n")
+        for name, iana, _ in zones:
+            f.write('    %s,\n' % ('"%s"' % iana if iana else "NULL"))
+        f.write("};\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,355 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * swxfer: host side of the watch's get/put shell commands (see movement/lib/xfer/xfer.h).
+ *
+ *   swxfer [-v] DEVICE get REMOTE [LOCAL]    copy a file off the watch
+ *   swxfer [-v] DEVICE put LOCAL [REMOTE]    copy a file onto the watch
+ *   swxfer loopback [-d DIR] [-l PERCENT]    pretend to be a watch on a pty, serving DIR
+ *
+ * The loopback mode runs the same protocol code the watch runs, behind a fake shell on a
+ * pseudo-terminal, so transfers can be tested (and timed, with -v) on a Linux box without a
+ * device. -l drops that percentage of the frames it sends, to exercise retransmission.
+ *
+ * Build from this directory:
+ *   gcc -O2 -Wall -I../../movement/lib/xfer -o swxfer swxfer.c ../../movement/lib/xfer/xfer.c
+ * Try it out:
+ *   ./swxfer loopback -d /tmp/watchfs &     # prints the pty it's listening on, say /dev/pts/5
+ *   ./swxfer -v /dev/pts/5 put some_file
+ *   ./swxfer -v /dev/pts/5 get some_file copy_of_some_file
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "xfer.h"
+
+typedef struct {
+    int fd;
+    unsigned drop_percent;
+    int lossy;
+} port_t;
+
+static int32_t port_read(void *context, uint8_t *buf, uint16_t len, uint16_t timeout_ms) {
+    port_t *port = context;
+    struct pollfd pfd = { port->fd, POLLIN, 0 };
+    if (poll(&pfd, 1, timeout_ms) <= 0) return 0;
+    ssize_t n = read(port->fd, buf, len);
+    return n > 0 ? n : 0;
+}
+
+static void port_write(void *context, const uint8_t *buf, uint16_t len) {
+    port_t *port = context;
+    if (port->lossy && (unsigned)(rand() % 100) < port->drop_percent) return;
+    while (len > 0) {
+        ssize_t n = write(port->fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return;
+        }
+        buf += n;
+        len -= n;
+    }
+}
+
+static void port_puts(port_t *port, const char *s) {
+    int lossy = port->lossy;
+    port->lossy = 0;
+    port_write(port, (const uint8_t *)s, strlen(s));
+    port->lossy = lossy;
+}
+
+static int make_raw(int fd) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) < 0) return -1;
+    cfmakeraw(&tio);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const char *result_string(xfer_result_t result, const xfer_t *x) {
+    switch (result) {
+        case XFER_OK: return "ok";
+        case XFER_ERR_TIMEOUT: return "timed out";
+        case XFER_ERR_ABORTED: return x->peer_error;
+        case XFER_ERR_IO: return "local file error";
+        case XFER_ERR_CHECKSUM: return "checksum mismatch";
+    }
+    return "unknown error";
+}
+
+static int32_t file_source(void *context, uint32_t offset, uint8_t *buf, uint16_t len) {
+    FILE *f = context;
+    if (fseek(f, offset, SEEK_SET) != 0) return -1;
+    return fread(buf, 1, len, f);
+}
+
+static bool file_sink(void *context, const uint8_t *buf, uint16_t len) {
+    return fwrite(buf, 1, len, (FILE *)context) == len;
+}
+
+static void print_stats(const xfer_t *x, uint32_t bytes, double seconds) {
+    fprintf(stderr, "%u bytes in %.2f s (%.1f KiB/s); %u frames sent, %u received, %u retransmitted, %u bad\n",
+            bytes, seconds, seconds > 0 ? bytes / seconds / 1024 : 0,
+            x->stats.frames_sent, x->stats.frames_received, x->stats.retransmits, x->stats.bad_frames);
+}
+
+/* Client */
+
+#define SHELL_PROMPT "swsh> "
+
+static int wait_for_prompt(port_t *port) {
+    char seen[512];
+    for (int attempt = 0; attempt < 5; attempt++) {
+        size_t len = 0;
+        port_puts(port, "\r");
+        int32_t n;
+        while ((n = port_read(port, (uint8_t *)seen + len, sizeof(seen) - 1 - len, 2 * XFER_LINGER_MS)) > 0) {
+            len += n;
+            seen[len] = 0;
+            if (strstr(seen, SHELL_PROMPT)) {
+                // Throw away the rest of whatever the shell had to say
+                uint8_t junk[256];
+                while (port_read(port, junk, sizeof(junk), 50) > 0);
+                return 1;
+            }
+            if (len == sizeof(seen) - 1) len = 0;
+        }
+    }
+    return 0;
+}
+
+static xfer_t x;
+
+static int client(const char *device, const char *command, const char *from, const char *to, int verbose) {
+    port_t port = { 0 };
+    port.fd = open(device, O_RDWR | O_NOCTTY);
+    if (port.fd < 0 || make_raw(port.fd) < 0) {
+        perror(device);
+        return 1;
+    }
+    xfer_io_t io = { port_read, port_write, &port };
+    xfer_init(&x, &io);
+
+    // Get the shell to a clean prompt. Right after a transfer the watch may still be listening
+    // for stray frames for a moment and swallow what we type, so keep at it until a prompt shows up.
+    if (!wait_for_prompt(&port)) {
+        fprintf(stderr, "%s: no shell prompt\n", device);
+        return 1;
+    }
+
+    int get = !strcmp(command, "get");
+    const char *remote = get ? from : to;
+    FILE *f = fopen(get ? to : from, get ? "wb" : "rb");
+    if (f == NULL) {
+        perror(get ? to : from);
+        return 1;
+    }
+
+    char line[300];
+    snprintf(line, sizeof(line), "%s %s\r", command, remote);
+    port_puts(&port, line);
+
+    uint32_t hello = 0;
+    xfer_result_t result = xfer_wait_hello(&x, &hello, 2000);
+    double start = now_seconds();
+    uint32_t bytes = 0;
+    if (result == XFER_OK) {
+        if (get) {
+            result = xfer_receive(&x, file_sink, f, &bytes);
+        } else {
+            fseek(f, 0, SEEK_END);
+            bytes = ftell(f);
+            if (bytes > hello) {
+                xfer_abort(&x, "no space");
+                fprintf(stderr, "%s: %u bytes won't fit in %u bytes free\n", from, bytes, hello);
+                fclose(f);
+                return 1;
+            }
+            result = xfer_send(&x, file_source, f, bytes);
+        }
+    }
+    double elapsed = now_seconds() - start;
+    if (fclose(f) != 0 && result == XFER_OK) result = XFER_ERR_IO;
+
+    if (result != XFER_OK) {
+        fprintf(stderr, "%s %s: %s\n", command, remote, result_string(result, &x));
+        if (get) unlink(to);
+        return 1;
+    }
+    if (verbose) print_stats(&x, bytes, elapsed);
+    close(port.fd);
+    return 0;
+}
+
+/* Loopback watch */
+
+static void loopback_command(port_t *port, const char *dir, char *cmd) {
+    char *verb = strtok(cmd, " \t");
+    char *name = strtok(NULL, " \t");
+    char path[1024];
+
+    if (verb == NULL) return;
+    if (name == NULL || (strcmp(verb, "get") && strcmp(verb, "put"))) {
+        port_puts(port, "\r\nonly get and put are supported here\r\n");
+        return;
+    }
+    port_puts(port, "\r\n");
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+    xfer_io_t io = { port_read, port_write, port };
+    xfer_init(&x, &io);
+    xfer_result_t result;
+    uint32_t bytes = 0;
+    double start = now_seconds();
+
+    if (!strcmp(verb, "get")) {
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            xfer_abort(&x, "no such file");
+            return;
+        }
+        fseek(f, 0, SEEK_END);
+        bytes = ftell(f);
+        xfer_send_hello(&x, bytes);
+        port->lossy = 1;
+        result = xfer_send(&x, file_source, f, bytes);
+        fclose(f);
+    } else {
+        FILE *f = fopen(path, "wb");
+        if (f == NULL) {
+            xfer_abort(&x, "cannot create file");
+            return;
+        }
+        // Same limit as the watch's filesystem
+        xfer_send_hello(&x, 8192);
+        port->lossy = 1;
+        result = xfer_receive(&x, file_sink, f, &bytes);
+        fclose(f);
+        if (result != XFER_OK) unlink(path);
+    }
+    port->lossy = 0;
+
+    fprintf(stderr, "%s %s: %s; ", verb, name, result_string(result, &x));
+    print_stats(&x, bytes, now_seconds() - start);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "\r\n%s: %s\r\n", verb, result == XFER_OK ? "ok" : "failed");
+    port_puts(port, msg);
+}
+
+static int loopback(const char *dir, unsigned drop_percent) {
+    port_t port = { 0 };
+    port.drop_percent = drop_percent;
+    port.fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (port.fd < 0 || grantpt(port.fd) < 0 || unlockpt(port.fd) < 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    // Hold the other end open in raw mode, so the line discipline stays out of the way and the pty
+    // survives clients coming and going
+    int slave = open(ptsname(port.fd), O_RDWR | O_NOCTTY);
+    if (slave < 0 || make_raw(slave) < 0) {
+        perror(ptsname(port.fd));
+        return 1;
+    }
+    printf("%s\n", ptsname(port.fd));
+    fflush(stdout);
+
+    // A minimal stand-in for the watch shell: echo, and run a command at the end of each line
+    char cmd[300];
+    size_t len = 0;
+    port_puts(&port, "swsh> ");
+    while (1) {
+        uint8_t c;
+        if (port_read(&port, &c, 1, 1000) <= 0) continue;
+        if (c == '\r' || c == '\n') {
+            cmd[len] = 0;
+            loopback_command(&port, dir, cmd);
+            len = 0;
+            port_puts(&port, "\r\nswsh> ");
+        } else if (len < sizeof(cmd) - 1) {
+            cmd[len++] = c;
+            port_write(&port, &c, 1);
+        }
+    }
+    return 0;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: swxfer [-v] DEVICE get REMOTE [LOCAL]\n"
+            "       swxfer [-v] DEVICE put LOCAL [REMOTE]\n"
+            "       swxfer loopback [-d DIR] [-l DROP_PERCENT]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    int verbose = 0;
+    int i = 1;
+
+    if (i < argc && !strcmp(argv[i], "loopback")) {
+        const char *dir = ".";
+        unsigned drop = 0;
+        for (i++; i < argc; i++) {
+            if (!strcmp(argv[i], "-d") && i + 1 < argc) dir = argv[++i];
+            else if (!strcmp(argv[i], "-l") && i + 1 < argc) drop = atoi(argv[++i]);
+            else usage();
+        }
+        return loopback(dir, drop);
+    }
+
+    if (i < argc && !strcmp(argv[i], "-v")) {
+        verbose = 1;
+        i++;
+    }
+    if (argc - i < 3) usage();
+    const char *device = argv[i];
+    const char *command = argv[i + 1];
+    const char *from = argv[i + 2];
+    const char *to = argc - i > 3 ? argv[i + 3] : NULL;
+    if (to == NULL) {
+        // Default to the same name on the other side, without any local directories
+        const char *slash = strrchr(from, '/');
+        to = slash ? slash + 1 : from;
+    }
+    if (strcmp(command, "get") && strcmp(command, "put")) usage();
+
+    return client(device, command, from, to, verbose);
+}
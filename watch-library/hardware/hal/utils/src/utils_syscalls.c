@@ -33,6 +33,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -43,6 +44,7 @@ extern "C" {
 #undef errno
 extern int errno;
 extern int _end;
+extern int _eram;
 
 extern caddr_t _sbrk(int incr);
 extern int     link(char *old, char *_new);
@@ -67,6 +69,12 @@ extern caddr_t _sbrk(int incr)
 	}
 	prev_heap = heap;
 
+	/* Fail rather than grow the heap past the end of RAM; malloc then returns NULL. */
+	if (incr > (unsigned char *)&_eram - heap) {
+		errno = ENOMEM;
+		return (caddr_t)-1;
+	}
+
 	heap += incr;
 
 	return (caddr_t)prev_heap;
@@ -31,9 +31,13 @@
 #include "saml22.h"
 #include "hal_init.h"
 #include "watch.h"
+#include "watch_private_sleep.h"
 #include "tusb.h"
 
 int main(void) {
+    // paint the stack first, so its high water mark counts everything that comes after.
+    _watch_paint_stack();
+
     // ASF code. Initialize the MCU with configuration options from Atmel Studio.
     init_mcu();
 
@@ -79,10 +83,19 @@ int main(void) {
     while (1) {
         bool usb_enabled = hri_usbdevice_get_CTRLA_ENABLE_bit(USB);
         bool can_sleep = app_loop();
-        if (can_sleep && !usb_enabled) {
-            app_prepare_for_standby();
-            sleep(4);
-            app_wake_from_standby();
+        switch (watch_sleep_mode_for(can_sleep, usb_enabled, _watch_usb_is_suspended())) {
+            case WATCH_SLEEP_NONE:
+                break;
+            case WATCH_SLEEP_IDLE:
+                // USB keeps its clocks; its interrupts service TinyUSB and wake us if there's anything for the app.
+                sleep(2);
+                break;
+            case WATCH_SLEEP_STANDBY:
+                _watch_storage_wait_idle();
+                app_prepare_for_standby();
+                sleep(4);
+                app_wake_from_standby();
+                break;
         }
     }
 
@@ -43,7 +43,7 @@ static uint16_t _watch_get_analog_value(uint16_t channel) {
 
 void watch_enable_adc(void) {
     MCLK->APBCMASK.reg |= MCLK_APBCMASK_ADC;
-    GCLK->PCHCTRL[ADC_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN;
+    GCLK->PCHCTRL[ADC_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK2 | GCLK_PCHCTRL_CHEN;
 
     uint16_t calib_reg = 0;
     calib_reg = ADC_CALIB_BIASREFBUF((*(uint32_t *)ADC_FUSES_BIASREFBUF_ADDR >> ADC_FUSES_BIASREFBUF_Pos)) |
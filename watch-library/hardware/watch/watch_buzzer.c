@@ -24,6 +24,7 @@
 
 #include "watch_buzzer.h"
 #include "watch_private_buzzer.h"
+#include "watch_private.h"
 #include "../../../watch-library/hardware/include/saml22j18a.h"
 #include "../../../watch-library/hardware/include/component/tc.h"
 #include "../../../watch-library/hardware/hri/hri_tc_l22.h"
@@ -74,6 +75,10 @@ static void _tc3_initialize() {
 }
 
 void watch_buzzer_play_sequence(int8_t *note_sequence, void (*callback_on_end)(void)) {
+#ifdef WATCH_PROFILER
+    // the profiler borrows TC3; a sequence takes it back.
+    watch_profiler_stop();
+#endif
     if (_callback_running) _tc3_stop();
     watch_set_buzzer_off();
     _sequence = note_sequence;
@@ -138,12 +143,18 @@ void watch_buzzer_abort_sequence(void) {
     _tcc_write_RUNSTDBY(false);
 }
 
-void TC3_Handler(void) {
-    // interrupt handler vor TC3 (globally!)
+void _watch_buzzer_tc3_handler(void) {
     cb_watch_buzzer_seq();
     TC3->COUNT8.INTFLAG.reg |= TC_INTFLAG_OVF;
 }
 
+#ifndef WATCH_PROFILER
+void TC3_Handler(void) {
+    // interrupt handler vor TC3 (globally!). With the profiler built in, it has this vector instead.
+    _watch_buzzer_tc3_handler();
+}
+#endif
+
 inline void watch_enable_buzzer(void) {
     if (!hri_tcc_get_CTRLA_reg(TCC0, TCC_CTRLA_ENABLE)) {
         _watch_enable_tcc();
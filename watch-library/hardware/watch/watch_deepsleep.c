@@ -151,6 +151,9 @@ static void _watch_disable_all_peripherals_except_slcd(void) {
 }
 
 void watch_enter_sleep_mode(void) {
+    // let any queued flash writes finish before we stop the clocks
+    _watch_storage_wait_idle();
+
     // disable all other peripherals
     _watch_disable_all_peripherals_except_slcd();
 
@@ -191,6 +194,7 @@ void watch_enter_deep_sleep_mode(void) {
 }
 
 void watch_enter_backup_mode(void) {
+    _watch_storage_wait_idle();
     watch_rtc_disable_all_periodic_callbacks();
     _watch_disable_all_peripherals_except_slcd();
     slcd_sync_deinit(&SEGMENT_LCD_0);
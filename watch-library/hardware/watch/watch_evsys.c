@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_evsys.h"
+#include "watch_private_evsys.h"
+#include "watch.h"
+
+static const uint8_t _generator_ids[] = {
+    [WATCH_EVSYS_GEN_RTC_PER_0] = EVSYS_ID_GEN_RTC_PER_0,
+    [WATCH_EVSYS_GEN_RTC_PER_1] = EVSYS_ID_GEN_RTC_PER_1,
+    [WATCH_EVSYS_GEN_RTC_PER_2] = EVSYS_ID_GEN_RTC_PER_2,
+    [WATCH_EVSYS_GEN_RTC_PER_3] = EVSYS_ID_GEN_RTC_PER_3,
+    [WATCH_EVSYS_GEN_RTC_PER_4] = EVSYS_ID_GEN_RTC_PER_4,
+    [WATCH_EVSYS_GEN_RTC_PER_5] = EVSYS_ID_GEN_RTC_PER_5,
+    [WATCH_EVSYS_GEN_RTC_PER_6] = EVSYS_ID_GEN_RTC_PER_6,
+    [WATCH_EVSYS_GEN_RTC_PER_7] = EVSYS_ID_GEN_RTC_PER_7,
+    [WATCH_EVSYS_GEN_TC2_OVF] = EVSYS_ID_GEN_TC2_OVF,
+    [WATCH_EVSYS_GEN_TC2_MC_0] = EVSYS_ID_GEN_TC2_MCX_0,
+    [WATCH_EVSYS_GEN_TC3_OVF] = EVSYS_ID_GEN_TC3_OVF,
+    [WATCH_EVSYS_GEN_TC3_MC_0] = EVSYS_ID_GEN_TC3_MCX_0,
+    [WATCH_EVSYS_GEN_ADC_RESRDY] = EVSYS_ID_GEN_ADC_RESRDY,
+};
+
+static const uint8_t _user_ids[] = {
+    [WATCH_EVSYS_USER_TC2_EVU] = EVSYS_ID_USER_TC2_EVU,
+    [WATCH_EVSYS_USER_TC3_EVU] = EVSYS_ID_USER_TC3_EVU,
+    [WATCH_EVSYS_USER_ADC_START] = EVSYS_ID_USER_ADC_START,
+    [WATCH_EVSYS_USER_DMAC_CH_0] = EVSYS_ID_USER_DMAC_CH_0,
+    [WATCH_EVSYS_USER_DMAC_CH_1] = EVSYS_ID_USER_DMAC_CH_1,
+    [WATCH_EVSYS_USER_DMAC_CH_2] = EVSYS_ID_USER_DMAC_CH_2,
+    [WATCH_EVSYS_USER_DMAC_CH_3] = EVSYS_ID_USER_DMAC_CH_3,
+};
+
+static watch_evsys_routes_t _routes;
+static bool _routes_initialized;
+
+static void _watch_evsys_enable_rtc_event_output(watch_evsys_generator_t generator) {
+    uint16_t pereo = RTC_MODE2_EVCTRL_PEREO0 << (generator - WATCH_EVSYS_GEN_RTC_PER_0);
+    if (RTC->MODE2.EVCTRL.reg & pereo) return;
+
+    // EVCTRL can only be written with the RTC off. _watch_rtc_init turns on every periodic event output when
+    // it sets up the RTC, so this only happens after a reset that left the RTC running without them; turn
+    // them all on at once, so that it happens just the once, and costs the clock a few milliseconds.
+    watch_rtc_enable(false);
+    RTC->MODE2.EVCTRL.reg |= RTC_MODE2_EVCTRL_PEREO_Msk;
+    watch_rtc_enable(true);
+}
+
+int8_t watch_evsys_connect(watch_evsys_generator_t generator, watch_evsys_user_t user) {
+    if (!_routes_initialized) {
+        watch_evsys_routes_init(&_routes);
+        _routes_initialized = true;
+    }
+
+    bool new_channel;
+    int8_t channel = watch_evsys_routes_connect(&_routes, generator, user, &new_channel);
+    if (channel < 0) return channel;
+
+    if (new_channel) {
+        hri_mclk_set_APBCMASK_EVSYS_bit(MCLK);
+        if (generator <= WATCH_EVSYS_GEN_RTC_PER_7) _watch_evsys_enable_rtc_event_output(generator);
+        // resynchronize to the 32.768 kHz clock, which runs in standby; ONDEMAND keeps it off between events.
+        hri_gclk_write_PCHCTRL_reg(GCLK, EVSYS_GCLK_ID_0 + channel, GCLK_PCHCTRL_GEN_GCLK3_Val | GCLK_PCHCTRL_CHEN);
+        EVSYS->CHANNEL[channel].reg = EVSYS_CHANNEL_EVGEN(_generator_ids[generator]) |
+                                      EVSYS_CHANNEL_PATH_RESYNCHRONIZED |
+                                      EVSYS_CHANNEL_EDGSEL_RISING_EDGE |
+                                      EVSYS_CHANNEL_RUNSTDBY |
+                                      EVSYS_CHANNEL_ONDEMAND;
+    }
+    // the user register holds the channel number plus one; zero means no channel.
+    EVSYS->USER[_user_ids[user]].reg = EVSYS_USER_CHANNEL(channel + 1);
+
+    return channel;
+}
+
+void watch_evsys_disconnect(watch_evsys_user_t user) {
+    if (!_routes_initialized || user >= WATCH_EVSYS_NUM_USERS) return;
+    if (_routes.user_channel[user] == -1) return;
+
+    EVSYS->USER[_user_ids[user]].reg = 0;
+    int8_t channel = watch_evsys_routes_disconnect(&_routes, user);
+    if (channel < 0) return;
+
+    EVSYS->CHANNEL[channel].reg = 0;
+    hri_gclk_write_PCHCTRL_reg(GCLK, EVSYS_GCLK_ID_0 + channel, 0);
+    for (uint8_t i = 0; i < WATCH_EVSYS_NUM_CHANNELS; i++) {
+        if (_routes.channel_generator[i] != WATCH_EVSYS_GEN_NONE) return;
+    }
+    hri_mclk_clear_APBCMASK_EVSYS_bit(MCLK);
+}
+
+watch_evsys_generator_t watch_evsys_get_generator(watch_evsys_user_t user) {
+    if (!_routes_initialized || user >= WATCH_EVSYS_NUM_USERS) return WATCH_EVSYS_GEN_NONE;
+    int8_t channel = _routes.user_channel[user];
+
+    return channel == -1 ? WATCH_EVSYS_GEN_NONE : _routes.channel_generator[channel];
+}
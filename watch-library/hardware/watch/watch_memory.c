@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <malloc.h>
+#include <sys/types.h>
+#include "watch.h"
+
+extern uint32_t _sstack;
+extern uint32_t _estack;
+extern uint32_t _end;
+extern uint32_t _eram;
+
+caddr_t _sbrk(int incr);
+
+// The linker sends every call to malloc, calloc, realloc and free here (see --wrap in make.mk), and these
+// pass them on to newlib's, counting as they go.
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+void __wrap_free(void *ptr);
+
+static watch_heap_counters_t _heap_counters;
+
+void _watch_paint_stack(void) {
+    // leave a little room below the stack pointer for this function's own frame.
+    watch_memory_paint_stack(&_sstack, (uint32_t *)(__get_MSP() - 32));
+}
+
+void watch_get_memory_stats(watch_memory_stats_t *stats) {
+    uint32_t heap_end = (uint32_t)_sbrk(0);
+
+    stats->stack_size = (uint32_t)&_estack - (uint32_t)&_sstack;
+    stats->stack_high_water = watch_memory_stack_high_water(&_sstack, &_estack);
+    stats->heap_size = heap_end - (uint32_t)&_end;
+    stats->heap_free = (uint32_t)&_eram - heap_end;
+    stats->heap = _heap_counters;
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+
+    if (ptr == NULL) watch_heap_counters_failed(&_heap_counters);
+    else watch_heap_counters_allocated(&_heap_counters, malloc_usable_size(ptr));
+
+    return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    void *ptr = __real_calloc(count, size);
+
+    if (ptr == NULL) watch_heap_counters_failed(&_heap_counters);
+    else watch_heap_counters_allocated(&_heap_counters, malloc_usable_size(ptr));
+
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    size_t old_size = ptr ? malloc_usable_size(ptr) : 0;
+    void *new_ptr = __real_realloc(ptr, size);
+
+    if (new_ptr == NULL) {
+        // with a size of zero, newlib frees the block; otherwise the old one is still there.
+        if (size == 0 && ptr != NULL) watch_heap_counters_freed(&_heap_counters, old_size);
+        else if (size != 0) watch_heap_counters_failed(&_heap_counters);
+        return NULL;
+    }
+
+    // a block moved or resized is counted as the old one given back and a new one handed out.
+    if (ptr != NULL) watch_heap_counters_freed(&_heap_counters, old_size);
+    watch_heap_counters_allocated(&_heap_counters, malloc_usable_size(new_ptr));
+
+    return new_ptr;
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr != NULL) watch_heap_counters_freed(&_heap_counters, malloc_usable_size(ptr));
+    __real_free(ptr);
+}
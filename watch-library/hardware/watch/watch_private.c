@@ -25,6 +25,7 @@
 #include "watch_private.h"
 #include "watch_private_cdc.h"
 #include "watch_utility.h"
+#include "hpl_init.h"
 #include "tusb.h"
 
 void _watch_init(void) {
@@ -127,10 +128,53 @@ void watch_disable_TRNG() {
     hri_trng_write_CTRLA_reg(TRNG, 0);
 }
 
+static uint32_t *_trng_words;
+static volatile uint8_t _trng_remaining = 0;
+static ext_irq_cb_t _trng_callback;
+
+bool watch_trng_fill(uint32_t *words, uint8_t count, ext_irq_cb_t callback) {
+    if (_trng_remaining || count == 0) return false;
+
+    _trng_words = words;
+    _trng_callback = callback;
+    _trng_remaining = count;
+
+    // TRNG_Handler takes a word each time one is ready, and turns the TRNG off after the last.
+    hri_mclk_set_APBCMASK_TRNG_bit(MCLK);
+    hri_trng_set_INTEN_DATARDY_bit(TRNG);
+    NVIC_ClearPendingIRQ(TRNG_IRQn);
+    NVIC_EnableIRQ(TRNG_IRQn);
+    hri_trng_set_CTRLA_ENABLE_bit(TRNG);
+
+    return true;
+}
+
+bool watch_trng_is_busy(void) {
+    return _trng_remaining != 0;
+}
+
+void watch_trng_read(uint32_t *words, uint8_t count) {
+    // getentropy turns the TRNG off when it's done, which would strand a fill in progress.
+    while (_trng_remaining);
+    getentropy(words, count * sizeof(uint32_t));
+}
+
+void TRNG_Handler(void) {
+    // reading DATA clears the interrupt flag
+    *_trng_words++ = hri_trng_read_DATA_reg(TRNG);
+    if (--_trng_remaining) return;
+
+    NVIC_DisableIRQ(TRNG_IRQn);
+    hri_trng_clear_INTEN_DATARDY_bit(TRNG);
+    watch_disable_TRNG();
+    hri_mclk_clear_APBCMASK_TRNG_bit(MCLK);
+    if (_trng_callback) _trng_callback();
+}
+
 
 void _watch_enable_tcc(void) {
-    // clock TCC0 with the main clock (8 MHz) and enable the peripheral clock.
-    hri_gclk_write_PCHCTRL_reg(GCLK, TCC0_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK0_Val | GCLK_PCHCTRL_CHEN);
+    // clock TCC0 with the 4 MHz peripheral clock and enable the peripheral clock.
+    hri_gclk_write_PCHCTRL_reg(GCLK, TCC0_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK2_Val | GCLK_PCHCTRL_CHEN);
     hri_mclk_set_APBCMASK_TCC0_bit(MCLK);
     // disable and reset TCC0.
     hri_tcc_clear_CTRLA_ENABLE_bit(TCC0);
@@ -138,13 +182,7 @@ void _watch_enable_tcc(void) {
     hri_tcc_write_CTRLA_reg(TCC0, TCC_CTRLA_SWRST);
     hri_tcc_wait_for_sync(TCC0, TCC_SYNCBUSY_SWRST);
     // divide the clock down to 1 MHz
-    if (hri_usbdevice_get_CTRLA_ENABLE_bit(USB)) {
-        // if USB is enabled, we are running an 8 MHz clock.
-        hri_tcc_write_CTRLA_reg(TCC0, TCC_CTRLA_PRESCALER_DIV8);
-    } else {
-        // otherwise it's 4 Mhz.
-        hri_tcc_write_CTRLA_reg(TCC0, TCC_CTRLA_PRESCALER_DIV4);
-    }
+    hri_tcc_write_CTRLA_reg(TCC0, TCC_CTRLA_PRESCALER_DIV4);
     // We're going to use normal PWM mode, which means period is controlled by PER, and duty cycle is controlled by
     // each compare channel's value:
     //  * Buzzer tones are set by setting PER to the desired period for a given frequency, and CC[1] to half of that
@@ -188,93 +226,100 @@ void _watch_disable_tcc(void) {
     hri_mclk_clear_APBCMASK_TCC0_bit(MCLK);
 }    
 
-void _watch_enable_tc0(void) {
-    // before we init TinyUSB, we are going to need a periodic callback to handle TinyUSB tasks.
-    // TC2 and TC3 are reserved for devices on the 9-pin connector, so let's use TC0.
-    // clock TC0 with the 8 MHz clock on GCLK0.
-    hri_gclk_write_PCHCTRL_reg(GCLK, TC0_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK0_Val | GCLK_PCHCTRL_CHEN);
-    // and enable the peripheral clock.
-    hri_mclk_set_APBCMASK_TC0_bit(MCLK);
-    // disable and reset TC0.
-    hri_tc_clear_CTRLA_ENABLE_bit(TC0);
-    hri_tc_wait_for_sync(TC0, TC_SYNCBUSY_ENABLE);
-    hri_tc_write_CTRLA_reg(TC0, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC0, TC_SYNCBUSY_SWRST);
-    hri_tc_write_CTRLA_reg(TC0, TC_CTRLA_PRESCALER_DIV1024 | // divide the 8 MHz clock by 1024 to count at 7812.5 Hz
-                                TC_CTRLA_MODE_COUNT8 |       // count in 8-bit mode
-                                TC_CTRLA_RUNSTDBY);          // run in standby, just in case we figure that out
-    hri_tccount8_write_PER_reg(TC0, 10);                     // 7812.5 Hz / 10 = 781.125 Hz
-    // set an interrupt on overflow; this will call TC0_Handler below.
-    hri_tc_set_INTEN_OVF_bit(TC0);
-
-    // set priority higher than TC1
-    NVIC_SetPriority(TC0_IRQn, 5);
-    NVIC_ClearPendingIRQ(TC0_IRQn);
-    NVIC_EnableIRQ(TC0_IRQn);
-
-    // Start the timer
-    hri_tc_set_CTRLA_ENABLE_bit(TC0);
-}
+static volatile bool _usb_suspended = false;
 
-void _watch_disable_tc0(void) {
-    NVIC_DisableIRQ(TC0_IRQn);
+void _watch_enable_usb_tasks(void) {
+    // TinyUSB's task runs in the TC0 interrupt, and the CDC task in TC1's, but the timers themselves stay off:
+    // USB_Handler pends TC0 when the USB peripheral has something for TinyUSB, TC0 pends TC1 to move serial
+    // data, and the serial buffers pend TC1 when they change. With no USB traffic, nothing runs at all.
+    NVIC_SetPriority(TC0_IRQn, 5); // higher than TC1
     NVIC_ClearPendingIRQ(TC0_IRQn);
-    hri_tc_clear_CTRLA_ENABLE_bit(TC0);
-    hri_tc_wait_for_sync(TC0, TC_SYNCBUSY_ENABLE);
-    hri_tc_write_CTRLA_reg(TC0, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC0, TC_SYNCBUSY_SWRST);
-}
+    NVIC_EnableIRQ(TC0_IRQn);
 
-void _watch_enable_tc1(void) {
-    hri_gclk_write_PCHCTRL_reg(GCLK, TC1_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK0_Val | GCLK_PCHCTRL_CHEN);
-    // and enable the peripheral clock.
-    hri_mclk_set_APBCMASK_TC1_bit(MCLK);
-    // disable and reset TC1.
-    hri_tc_clear_CTRLA_ENABLE_bit(TC1);
-    hri_tc_wait_for_sync(TC1, TC_SYNCBUSY_ENABLE);
-    hri_tc_write_CTRLA_reg(TC1, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC1, TC_SYNCBUSY_SWRST);
-    hri_tc_write_CTRLA_reg(TC1, TC_CTRLA_PRESCALER_DIV1024 | // divide the 8 MHz clock by 1024 to count at 7812.5 Hz
-                                TC_CTRLA_MODE_COUNT8 |       // count in 8-bit mode
-                                TC_CTRLA_RUNSTDBY);          // run in standby, just in case we figure that out
-    hri_tccount8_write_PER_reg(TC1, 20);                     // 7812.5 Hz / 50 = 156.25 Hz
-    // set an interrupt on overflow; this will call TC1_Handler below.
-    hri_tc_set_INTEN_OVF_bit(TC1);
-
-    // set priority lower than TC0
     NVIC_SetPriority(TC1_IRQn, 6);
     NVIC_ClearPendingIRQ(TC1_IRQn);
     NVIC_EnableIRQ(TC1_IRQn);
-
-    // Start the timer
-    hri_tc_set_CTRLA_ENABLE_bit(TC1);
 }
 
-void _watch_disable_tc1(void) {
+void _watch_disable_usb_tasks(void) {
+    NVIC_DisableIRQ(TC0_IRQn);
+    NVIC_ClearPendingIRQ(TC0_IRQn);
     NVIC_DisableIRQ(TC1_IRQn);
     NVIC_ClearPendingIRQ(TC1_IRQn);
-    hri_tc_clear_CTRLA_ENABLE_bit(TC1);
-    hri_tc_wait_for_sync(TC1, TC_SYNCBUSY_ENABLE);
-    hri_tc_write_CTRLA_reg(TC1, TC_CTRLA_SWRST);
-    hri_tc_wait_for_sync(TC1, TC_SYNCBUSY_SWRST);
 }
 
 void TC0_Handler(void) {
     tud_task();
-    TC0->COUNT8.INTFLAG.reg |= TC_INTFLAG_OVF;
+    // whatever TinyUSB just did may have freed up or filled the CDC FIFOs
+    NVIC_SetPendingIRQ(TC1_IRQn);
 }
 
 void TC1_Handler(void) {
     cdc_task();
-    TC1->COUNT8.INTFLAG.reg |= TC_INTFLAG_OVF;
+}
+
+static watch_performance_level_t _performance_level = WATCH_PERFORMANCE_NORMAL;
+
+static void _watch_apply_performance_config(watch_performance_config_t config) {
+    // FSEL 0 through 3 select 4, 8, 12 and 16 MHz.
+    uint8_t fsel = config.cpu_mhz / 4 - 1;
+    uint8_t old_fsel = hri_oscctrl_read_OSC16MCTRL_FSEL_bf(OSCCTRL);
+
+    // going up, the voltage and the flash wait states have to be ready before the clock is...
+    if (config.power_level > hri_pm_read_PLCFG_PLSEL_bf(PM)) _set_performance_level(config.power_level);
+    if (config.flash_wait_states > hri_nvmctrl_read_CTRLB_RWS_bf(NVMCTRL)) hri_nvmctrl_write_CTRLB_RWS_bf(NVMCTRL, config.flash_wait_states);
+
+    // ...and GCLK2 divides before OSC16M speeds up, so the peripherals never see more than 4 MHz.
+    if (fsel > old_fsel) {
+        GCLK->GENCTRL[2].reg = GCLK_GENCTRL_SRC(GCLK_GENCTRL_SRC_OSC16M) | GCLK_GENCTRL_DIV(config.peripheral_div) | GCLK_GENCTRL_GENEN;
+        while (GCLK->SYNCBUSY.bit.GENCTRL2);
+        hri_oscctrl_write_OSC16MCTRL_FSEL_bf(OSCCTRL, fsel);
+    } else if (fsel < old_fsel) {
+        hri_oscctrl_write_OSC16MCTRL_FSEL_bf(OSCCTRL, fsel);
+        GCLK->GENCTRL[2].reg = GCLK_GENCTRL_SRC(GCLK_GENCTRL_SRC_OSC16M) | GCLK_GENCTRL_DIV(config.peripheral_div) | GCLK_GENCTRL_GENEN;
+        while (GCLK->SYNCBUSY.bit.GENCTRL2);
+    }
+
+    // going down, it's the other way around.
+    if (config.flash_wait_states < hri_nvmctrl_read_CTRLB_RWS_bf(NVMCTRL)) hri_nvmctrl_write_CTRLB_RWS_bf(NVMCTRL, config.flash_wait_states);
+    if (config.power_level < hri_pm_read_PLCFG_PLSEL_bf(PM)) _set_performance_level(config.power_level);
+}
+
+void watch_set_performance_level(watch_performance_level_t level) {
+    _performance_level = level;
+    _watch_apply_performance_config(watch_performance_config_for(level, watch_is_usb_enabled()));
+}
+
+watch_performance_level_t watch_get_performance_level(void) {
+    return _performance_level;
+}
+
+// TC0 and TC1 count together as one 32-bit counter, from GCLK2 divided by four. GCLK2 is 4 MHz at every
+// performance level, and neither it nor the counter runs in standby.
+void watch_enable_active_time(void) {
+    if (hri_tc_get_CTRLA_ENABLE_bit(TC0)) return;
+    hri_mclk_set_APBCMASK_TC0_bit(MCLK);
+    hri_mclk_set_APBCMASK_TC1_bit(MCLK);
+    hri_gclk_write_PCHCTRL_reg(GCLK, TC0_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK2 | GCLK_PCHCTRL_CHEN);
+    hri_tc_write_CTRLA_reg(TC0, TC_CTRLA_SWRST);
+    hri_tc_wait_for_sync(TC0, TC_SYNCBUSY_SWRST);
+    hri_tc_write_CTRLA_reg(TC0, TC_CTRLA_MODE_COUNT32 | TC_CTRLA_PRESCALER_DIV4);
+    hri_tc_set_CTRLA_ENABLE_bit(TC0);
+}
+
+uint32_t watch_get_active_time(void) {
+    if (!hri_tc_get_CTRLA_ENABLE_bit(TC0)) return 0;
+    TC0->COUNT32.CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+    while (TC0->COUNT32.SYNCBUSY.reg & (TC_SYNCBUSY_CTRLB | TC_SYNCBUSY_COUNT));
+    return TC0->COUNT32.COUNT.reg;
 }
 
 void _watch_enable_usb(void) {
     // disable USB, just in case.
     hri_usb_clear_CTRLA_ENABLE_bit(USB);
 
-    // bump clock up to 8 MHz
-    hri_oscctrl_write_OSC16MCTRL_FSEL_bf(OSCCTRL, OSCCTRL_OSC16MCTRL_FSEL_8_Val);
+    // USB needs PL2, and a faster clock than the watch usually runs at.
+    _watch_apply_performance_config(watch_performance_config_for(_performance_level, true));
 
     // reset flags and disable DFLL
     OSCCTRL->INTFLAG.reg = OSCCTRL_INTFLAG_DFLLRDY;
@@ -313,15 +358,38 @@ void _watch_enable_usb(void) {
     gpio_set_pin_function(PIN_PA24, PINMUX_PA24G_USB_DM);
     gpio_set_pin_function(PIN_PA25, PINMUX_PA25G_USB_DP);
 
-    _watch_enable_tc0();
-
     tusb_init();
 
-    _watch_enable_tc1();
+    // keep watching the bus in standby, so that the host resuming a suspended bus wakes us up
+    hri_usb_set_CTRLA_RUNSTDBY_bit(USB);
+
+    _watch_enable_usb_tasks();
+    NVIC_SetPendingIRQ(TC0_IRQn);
+}
+
+bool _watch_usb_is_suspended(void) {
+    return _usb_suspended;
 }
 
 void USB_Handler(void) {
     tud_int_handler(0);
+    NVIC_SetPendingIRQ(TC0_IRQn);
+}
+
+// Invoked when the host suspends the bus; main() can go to standby until it resumes.
+void tud_suspend_cb(bool remote_wakeup_en) {
+    (void) remote_wakeup_en;
+    _usb_suspended = true;
+}
+
+// Invoked when the host resumes the bus.
+void tud_resume_cb(void) {
+    _usb_suspended = false;
+}
+
+// Invoked when the device is configured, which also means the bus is awake.
+void tud_mount_cb(void) {
+    _usb_suspended = false;
 }
 
 // USB Descriptors and tinyUSB callbacks follow.
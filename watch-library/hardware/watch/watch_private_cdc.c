@@ -28,37 +28,43 @@
 #include <stddef.h>
 
 #include "watch_utility.h"
+#include "watch_private_ring.h"
+#include "hal_delay.h"
 #include "tusb.h"
 
 /*
- * Implement a circular buffer for the USB CDC Serial read buffer.
- * The size of the buffer must be a power of two for this circular buffer
- * implementation to work.
+ * USB CDC Serial buffers. Both are single-producer, single-consumer rings:
+ * the write buffer is filled by _write() in the main loop and drained by cdc_task()
+ * in the TC1 interrupt; the read buffer is the other way around. Neither side
+ * needs to mask the other, and data moves in contiguous spans rather than byte by byte.
+ * TC1 only runs when pended: by the USB task after USB traffic, and by _write() and
+ * _read() below when they give cdc_task() something to do.
  */
 
-// Size of the circular buffer. Must be a power of two.
+// Sizes of the rings. Must be powers of two.
 #define CDC_WRITE_BUF_SZ  (1024)
-// Macro function to perform modular arithmetic on an index.
-// eg. (63 + 2) & (64 - 1) -> 1
-#define CDC_WRITE_BUF_IDX(x)  ((x) & (CDC_WRITE_BUF_SZ - 1))
-static char s_write_buf[CDC_WRITE_BUF_SZ] = {0};
-static size_t s_write_buf_pos = 0;
-static size_t s_write_buf_len = 0;
-
 #define CDC_READ_BUF_SZ  (256)
-#define CDC_READ_BUF_IDX(x)  ((x) & (CDC_READ_BUF_SZ - 1))
-static char s_read_buf[CDC_READ_BUF_SZ] = {0};
-static size_t s_read_buf_pos = 0;
-static size_t s_read_buf_len = 0;
-
-// Mask TC1 interrupts, preventing calls to cdc_task()
-static inline void prv_critical_section_enter(void) {
-    NVIC_DisableIRQ(TC1_IRQn);
+
+static uint8_t s_write_buf[CDC_WRITE_BUF_SZ];
+static uint8_t s_read_buf[CDC_READ_BUF_SZ];
+static watch_ring_t s_write_ring = { s_write_buf, CDC_WRITE_BUF_SZ, 0, 0, 0 };
+static watch_ring_t s_read_ring = { s_read_buf, CDC_READ_BUF_SZ, 0, 0, 0 };
+
+// How long _write() waits for the host to make room before it gives up on a chunk.
+#define CDC_WRITE_TIMEOUT_US  (100000)
+#define CDC_WRITE_POLL_US  (100)
+
+static uint32_t s_write_dropped = 0;
+static uint32_t s_write_stalls = 0;
+
+// _write() may only wait for cdc_task() if cdc_task() can actually run: not from an interrupt
+// (TC1 could be masked by priority), and not when nobody is on the other end of the cable.
+static bool prv_can_block(void) {
+    return __get_IPSR() == 0 && (NVIC->ISER[0] & (1UL << TC1_IRQn)) && tud_cdc_connected();
 }
 
-// Unmask TC1 interrupts, allowing calls to cdc_task()
-static inline void prv_critical_section_exit(void) {
-    NVIC_EnableIRQ(TC1_IRQn);
+static inline void prv_wake_cdc_task(void) {
+    NVIC_SetPendingIRQ(TC1_IRQn);
 }
 
 int _write(int file, char *ptr, int len) {
@@ -68,88 +74,103 @@ int _write(int file, char *ptr, int len) {
         return -1;
     }
 
-    int bytes_written = 0;
-
-    prv_critical_section_enter();
+    uint16_t written = watch_ring_write(&s_write_ring, ptr, len > UINT16_MAX ? UINT16_MAX : len);
+    if (written > 0) {
+        // Partial writes are fine: newlib comes back with the rest.
+        prv_wake_cdc_task();
+        return written;
+    }
 
-    for (int i = 0; i < len; i++) {
-        s_write_buf[s_write_buf_pos] = ptr[i];
-        s_write_buf_pos = CDC_WRITE_BUF_IDX(s_write_buf_pos + 1);
-        if (s_write_buf_len < CDC_WRITE_BUF_SZ) {
-            s_write_buf_len++;
+    // Buffer is full. Wait for cdc_task() to drain some of it, as long as the host keeps reading.
+    if (prv_can_block()) {
+        s_write_stalls++;
+        uint16_t tail = s_write_ring.tail;
+        uint32_t waited = 0;
+        while (waited < CDC_WRITE_TIMEOUT_US && prv_can_block()) {
+            delay_us(CDC_WRITE_POLL_US);
+            if (s_write_ring.tail != tail) {
+                written = watch_ring_write(&s_write_ring, ptr, len > UINT16_MAX ? UINT16_MAX : len);
+                prv_wake_cdc_task();
+                return written;
+            }
+            waited += CDC_WRITE_POLL_US;
         }
-        bytes_written++;
     }
 
-    prv_critical_section_exit();
-
-    return bytes_written;
+    // Nobody is listening: count the loss rather than corrupting what's already queued.
+    s_write_dropped += len;
+    return len;
 }
 
 int _read(int file, char *ptr, int len) {
     (void) file;
 
-    prv_critical_section_enter();
-
-    if (ptr == NULL || len <= 0 || s_read_buf_len == 0) {
-        prv_critical_section_exit();
+    if (ptr == NULL || len <= 0) {
         return -1;
     }
 
-    // Clamp to the length of the read buffer
-    if ((size_t) len > s_read_buf_len) {
-        len = s_read_buf_len;
-    }
-
-    // Calculate the start of the circular buffer, and iterate from there
-    const size_t start_pos = CDC_READ_BUF_IDX(s_read_buf_pos - len);
-    for (size_t i = 0; i < (size_t) len; i++) {
-        const size_t idx = CDC_READ_BUF_IDX(start_pos + i);
-        ptr[i] = s_read_buf[idx];
-        s_read_buf[idx] = 0;
+    uint16_t bytes_read = watch_ring_read(&s_read_ring, ptr, len > UINT16_MAX ? UINT16_MAX : len);
+    if (bytes_read == 0) {
+        return -1;
     }
 
-    // Update circular buffer position and length
-    s_read_buf_len -= len;
-    s_read_buf_pos = CDC_READ_BUF_IDX(s_read_buf_pos - len);
+    // There's room in the ring again for anything left waiting in TinyUSB's FIFO.
+    prv_wake_cdc_task();
 
-    prv_critical_section_exit();
+    return bytes_read;
+}
 
-    return len;
+void watch_cdc_get_stats(watch_cdc_stats_t *stats) {
+    stats->tx_size = CDC_WRITE_BUF_SZ;
+    stats->tx_used = watch_ring_used(&s_write_ring);
+    stats->tx_high_water = s_write_ring.high_water;
+    stats->tx_stalls = s_write_stalls;
+    stats->tx_dropped = s_write_dropped;
+    stats->rx_size = CDC_READ_BUF_SZ;
+    stats->rx_used = watch_ring_used(&s_read_ring);
+    stats->rx_high_water = s_read_ring.high_water;
 }
 
 static void prv_handle_reads(void) {
-    while (tud_cdc_available()) {
-        int c = tud_cdc_read_char();
-        if (c < 0) {
-            continue;
-        }
-        s_read_buf[s_read_buf_pos] = c;
-        s_read_buf_pos = CDC_READ_BUF_IDX(s_read_buf_pos + 1);
-        if (s_read_buf_len < CDC_READ_BUF_SZ) {
-            s_read_buf_len++;
+    uint8_t *ptr;
+    uint16_t span;
+
+    // If the read buffer is full, whatever is left stays in TinyUSB's FIFO and the host is
+    // held off at the USB level until the shell catches up.
+    while (tud_cdc_available() && (span = watch_ring_reserve(&s_read_ring, &ptr)) > 0) {
+        uint32_t count = tud_cdc_read(ptr, span);
+        if (count == 0) {
+            break;
         }
+        watch_ring_commit(&s_read_ring, count);
+    }
+}
+
+static uint16_t prv_usb_sink(const uint8_t *data, uint16_t len, void *context) {
+    (void) context;
+
+    if (tud_cdc_available() > 0) {
+        // If we receive data while doing a large write, we need to
+        // fully service it before continuing to write, or the
+        // stack will crash.
+        prv_handle_reads();
     }
+
+    uint32_t available = tud_cdc_write_available();
+    if (available < len) {
+        len = available;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    return tud_cdc_write(data, len);
 }
 
 static void prv_handle_writes(void) {
-    if (s_write_buf_len > 0) {
-        const size_t start_pos =
-            CDC_WRITE_BUF_IDX(s_write_buf_pos - s_write_buf_len);
-        for (size_t i = 0; i < (size_t) s_write_buf_len; i++) {
-            const size_t idx = CDC_WRITE_BUF_IDX(start_pos + i);
-            if (tud_cdc_available() > 0) {
-                // If we receive data while doing a large write, we need to
-                // fully service it before continuing to write, or the
-                // stack will crash.
-                prv_handle_reads();
-            }
-            if (tud_cdc_write_available()) {
-                tud_cdc_write(&s_write_buf[idx], 1);
-            }
-            s_write_buf[idx] = 0;
-            s_write_buf_len--;
-        }
+    if (watch_ring_used(&s_write_ring) > 0) {
+        // Whatever the endpoint can't take right now stays queued for the next tick.
+        watch_ring_drain(&s_write_ring, prv_usb_sink, NULL);
         tud_cdc_write_flush();
     }
 }
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch.h"
+
+#ifdef WATCH_PROFILER
+
+extern uint32_t _sfixed;
+extern uint32_t _efixed;
+
+void _watch_profiler_interrupt(const uint32_t *frame);
+
+static watch_profiler_histogram_t _histogram;
+static volatile bool _running;
+
+bool watch_profiler_start(uint16_t frequency) {
+    if (frequency == 0 || frequency > 16384) return false;
+    if (hri_tc_get_CTRLA_ENABLE_bit(TC3) && !_running) return false;
+    watch_profiler_stop();
+
+    watch_profiler_histogram_init(&_histogram, (uint32_t)&_sfixed, (uint32_t)&_efixed);
+
+    // 32.768 kHz, counting up to CC0 and starting over. No RUNSTDBY: the timer stops when the CPU does.
+    hri_mclk_set_APBCMASK_TC3_bit(MCLK);
+    hri_gclk_write_PCHCTRL_reg(GCLK, TC3_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK3 | GCLK_PCHCTRL_CHEN);
+    hri_tc_write_CTRLA_reg(TC3, TC_CTRLA_SWRST);
+    hri_tc_wait_for_sync(TC3, TC_SYNCBUSY_SWRST);
+    hri_tc_write_CTRLA_reg(TC3, TC_CTRLA_MODE_COUNT16);
+    hri_tc_write_WAVE_reg(TC3, TC_WAVE_WAVEGEN_MFRQ);
+    hri_tccount16_write_CC_reg(TC3, 0, 32768 / frequency - 1);
+    hri_tc_set_INTEN_MC0_bit(TC3);
+    // TC3 keeps the default priority, the highest, so the samples see into the other interrupt handlers too.
+    NVIC_ClearPendingIRQ(TC3_IRQn);
+    NVIC_EnableIRQ(TC3_IRQn);
+
+    _running = true;
+    hri_tc_set_CTRLA_ENABLE_bit(TC3);
+
+    return true;
+}
+
+void watch_profiler_stop(void) {
+    if (!_running) return;
+    hri_tc_clear_CTRLA_ENABLE_bit(TC3);
+    hri_tc_wait_for_sync(TC3, TC_SYNCBUSY_ENABLE);
+    hri_tc_clear_INTEN_MC0_bit(TC3);
+    _running = false;
+}
+
+bool watch_profiler_is_running(void) {
+    return _running;
+}
+
+const watch_profiler_histogram_t *watch_profiler_get_histogram(void) {
+    return &_histogram;
+}
+
+void _watch_profiler_interrupt(const uint32_t *frame) {
+    if (!_running) {
+        _watch_buzzer_tc3_handler();
+        return;
+    }
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    // the exception frame is r0, r1, r2, r3, r12, lr, pc and xpsr; the pc is where the CPU was interrupted.
+    if (!watch_profiler_histogram_add(&_histogram, frame[6])) watch_profiler_stop();
+}
+
+// The handler has to find the exception frame before any C code moves the stack pointer, so it is a few
+// instructions of assembly that pass the frame to _watch_profiler_interrupt. Bit 2 of the EXC_RETURN value
+// in lr says which stack the frame went on.
+__attribute__((naked)) void TC3_Handler(void) {
+    __asm volatile(
+        "movs r0, #4            \n"
+        "mov r1, lr             \n"
+        "tst r0, r1             \n"
+        "beq 1f                 \n"
+        "mrs r0, psp            \n"
+        "b 2f                   \n"
+        "1: mrs r0, msp         \n"
+        "2: ldr r1, 3f          \n"
+        "bx r1                  \n"
+        ".align 2               \n"
+        "3: .word _watch_profiler_interrupt \n"
+    );
+}
+
+#endif // WATCH_PROFILER
@@ -30,6 +30,17 @@ ext_irq_cb_t btn_alarm_callback;
 ext_irq_cb_t a2_callback;
 ext_irq_cb_t a4_callback;
 
+// A copy of CLOCK shared by everything that reads the time between two RTC interrupts. RTC_Handler bumps
+// _rtc_interrupt_count and refreshes the copy from CLOCK before calling back, so a cached read is a plain
+// copy; it only reads CLOCK itself if its own refresh raced an interrupt, or before the first one. Readers
+// check _rtc_shadow_sequence, which is odd while the copy is being written, and changes with every write,
+// so they never use a date and an interrupt count from different refreshes.
+static volatile uint32_t _rtc_interrupt_count;
+static volatile uint32_t _rtc_shadow_sequence;
+static volatile uint32_t _rtc_shadow_interrupt_count;
+static volatile watch_date_time _rtc_shadow;
+static uint32_t _rtc_uncached_reads;
+
 bool _watch_rtc_is_enabled(void) {
     return RTC->MODE2.CTRLA.bit.ENABLE;
 }
@@ -52,14 +63,29 @@ void _watch_rtc_init(void) {
     RTC->MODE2.CTRLA.bit.MODE = RTC_MODE2_CTRLA_MODE_CLOCK_Val;
     RTC->MODE2.CTRLA.bit.PRESCALER = RTC_MODE2_CTRLA_PRESCALER_DIV1024_Val;
     RTC->MODE2.CTRLA.bit.CLOCKSYNC = 1;
+    // periodic events cost nothing until the event system routes them somewhere, and EVCTRL can't be
+    // written once the RTC is running, so turn them all on now.
+    RTC->MODE2.EVCTRL.reg = RTC_MODE2_EVCTRL_PEREO_Msk;
     RTC->MODE2.CTRLA.bit.ENABLE = 1;
     _sync_rtc();
 }
 
+static void _watch_rtc_store_shadow(watch_date_time date_time, uint32_t interrupt_count) {
+    // the writer can't be interrupted, so readers in interrupt handlers never see a write half done
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    _rtc_shadow_sequence++;
+    _rtc_shadow = date_time;
+    _rtc_shadow_interrupt_count = interrupt_count;
+    _rtc_shadow_sequence++;
+    __set_PRIMASK(primask);
+}
+
 void watch_rtc_set_date_time(watch_date_time date_time) {
     _sync_rtc(); // Double sync as without it at high Hz faces setting time is unrealiable (specifically, set_time_hackwatch)
     RTC->MODE2.CLOCK.reg = date_time.reg;
     _sync_rtc();
+    _watch_rtc_store_shadow(date_time, _rtc_interrupt_count);
 }
 
 watch_date_time watch_rtc_get_date_time(void) {
@@ -67,10 +93,116 @@ watch_date_time watch_rtc_get_date_time(void) {
 
     _sync_rtc();
     retval.reg = RTC->MODE2.CLOCK.reg;
+    _rtc_uncached_reads++;
 
     return retval;
 }
 
+watch_date_time watch_rtc_get_cached_date_time(void) {
+    uint32_t sequence = _rtc_shadow_sequence;
+    watch_date_time shadow = _rtc_shadow;
+    if (!(sequence & 1) && _rtc_shadow_interrupt_count == _rtc_interrupt_count && sequence == _rtc_shadow_sequence) {
+        return shadow;
+    }
+
+    // take the count first: if an interrupt lands during the read, the copy is stale as soon as it's stored
+    uint32_t interrupt_count = _rtc_interrupt_count;
+    watch_date_time date_time = watch_rtc_get_date_time();
+    _watch_rtc_store_shadow(date_time, interrupt_count);
+
+    return date_time;
+}
+
+uint32_t watch_rtc_get_uncached_read_count(void) {
+    return _rtc_uncached_reads;
+}
+
+// Timestamp ticks are counted by TC2, from the RTC's 128 Hz periodic event over the event system, so they
+// land on the same edges as the RTC's own 128 Hz tick. The counter is 16 bits wide; its overflow, once every
+// 512 seconds, carries into _timestamp_upper. Compare channel 0 calls back at a deadline.
+static uint8_t _timestamp_users;
+static volatile uint16_t _timestamp_upper;
+static ext_irq_cb_t _timestamp_callback;
+static uint32_t _timestamp_deadline;
+
+static uint16_t _watch_rtc_read_timestamp_counter(void) {
+    TC2->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+    while (TC2->COUNT16.SYNCBUSY.reg & (TC_SYNCBUSY_CTRLB | TC_SYNCBUSY_COUNT));
+    return TC2->COUNT16.COUNT.reg;
+}
+
+void watch_rtc_enable_timestamp_ticks(void) {
+    if (_timestamp_users++) return;
+
+    _timestamp_upper = 0;
+    _timestamp_callback = NULL;
+    hri_mclk_set_APBCMASK_TC2_bit(MCLK);
+    // GCLK3 only synchronizes the counter to the bus now; the events are what it counts.
+    hri_gclk_write_PCHCTRL_reg(GCLK, TC2_GCLK_ID, GCLK_PCHCTRL_GEN_GCLK3 | GCLK_PCHCTRL_CHEN);
+    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_SWRST);
+    hri_tc_wait_for_sync(TC2, TC_SYNCBUSY_SWRST);
+    hri_tc_write_CTRLA_reg(TC2, TC_CTRLA_MODE_COUNT16 | TC_CTRLA_RUNSTDBY);
+    hri_tc_write_EVCTRL_reg(TC2, TC_EVCTRL_TCEI | TC_EVCTRL_EVACT_COUNT);
+    watch_evsys_connect(WATCH_EVSYS_GEN_RTC_PER_0, WATCH_EVSYS_USER_TC2_EVU);
+    hri_tc_set_INTEN_OVF_bit(TC2);
+    NVIC_ClearPendingIRQ(TC2_IRQn);
+    NVIC_EnableIRQ(TC2_IRQn);
+    hri_tc_set_CTRLA_ENABLE_bit(TC2);
+}
+
+void watch_rtc_disable_timestamp_ticks(void) {
+    if (_timestamp_users == 0 || --_timestamp_users) return;
+
+    NVIC_DisableIRQ(TC2_IRQn);
+    _timestamp_callback = NULL;
+    hri_tc_clear_CTRLA_ENABLE_bit(TC2);
+    hri_tc_wait_for_sync(TC2, TC_SYNCBUSY_ENABLE);
+    watch_evsys_disconnect(WATCH_EVSYS_USER_TC2_EVU);
+    hri_mclk_clear_APBCMASK_TC2_bit(MCLK);
+}
+
+bool watch_rtc_timestamp_ticks_enabled(void) {
+    return _timestamp_users != 0;
+}
+
+uint32_t watch_rtc_get_timestamp_ticks(void) {
+    if (!_timestamp_users) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint16_t upper = _timestamp_upper;
+    uint16_t lower = _watch_rtc_read_timestamp_counter();
+    if (TC2->COUNT16.INTFLAG.reg & TC_INTFLAG_OVF) {
+        // the counter wrapped, and TC2_Handler hasn't carried it yet; read again so both halves agree.
+        upper++;
+        lower = _watch_rtc_read_timestamp_counter();
+    }
+    __set_PRIMASK(primask);
+
+    return ((uint32_t)upper << 16) | lower;
+}
+
+void watch_rtc_register_timestamp_callback(ext_irq_cb_t callback, uint32_t ticks) {
+    if (!_timestamp_users) return;
+
+    hri_tc_clear_INTEN_MC0_bit(TC2);
+    _timestamp_deadline = ticks;
+    _timestamp_callback = callback;
+    TC2->COUNT16.CC[0].reg = (uint16_t)ticks;
+    while (TC2->COUNT16.SYNCBUSY.reg & TC_SYNCBUSY_CC0);
+    TC2->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    hri_tc_set_INTEN_MC0_bit(TC2);
+    // if the deadline passed while we were setting it, the compare won't match for another 512 seconds.
+    if ((int32_t)(watch_rtc_get_timestamp_ticks() - ticks) >= 0) NVIC_SetPendingIRQ(TC2_IRQn);
+}
+
+void watch_rtc_disable_timestamp_callback(void) {
+    if (!_timestamp_users) return;
+
+    hri_tc_clear_INTEN_MC0_bit(TC2);
+    _timestamp_callback = NULL;
+}
+
 void watch_rtc_register_tick_callback(ext_irq_cb_t callback) {
     watch_rtc_register_periodic_callback(callback, 1);
 }
@@ -129,6 +261,14 @@ void RTC_Handler(void) {
     uint16_t interrupt_status = RTC->MODE2.INTFLAG.reg;
     uint16_t interrupt_enabled = RTC->MODE2.INTENSET.reg;
 
+    // the clock may have moved on since the last read: refresh the copy, once, for everyone the callbacks
+    // below and the main loop after them will ask for the time
+    _rtc_interrupt_count++;
+    _sync_rtc();
+    watch_date_time date_time;
+    date_time.reg = RTC->MODE2.CLOCK.reg;
+    _watch_rtc_store_shadow(date_time, _rtc_interrupt_count);
+
     if ((interrupt_status & interrupt_enabled) & RTC_MODE2_INTFLAG_PER_Msk) {
         // handle the tick callback first, it's what we do the most.
         // start from PER7, the 1 Hz tick.
@@ -162,6 +302,21 @@ void RTC_Handler(void) {
     }
 }
 
+void TC2_Handler(void) {
+    if (TC2->COUNT16.INTFLAG.reg & TC_INTFLAG_OVF) {
+        _timestamp_upper++;
+        TC2->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+    }
+    TC2->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    // the compare matches the lower half only, so check the whole count before calling back.
+    if (_timestamp_callback != NULL && (int32_t)(watch_rtc_get_timestamp_ticks() - _timestamp_deadline) >= 0) {
+        ext_irq_cb_t callback = _timestamp_callback;
+        hri_tc_clear_INTEN_MC0_bit(TC2);
+        _timestamp_callback = NULL;
+        callback();
+    }
+}
+
 void watch_rtc_enable(bool en)
 {
     // Writing it twice - as it's quite dangerous operation.
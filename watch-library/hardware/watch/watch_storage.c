@@ -2,6 +2,8 @@
 #include <string.h>
 #include <stdio.h>
 #include "watch_storage.h"
+#include "watch_private_nvm_queue.h"
+#include "hal_sleep.h"
 
 #define RWWEE_ADDR_START NVMCTRL_RWW_EEPROM_ADDR
 #define RWWEE_ADDR_END (NVMCTRL_RWW_EEPROM_ADDR + NVMCTRL_PAGE_SIZE * NVMCTRL_RWWEE_PAGES)
@@ -18,6 +20,123 @@ static bool _is_valid_address(uint32_t addr, uint32_t size) {
     return true;
 }
 
+static void _watch_storage_start(const watch_nvm_op_t *op) {
+    uint32_t address = RWWEE_ADDR_START + op->row * NVMCTRL_ROW_SIZE + op->offset;
+
+    if (op->type == WATCH_NVM_OP_WRITE) {
+        uint32_t nvm_address = address / 2;
+        uint16_t i, data;
+
+        // clearing the page buffer only takes a few cycles, so this wait doesn't need the queue
+        hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_PBC | NVMCTRL_CTRLA_CMDEX_KEY);
+        while (!hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL));
+
+        for (i = 0; i < op->size; i += 2) {
+            data = op->data[i];
+            if (i < NVMCTRL_PAGE_SIZE - 1) {
+                data |= (op->data[i + 1] << 8);
+            }
+            NVM_MEMORY[nvm_address++] = data;
+        }
+        hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
+        hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEWP | NVMCTRL_CTRLA_CMDEX_KEY);
+    } else {
+        hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
+        hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEER | NVMCTRL_CTRLA_CMDEX_KEY);
+    }
+
+    // READY is a level, not an event: only listen for it while an operation is in flight.
+    hri_nvmctrl_set_INTEN_READY_bit(NVMCTRL);
+}
+
+static void _watch_storage_enter_critical(void) {
+    __disable_irq();
+}
+
+static void _watch_storage_exit_critical(void) {
+    __enable_irq();
+}
+
+// The queue calls this with PRIMASK set, between its check for completion and the wait, so the
+// READY interrupt can't land in between and leave us asleep. That relies on WFI waking for any
+// interrupt that is enabled in the NVIC and pending, whatever PRIMASK says (ARMv6-M ARM, B1.5.19,
+// "Wait For Interrupt"); the handler then runs as soon as the queue clears PRIMASK. Masking only
+// the NVMCTRL line in the NVIC would not wake WFI at all, and clearing PRIMASK before the WFI
+// would reopen the race.
+static void _watch_storage_idle(void) {
+    if (__get_IPSR() == 0) {
+        // IDLE sleep stops the CPU clock only; the NVM controller keeps going.
+        sleep(2);
+    } else if (hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL)) {
+        // an interrupt handler of the same priority can't be preempted by ours, so poll instead.
+        NVMCTRL_Handler();
+    }
+}
+
+static const watch_nvm_backend_t nvm_backend = {
+    .start = _watch_storage_start,
+    .enter_critical = _watch_storage_enter_critical,
+    .exit_critical = _watch_storage_exit_critical,
+    .idle = _watch_storage_idle,
+};
+
+static watch_nvm_queue_t nvm_queue;
+static bool nvm_queue_ready = false;
+
+static void _watch_storage_init_queue(void) {
+    if (nvm_queue_ready) return;
+
+    watch_nvm_queue_init(&nvm_queue, &nvm_backend);
+    hri_nvmctrl_clear_INTEN_reg(NVMCTRL, NVMCTRL_INTENCLR_MASK);
+    NVIC_ClearPendingIRQ(NVMCTRL_IRQn);
+    NVIC_EnableIRQ(NVMCTRL_IRQn);
+    nvm_queue_ready = true;
+}
+
+void NVMCTRL_Handler(void) {
+    if (!hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL)) return;
+    hri_nvmctrl_clear_INTEN_READY_bit(NVMCTRL);
+
+    bool ok = !(hri_nvmctrl_read_STATUS_reg(NVMCTRL) & (NVMCTRL_STATUS_PROGE | NVMCTRL_STATUS_LOCKE | NVMCTRL_STATUS_NVME));
+    hri_nvmctrl_clear_STATUS_reg(NVMCTRL, NVMCTRL_STATUS_MASK);
+
+    watch_nvm_queue_complete(&nvm_queue, ok);
+}
+
+static uint32_t _watch_storage_submit_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE + offset;
+    if (!_is_valid_address(address, size) || size > NVMCTRL_PAGE_SIZE) return 0;
+
+    _watch_storage_init_queue();
+    watch_nvm_op_t op = {
+        .type = WATCH_NVM_OP_WRITE,
+        .row = row,
+        .offset = offset,
+        .size = size,
+    };
+    memcpy(op.data, buffer, size);
+
+    return watch_nvm_queue_submit(&nvm_queue, &op);
+}
+
+static uint32_t _watch_storage_submit_erase(uint32_t row) {
+    uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE;
+    if (!_is_valid_address(address, NVMCTRL_ROW_SIZE)) return 0;
+
+    _watch_storage_init_queue();
+    watch_nvm_op_t op = {
+        .type = WATCH_NVM_OP_ERASE,
+        .row = row,
+    };
+
+    return watch_nvm_queue_submit(&nvm_queue, &op);
+}
+
+void _watch_storage_wait_idle(void) {
+    // the array can't be read while the controller is busy, and queued writes must land first
+    if (nvm_queue_ready) watch_nvm_queue_wait(&nvm_queue, nvm_queue.submitted);
+}
+
 bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t size) {
     uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE + offset;
     if (!_is_valid_address(address, size)) return false;
@@ -26,7 +145,7 @@ bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t
     uint32_t i;
     uint16_t data;
 
-    watch_storage_sync();
+    _watch_storage_wait_idle();
 
     if (address % 2) {
         data      = NVM_MEMORY[nvm_address++];
@@ -47,48 +166,39 @@ bool watch_storage_read(uint32_t row, uint32_t offset, uint8_t *buffer, uint32_t
     return true;
 }
 
-bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
-    uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE + offset;
-    if (!_is_valid_address(address, size)) return false;
-
-    watch_storage_sync();
-
-    uint32_t nvm_address = address / 2;
-    uint16_t i, data;
+bool watch_storage_write_async(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    return _watch_storage_submit_write(row, offset, buffer, size) != 0;
+}
 
-    hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_PBC | NVMCTRL_CTRLA_CMDEX_KEY);
-    watch_storage_sync();
+bool watch_storage_erase_async(uint32_t row) {
+    return _watch_storage_submit_erase(row) != 0;
+}
 
-    for (i = 0; i < size; i += 2) {
-        data = buffer[i];
-        if (i < NVMCTRL_PAGE_SIZE - 1) {
-            data |= (buffer[i + 1] << 8);
-        }
-        NVM_MEMORY[nvm_address++] = data;
-    }
-    hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
-    hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEWP | NVMCTRL_CTRLA_CMDEX_KEY);
+bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    uint32_t ticket = _watch_storage_submit_write(row, offset, buffer, size);
+    if (ticket == 0) return false;
 
-    return true;
+    return watch_nvm_queue_wait(&nvm_queue, ticket);
 }
 
 bool watch_storage_erase(uint32_t row) {
-    uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE;
-    if (!_is_valid_address(address, NVMCTRL_ROW_SIZE)) return false;
-
-    watch_storage_sync();
-    hri_nvmctrl_write_ADDR_reg(NVMCTRL, address / 2);
-    hri_nvmctrl_write_CTRLA_reg(NVMCTRL, NVMCTRL_CTRLA_CMD_RWWEEER | NVMCTRL_CTRLA_CMDEX_KEY);
+    uint32_t ticket = _watch_storage_submit_erase(row);
+    if (ticket == 0) return false;
 
-    return true;
+    return watch_nvm_queue_wait(&nvm_queue, ticket);
 }
 
 bool watch_storage_sync(void) {
-    while (!hri_nvmctrl_get_interrupt_READY_bit(NVMCTRL)) {
-        // wait for flash to become ready
-    }
+    if (!nvm_queue_ready) return true;
 
-    hri_nvmctrl_clear_STATUS_reg(NVMCTRL, NVMCTRL_STATUS_MASK);
+    return watch_nvm_queue_flush(&nvm_queue);
+}
 
-    return true;
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset) {
+    uint32_t address = RWWEE_ADDR_START + row * NVMCTRL_ROW_SIZE + offset;
+    if (!_is_valid_address(address, 0)) return NULL;
+
+    _watch_storage_wait_idle();
+
+    return (const uint8_t *)address;
 }
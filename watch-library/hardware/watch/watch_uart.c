@@ -35,7 +35,7 @@ void watch_enable_uart(const uint8_t tx_pin, const uint8_t rx_pin, uint32_t baud
     ctrlb.reg = SERCOM_USART_CTRLB_CHSIZE(0);
 
     MCLK->APBCMASK.reg |= MCLK_APBCMASK_SERCOM3;
-    GCLK->PCHCTRL[SERCOM3_GCLK_ID_CORE].reg = GCLK_PCHCTRL_GEN(0) | GCLK_PCHCTRL_CHEN;
+    GCLK->PCHCTRL[SERCOM3_GCLK_ID_CORE].reg = GCLK_PCHCTRL_GEN(2) | GCLK_PCHCTRL_CHEN;
 
     while (0 == (GCLK->PCHCTRL[SERCOM3_GCLK_ID_CORE].reg & GCLK_PCHCTRL_CHEN)) {
         // wait
@@ -93,13 +93,9 @@ void watch_enable_uart(const uint8_t tx_pin, const uint8_t rx_pin, uint32_t baud
     SERCOM3->USART.CTRLA.reg = ctrla.reg;
     SERCOM3->USART.CTRLB.reg = ctrlb.reg;
 
-    if (hri_usbdevice_get_CTRLA_ENABLE_bit(USB)) {
-        uint64_t br = 65536 - ((65536 * 16.0f * baud) / 8000000);
-        SERCOM3->USART.BAUD.reg = (uint16_t)br;
-    } else {
-        uint64_t br = 65536 - ((65536 * 16.0f * baud) / 4000000);
-        SERCOM3->USART.BAUD.reg = (uint16_t)br;
-    }
+    // the peripheral clock is 4 MHz whatever the CPU is running at.
+    uint64_t br = 65536 - ((65536 * 16.0f * baud) / 4000000);
+    SERCOM3->USART.BAUD.reg = (uint16_t)br;
 
     SERCOM3->USART.CTRLA.reg |= SERCOM_USART_CTRLA_ENABLE;
 
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Times the table-driven calendar arithmetic in watch_utility.c against the musl-derived
+ * conversions it replaced (kept in reference_calendar.c), in host cycles per call. The host
+ * divides in hardware, so the gap on the Cortex-M0+, where every division is a library call,
+ * is wider than what this prints; treat the numbers as a ratio, not as watch timings.
+ *
+ * Build and run from this directory:
+ *   gcc -O2 -include watch_shim.h -I.. calendar_bench.c reference_calendar.c ../watch_utility.c -lm -o calendar_bench && ./calendar_bench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <x86intrin.h>
+#include "watch_utility.h"
+#include "reference_calendar.h"
+
+#define CALLS 4000000
+#define START 1704067200u // 2024-01-01 00:00:00 UTC
+#define STRIDE 8191       // walks across seconds, hours, days and years
+
+static volatile uint32_t sink;
+
+#define BENCH(label, expression) do { \
+    uint64_t start = __rdtsc(); \
+    for (uint32_t i = 0; i < CALLS; i++) { expression; } \
+    printf("  %-44s %6.1f cycles\n", label, (double)(__rdtsc() - start) / CALLS); \
+} while (0)
+
+int main(void) {
+    watch_date_time date_time = watch_utility_date_time_from_unix_time(START, 0);
+
+    printf("date_time_from_unix_time\n");
+    BENCH("musl", sink = reference_date_time_from_unix_time(START + i * STRIDE, 0).reg);
+    BENCH("tables", sink = watch_utility_date_time_from_unix_time(START + i * STRIDE, 0).reg);
+
+    printf("date_time_to_unix_time\n");
+    BENCH("musl", date_time.unit.day = 1 + (i & 15); sink = reference_date_time_to_unix_time(date_time, 0));
+    BENCH("tables", date_time.unit.day = 1 + (i & 15); sink = watch_utility_date_time_to_unix_time(date_time, 0));
+
+    printf("get_iso8601_weekday_number\n");
+    BENCH("formula", sink = reference_get_iso8601_weekday_number(2020 + (i & 63), 1 + (i >> 6) % 12, 1 + (i & 27)));
+    BENCH("tables", sink = watch_utility_get_iso8601_weekday_number(2020 + (i & 63), 1 + (i >> 6) % 12, 1 + (i & 27)));
+
+    printf("one second later\n");
+    BENCH("to_unix + 1, from_unix", sink = (date_time = reference_date_time_from_unix_time(reference_date_time_to_unix_time(date_time, 0) + 1, 0)).reg);
+    BENCH("date_time_add_seconds(1)", sink = (date_time = watch_utility_date_time_add_seconds(date_time, 1)).reg);
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Counts the date arithmetic a tick costs, with each face working out the time for itself versus
+ * Movement keeping one watch_utility_clock_t up to date for all of them.
+ *
+ * The Cortex-M0+ has no divide instruction, so every / or % by anything but a power of two is a
+ * call into the compiler's division routine. watch_utility.c is built with -finstrument-functions
+ * to count calls to each conversion, and each call is charged the divisions the musl-derived
+ * conversions had (the table-driven ones that replaced them have none, so the charge now stands for
+ * the work a conversion does rather than literal library calls):
+ *   watch_utility_date_time_from_unix_time: 12 (/ and % by 86400, % 7, / and % by days per 400 years,
+ *                                           / days per 100 and 4 years, / 365, / 3600, / 60, % 60 twice)
+ *   watch_utility_get_iso8601_weekday_number: 2 (/ 5, % 7)
+ *   watch_utility_date_time_to_unix_time: 0 for years up to 2038, where musl's fast path applies
+ * Along the way, every cached clock is checked against a from-scratch conversion.
+ *
+ * Build and run from this directory:
+ *   gcc -O1 -include watch_shim.h -I.. -finstrument-functions -c ../watch_utility.c -o watch_utility.o
+ *   gcc -O1 -include watch_shim.h -I.. clock_bench.c watch_utility.o -lm -o clock_bench && ./clock_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "watch_utility.h"
+
+#define DIVS_FROM_UNIX 12
+#define DIVS_WEEKDAY 2
+
+static uint32_t calls_from_unix, calls_to_unix, calls_weekday;
+static uint32_t rtc_syncs;
+
+void __cyg_profile_func_enter(void *fn, void *call_site) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *fn, void *call_site) __attribute__((no_instrument_function));
+
+void __cyg_profile_func_enter(void *fn, void *call_site) {
+    (void) call_site;
+    if (fn == (void *)watch_utility_date_time_from_unix_time) calls_from_unix++;
+    if (fn == (void *)watch_utility_date_time_to_unix_time) calls_to_unix++;
+    if (fn == (void *)watch_utility_get_iso8601_weekday_number) calls_weekday++;
+}
+
+void __cyg_profile_func_exit(void *fn, void *call_site) {
+    (void) fn;
+    (void) call_site;
+}
+
+static watch_date_time rtc;
+static int32_t utc_offset = -5 * 3600;
+
+static watch_date_time read_rtc(void) {
+    rtc_syncs++;
+    return rtc;
+}
+
+static void reset_counts(void) {
+    calls_from_unix = calls_to_unix = calls_weekday = rtc_syncs = 0;
+}
+
+static void report(const char *name, uint32_t ticks) {
+    uint32_t divisions = calls_from_unix * DIVS_FROM_UNIX + calls_weekday * DIVS_WEEKDAY;
+    printf("%-34s per tick: %5.2f RTC syncs, %5.2f to_unix, %5.2f from_unix, %5.2f weekday, %6.2f divisions\n", name,
+           (double)rtc_syncs / ticks, (double)calls_to_unix / ticks, (double)calls_from_unix / ticks,
+           (double)calls_weekday / ticks, (double)divisions / ticks);
+}
+
+// What one tick costs the faces: the active clock face shows local time, the weekday and a second
+// zone, and the world clock in the background wants UTC to see whether its alarm is due.
+static void faces_before(void) {
+    watch_date_time now = read_rtc();
+    uint32_t timestamp = watch_utility_date_time_to_unix_time(now, utc_offset);
+    volatile const char *weekday = watch_utility_get_weekday(now);
+    volatile watch_date_time other = watch_utility_date_time_convert_zone(now, utc_offset, 9 * 3600);
+
+    watch_date_time background = read_rtc();
+    volatile watch_date_time utc = watch_utility_date_time_from_unix_time(watch_utility_date_time_to_unix_time(background, utc_offset), 0);
+    (void) timestamp; (void) weekday; (void) other; (void) utc;
+}
+
+static void faces_after(const watch_utility_clock_t *now) {
+    static uint32_t weekday_day;
+    static const char *weekday;
+    // the weekday only changes when the day does
+    if (now->local.reg >> 17 != weekday_day) {
+        weekday_day = now->local.reg >> 17;
+        weekday = watch_utility_get_weekday(now->local);
+    }
+    volatile const char *w = weekday;
+    volatile watch_date_time other = watch_utility_date_time_from_unix_time(now->timestamp, 9 * 3600);
+    volatile watch_date_time utc = now->utc;
+    (void) w; (void) other; (void) utc;
+}
+
+// ticks the emulated RTC by hand, so that the bench's own bookkeeping doesn't show up in the counts
+static void advance_rtc(void) {
+    static const uint8_t days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (++rtc.unit.second < 60) return;
+    rtc.unit.second = 0;
+    if (++rtc.unit.minute < 60) return;
+    rtc.unit.minute = 0;
+    if (++rtc.unit.hour < 24) return;
+    rtc.unit.hour = 0;
+    uint8_t days = days_in_month[rtc.unit.month - 1] + (rtc.unit.month == 2 && rtc.unit.year % 4 == 0);
+    if (++rtc.unit.day <= days) return;
+    rtc.unit.day = 1;
+    if (++rtc.unit.month <= 12) return;
+    rtc.unit.month = 1;
+    rtc.unit.year++;
+}
+
+static void check(const watch_utility_clock_t *clock) {
+    uint32_t timestamp = watch_utility_date_time_to_unix_time(clock->local, clock->utc_offset);
+    watch_date_time utc = watch_utility_date_time_from_unix_time(timestamp, 0);
+    if (clock->timestamp != timestamp || clock->local_timestamp != timestamp + clock->utc_offset || clock->utc.reg != utc.reg) {
+        printf("mismatch at local %08x offset %d: timestamp %u vs %u, utc %08x vs %08x\n", clock->local.reg,
+               clock->utc_offset, clock->timestamp, timestamp, clock->utc.reg, utc.reg);
+        exit(1);
+    }
+}
+
+int main(void) {
+    const uint32_t ticks = 86400;
+    const watch_date_time start = { .unit = { .year = 6, .month = 3, .day = 8, .hour = 0, .minute = 0, .second = 0 } };
+
+    rtc = start;
+    reset_counts();
+    for (uint32_t i = 0; i < ticks; i++) {
+        read_rtc(); // movement's cb_tick
+        faces_before();
+        advance_rtc();
+    }
+    report("each face converts for itself", ticks);
+
+    watch_utility_clock_t clock = {0};
+    rtc = start;
+    reset_counts();
+    for (uint32_t i = 0; i < ticks; i++) {
+        watch_utility_clock_update(&clock, read_rtc(), utc_offset);
+        faces_after(&clock);
+        advance_rtc();
+    }
+    report("shared clock, advanced per tick", ticks);
+
+    // correctness: odd offsets, the clock being set forward and back, and zone changes along the way
+    const int32_t offsets[] = { 0, -5 * 3600, 5 * 3600 + 1800, 12 * 3600 + 2700, -9 * 3600 - 1800, 14 * 3600 };
+    srand(1);
+    memset(&clock, 0, sizeof(clock));
+    rtc = start;
+    for (uint32_t i = 0; i < 5 * ticks; i++) {
+        int r = rand() % 10000;
+        if (r == 0) utc_offset = offsets[rand() % 6];
+        else if (r == 1) rtc.unit.minute = rand() % 60;
+        else if (r == 2) rtc.unit.hour = rand() % 24;
+        else if (r < 200) for (int n = rand() % 600; n > 0; n--) advance_rtc();
+        else advance_rtc();
+        watch_utility_clock_update(&clock, rtc, utc_offset);
+        check(&clock);
+    }
+    printf("cached clock matched a full conversion on every tick\n");
+
+    return 0;
+}
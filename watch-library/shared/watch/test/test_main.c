@@ -0,0 +1,962 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Host tests for the CDC ring buffer, with a fake USB endpoint standing in for TinyUSB; for the
+ * NVM operation queue, with an emulated NVM controller that takes as long as the real one; for
+ * watch_utility's calendar arithmetic, against the implementation it replaced, over the whole
+ * range the RTC can hold; for the main loop's choice of sleep mode, against a model of the
+ * interrupts that wake it; for the performance levels, against a model of what each costs; for
+ * the event system's routing table; for the simulator's timestamp tick counter, stepped by hand;
+ * for the profiler's histogram, with made-up samples; and for the memory diagnostics, with an
+ * allocation script and a painted stack.
+ * Build and run from this directory:
+ *   gcc -O2 -include watch_shim.h -I.. -o test_watch test_main.c reference_calendar.c unity.c \
+ *       ../watch_private_ring.c ../watch_private_nvm_queue.c ../watch_private_sleep.c \
+ *       ../watch_private_performance.c ../watch_private_evsys.c ../watch_private_timestamp.c \
+ *       ../watch_private_profiler.c ../watch_private_memory.c ../watch_utility.c -lm && ./test_watch
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "watch_private_ring.h"
+#include "watch_private_nvm_queue.h"
+#include "watch_private_sleep.h"
+#include "watch_private_performance.h"
+#include "watch_private_evsys.h"
+#include "watch_private_timestamp.h"
+#include "watch_private_profiler.h"
+#include "watch_private_memory.h"
+#include "watch_utility.h"
+#include "reference_calendar.h"
+#include "unity.h"
+
+#define RING_SZ 64
+
+static uint8_t ring_buf[RING_SZ];
+static watch_ring_t ring;
+
+void setUp(void) {
+  memset(ring_buf, 0xAA, sizeof(ring_buf));
+  watch_ring_init(&ring, ring_buf, RING_SZ);
+}
+
+void tearDown(void) {
+}
+
+// Fake endpoint: a FIFO of limited size, like TinyUSB's CDC TX FIFO, that the "host" empties
+typedef struct {
+  uint8_t data[4096];
+  uint16_t len;
+  uint16_t fifo_free;
+  uint16_t calls;
+} fake_endpoint_t;
+
+static uint16_t fake_endpoint_sink(const uint8_t *data, uint16_t len, void *context) {
+  fake_endpoint_t *ep = context;
+  ep->calls++;
+  if (len > ep->fifo_free) len = ep->fifo_free;
+  memcpy(ep->data + ep->len, data, len);
+  ep->len += len;
+  ep->fifo_free -= len;
+  return len;
+}
+
+void test_write_read() {
+  uint8_t out[RING_SZ];
+  TEST_ASSERT_EQUAL(0, watch_ring_read(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL(5, watch_ring_write(&ring, "hello", 5));
+  TEST_ASSERT_EQUAL(5, watch_ring_used(&ring));
+  TEST_ASSERT_EQUAL(RING_SZ - 5, watch_ring_free(&ring));
+  TEST_ASSERT_EQUAL(3, watch_ring_read(&ring, out, 3));
+  TEST_ASSERT_EQUAL_MEMORY("hel", out, 3);
+  TEST_ASSERT_EQUAL(2, watch_ring_read(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY("lo", out, 2);
+  TEST_ASSERT_EQUAL(0, watch_ring_used(&ring));
+}
+
+void test_full_ring_takes_partial_writes() {
+  uint8_t in[100];
+  uint8_t out[100];
+  for (uint8_t i = 0; i < sizeof(in); ++i) in[i] = i;
+
+  // Nothing already queued is overwritten: the writer is told how much fit
+  TEST_ASSERT_EQUAL(RING_SZ, watch_ring_write(&ring, in, sizeof(in)));
+  TEST_ASSERT_EQUAL(0, watch_ring_write(&ring, in, 1));
+  TEST_ASSERT_EQUAL(RING_SZ, ring.high_water);
+  TEST_ASSERT_EQUAL(RING_SZ, watch_ring_read(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(in, out, RING_SZ);
+}
+
+void test_wraparound() {
+  uint8_t in[RING_SZ];
+  uint8_t out[RING_SZ];
+  uint8_t next_in = 0, next_out = 0;
+
+  // Push enough through that the free-running indices wrap several times, in odd-sized pieces
+  for (uint32_t round = 0; round < 5000; ++round) {
+    uint16_t n = 1 + (round * 7) % 40;
+    for (uint16_t i = 0; i < n; ++i) in[i] = next_in + i;
+    uint16_t written = watch_ring_write(&ring, in, n);
+    next_in += written;
+    uint16_t m = 1 + (round * 13) % 45;
+    uint16_t got = watch_ring_read(&ring, out, m);
+    for (uint16_t i = 0; i < got; ++i) TEST_ASSERT_EQUAL_UINT8(next_out++, out[i]);
+  }
+  TEST_ASSERT_TRUE(ring.head > 0 && ring.head < 5000 * 40);
+}
+
+void test_reserve_commit() {
+  uint8_t *ptr;
+  uint8_t out[RING_SZ];
+
+  // Move the indices to the middle, so the free space is split in two
+  uint8_t filler[40] = {0};
+  watch_ring_write(&ring, filler, sizeof(filler));
+  watch_ring_read(&ring, out, sizeof(filler));
+
+  uint16_t span = watch_ring_reserve(&ring, &ptr);
+  TEST_ASSERT_EQUAL(RING_SZ - 40, span);
+  TEST_ASSERT_EQUAL_PTR(ring_buf + 40, ptr);
+  memset(ptr, 'a', span);
+  watch_ring_commit(&ring, span);
+
+  span = watch_ring_reserve(&ring, &ptr);
+  TEST_ASSERT_EQUAL(40, span);
+  TEST_ASSERT_EQUAL_PTR(ring_buf, ptr);
+  memset(ptr, 'b', 10);
+  watch_ring_commit(&ring, 10);
+
+  TEST_ASSERT_EQUAL(RING_SZ - 40 + 10, watch_ring_read(&ring, out, sizeof(out)));
+  TEST_ASSERT_EACH_EQUAL_UINT8('a', out, RING_SZ - 40);
+  TEST_ASSERT_EACH_EQUAL_UINT8('b', out + RING_SZ - 40, 10);
+}
+
+void test_drain_to_endpoint() {
+  fake_endpoint_t ep = {0};
+  uint8_t in[RING_SZ];
+  uint8_t out[RING_SZ];
+  for (uint8_t i = 0; i < sizeof(in); ++i) in[i] = 'A' + i % 26;
+
+  // Wrap the data around the end of the buffer, so it goes out in two spans (14 + 16 bytes)
+  watch_ring_write(&ring, in, 50);
+  watch_ring_read(&ring, out, 50);
+  watch_ring_write(&ring, in, 30);
+
+  // Endpoint only has room for some of it: the first span, part of the second, and the rest stays queued
+  ep.fifo_free = 20;
+  TEST_ASSERT_EQUAL(20, watch_ring_drain(&ring, fake_endpoint_sink, &ep));
+  TEST_ASSERT_EQUAL(10, watch_ring_used(&ring));
+  TEST_ASSERT_EQUAL(2, ep.calls);
+
+  // Host reads, endpoint frees up; the remainder goes out
+  ep.fifo_free = 64;
+  TEST_ASSERT_EQUAL(10, watch_ring_drain(&ring, fake_endpoint_sink, &ep));
+  TEST_ASSERT_EQUAL(0, watch_ring_used(&ring));
+  TEST_ASSERT_EQUAL(30, ep.len);
+  TEST_ASSERT_EQUAL_MEMORY(in, ep.data, 30);
+
+  // An empty ring never calls the sink
+  ep.calls = 0;
+  TEST_ASSERT_EQUAL(0, watch_ring_drain(&ring, fake_endpoint_sink, &ep));
+  TEST_ASSERT_EQUAL(0, ep.calls);
+}
+
+void test_drain_in_contiguous_spans() {
+  fake_endpoint_t ep = {0};
+  ep.fifo_free = sizeof(ep.data);
+  uint8_t in[RING_SZ];
+  uint8_t out[RING_SZ];
+  for (uint8_t i = 0; i < sizeof(in); ++i) in[i] = i;
+
+  // 48 in, 48 out, then 48 more: the data straddles the end, and goes out in exactly two bulk writes
+  watch_ring_write(&ring, in, 48);
+  watch_ring_read(&ring, out, 48);
+  watch_ring_write(&ring, in, 48);
+  TEST_ASSERT_EQUAL(48, watch_ring_drain(&ring, fake_endpoint_sink, &ep));
+  TEST_ASSERT_EQUAL(2, ep.calls);
+  TEST_ASSERT_EQUAL_MEMORY(in, ep.data, 48);
+}
+
+// Emulated NVM controller. Time only moves when the CPU idles or a test says so, and the
+// completion interrupt is delivered whenever the controller is done and it isn't masked.
+#define NVM_ERASE_US 6000
+#define NVM_WRITE_US 2500
+#define NVM_ROWS 32
+
+static struct {
+  uint8_t storage[NVM_ROWS * 256];
+  uint32_t now_us;
+  uint32_t busy_until;
+  bool busy;
+  bool masked;
+  watch_nvm_op_t in_flight;
+  watch_nvm_op_t log[16];
+  uint8_t log_len;
+  uint16_t idles;
+  uint32_t fail_rows;  // bit n set: operations on row n fail
+} nvm;
+
+static watch_nvm_queue_t nvm_queue;
+
+static void fake_nvm_deliver(void) {
+  if (!nvm.busy || nvm.masked || nvm.now_us < nvm.busy_until) return;
+  nvm.busy = false;
+  watch_nvm_op_t *op = &nvm.in_flight;
+  bool ok = !(nvm.fail_rows & (1u << op->row));
+  if (ok && op->type == WATCH_NVM_OP_ERASE) memset(nvm.storage + op->row * 256, 0xff, 256);
+  if (ok && op->type == WATCH_NVM_OP_WRITE) memcpy(nvm.storage + op->row * 256 + op->offset, op->data, op->size);
+  watch_nvm_queue_complete(&nvm_queue, ok);
+}
+
+static void fake_nvm_start(const watch_nvm_op_t *op) {
+  TEST_ASSERT_FALSE_MESSAGE(nvm.busy, "started an operation while the controller was busy");
+  nvm.in_flight = *op;
+  if (nvm.log_len < 16) nvm.log[nvm.log_len++] = *op;
+  nvm.busy = true;
+  nvm.busy_until = nvm.now_us + (op->type == WATCH_NVM_OP_ERASE ? NVM_ERASE_US : NVM_WRITE_US);
+}
+
+static void fake_nvm_enter_critical(void) {
+  nvm.masked = true;
+}
+
+static void fake_nvm_exit_critical(void) {
+  nvm.masked = false;
+  fake_nvm_deliver();
+}
+
+static void fake_nvm_idle(void) {
+  TEST_ASSERT_TRUE_MESSAGE(nvm.masked, "idled with the completion interrupt unmasked");
+  TEST_ASSERT_TRUE_MESSAGE(nvm.busy, "idled with nothing in flight; this would sleep forever");
+  nvm.idles++;
+  nvm.now_us = nvm.busy_until;
+}
+
+static const watch_nvm_backend_t fake_nvm_backend = {
+  .start = fake_nvm_start,
+  .enter_critical = fake_nvm_enter_critical,
+  .exit_critical = fake_nvm_exit_critical,
+  .idle = fake_nvm_idle,
+};
+
+// the CPU does something else for a while
+static void fake_nvm_advance(uint32_t us) {
+  uint32_t until = nvm.now_us + us;
+  while (nvm.busy && nvm.busy_until <= until) {
+    nvm.now_us = nvm.busy_until;
+    fake_nvm_deliver();
+  }
+  nvm.now_us = until;
+}
+
+static void nvm_setup(void) {
+  memset(&nvm, 0, sizeof(nvm));
+  memset(nvm.storage, 0xff, sizeof(nvm.storage));
+  watch_nvm_queue_init(&nvm_queue, &fake_nvm_backend);
+}
+
+static uint32_t nvm_erase(uint32_t row) {
+  watch_nvm_op_t op = { .type = WATCH_NVM_OP_ERASE, .row = row };
+  return watch_nvm_queue_submit(&nvm_queue, &op);
+}
+
+static uint32_t nvm_write(uint32_t row, uint16_t offset, uint8_t fill) {
+  watch_nvm_op_t op = { .type = WATCH_NVM_OP_WRITE, .row = row, .offset = offset, .size = 64 };
+  memset(op.data, fill, 64);
+  return watch_nvm_queue_submit(&nvm_queue, &op);
+}
+
+void test_nvm_submit_does_not_wait() {
+  nvm_setup();
+  nvm_erase(3);
+  nvm_write(3, 0, 0x11);
+  nvm_write(3, 64, 0x22);
+  TEST_ASSERT_EQUAL_UINT32(0, nvm.now_us);
+  TEST_ASSERT_EQUAL_UINT16(0, nvm.idles);
+  TEST_ASSERT_TRUE(nvm.busy);
+  TEST_ASSERT_FALSE(watch_nvm_queue_is_idle(&nvm_queue));
+
+  // the queue keeps going from the interrupt while the CPU is busy elsewhere
+  fake_nvm_advance(NVM_ERASE_US + NVM_WRITE_US);
+  TEST_ASSERT_EQUAL_HEX8(0x11, nvm.storage[3 * 256]);
+  TEST_ASSERT_EQUAL_HEX8(0xff, nvm.storage[3 * 256 + 64]);
+  fake_nvm_advance(NVM_WRITE_US);
+  TEST_ASSERT_EQUAL_HEX8(0x22, nvm.storage[3 * 256 + 64]);
+  TEST_ASSERT_TRUE(watch_nvm_queue_is_idle(&nvm_queue));
+  TEST_ASSERT_EQUAL_UINT16(0, nvm.idles);
+}
+
+void test_nvm_runs_in_order() {
+  nvm_setup();
+  nvm_erase(5);
+  nvm_write(5, 0, 0x01);
+  nvm_erase(6);
+  nvm_write(6, 192, 0x02);
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_EQUAL_UINT8(4, nvm.log_len);
+  TEST_ASSERT_EQUAL_UINT8(WATCH_NVM_OP_ERASE, nvm.log[0].type);
+  TEST_ASSERT_EQUAL_UINT32(5, nvm.log[0].row);
+  TEST_ASSERT_EQUAL_UINT8(WATCH_NVM_OP_WRITE, nvm.log[1].type);
+  TEST_ASSERT_EQUAL_UINT8(WATCH_NVM_OP_ERASE, nvm.log[2].type);
+  TEST_ASSERT_EQUAL_UINT32(6, nvm.log[2].row);
+  TEST_ASSERT_EQUAL_UINT16(192, nvm.log[3].offset);
+}
+
+void test_nvm_flush_is_a_barrier() {
+  nvm_setup();
+  nvm_erase(1);
+  nvm_write(1, 0, 0xAB);
+  nvm_write(1, 64, 0xCD);
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_TRUE(watch_nvm_queue_is_idle(&nvm_queue));
+  TEST_ASSERT_FALSE(nvm.busy);
+  TEST_ASSERT_EQUAL_UINT32(NVM_ERASE_US + 2 * NVM_WRITE_US, nvm.now_us);
+  TEST_ASSERT_EQUAL_HEX8(0xCD, nvm.storage[256 + 127]);
+  // the CPU idled instead of spinning: once per operation
+  TEST_ASSERT_EQUAL_UINT16(3, nvm.idles);
+
+  // flushing an idle queue doesn't wait at all
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_EQUAL_UINT16(3, nvm.idles);
+}
+
+void test_nvm_wait_only_waits_for_its_ticket() {
+  nvm_setup();
+  uint32_t erase = nvm_erase(2);
+  nvm_write(2, 0, 0x33);
+  nvm_write(2, 64, 0x44);
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, erase));
+  TEST_ASSERT_EQUAL_UINT32(NVM_ERASE_US, nvm.now_us);
+  TEST_ASSERT_TRUE(watch_nvm_queue_is_done(&nvm_queue, erase));
+  TEST_ASSERT_FALSE(watch_nvm_queue_is_idle(&nvm_queue));
+  TEST_ASSERT_TRUE(nvm.busy);
+}
+
+void test_nvm_full_queue_waits_for_a_slot() {
+  nvm_setup();
+  for (uint32_t i = 0; i < WATCH_NVM_QUEUE_DEPTH; i++) nvm_erase(i);
+  TEST_ASSERT_EQUAL_UINT16(0, nvm.idles);
+
+  // one more than fits: has to wait for the first erase to finish
+  nvm_erase(WATCH_NVM_QUEUE_DEPTH);
+  TEST_ASSERT_EQUAL_UINT16(1, nvm.idles);
+  TEST_ASSERT_EQUAL_UINT32(NVM_ERASE_US, nvm.now_us);
+  TEST_ASSERT_EQUAL_UINT32(WATCH_NVM_QUEUE_DEPTH, nvm_queue.submitted - nvm_queue.completed);
+
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_EQUAL_UINT8(WATCH_NVM_QUEUE_DEPTH + 1, nvm.log_len);
+  for (uint32_t i = 0; i <= WATCH_NVM_QUEUE_DEPTH; i++) TEST_ASSERT_EQUAL_UINT32(i, nvm.log[i].row);
+}
+
+void test_nvm_write_data_is_copied() {
+  nvm_setup();
+  watch_nvm_op_t op = { .type = WATCH_NVM_OP_WRITE, .row = 4, .offset = 0, .size = 64 };
+  memset(op.data, 0x5A, 64);
+  nvm_erase(4);
+  watch_nvm_queue_submit(&nvm_queue, &op);
+  memset(op.data, 0x00, 64);
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_EQUAL_HEX8(0x5A, nvm.storage[4 * 256]);
+  TEST_ASSERT_EQUAL_HEX8(0x5A, nvm.storage[4 * 256 + 63]);
+}
+
+void test_nvm_failures_are_reported() {
+  nvm_setup();
+  nvm.fail_rows = 1u << 7;
+  uint32_t good = nvm_erase(6);
+  uint32_t bad = nvm_erase(7);
+  uint32_t after = nvm_erase(8);
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, good));
+  TEST_ASSERT_FALSE(watch_nvm_queue_wait(&nvm_queue, bad));
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, after));
+
+  // the barrier reports it once, then starts clean
+  TEST_ASSERT_FALSE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+}
+
+void test_nvm_later_failure_does_not_hide_earlier_one() {
+  nvm_setup();
+  nvm.fail_rows = (1u << 7) | (1u << 9);
+  uint32_t first = nvm_erase(7);
+  uint32_t good = nvm_erase(8);
+  uint32_t second = nvm_erase(9);
+  TEST_ASSERT_FALSE(watch_nvm_queue_wait(&nvm_queue, second));
+  TEST_ASSERT_FALSE(watch_nvm_queue_wait(&nvm_queue, first));
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, good));
+}
+
+void test_nvm_failure_outlives_its_slot() {
+  nvm_setup();
+  nvm.fail_rows = 1u << 7;
+  uint32_t good = nvm_erase(6);
+  uint32_t bad = nvm_erase(7);
+  uint32_t last = 0;
+  for (uint32_t i = 0; i < WATCH_NVM_QUEUE_DEPTH; i++) last = nvm_erase(10 + i);
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, last));
+  // both slots have been reused by now
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, good));
+  TEST_ASSERT_FALSE(watch_nvm_queue_wait(&nvm_queue, bad));
+  TEST_ASSERT_FALSE(watch_nvm_queue_flush(&nvm_queue));
+  TEST_ASSERT_TRUE(watch_nvm_queue_flush(&nvm_queue));
+}
+
+void test_nvm_waits_leave_failures_for_flush() {
+  // an _async write fails; later blocking operations succeed and waiting on them mustn't eat it
+  nvm_setup();
+  nvm.fail_rows = 1u << 7;
+  nvm_erase(7);
+  uint32_t later = nvm_erase(8);
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, later));
+  TEST_ASSERT_TRUE(watch_nvm_queue_wait(&nvm_queue, nvm_queue.submitted));
+  TEST_ASSERT_FALSE(watch_nvm_queue_flush(&nvm_queue));
+}
+
+#define RTC_RANGE_START 1577836800u  // 2020-01-01 00:00:00 UTC
+#define RTC_RANGE_END 3597523200u    // 2084-01-01 00:00:00 UTC
+
+// Every minute from 2020 through 2083, each at a different second, covers every date the RTC can hold
+// at every time of day; test_from_unix_every_second_of_the_day covers the seconds.
+void test_from_unix_and_to_unix_over_the_rtc_range() {
+  for (uint32_t t = RTC_RANGE_START, i = 0; t < RTC_RANGE_END; t += 60, i++) {
+    uint32_t timestamp = t + i % 60;
+    watch_date_time expected = reference_date_time_from_unix_time(timestamp, 0);
+    watch_date_time actual = watch_utility_date_time_from_unix_time(timestamp, 0);
+    if (expected.reg != actual.reg) TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected.reg, actual.reg, "from_unix");
+    uint32_t back = watch_utility_date_time_to_unix_time(actual, 0);
+    if (back != timestamp) TEST_ASSERT_EQUAL_UINT32_MESSAGE(timestamp, back, "to_unix");
+  }
+}
+
+void test_from_unix_every_second_of_the_day() {
+  // a leap day, and the last day the RTC can hold
+  const uint32_t days[] = { 1709164800u, RTC_RANGE_END - 86400 };
+  for (uint8_t d = 0; d < 2; d++) {
+    for (uint32_t t = days[d]; t < days[d] + 86400; t++) {
+      watch_date_time expected = reference_date_time_from_unix_time(t, 0);
+      watch_date_time actual = watch_utility_date_time_from_unix_time(t, 0);
+      if (expected.reg != actual.reg) TEST_ASSERT_EQUAL_HEX32(expected.reg, actual.reg);
+      if (watch_utility_date_time_to_unix_time(actual, 0) != t) TEST_ASSERT_EQUAL_UINT32(t, watch_utility_date_time_to_unix_time(actual, 0));
+    }
+  }
+}
+
+void test_from_unix_outside_the_rtc_range() {
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_from_unix_time(RTC_RANGE_START - 1, 0).reg);
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_from_unix_time(RTC_RANGE_END, 0).reg);
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_from_unix_time(0, 0).reg);
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_from_unix_time(0xFFFFFFFF, 0).reg);
+  TEST_ASSERT_EQUAL_HEX32(reference_date_time_from_unix_time(RTC_RANGE_START, 0).reg, watch_utility_date_time_from_unix_time(RTC_RANGE_START, 0).reg);
+}
+
+void test_conversions_with_utc_offsets() {
+  const int32_t offsets[] = { -12 * 3600, -9 * 3600 - 1800, -3600, 3600, 5 * 3600 + 1800, 5 * 3600 + 2700, 14 * 3600 };
+  srand(2);
+  for (uint32_t i = 0; i < 1000000; i++) {
+    uint32_t timestamp = RTC_RANGE_START + 86400 + (uint32_t)(((uint64_t)rand() * rand()) % (RTC_RANGE_END - RTC_RANGE_START - 2 * 86400));
+    uint32_t offset = offsets[i % 7];
+    watch_date_time expected = reference_date_time_from_unix_time(timestamp, offset);
+    watch_date_time actual = watch_utility_date_time_from_unix_time(timestamp, offset);
+    if (expected.reg != actual.reg) TEST_ASSERT_EQUAL_HEX32(expected.reg, actual.reg);
+    if (reference_date_time_to_unix_time(actual, offset) != watch_utility_date_time_to_unix_time(actual, offset)) {
+      TEST_ASSERT_EQUAL_UINT32(reference_date_time_to_unix_time(actual, offset), watch_utility_date_time_to_unix_time(actual, offset));
+    }
+  }
+}
+
+void test_convert_to_unix_time_outside_the_rtc_range() {
+  // birthdays and such still go through musl's general conversion
+  TEST_ASSERT_EQUAL_UINT32(reference_convert_to_unix_time(1990, 6, 15, 12, 30, 0, 0), watch_utility_convert_to_unix_time(1990, 6, 15, 12, 30, 0, 0));
+  TEST_ASSERT_EQUAL_UINT32(reference_convert_to_unix_time(2019, 12, 31, 23, 59, 59, 3600), watch_utility_convert_to_unix_time(2019, 12, 31, 23, 59, 59, 3600));
+  TEST_ASSERT_EQUAL_UINT32(reference_convert_to_unix_time(2084, 1, 1, 0, 0, 0, 0), watch_utility_convert_to_unix_time(2084, 1, 1, 0, 0, 0, 0));
+  TEST_ASSERT_EQUAL_UINT32(reference_convert_to_unix_time(2020, 1, 1, 0, 0, 0, 0), watch_utility_convert_to_unix_time(2020, 1, 1, 0, 0, 0, 0));
+}
+
+void test_weekday_and_day_of_year_for_every_date() {
+  for (uint16_t year = 2010; year < 2100; year++) {
+    for (uint8_t month = 1; month <= 12; month++) {
+      for (uint8_t day = 1; day <= 31; day++) {
+        TEST_ASSERT_EQUAL_UINT8(reference_get_iso8601_weekday_number(year, month, day), watch_utility_get_iso8601_weekday_number(year, month, day));
+        TEST_ASSERT_EQUAL_UINT16(reference_days_since_new_year(year, month, day), watch_utility_days_since_new_year(year, month, day));
+      }
+    }
+  }
+}
+
+void test_add_seconds_minutes_and_days() {
+  srand(3);
+  for (uint32_t i = 0; i < 2000000; i++) {
+    uint32_t timestamp = RTC_RANGE_START + (uint32_t)(((uint64_t)rand() * rand()) % (RTC_RANGE_END - RTC_RANGE_START));
+    watch_date_time date_time = watch_utility_date_time_from_unix_time(timestamp, 0);
+    uint32_t n = (i & 1) ? rand() % 60 : rand() % 100000;
+    uint32_t days = (i & 1) ? rand() % 28 : rand() % 1000;
+
+    watch_date_time expected = reference_date_time_from_unix_time(timestamp + n, 0);
+    TEST_ASSERT_EQUAL_HEX32(expected.reg, watch_utility_date_time_add_seconds(date_time, n).reg);
+    expected = reference_date_time_from_unix_time(timestamp + n * 60, 0);
+    TEST_ASSERT_EQUAL_HEX32(expected.reg, watch_utility_date_time_add_minutes(date_time, n).reg);
+    expected = reference_date_time_from_unix_time(timestamp + days * 86400, 0);
+    TEST_ASSERT_EQUAL_HEX32(expected.reg, watch_utility_date_time_add_days(date_time, days).reg);
+  }
+
+  // carrying all the way into the next year, and off the end of the RTC's range
+  watch_date_time new_years_eve = watch_utility_date_time_from_unix_time(1704067199u, 0); // 2023-12-31 23:59:59
+  TEST_ASSERT_EQUAL_HEX32(watch_utility_date_time_from_unix_time(1704067200u, 0).reg, watch_utility_date_time_add_seconds(new_years_eve, 1).reg);
+  watch_date_time last = watch_utility_date_time_from_unix_time(RTC_RANGE_END - 1, 0);
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_add_seconds(last, 1).reg);
+  TEST_ASSERT_EQUAL_HEX32(0, watch_utility_date_time_add_days(last, 1).reg);
+}
+
+void test_compare_and_diff() {
+  srand(4);
+  for (uint32_t i = 0; i < 1000000; i++) {
+    uint32_t a = RTC_RANGE_START + (uint32_t)(((uint64_t)rand() * rand()) % (RTC_RANGE_END - RTC_RANGE_START));
+    uint32_t b = (i & 1) ? a + rand() % 3 - 1 : RTC_RANGE_START + (uint32_t)(((uint64_t)rand() * rand()) % (RTC_RANGE_END - RTC_RANGE_START));
+    if (b >= RTC_RANGE_END || b < RTC_RANGE_START) continue;
+    watch_date_time date_a = watch_utility_date_time_from_unix_time(a, 0);
+    watch_date_time date_b = watch_utility_date_time_from_unix_time(b, 0);
+    int8_t order = watch_utility_date_time_compare(date_a, date_b);
+    TEST_ASSERT_EQUAL_INT8((a > b) - (a < b), order > 0 ? 1 : (order < 0 ? -1 : 0));
+    TEST_ASSERT_EQUAL_INT32((int32_t)(a - b), watch_utility_date_time_diff(date_a, date_b));
+  }
+}
+
+// Main loop model: one simulated second of interrupts, and an app_loop that can always sleep.
+// A trip through the loop costs LOOP_PASS_US; sleeping skips ahead to the next interrupt that
+// can end it. Interrupts that arrive during a trip are pending, and end the next sleep at once.
+
+#define LOOP_PASS_US 50
+#define ONE_SECOND_US 1000000
+
+typedef struct {
+  uint32_t at_us;
+  bool wakes_standby;   // RTC and button interrupts do; USB traffic needs the clocks STANDBY stops
+} model_interrupt_t;
+
+typedef watch_sleep_mode_t (*sleep_policy_t)(bool can_sleep, bool usb_enabled, bool usb_suspended);
+
+static uint32_t main_loop_passes(sleep_policy_t policy, bool usb_enabled, bool usb_suspended,
+                                 const model_interrupt_t *interrupts, size_t count) {
+  uint32_t now = 0;
+  uint32_t passes = 0;
+  size_t next = 0;
+
+  while (now < ONE_SECOND_US) {
+    passes++;
+    now += LOOP_PASS_US;
+    watch_sleep_mode_t mode = policy(true, usb_enabled, usb_suspended);
+    if (mode == WATCH_SLEEP_NONE) continue;
+
+    // sleep until an interrupt that can wake this mode; anything else just gets handled on the way
+    while (next < count && !(mode == WATCH_SLEEP_IDLE || interrupts[next].wakes_standby)) next++;
+    if (next == count) break;
+    if (interrupts[next].at_us > now) now = interrupts[next].at_us;
+    // everything pending by now is handled in this one trip
+    while (next < count && interrupts[next].at_us <= now) next++;
+  }
+
+  return passes;
+}
+
+// What main() did before: with USB enabled, never sleep.
+static watch_sleep_mode_t sleep_policy_without_usb_idle(bool can_sleep, bool usb_enabled, bool usb_suspended) {
+  (void) usb_suspended;
+  return (can_sleep && !usb_enabled) ? WATCH_SLEEP_STANDBY : WATCH_SLEEP_NONE;
+}
+
+void test_sleep_modes() {
+  TEST_ASSERT_EQUAL(WATCH_SLEEP_NONE, watch_sleep_mode_for(false, false, false));
+  TEST_ASSERT_EQUAL(WATCH_SLEEP_NONE, watch_sleep_mode_for(false, true, false));
+  TEST_ASSERT_EQUAL(WATCH_SLEEP_STANDBY, watch_sleep_mode_for(true, false, false));
+  TEST_ASSERT_EQUAL(WATCH_SLEEP_IDLE, watch_sleep_mode_for(true, true, false));
+  TEST_ASSERT_EQUAL(WATCH_SLEEP_STANDBY, watch_sleep_mode_for(true, true, true));
+}
+
+void test_usb_attached_and_idle_does_not_spin() {
+  // the 1 Hz tick is all that happens on a quiet bus
+  const model_interrupt_t tick[] = { { 500000, true } };
+  TEST_ASSERT_EQUAL_UINT32(ONE_SECOND_US / LOOP_PASS_US,
+                           main_loop_passes(sleep_policy_without_usb_idle, true, false, tick, 1));
+  TEST_ASSERT_EQUAL_UINT32(2, main_loop_passes(watch_sleep_mode_for, true, false, tick, 1));
+  // and without USB, nothing changes
+  TEST_ASSERT_EQUAL_UINT32(2, main_loop_passes(sleep_policy_without_usb_idle, false, false, tick, 1));
+  TEST_ASSERT_EQUAL_UINT32(2, main_loop_passes(watch_sleep_mode_for, false, false, tick, 1));
+}
+
+void test_usb_traffic_wakes_idle() {
+  // ten serial packets; the tick lands while the loop is handling the last one, and gets its own trip
+  model_interrupt_t interrupts[11];
+  for (size_t i = 0; i < 10; i++) interrupts[i] = (model_interrupt_t){ 50000 + i * 100000, false };
+  interrupts[10] = (model_interrupt_t){ 950020, true };
+  TEST_ASSERT_EQUAL_UINT32(12, main_loop_passes(watch_sleep_mode_for, true, false, interrupts, 11));
+  // when the tick and the packet arrive together, one trip handles both
+  interrupts[10].at_us = 950000;
+  TEST_ASSERT_EQUAL_UINT32(11, main_loop_passes(watch_sleep_mode_for, true, false, interrupts, 11));
+}
+
+void test_usb_suspended_sleeps_in_standby() {
+  const model_interrupt_t interrupts[] = { { 250000, false }, { 500000, true } };
+  // with the bus suspended, only the tick wakes us
+  TEST_ASSERT_EQUAL_UINT32(2, main_loop_passes(watch_sleep_mode_for, true, true, interrupts, 2));
+  TEST_ASSERT_EQUAL_UINT32(3, main_loop_passes(watch_sleep_mode_for, true, false, interrupts, 2));
+}
+
+void test_performance_configs() {
+  watch_performance_config_t config = watch_performance_config_for(WATCH_PERFORMANCE_LOW, false);
+  TEST_ASSERT_EQUAL_UINT8(4, config.cpu_mhz);
+  TEST_ASSERT_EQUAL_UINT8(0, config.power_level);
+  TEST_ASSERT_EQUAL_UINT8(0, config.flash_wait_states);
+  TEST_ASSERT_EQUAL_UINT8(1, config.peripheral_div);
+
+  config = watch_performance_config_for(WATCH_PERFORMANCE_NORMAL, false);
+  TEST_ASSERT_EQUAL_UINT8(4, config.cpu_mhz);
+  TEST_ASSERT_EQUAL_UINT8(2, config.power_level);
+
+  config = watch_performance_config_for(WATCH_PERFORMANCE_HIGH, false);
+  TEST_ASSERT_EQUAL_UINT8(16, config.cpu_mhz);
+  TEST_ASSERT_EQUAL_UINT8(2, config.power_level);
+  TEST_ASSERT_EQUAL_UINT8(1, config.flash_wait_states);
+  TEST_ASSERT_EQUAL_UINT8(4, config.peripheral_div);
+
+  // USB can't run at PL0, and wants 8 MHz
+  for (watch_performance_level_t level = WATCH_PERFORMANCE_LOW; level <= WATCH_PERFORMANCE_HIGH; level++) {
+    config = watch_performance_config_for(level, true);
+    TEST_ASSERT_EQUAL_UINT8(2, config.power_level);
+    TEST_ASSERT_TRUE(config.cpu_mhz >= 8);
+    // whatever the CPU runs at, the peripherals see 4 MHz
+    TEST_ASSERT_EQUAL_UINT8(4, config.cpu_mhz / config.peripheral_div);
+  }
+  TEST_ASSERT_EQUAL_UINT8(8, watch_performance_config_for(WATCH_PERFORMANCE_LOW, true).cpu_mhz);
+  TEST_ASSERT_EQUAL_UINT8(16, watch_performance_config_for(WATCH_PERFORMANCE_HIGH, true).cpu_mhz);
+}
+
+void test_performance_estimates() {
+  const watch_performance_config_t low = watch_performance_config_for(WATCH_PERFORMANCE_LOW, false);
+  const watch_performance_config_t normal = watch_performance_config_for(WATCH_PERFORMANCE_NORMAL, false);
+  const watch_performance_config_t high = watch_performance_config_for(WATCH_PERFORMANCE_HIGH, false);
+
+  // half a second of work at 4 MHz, in a one-second window: 180 uA for 0.5 s, then 5 uA for 0.5 s, at 3 V
+  watch_performance_estimate_t estimate = watch_performance_estimate(low, 2000000, ONE_SECOND_US);
+  TEST_ASSERT_EQUAL_UINT32(500000, estimate.active_us);
+  TEST_ASSERT_EQUAL_UINT32(277500, estimate.energy_nj);
+
+  // HIGH gets it done in under a third of the time, wait state and all...
+  watch_performance_estimate_t fast = watch_performance_estimate(high, 2000000, ONE_SECOND_US);
+  TEST_ASSERT_EQUAL_UINT32(143750, fast.active_us);
+  // ...but each cycle costs more than the time asleep saves, so it's for a UI that would otherwise wait
+  TEST_ASSERT_TRUE(fast.energy_nj > estimate.energy_nj);
+
+  // a once-a-second tick that redraws the screen is cheapest at LOW, which is why Movement idles there
+  watch_performance_estimate_t tick_low = watch_performance_estimate(low, 4000, ONE_SECOND_US);
+  watch_performance_estimate_t tick_normal = watch_performance_estimate(normal, 4000, ONE_SECOND_US);
+  watch_performance_estimate_t tick_high = watch_performance_estimate(high, 4000, ONE_SECOND_US);
+  TEST_ASSERT_EQUAL_UINT32(tick_low.active_us, tick_normal.active_us);
+  TEST_ASSERT_TRUE(tick_low.energy_nj < tick_normal.energy_nj);
+  TEST_ASSERT_TRUE(tick_normal.energy_nj < tick_high.energy_nj);
+
+  // with no window to sleep through, it's just the work
+  estimate = watch_performance_estimate(low, 4000, 0);
+  TEST_ASSERT_EQUAL_UINT32(1000, estimate.active_us);
+  TEST_ASSERT_EQUAL_UINT32(540, estimate.energy_nj);
+}
+
+void test_evsys_rtc_periodic_generators() {
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_RTC_PER_0, watch_evsys_rtc_periodic_generator(128));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_RTC_PER_4, watch_evsys_rtc_periodic_generator(8));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_RTC_PER_7, watch_evsys_rtc_periodic_generator(1));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_NONE, watch_evsys_rtc_periodic_generator(0));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_NONE, watch_evsys_rtc_periodic_generator(3));
+}
+
+void test_evsys_routes_share_channels() {
+  watch_evsys_routes_t routes;
+  bool new_channel;
+  watch_evsys_routes_init(&routes);
+
+  // the timestamp counter and an ADC sampling at the same rate listen on one channel
+  TEST_ASSERT_EQUAL_INT8(0, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_RTC_PER_0, WATCH_EVSYS_USER_TC2_EVU, &new_channel));
+  TEST_ASSERT_TRUE(new_channel);
+  TEST_ASSERT_EQUAL_INT8(0, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_RTC_PER_0, WATCH_EVSYS_USER_ADC_START, &new_channel));
+  TEST_ASSERT_FALSE(new_channel);
+  TEST_ASSERT_EQUAL_INT8(1, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_TC3_OVF, WATCH_EVSYS_USER_DMAC_CH_0, &new_channel));
+  TEST_ASSERT_TRUE(new_channel);
+
+  // firing a generator reaches exactly the users routed to it
+  TEST_ASSERT_EQUAL_HEX32((1 << WATCH_EVSYS_USER_TC2_EVU) | (1 << WATCH_EVSYS_USER_ADC_START),
+                          watch_evsys_routes_users_of(&routes, WATCH_EVSYS_GEN_RTC_PER_0));
+  TEST_ASSERT_EQUAL_HEX32(1 << WATCH_EVSYS_USER_DMAC_CH_0, watch_evsys_routes_users_of(&routes, WATCH_EVSYS_GEN_TC3_OVF));
+  TEST_ASSERT_EQUAL_HEX32(0, watch_evsys_routes_users_of(&routes, WATCH_EVSYS_GEN_RTC_PER_7));
+
+  // a user listens to one generator at a time
+  TEST_ASSERT_EQUAL_INT8(-1, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_RTC_PER_7, WATCH_EVSYS_USER_TC2_EVU, &new_channel));
+  TEST_ASSERT_EQUAL_INT8(-1, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_NONE, WATCH_EVSYS_USER_TC3_EVU, &new_channel));
+
+  // the shared channel stays up until its last user goes
+  TEST_ASSERT_EQUAL_INT8(-1, watch_evsys_routes_disconnect(&routes, WATCH_EVSYS_USER_TC2_EVU));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_RTC_PER_0, routes.channel_generator[0]);
+  TEST_ASSERT_EQUAL_INT8(0, watch_evsys_routes_disconnect(&routes, WATCH_EVSYS_USER_ADC_START));
+  TEST_ASSERT_EQUAL(WATCH_EVSYS_GEN_NONE, routes.channel_generator[0]);
+  TEST_ASSERT_EQUAL_INT8(-1, watch_evsys_routes_disconnect(&routes, WATCH_EVSYS_USER_ADC_START));
+
+  // and the freed channel is the first one handed out again
+  TEST_ASSERT_EQUAL_INT8(0, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_RTC_PER_3, WATCH_EVSYS_USER_TC2_EVU, &new_channel));
+}
+
+void test_evsys_routes_run_out_of_channels() {
+  watch_evsys_routes_t routes;
+  bool new_channel;
+  watch_evsys_routes_init(&routes);
+
+  // give six users a generator each, and take the last two channels as if something else had them
+  for (uint8_t user = 0; user < WATCH_EVSYS_USER_DMAC_CH_3; user++) {
+    TEST_ASSERT_EQUAL_INT8(user, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_RTC_PER_0 + user, user, &new_channel));
+  }
+  routes.channel_generator[6] = WATCH_EVSYS_GEN_TC3_MC_0;
+  routes.channel_generator[7] = WATCH_EVSYS_GEN_ADC_RESRDY;
+
+  // a new generator has nowhere to go, but one already on a channel can still be shared
+  TEST_ASSERT_EQUAL_INT8(-1, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_TC2_OVF, WATCH_EVSYS_USER_DMAC_CH_3, &new_channel));
+  TEST_ASSERT_FALSE(new_channel);
+  TEST_ASSERT_EQUAL_INT8(7, watch_evsys_routes_connect(&routes, WATCH_EVSYS_GEN_ADC_RESRDY, WATCH_EVSYS_USER_DMAC_CH_3, &new_channel));
+  TEST_ASSERT_FALSE(new_channel);
+}
+
+// Timestamp ticks, on the simulator's model of TC2, stepped by hand in place of the host's clock
+#define TIMESTAMP_WRAP 65536  // 512 seconds
+
+void test_timestamp_counter_carries_every_512_seconds() {
+  watch_timestamp_counter_t counter;
+  watch_timestamp_counter_init(&counter);
+
+  // tick by tick across the first wrap: the count never goes backwards, before or after the handler carries
+  TEST_ASSERT_FALSE(watch_timestamp_counter_step(&counter, TIMESTAMP_WRAP - 2));
+  uint32_t last = watch_timestamp_counter_read(&counter);
+  for (uint8_t i = 0; i < 4; i++) {
+    bool interrupt = watch_timestamp_counter_step(&counter, 1);
+    TEST_ASSERT_EQUAL(last + 1 == TIMESTAMP_WRAP, interrupt);
+    TEST_ASSERT_EQUAL_UINT32(last + 1, watch_timestamp_counter_read(&counter));
+    if (interrupt) {
+      TEST_ASSERT_FALSE(watch_timestamp_counter_handle(&counter));
+      TEST_ASSERT_EQUAL_UINT32(last + 1, watch_timestamp_counter_read(&counter));
+    }
+    last++;
+  }
+  TEST_ASSERT_EQUAL_UINT16(1, counter.upper);
+
+  // a long step, as when the simulator's tab was in the background, carries every wrap in it
+  watch_timestamp_counter_step(&counter, 3 * TIMESTAMP_WRAP + 5);
+  TEST_ASSERT_EQUAL_UINT32(last + 3 * TIMESTAMP_WRAP + 5, watch_timestamp_counter_read(&counter));
+  watch_timestamp_counter_handle(&counter);
+  TEST_ASSERT_EQUAL_UINT32(last + 3 * TIMESTAMP_WRAP + 5, watch_timestamp_counter_read(&counter));
+
+  // and the whole count wraps at 2^32, like the watch's
+  counter.upper = 0xFFFF;
+  counter.count = 0xFFFF;
+  watch_timestamp_counter_step(&counter, 2);
+  TEST_ASSERT_EQUAL_UINT32(1, watch_timestamp_counter_read(&counter));
+}
+
+void test_timestamp_deadline_waits_for_the_whole_count() {
+  watch_timestamp_counter_t counter;
+  watch_timestamp_counter_init(&counter);
+
+  // a deadline more than 512 seconds off matches its lower half once on the way, and must not call back then
+  uint32_t deadline = TIMESTAMP_WRAP + 1000;
+  TEST_ASSERT_FALSE(watch_timestamp_counter_set_deadline(&counter, deadline));
+  TEST_ASSERT_EQUAL_UINT32(deadline, watch_timestamp_counter_events_to_deadline(&counter));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_step(&counter, 1000));
+  TEST_ASSERT_FALSE(watch_timestamp_counter_handle(&counter));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_step(&counter, TIMESTAMP_WRAP - 1000));
+  TEST_ASSERT_FALSE(watch_timestamp_counter_handle(&counter));
+  TEST_ASSERT_EQUAL_UINT32(1000, watch_timestamp_counter_events_to_deadline(&counter));
+
+  // one tick short, nothing; on the tick, it calls back, once
+  TEST_ASSERT_FALSE(watch_timestamp_counter_step(&counter, 999));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_step(&counter, 1));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_handle(&counter));
+  TEST_ASSERT_EQUAL_UINT32(0, watch_timestamp_counter_events_to_deadline(&counter));
+  watch_timestamp_counter_step(&counter, TIMESTAMP_WRAP);
+  TEST_ASSERT_FALSE(watch_timestamp_counter_handle(&counter));
+
+  // a step that overshoots the deadline still calls back
+  TEST_ASSERT_FALSE(watch_timestamp_counter_set_deadline(&counter, watch_timestamp_counter_read(&counter) + 10));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_step(&counter, 50));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_handle(&counter));
+
+  // a deadline that has already passed is due as soon as it's set
+  TEST_ASSERT_TRUE(watch_timestamp_counter_set_deadline(&counter, watch_timestamp_counter_read(&counter) - 1));
+  TEST_ASSERT_TRUE(watch_timestamp_counter_handle(&counter));
+
+  // and one that's cleared never calls back
+  watch_timestamp_counter_set_deadline(&counter, watch_timestamp_counter_read(&counter) + 10);
+  watch_timestamp_counter_clear_deadline(&counter);
+  TEST_ASSERT_FALSE(watch_timestamp_counter_step(&counter, 20));
+  TEST_ASSERT_FALSE(watch_timestamp_counter_handle(&counter));
+}
+
+void test_profiler_bins_fit_the_range() {
+  static watch_profiler_histogram_t histogram;
+
+  // 200 KB of flash needs bins 256 bytes wide to fit in 1024
+  watch_profiler_histogram_init(&histogram, 0x2000, 0x2000 + 200 * 1024);
+  TEST_ASSERT_EQUAL_UINT8(8, histogram.shift);
+  TEST_ASSERT_EQUAL_HEX32(0x2000, watch_profiler_histogram_bin_address(&histogram, 0));
+  TEST_ASSERT_EQUAL_HEX32(0x2000 + 1023 * 256, watch_profiler_histogram_bin_address(&histogram, 1023));
+  // exactly 2 KB fits at the narrowest, one Thumb instruction per bin
+  watch_profiler_histogram_init(&histogram, 0x2000, 0x2800);
+  TEST_ASSERT_EQUAL_UINT8(1, histogram.shift);
+  watch_profiler_histogram_init(&histogram, 0x2000, 0x2802);
+  TEST_ASSERT_EQUAL_UINT8(2, histogram.shift);
+}
+
+void test_profiler_bins_synthetic_samples() {
+  static watch_profiler_histogram_t histogram;
+  watch_profiler_histogram_init(&histogram, 0x2000, 0x2000 + 128 * 1024);
+  TEST_ASSERT_EQUAL_UINT8(7, histogram.shift);
+
+  // a hot loop from 0x4100 to 0x4110, a cooler function around 0x8000, and one each from RAM and the bootloader
+  for (uint32_t i = 0; i < 900; i++) TEST_ASSERT_TRUE(watch_profiler_histogram_add(&histogram, 0x4100 + (i % 8) * 2));
+  for (uint32_t i = 0; i < 100; i++) TEST_ASSERT_TRUE(watch_profiler_histogram_add(&histogram, 0x7ff8 + (i % 2) * 8));
+  watch_profiler_histogram_add(&histogram, 0x20000100);
+  watch_profiler_histogram_add(&histogram, 0x0100);
+
+  TEST_ASSERT_EQUAL_UINT32(1000, histogram.samples);
+  TEST_ASSERT_EQUAL_UINT32(2, histogram.outside);
+  TEST_ASSERT_EQUAL_UINT16(900, histogram.bins[(0x4100 - 0x2000) >> 7]);
+  // the cooler function straddles two bins, half its samples on either side
+  TEST_ASSERT_EQUAL_UINT16(50, histogram.bins[(0x7ff8 - 0x2000) >> 7]);
+  TEST_ASSERT_EQUAL_UINT16(50, histogram.bins[(0x8000 - 0x2000) >> 7]);
+
+  uint32_t total = 0;
+  for (uint16_t i = 0; i < WATCH_PROFILER_NUM_BINS; i++) total += histogram.bins[i];
+  TEST_ASSERT_EQUAL_UINT32(histogram.samples, total);
+}
+
+void test_profiler_stops_when_a_bin_fills() {
+  static watch_profiler_histogram_t histogram;
+  watch_profiler_histogram_init(&histogram, 0x2000, 0x4000);
+
+  for (uint32_t i = 0; i < UINT16_MAX - 1; i++) watch_profiler_histogram_add(&histogram, 0x2100);
+  TEST_ASSERT_FALSE(histogram.full);
+  TEST_ASSERT_TRUE(watch_profiler_histogram_add(&histogram, 0x2100));
+  TEST_ASSERT_TRUE(histogram.full);
+  // nothing more is taken, anywhere, so the proportions stay as they were
+  TEST_ASSERT_FALSE(watch_profiler_histogram_add(&histogram, 0x3000));
+  TEST_ASSERT_FALSE(watch_profiler_histogram_add(&histogram, 0x100));
+  TEST_ASSERT_EQUAL_UINT32(UINT16_MAX, histogram.samples);
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.outside);
+}
+
+void test_heap_counters_follow_an_allocation_script() {
+  // a face's context at boot, a file read into a buffer and freed, one that didn't fit, and a TOTP
+  // key list that grows; sizes are malloc's usable sizes, as the hardware passes them.
+  watch_heap_counters_t counters = { 0 };
+  watch_heap_counters_allocated(&counters, 60);
+  watch_heap_counters_allocated(&counters, 516);
+  watch_heap_counters_freed(&counters, 516);
+  watch_heap_counters_failed(&counters);
+  watch_heap_counters_allocated(&counters, 124);
+  // realloc to a bigger block counts as the old one freed and a new one handed out
+  watch_heap_counters_freed(&counters, 124);
+  watch_heap_counters_allocated(&counters, 252);
+
+  TEST_ASSERT_EQUAL_UINT32(312, counters.live_bytes);
+  TEST_ASSERT_EQUAL_UINT32(576, counters.peak_bytes);
+  TEST_ASSERT_EQUAL_UINT32(4, counters.allocations);
+  TEST_ASSERT_EQUAL_UINT32(2, counters.frees);
+  TEST_ASSERT_EQUAL_UINT32(1, counters.failures);
+
+  // freeing a block from before the counters started doesn't wrap around
+  watch_heap_counters_freed(&counters, 1000);
+  TEST_ASSERT_EQUAL_UINT32(0, counters.live_bytes);
+  TEST_ASSERT_EQUAL_UINT32(576, counters.peak_bytes);
+}
+
+void test_stack_high_water_finds_the_deepest_call() {
+  uint32_t stack[64];
+  uint32_t *top = stack + 64;
+
+  watch_memory_paint_stack(stack, top);
+  TEST_ASSERT_EQUAL_UINT32(0, watch_memory_stack_high_water(stack, top));
+
+  // a call 40 words deep, then a shallower one; the mark stays at the deepest
+  for (uint32_t *word = top - 40; word < top; word++) *word = 0;
+  for (uint32_t *word = top - 10; word < top; word++) *word = 0xFFFFFFFF;
+  TEST_ASSERT_EQUAL_UINT32(160, watch_memory_stack_high_water(stack, top));
+
+  // a local that happens to hold the paint value doesn't hide what's below it
+  stack[30] = WATCH_MEMORY_STACK_PAINT;
+  TEST_ASSERT_EQUAL_UINT32(160, watch_memory_stack_high_water(stack, top));
+
+  // all the way down
+  stack[0] = 0;
+  TEST_ASSERT_EQUAL_UINT32(256, watch_memory_stack_high_water(stack, top));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_write_read);
+  RUN_TEST(test_full_ring_takes_partial_writes);
+  RUN_TEST(test_wraparound);
+  RUN_TEST(test_reserve_commit);
+  RUN_TEST(test_drain_to_endpoint);
+  RUN_TEST(test_drain_in_contiguous_spans);
+  RUN_TEST(test_nvm_submit_does_not_wait);
+  RUN_TEST(test_nvm_runs_in_order);
+  RUN_TEST(test_nvm_flush_is_a_barrier);
+  RUN_TEST(test_nvm_wait_only_waits_for_its_ticket);
+  RUN_TEST(test_nvm_full_queue_waits_for_a_slot);
+  RUN_TEST(test_nvm_write_data_is_copied);
+  RUN_TEST(test_nvm_failures_are_reported);
+  RUN_TEST(test_nvm_later_failure_does_not_hide_earlier_one);
+  RUN_TEST(test_nvm_failure_outlives_its_slot);
+  RUN_TEST(test_nvm_waits_leave_failures_for_flush);
+  RUN_TEST(test_from_unix_and_to_unix_over_the_rtc_range);
+  RUN_TEST(test_from_unix_every_second_of_the_day);
+  RUN_TEST(test_from_unix_outside_the_rtc_range);
+  RUN_TEST(test_conversions_with_utc_offsets);
+  RUN_TEST(test_convert_to_unix_time_outside_the_rtc_range);
+  RUN_TEST(test_weekday_and_day_of_year_for_every_date);
+  RUN_TEST(test_add_seconds_minutes_and_days);
+  RUN_TEST(test_compare_and_diff);
+  RUN_TEST(test_sleep_modes);
+  RUN_TEST(test_usb_attached_and_idle_does_not_spin);
+  RUN_TEST(test_usb_traffic_wakes_idle);
+  RUN_TEST(test_usb_suspended_sleeps_in_standby);
+  RUN_TEST(test_performance_configs);
+  RUN_TEST(test_performance_estimates);
+  RUN_TEST(test_evsys_rtc_periodic_generators);
+  RUN_TEST(test_evsys_routes_share_channels);
+  RUN_TEST(test_evsys_routes_run_out_of_channels);
+  RUN_TEST(test_timestamp_counter_carries_every_512_seconds);
+  RUN_TEST(test_timestamp_deadline_waits_for_the_whole_count);
+  RUN_TEST(test_profiler_bins_fit_the_range);
+  RUN_TEST(test_profiler_bins_synthetic_samples);
+  RUN_TEST(test_profiler_stops_when_a_bin_fills);
+  RUN_TEST(test_heap_counters_follow_an_allocation_script);
+  RUN_TEST(test_stack_high_water_finds_the_deepest_call);
+  return UNITY_END();
+}
@@ -55,6 +55,7 @@
             - @ref uart - This section covers functions related to the UART peripheral.
             - @ref deepsleep - This section covers functions related to preparing for and entering BACKUP mode, the
                                deepest sleep mode available on the SAM L22.
+            - @ref profiler - This section covers the sampling profiler, which is only built when asked for.
  */
 
 #include "watch_app.h"
@@ -70,8 +71,12 @@
 #include "watch_uart.h"
 #include "watch_storage.h"
 #include "watch_deepsleep.h"
+#include "watch_evsys.h"
+#include "watch_profiler.h"
 
 #include "watch_private.h"
+#include "watch_private_performance.h"
+#include "watch_private_memory.h"
 
 /** @brief Returns true if either the buzzer or the LED driver is enabled.
   * @details Both the buzzer and the LED use the TCC peripheral to drive their behavior. This function returns true if that
@@ -92,6 +97,24 @@ void watch_reset_to_bootloader(void);
   */
 void cdc_task(void);
 
+/** @brief Statistics for the USB serial buffers. Sizes and fill levels are in bytes.
+  */
+typedef struct {
+    uint16_t tx_size;
+    uint16_t tx_used;
+    uint16_t tx_high_water; ///< Fullest the write buffer has been since boot.
+    uint32_t tx_stalls;     ///< Number of times a write had to wait for the host to read.
+    uint32_t tx_dropped;    ///< Bytes thrown away because the host wasn't reading.
+    uint16_t rx_size;
+    uint16_t rx_used;
+    uint16_t rx_high_water; ///< Fullest the read buffer has been since boot.
+} watch_cdc_stats_t;
+
+/** @brief Fills in statistics for the USB serial buffers.
+  * @param stats The struct to fill in.
+  */
+void watch_cdc_get_stats(watch_cdc_stats_t *stats);
+
 /** @brief Reads up to len bytes from the USB serial.
   * @param file ignored, you can pass in 0
   * @param ptr pointer to a buffer of at least len bytes
@@ -104,4 +127,68 @@ int read(int file, char *ptr, int len);
  */
 void watch_disable_TRNG();
 
+/** @brief Starts filling words from the true random number generator, without waiting for it.
+  * @details The TRNG is powered only until the last word is in. Then callback is called, from the TRNG
+  *          interrupt on hardware, so keep it short. In the simulator the words come from a seeded generator:
+  *          set Module.trngSeed before the firmware starts to get the same words on every run.
+  * @param words Where to put the words; it must stay valid until the callback.
+  * @param count How many 32-bit words to fill.
+  * @param callback Called once all the words are in; may be NULL.
+  * @return false if a fill is already running, or count is 0.
+  */
+bool watch_trng_fill(uint32_t *words, uint8_t count, ext_irq_cb_t callback);
+
+/** @brief Returns true while a fill started with watch_trng_fill is running.
+  */
+bool watch_trng_is_busy(void);
+
+/** @brief Fills words from the true random number generator, and waits for them.
+  * @details Waits for any fill started with watch_trng_fill to finish first, so don't call it from an interrupt.
+  */
+void watch_trng_read(uint32_t *words, uint8_t count);
+
+/** @brief Sets how fast the CPU runs, and at which of the power manager's performance levels.
+  * @details LOW is the cheapest way to run the CPU; HIGH runs it four times as fast, for work that would
+  *          otherwise keep the UI waiting. The sensor buses, the ADC and the buzzer and LED timer see the
+  *          same 4 MHz clock at every level, so it's safe to switch with any of them running. With USB on,
+  *          LOW runs as NORMAL, since USB needs PL2. Does nothing in the simulator except remember the level.
+  * @param level The level to switch to.
+  */
+void watch_set_performance_level(watch_performance_level_t level);
+
+/** @brief Returns the level last passed to watch_set_performance_level; NORMAL until then.
+  */
+watch_performance_level_t watch_get_performance_level(void);
+
+/** @brief Starts a microsecond counter that only runs while the CPU is awake.
+  * @details The counter stops in standby, so the difference between two readings is time spent running,
+  *          not time spent asleep. It does keep counting in the idle sleep used while USB is attached, and
+  *          runs at the same rate at every performance level. It uses TC0 and TC1 as one 32-bit counter;
+  *          their interrupts still belong to USB. In the simulator it reads the browser's clock instead.
+  */
+void watch_enable_active_time(void);
+
+/** @brief Returns the active time counter, in microseconds, or 0 if it hasn't been enabled.
+  * @details The count wraps about every 71 minutes, so subtract two readings as uint32_t.
+  */
+uint32_t watch_get_active_time(void);
+
+/** @brief How RAM is being used, in bytes. See watch_get_memory_stats.
+  */
+typedef struct {
+    uint32_t stack_size;        ///< The space set aside for the stack.
+    uint32_t stack_high_water;  ///< The most of it that has been used since the watch was reset.
+    uint32_t heap_size;         ///< RAM the heap has taken so far; it never gives any back.
+    uint32_t heap_free;         ///< RAM the heap can still grow into.
+    watch_heap_counters_t heap; ///< Blocks and bytes handed out by malloc, calloc and realloc.
+} watch_memory_stats_t;
+
+/** @brief Fills in how much stack and heap have been used.
+  * @details The stack is painted at boot, so its high water mark counts everything but interrupts that came
+  *          before main. The heap counters come from wrapping malloc and friends; what newlib allocates for
+  *          itself, like stdio's buffers, only shows up in heap_size. heap_size minus live bytes is what's lost
+  *          to fragmentation and to blocks malloc is holding on to. In the simulator, everything is zero.
+  */
+void watch_get_memory_stats(watch_memory_stats_t *stats);
+
 #endif /* WATCH_H_ */
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_EVSYS_H_INCLUDED
+#define _WATCH_EVSYS_H_INCLUDED
+////< @file watch_evsys.h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @addtogroup evsys Event System
+  * @brief This section covers functions related to the SAM L22's event system, which lets one peripheral
+  *        act on another's events without waking the CPU: the RTC's periodic events can clock a counter or
+  *        start an ADC conversion, and a counter's overflow can trigger a DMA transfer.
+  * @details A connection is made in two halves. watch_evsys_connect routes the generator's events to the
+  *          user, and turns on the generator's event output; you still have to tell the user what to do
+  *          with them, by setting the event input and action in its EVCTRL register (TC_EVCTRL_TCEI with
+  *          TC_EVCTRL_EVACT_COUNT, say, or ADC_EVCTRL_STARTEI) before you enable it. There are eight
+  *          channels; users that listen to the same generator share one. Every channel is resynchronized to
+  *          the 32.768 kHz clock and runs in standby, so events arrive while the watch sleeps.
+  */
+/// @{
+
+typedef enum {
+    WATCH_EVSYS_GEN_NONE = 0,
+    WATCH_EVSYS_GEN_RTC_PER_0,  ///< RTC periodic event, 128 Hz
+    WATCH_EVSYS_GEN_RTC_PER_1,  ///< 64 Hz
+    WATCH_EVSYS_GEN_RTC_PER_2,  ///< 32 Hz
+    WATCH_EVSYS_GEN_RTC_PER_3,  ///< 16 Hz
+    WATCH_EVSYS_GEN_RTC_PER_4,  ///< 8 Hz
+    WATCH_EVSYS_GEN_RTC_PER_5,  ///< 4 Hz
+    WATCH_EVSYS_GEN_RTC_PER_6,  ///< 2 Hz
+    WATCH_EVSYS_GEN_RTC_PER_7,  ///< 1 Hz
+    WATCH_EVSYS_GEN_TC2_OVF,
+    WATCH_EVSYS_GEN_TC2_MC_0,
+    WATCH_EVSYS_GEN_TC3_OVF,
+    WATCH_EVSYS_GEN_TC3_MC_0,
+    WATCH_EVSYS_GEN_ADC_RESRDY,
+} watch_evsys_generator_t;
+
+typedef enum {
+    WATCH_EVSYS_USER_TC2_EVU = 0,
+    WATCH_EVSYS_USER_TC3_EVU,
+    WATCH_EVSYS_USER_ADC_START,
+    WATCH_EVSYS_USER_DMAC_CH_0,
+    WATCH_EVSYS_USER_DMAC_CH_1,
+    WATCH_EVSYS_USER_DMAC_CH_2,
+    WATCH_EVSYS_USER_DMAC_CH_3,
+    WATCH_EVSYS_NUM_USERS
+} watch_evsys_user_t;
+
+/// The number of event channels on the SAM L22.
+#define WATCH_EVSYS_NUM_CHANNELS (8)
+
+/** @brief Returns the RTC periodic event that happens at the given frequency.
+  * @param frequency 1, 2, 4, 8, 16, 32, 64 or 128 Hz.
+  * @return The generator, or WATCH_EVSYS_GEN_NONE if the frequency isn't one of those.
+  */
+watch_evsys_generator_t watch_evsys_rtc_periodic_generator(uint8_t frequency);
+
+/** @brief Routes a generator's events to a user.
+  * @details A user listens to one generator at a time; to change it, disconnect it first.
+  * @return The channel the events travel on, or -1 if the user is already connected, or all eight channels
+  *         are carrying other generators.
+  */
+int8_t watch_evsys_connect(watch_evsys_generator_t generator, watch_evsys_user_t user);
+
+/** @brief Stops routing events to a user, and frees its channel if no other user shares it.
+  */
+void watch_evsys_disconnect(watch_evsys_user_t user);
+
+/** @brief Returns the generator a user is connected to, or WATCH_EVSYS_GEN_NONE. In the simulator, nothing
+  *        acts on the events, but the connections are kept just the same, so you can check your routing.
+  */
+watch_evsys_generator_t watch_evsys_get_generator(watch_evsys_user_t user);
+
+/// @}
+#endif
@@ -29,6 +29,9 @@
 /// Called by main.c while setting up the app. You should not call this from your app.
 void _watch_init(void);
 
+/// Called by main.c before anything else, to paint the unused stack for watch_get_memory_stats.
+void _watch_paint_stack(void);
+
 /// Initializes the real-time clock peripheral.
 void _watch_rtc_init(void);
 
@@ -38,19 +41,23 @@ void _watch_enable_tcc(void);
 /// Called by buzzer and LED teardown functions. You should not call this from your app.
 void _watch_disable_tcc(void);
 
-/// Enable USB task timer. Called by USB enable routine in main(). You should not call this from your app.
-void _watch_enable_tc0(void);
-
-/// Disable USB task timer. You should not call this from your app.
-void _watch_disable_tc0(void);
-
-/// Enable CDC task timer. Called by USB enable routine in main(). You should not call this from your app.
-void _watch_enable_tc1(void);
+/// Enable the USB and CDC task interrupts. Called by USB enable routine in main(). You should not call this from your app.
+void _watch_enable_usb_tasks(void);
 
-/// Disable CDC task timer. You should not call this from your app.
-void _watch_disable_tc1(void);
+/// Disable the USB and CDC task interrupts. You should not call this from your app.
+void _watch_disable_usb_tasks(void);
 
 /// Called by main.c if plugged in to USB. You should not call this from your app.
 void _watch_enable_usb(void);
 
+/// Called by main.c to decide how to sleep: true while the host has the USB bus suspended.
+bool _watch_usb_is_suspended(void);
+
+/// Waits for queued flash writes and erases to finish, leaving their errors for watch_storage_sync. Called before
+/// stopping the clocks. You should not call this from your app.
+void _watch_storage_wait_idle(void);
+
+/// Advances a playing buzzer sequence. Called from TC3's interrupt. You should not call this from your app.
+void _watch_buzzer_tc3_handler(void);
+
 #endif
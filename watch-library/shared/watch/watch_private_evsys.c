@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_private_evsys.h"
+
+watch_evsys_generator_t watch_evsys_rtc_periodic_generator(uint8_t frequency) {
+    if (frequency == 0 || __builtin_popcount(frequency) != 1) return WATCH_EVSYS_GEN_NONE;
+    // PER7 is 1 Hz, and each one below it is twice as fast, up to 128 Hz on PER0.
+    return WATCH_EVSYS_GEN_RTC_PER_7 - __builtin_ctz(frequency);
+}
+
+void watch_evsys_routes_init(watch_evsys_routes_t *routes) {
+    for (uint8_t i = 0; i < WATCH_EVSYS_NUM_CHANNELS; i++) routes->channel_generator[i] = WATCH_EVSYS_GEN_NONE;
+    for (uint8_t i = 0; i < WATCH_EVSYS_NUM_USERS; i++) routes->user_channel[i] = -1;
+}
+
+int8_t watch_evsys_routes_connect(watch_evsys_routes_t *routes, watch_evsys_generator_t generator, watch_evsys_user_t user, bool *new_channel) {
+    *new_channel = false;
+    if (generator == WATCH_EVSYS_GEN_NONE || user >= WATCH_EVSYS_NUM_USERS) return -1;
+    if (routes->user_channel[user] != -1) return -1;
+
+    int8_t free_channel = -1;
+    for (int8_t i = 0; i < WATCH_EVSYS_NUM_CHANNELS; i++) {
+        if (routes->channel_generator[i] == generator) {
+            routes->user_channel[user] = i;
+            return i;
+        }
+        if (free_channel == -1 && routes->channel_generator[i] == WATCH_EVSYS_GEN_NONE) free_channel = i;
+    }
+    if (free_channel == -1) return -1;
+
+    routes->channel_generator[free_channel] = generator;
+    routes->user_channel[user] = free_channel;
+    *new_channel = true;
+
+    return free_channel;
+}
+
+int8_t watch_evsys_routes_disconnect(watch_evsys_routes_t *routes, watch_evsys_user_t user) {
+    if (user >= WATCH_EVSYS_NUM_USERS) return -1;
+    int8_t channel = routes->user_channel[user];
+    if (channel == -1) return -1;
+
+    routes->user_channel[user] = -1;
+    for (uint8_t i = 0; i < WATCH_EVSYS_NUM_USERS; i++) {
+        if (routes->user_channel[i] == channel) return -1;
+    }
+    routes->channel_generator[channel] = WATCH_EVSYS_GEN_NONE;
+
+    return channel;
+}
+
+uint32_t watch_evsys_routes_users_of(const watch_evsys_routes_t *routes, watch_evsys_generator_t generator) {
+    uint32_t users = 0;
+    if (generator == WATCH_EVSYS_GEN_NONE) return 0;
+
+    for (uint8_t i = 0; i < WATCH_EVSYS_NUM_USERS; i++) {
+        int8_t channel = routes->user_channel[i];
+        if (channel != -1 && routes->channel_generator[channel] == generator) users |= 1ul << i;
+    }
+
+    return users;
+}
@@ -0,0 +1,52 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_EVSYS_H_INCLUDED
+#define _WATCH_PRIVATE_EVSYS_H_INCLUDED
+
+#include "watch_evsys.h"
+
+/*
+ * Which generator each event channel carries, and which channel each user listens to. The hardware
+ * and the simulator both keep one of these; only the hardware also writes it to the EVSYS registers.
+ * Users of the same generator share its channel, so eight channels go further than eight routes.
+ */
+
+typedef struct {
+    watch_evsys_generator_t channel_generator[WATCH_EVSYS_NUM_CHANNELS];  // WATCH_EVSYS_GEN_NONE if free
+    int8_t user_channel[WATCH_EVSYS_NUM_USERS];                           // -1 if not connected
+} watch_evsys_routes_t;
+
+void watch_evsys_routes_init(watch_evsys_routes_t *routes);
+
+/// Connects a user; sets *new_channel if the generator got a channel of its own, which then needs setting up.
+int8_t watch_evsys_routes_connect(watch_evsys_routes_t *routes, watch_evsys_generator_t generator, watch_evsys_user_t user, bool *new_channel);
+
+/// Disconnects a user; returns its channel if no one else listens to it any more, so it can be shut off, or -1.
+int8_t watch_evsys_routes_disconnect(watch_evsys_routes_t *routes, watch_evsys_user_t user);
+
+/// Returns the users that an event from the generator reaches, as a bit mask with bit n for user n.
+uint32_t watch_evsys_routes_users_of(const watch_evsys_routes_t *routes, watch_evsys_generator_t generator);
+
+#endif
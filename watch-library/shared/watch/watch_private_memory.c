@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_private_memory.h"
+
+void watch_heap_counters_allocated(watch_heap_counters_t *counters, size_t usable_size) {
+    counters->allocations++;
+    counters->live_bytes += usable_size;
+    if (counters->live_bytes > counters->peak_bytes) counters->peak_bytes = counters->live_bytes;
+}
+
+void watch_heap_counters_freed(watch_heap_counters_t *counters, size_t usable_size) {
+    counters->frees++;
+    // a block from before the counters started would take live_bytes below zero.
+    counters->live_bytes = (usable_size > counters->live_bytes) ? 0 : counters->live_bytes - usable_size;
+}
+
+void watch_heap_counters_failed(watch_heap_counters_t *counters) {
+    counters->failures++;
+}
+
+void watch_memory_paint_stack(uint32_t *bottom, uint32_t *top) {
+    for (uint32_t *word = bottom; word < top; word++) *word = WATCH_MEMORY_STACK_PAINT;
+}
+
+uint32_t watch_memory_stack_high_water(const uint32_t *bottom, const uint32_t *top) {
+    // the stack grows down, so the paint that's left is at the bottom, and stops where the deepest call reached.
+    const uint32_t *word = bottom;
+    while (word < top && *word == WATCH_MEMORY_STACK_PAINT) word++;
+
+    return (uint32_t)((top - word) * sizeof(uint32_t));
+}
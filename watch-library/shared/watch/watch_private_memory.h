@@ -0,0 +1,65 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_MEMORY_H_INCLUDED
+#define _WATCH_PRIVATE_MEMORY_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bookkeeping for the memory diagnostics. The hardware wraps malloc, calloc, realloc and free, and
+ * hands each block's usable size here as it comes and goes; it also paints the unused stack at boot
+ * and later looks for how far down the paint has been worn away. Nothing here touches the hardware,
+ * so the host tests can run an allocation script through it.
+ */
+
+/// What unused stack is painted with. Not zero, and not a valid address, so it's unlikely to be written by chance.
+#define WATCH_MEMORY_STACK_PAINT 0xC5C5C5C5
+
+typedef struct {
+    uint32_t live_bytes;    // allocated and not freed yet, counting what malloc rounded up
+    uint32_t peak_bytes;    // the most that live_bytes has been
+    uint32_t allocations;   // blocks handed out
+    uint32_t frees;         // blocks given back
+    uint32_t failures;      // requests that got NULL
+} watch_heap_counters_t;
+
+/// Counts a block of usable_size bytes handed out.
+void watch_heap_counters_allocated(watch_heap_counters_t *counters, size_t usable_size);
+
+/// Counts a block of usable_size bytes given back.
+void watch_heap_counters_freed(watch_heap_counters_t *counters, size_t usable_size);
+
+/// Counts a request that couldn't be met.
+void watch_heap_counters_failed(watch_heap_counters_t *counters);
+
+/// Paints the words from bottom up to, but not including, top.
+void watch_memory_paint_stack(uint32_t *bottom, uint32_t *top);
+
+/// Returns how many bytes of the stack from bottom to top have ever been used: everything above the
+/// last of the paint at the bottom.
+uint32_t watch_memory_stack_high_water(const uint32_t *bottom, const uint32_t *top);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "watch_private_nvm_queue.h"
+
+static inline watch_nvm_op_t *_slot(watch_nvm_queue_t *queue, uint32_t ticket) {
+    return &queue->ops[ticket % WATCH_NVM_QUEUE_DEPTH];
+}
+
+static void _wait_until_done(watch_nvm_queue_t *queue, uint32_t ticket) {
+    const watch_nvm_backend_t *backend = queue->backend;
+
+    while (true) {
+        // check and idle with the interrupt masked, so the completion can't slip in between the
+        // check and the idle; a pending interrupt still ends the idle.
+        backend->enter_critical();
+        bool done = watch_nvm_queue_is_done(queue, ticket);
+        if (!done) backend->idle();
+        backend->exit_critical();
+        if (done) return;
+    }
+}
+
+void watch_nvm_queue_init(watch_nvm_queue_t *queue, const watch_nvm_backend_t *backend) {
+    memset(queue, 0, sizeof(watch_nvm_queue_t));
+    queue->backend = backend;
+}
+
+uint32_t watch_nvm_queue_submit(watch_nvm_queue_t *queue, const watch_nvm_op_t *op) {
+    const watch_nvm_backend_t *backend = queue->backend;
+    uint32_t ticket = queue->submitted + 1;
+
+    // a full queue has to give up its oldest slot first
+    if (ticket - queue->completed > WATCH_NVM_QUEUE_DEPTH) {
+        _wait_until_done(queue, ticket - WATCH_NVM_QUEUE_DEPTH);
+    }
+
+    watch_nvm_op_t *slot = _slot(queue, ticket);
+    slot->type = op->type;
+    slot->row = op->row;
+    slot->offset = op->offset;
+    slot->size = op->size;
+    if (op->type == WATCH_NVM_OP_WRITE) memcpy(slot->data, op->data, op->size);
+    queue->op_failed[ticket % WATCH_NVM_QUEUE_DEPTH] = false;
+
+    backend->enter_critical();
+    bool was_idle = watch_nvm_queue_is_idle(queue);
+    queue->submitted = ticket;
+    if (was_idle) backend->start(slot);
+    backend->exit_critical();
+
+    return ticket;
+}
+
+void watch_nvm_queue_complete(watch_nvm_queue_t *queue, bool ok) {
+    if (watch_nvm_queue_is_idle(queue)) return;
+
+    uint32_t ticket = queue->completed + 1;
+    if (!ok) {
+        queue->op_failed[ticket % WATCH_NVM_QUEUE_DEPTH] = true;
+        if (queue->first_failed == 0) queue->first_failed = ticket;
+    }
+    queue->completed = ticket;
+
+    if (!watch_nvm_queue_is_idle(queue)) queue->backend->start(_slot(queue, ticket + 1));
+}
+
+bool watch_nvm_queue_wait(watch_nvm_queue_t *queue, uint32_t ticket) {
+    _wait_until_done(queue, ticket);
+
+    if (queue->submitted - ticket < WATCH_NVM_QUEUE_DEPTH) return !queue->op_failed[ticket % WATCH_NVM_QUEUE_DEPTH];
+
+    // its slot has been reused; all we still know is whether anything up to it failed
+    return queue->first_failed == 0 || (int32_t)(ticket - queue->first_failed) < 0;
+}
+
+bool watch_nvm_queue_flush(watch_nvm_queue_t *queue) {
+    _wait_until_done(queue, queue->submitted);
+
+    // the queue is idle now, so nothing can fail behind our back
+    bool ok = queue->first_failed == 0;
+    queue->first_failed = 0;
+
+    return ok;
+}
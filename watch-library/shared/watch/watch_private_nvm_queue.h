@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_NVM_QUEUE_H_INCLUDED
+#define _WATCH_PRIVATE_NVM_QUEUE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Queue of RWWEE erase and page write operations, completed from the NVM controller's READY
+ * interrupt, so that the CPU can idle while a row erase or page write is in progress instead of
+ * spinning on the READY bit.
+ *
+ * Operations run strictly in submission order. Each submission gets a ticket; the caller can
+ * wait for that ticket (which covers everything submitted before it too), or for the whole
+ * queue to drain. Write data is copied into the queue, so the caller's buffer is free as soon as
+ * submit returns. If the queue is full, submit waits for a slot.
+ *
+ * Failures are kept two ways: per operation, for as long as its slot isn't reused, so waiting
+ * on a ticket reports that operation's own result; and as the oldest failure since the last
+ * flush, which only flush clears, so an async failure stays visible until someone asks for it.
+ *
+ * The queue itself knows nothing about the hardware. A backend starts operations, masks the
+ * completion interrupt around the queue's bookkeeping, and idles until an interrupt is pending;
+ * the hardware backend lives in watch_storage.c, and the host tests supply one that emulates
+ * the NVM controller's timing.
+ */
+
+#define WATCH_NVM_QUEUE_DEPTH 4
+#define WATCH_NVM_QUEUE_MAX_WRITE 64
+
+typedef enum {
+    WATCH_NVM_OP_ERASE = 0,
+    WATCH_NVM_OP_WRITE,
+} watch_nvm_op_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t size;
+    uint16_t offset;
+    uint32_t row;
+    uint8_t data[WATCH_NVM_QUEUE_MAX_WRITE];
+} watch_nvm_op_t;
+
+typedef struct {
+    /// Issues op to the NVM controller; completion is signalled by calling watch_nvm_queue_complete.
+    void (*start)(const watch_nvm_op_t *op);
+    /// Masks the completion interrupt.
+    void (*enter_critical)(void);
+    /// Unmasks the completion interrupt.
+    void (*exit_critical)(void);
+    /// Called with the completion interrupt masked; returns once an interrupt is pending (or has been handled),
+    /// even though it is masked. The pending completion is then delivered by exit_critical.
+    void (*idle)(void);
+} watch_nvm_backend_t;
+
+typedef struct {
+    const watch_nvm_backend_t *backend;
+    watch_nvm_op_t ops[WATCH_NVM_QUEUE_DEPTH];
+    volatile bool op_failed[WATCH_NVM_QUEUE_DEPTH];  // result of the operation in each slot, once it has completed
+    uint32_t submitted;             // ticket of the most recent submission
+    volatile uint32_t completed;    // ticket of the most recent completion
+    volatile uint32_t first_failed; // ticket of the oldest operation that failed since the last flush, or 0
+} watch_nvm_queue_t;
+
+void watch_nvm_queue_init(watch_nvm_queue_t *queue, const watch_nvm_backend_t *backend);
+
+/// Queues an operation and returns its ticket. Starts it right away if the controller is idle.
+uint32_t watch_nvm_queue_submit(watch_nvm_queue_t *queue, const watch_nvm_op_t *op);
+
+/// From the completion interrupt: retires the running operation and starts the next one, if any.
+void watch_nvm_queue_complete(watch_nvm_queue_t *queue, bool ok);
+
+static inline bool watch_nvm_queue_is_idle(const watch_nvm_queue_t *queue) {
+    return queue->completed == queue->submitted;
+}
+
+static inline bool watch_nvm_queue_is_done(const watch_nvm_queue_t *queue, uint32_t ticket) {
+    return (int32_t)(queue->completed - ticket) >= 0;
+}
+
+/// Idles until the operation with this ticket has completed. Returns false if it failed. Once
+/// WATCH_NVM_QUEUE_DEPTH later operations have reused its slot, returns false if it or anything
+/// before it failed since the last flush. Doesn't clear anything.
+bool watch_nvm_queue_wait(watch_nvm_queue_t *queue, uint32_t ticket);
+
+/// Idles until the queue is empty. Returns false if any operation failed since the last flush,
+/// and starts over.
+bool watch_nvm_queue_flush(watch_nvm_queue_t *queue);
+
+#endif
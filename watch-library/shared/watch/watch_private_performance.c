@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_private_performance.h"
+
+// Typical current drawn from the battery while running code from flash, in microamps per MHz of
+// CPU clock, oscillator included; plus what the awake chip draws whatever its speed, and what the
+// whole watch draws in STANDBY with the display on.
+#define WATCH_PERFORMANCE_UA_PER_MHZ_PL0 40
+#define WATCH_PERFORMANCE_UA_PER_MHZ_PL2 55
+#define WATCH_PERFORMANCE_ACTIVE_BASE_UA 20
+#define WATCH_PERFORMANCE_STANDBY_UA 5
+#define WATCH_PERFORMANCE_BATTERY_MV 3000
+// Extra cycles per flash wait state, in percent.
+#define WATCH_PERFORMANCE_WAIT_STATE_PERCENT 15
+
+watch_performance_config_t watch_performance_config_for(watch_performance_level_t level, bool usb_enabled) {
+    watch_performance_config_t config;
+
+    switch (level) {
+        case WATCH_PERFORMANCE_LOW:
+            config.cpu_mhz = 4;
+            config.power_level = 0;
+            break;
+        case WATCH_PERFORMANCE_HIGH:
+            config.cpu_mhz = 16;
+            config.power_level = 2;
+            break;
+        case WATCH_PERFORMANCE_NORMAL:
+        default:
+            config.cpu_mhz = 4;
+            config.power_level = 2;
+            break;
+    }
+    if (usb_enabled) {
+        // the DFLL that USB runs from doesn't run at PL0, and the USB stack wants a faster CPU.
+        config.power_level = 2;
+        if (config.cpu_mhz < 8) config.cpu_mhz = 8;
+    }
+    // the flash manages 8 MHz without waiting at either level; any faster and it needs a cycle.
+    config.flash_wait_states = config.cpu_mhz > 8 ? 1 : 0;
+    config.peripheral_div = config.cpu_mhz / 4;
+
+    return config;
+}
+
+watch_performance_estimate_t watch_performance_estimate(watch_performance_config_t config, uint32_t cycles, uint32_t window_us) {
+    watch_performance_estimate_t estimate;
+    uint64_t effective_cycles = (uint64_t)cycles * (100 + WATCH_PERFORMANCE_WAIT_STATE_PERCENT * config.flash_wait_states) / 100;
+    uint64_t active_us = (effective_cycles + config.cpu_mhz - 1) / config.cpu_mhz;
+    uint32_t ua_per_mhz = config.power_level ? WATCH_PERFORMANCE_UA_PER_MHZ_PL2 : WATCH_PERFORMANCE_UA_PER_MHZ_PL0;
+    uint64_t active_ua = WATCH_PERFORMANCE_ACTIVE_BASE_UA + (uint64_t)ua_per_mhz * config.cpu_mhz;
+
+    // microamps times microseconds is picocoulombs; times millivolts, femtojoules.
+    uint64_t energy_fj = active_ua * active_us * WATCH_PERFORMANCE_BATTERY_MV;
+    if (window_us > active_us) energy_fj += (uint64_t)WATCH_PERFORMANCE_STANDBY_UA * (window_us - active_us) * WATCH_PERFORMANCE_BATTERY_MV;
+
+    estimate.active_us = active_us > UINT32_MAX ? UINT32_MAX : (uint32_t)active_us;
+    estimate.energy_nj = energy_fj / 1000000 > UINT32_MAX ? UINT32_MAX : (uint32_t)(energy_fj / 1000000);
+
+    return estimate;
+}
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_PERFORMANCE_H_INCLUDED
+#define _WATCH_PRIVATE_PERFORMANCE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Performance levels: how fast the CPU runs, and at which of the power manager's performance
+ * levels. PL0 runs the core at a lower voltage, but caps the clock and can't run the DFLL that
+ * USB needs; PL2 can run anything. The CPU runs from OSC16M, and the peripherals that used to
+ * share its clock (the sensor buses, the ADC, and the buzzer and LED timer) now run from GCLK2,
+ * which divides OSC16M back down so that they see 4 MHz at every level.
+ *
+ * Which settings a level gets, and what running some number of cycles at it costs, know nothing
+ * about the hardware, so the host tests can compare the levels without a watch to measure.
+ */
+
+typedef enum {
+    WATCH_PERFORMANCE_LOW = 0,  // 4 MHz at PL0; the lowest power the CPU can run at
+    WATCH_PERFORMANCE_NORMAL,   // 4 MHz at PL2, as the watch has always run (8 MHz with USB on)
+    WATCH_PERFORMANCE_HIGH,     // 16 MHz at PL2, for computations that would otherwise lock up the UI
+} watch_performance_level_t;
+
+typedef struct {
+    uint8_t cpu_mhz;            // OSC16M frequency, which is also the CPU clock: 4, 8, 12 or 16
+    uint8_t power_level;        // PM PLCFG.PLSEL: 0 for PL0, 2 for PL2
+    uint8_t flash_wait_states;  // NVMCTRL CTRLB.RWS
+    uint8_t peripheral_div;     // GCLK2 divider that brings OSC16M back down to 4 MHz
+} watch_performance_config_t;
+
+/// What one run of some work cost: how long the CPU was awake, and the energy drawn from the battery.
+typedef struct {
+    uint32_t active_us;
+    uint32_t energy_nj;
+} watch_performance_estimate_t;
+
+/// Picks the settings for a level. USB needs PL2 and at least 8 MHz, so it raises LOW and NORMAL.
+watch_performance_config_t watch_performance_config_for(watch_performance_level_t level, bool usb_enabled);
+
+/** Estimates what running some number of CPU cycles at the given settings costs, from typical
+  * figures in the SAM L22 datasheet; these are a model for comparing levels, not a measurement.
+  * A wait state costs a share of extra cycles, since not every instruction fetch waits on flash.
+  * If window_us is longer than the work takes, the rest of the window is spent in STANDBY, which
+  * is how a face that hurries up and goes back to sleep comes out against one that takes its time.
+  */
+watch_performance_estimate_t watch_performance_estimate(watch_performance_config_t config, uint32_t cycles, uint32_t window_us);
+
+#endif
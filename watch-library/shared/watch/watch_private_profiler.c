@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "watch_private_profiler.h"
+
+void watch_profiler_histogram_init(watch_profiler_histogram_t *histogram, uint32_t start, uint32_t end) {
+    memset(histogram, 0, sizeof(watch_profiler_histogram_t));
+    histogram->base = start;
+    // Thumb instructions are two bytes, so there's no point in bins narrower than that.
+    histogram->shift = 1;
+    while (end > start && ((end - start - 1) >> histogram->shift) >= WATCH_PROFILER_NUM_BINS) histogram->shift++;
+}
+
+bool watch_profiler_histogram_add(watch_profiler_histogram_t *histogram, uint32_t pc) {
+    if (histogram->full) return false;
+
+    uint32_t bin = (pc - histogram->base) >> histogram->shift;
+    if (pc < histogram->base || bin >= WATCH_PROFILER_NUM_BINS) {
+        histogram->outside++;
+        return true;
+    }
+
+    histogram->samples++;
+    if (++histogram->bins[bin] == UINT16_MAX) histogram->full = true;
+
+    return true;
+}
+
+uint32_t watch_profiler_histogram_bin_address(const watch_profiler_histogram_t *histogram, uint16_t bin) {
+    return histogram->base + ((uint32_t)bin << histogram->shift);
+}
@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_PROFILER_H_INCLUDED
+#define _WATCH_PRIVATE_PROFILER_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The profiler's histogram: program counter samples, binned by address. The bins cover a range of
+ * flash evenly, each one a power of two bytes wide, as narrow as the range allows. Samples from
+ * outside the range (code running from RAM, or the bootloader) are only counted. Once a bin is
+ * full, the histogram stops taking samples, so the proportions it holds stay right.
+ */
+
+#ifndef WATCH_PROFILER_NUM_BINS
+#define WATCH_PROFILER_NUM_BINS 1024
+#endif
+
+typedef struct {
+    uint32_t base;          // address of the start of the first bin
+    uint8_t shift;          // each bin is 1 << shift bytes wide
+    bool full;              // a bin reached UINT16_MAX, and no more samples were taken
+    uint32_t samples;       // samples binned
+    uint32_t outside;       // samples outside the bins
+    uint16_t bins[WATCH_PROFILER_NUM_BINS];
+} watch_profiler_histogram_t;
+
+/// Empties the histogram, and spreads its bins over the addresses from start up to end.
+void watch_profiler_histogram_init(watch_profiler_histogram_t *histogram, uint32_t start, uint32_t end);
+
+/// Bins one sample; returns false if the histogram is full, and the sample wasn't taken.
+bool watch_profiler_histogram_add(watch_profiler_histogram_t *histogram, uint32_t pc);
+
+/// Returns the address of the start of a bin.
+uint32_t watch_profiler_histogram_bin_address(const watch_profiler_histogram_t *histogram, uint16_t bin);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "watch_private_ring.h"
+
+// The data must be in place before the index that publishes it moves, and must be read before the
+// index that frees it moves. Single core, so keeping the compiler from reordering is all it takes.
+#define WATCH_RING_BARRIER() __asm__ volatile ("" ::: "memory")
+
+void watch_ring_init(watch_ring_t *ring, uint8_t *buf, uint16_t size) {
+    ring->buf = buf;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->high_water = 0;
+}
+
+static void _watch_ring_published(watch_ring_t *ring) {
+    uint16_t used = watch_ring_used(ring);
+    if (used > ring->high_water) ring->high_water = used;
+}
+
+uint16_t watch_ring_write(watch_ring_t *ring, const void *data, uint16_t len) {
+    const uint8_t *src = data;
+    uint16_t available = watch_ring_free(ring);
+    if (len > available) len = available;
+    if (len == 0) return 0;
+
+    uint16_t pos = ring->head & (ring->size - 1);
+    uint16_t first = ring->size - pos;
+    if (first > len) first = len;
+    memcpy(ring->buf + pos, src, first);
+    memcpy(ring->buf, src + first, len - first);
+
+    WATCH_RING_BARRIER();
+    ring->head += len;
+    _watch_ring_published(ring);
+
+    return len;
+}
+
+uint16_t watch_ring_reserve(watch_ring_t *ring, uint8_t **ptr) {
+    uint16_t pos = ring->head & (ring->size - 1);
+    uint16_t available = watch_ring_free(ring);
+    uint16_t span = ring->size - pos;
+    *ptr = ring->buf + pos;
+    return span < available ? span : available;
+}
+
+void watch_ring_commit(watch_ring_t *ring, uint16_t len) {
+    WATCH_RING_BARRIER();
+    ring->head += len;
+    _watch_ring_published(ring);
+}
+
+uint16_t watch_ring_read(watch_ring_t *ring, void *data, uint16_t len) {
+    uint8_t *dst = data;
+    uint16_t used = watch_ring_used(ring);
+    if (len > used) len = used;
+    if (len == 0) return 0;
+
+    WATCH_RING_BARRIER();
+    uint16_t pos = ring->tail & (ring->size - 1);
+    uint16_t first = ring->size - pos;
+    if (first > len) first = len;
+    memcpy(dst, ring->buf + pos, first);
+    memcpy(dst + first, ring->buf, len - first);
+
+    WATCH_RING_BARRIER();
+    ring->tail += len;
+
+    return len;
+}
+
+uint16_t watch_ring_peek(watch_ring_t *ring, const uint8_t **ptr) {
+    uint16_t used = watch_ring_used(ring);
+    uint16_t pos = ring->tail & (ring->size - 1);
+    uint16_t span = ring->size - pos;
+    WATCH_RING_BARRIER();
+    *ptr = ring->buf + pos;
+    return span < used ? span : used;
+}
+
+void watch_ring_consume(watch_ring_t *ring, uint16_t len) {
+    WATCH_RING_BARRIER();
+    ring->tail += len;
+}
+
+uint16_t watch_ring_drain(watch_ring_t *ring, watch_ring_sink_t sink, void *context) {
+    uint16_t total = 0;
+    const uint8_t *ptr;
+    uint16_t span;
+
+    while ((span = watch_ring_peek(ring, &ptr)) > 0) {
+        uint16_t taken = sink(ptr, span, context);
+        watch_ring_consume(ring, taken);
+        total += taken;
+        if (taken < span) break;
+    }
+
+    return total;
+}
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _WATCH_PRIVATE_RING_H_INCLUDED
+#define _WATCH_PRIVATE_RING_H_INCLUDED
+
+#include <stdint.h>
+
+/*
+ * Single-producer, single-consumer byte ring, used for the USB CDC buffers.
+ *
+ * head only ever moves in the producer and tail only ever moves in the consumer, so one side
+ * can live in an interrupt and the other in the main loop without masking anything. Both are
+ * free-running counters; the size must be a power of two, at most 32768, so that head - tail
+ * is the fill level even across wraparound.
+ *
+ * Data goes in and out with at most two memcpys, and the peek/consume and reserve/commit pairs
+ * give direct access to the contiguous span at either end so that callers can hand it straight
+ * to a bulk transfer without copying.
+ */
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t size;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    uint16_t high_water;
+} watch_ring_t;
+
+/// A sink for watch_ring_drain: accepts up to len bytes, returns how many it took.
+typedef uint16_t (*watch_ring_sink_t)(const uint8_t *data, uint16_t len, void *context);
+
+void watch_ring_init(watch_ring_t *ring, uint8_t *buf, uint16_t size);
+
+static inline uint16_t watch_ring_used(const watch_ring_t *ring) {
+    return (uint16_t)(ring->head - ring->tail);
+}
+
+static inline uint16_t watch_ring_free(const watch_ring_t *ring) {
+    return ring->size - watch_ring_used(ring);
+}
+
+/// Producer: copies in as much of data as fits and returns the number of bytes taken.
+uint16_t watch_ring_write(watch_ring_t *ring, const void *data, uint16_t len);
+
+/// Producer: returns the length of the contiguous free span at the head, and points *ptr at it.
+uint16_t watch_ring_reserve(watch_ring_t *ring, uint8_t **ptr);
+
+/// Producer: publishes len bytes written into the span returned by watch_ring_reserve.
+void watch_ring_commit(watch_ring_t *ring, uint16_t len);
+
+/// Consumer: copies out up to len bytes and returns the number of bytes read.
+uint16_t watch_ring_read(watch_ring_t *ring, void *data, uint16_t len);
+
+/// Consumer: returns the length of the contiguous readable span at the tail, and points *ptr at it.
+uint16_t watch_ring_peek(watch_ring_t *ring, const uint8_t **ptr);
+
+/// Consumer: releases len bytes read through watch_ring_peek.
+void watch_ring_consume(watch_ring_t *ring, uint16_t len);
+
+/// Consumer: feeds contiguous spans to sink until the ring is empty or the sink stops taking data.
+/// Returns the number of bytes drained.
+uint16_t watch_ring_drain(watch_ring_t *ring, watch_ring_sink_t sink, void *context);
+
+#endif
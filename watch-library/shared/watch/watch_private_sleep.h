@@ -0,0 +1,51 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_SLEEP_H_INCLUDED
+#define _WATCH_PRIVATE_SLEEP_H_INCLUDED
+
+#include <stdbool.h>
+
+/*
+ * How main() sleeps between trips through app_loop.
+ *
+ * With USB off, an app that can sleep goes to STANDBY, as it always has. With USB on, STANDBY
+ * would stop the clocks USB runs on, so the CPU sleeps in IDLE instead: USB keeps running, and
+ * its interrupt, or any other, wakes the CPU. Once the host suspends the bus, nothing is coming
+ * over USB until it resumes, and the resume signalling can wake the watch from STANDBY.
+ *
+ * The choice knows nothing about the hardware, so the host tests can run the main loop against
+ * a model of the interrupts and count how often it goes around.
+ */
+
+typedef enum {
+    WATCH_SLEEP_NONE = 0,   // go around the loop again right away
+    WATCH_SLEEP_IDLE,       // stop the CPU until the next interrupt, leaving clocks and peripherals running
+    WATCH_SLEEP_STANDBY,    // prepare for standby, and stop everything that doesn't run in standby
+} watch_sleep_mode_t;
+
+/// Picks the sleep mode from what app_loop returned and the state of the USB peripheral.
+watch_sleep_mode_t watch_sleep_mode_for(bool can_sleep, bool usb_enabled, bool usb_suspended);
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_private_timestamp.h"
+
+void watch_timestamp_counter_init(watch_timestamp_counter_t *counter) {
+    counter->count = 0;
+    counter->upper = 0;
+    counter->overflowed = false;
+    counter->compare_matched = false;
+    counter->armed = false;
+    counter->deadline = 0;
+}
+
+bool watch_timestamp_counter_step(watch_timestamp_counter_t *counter, uint32_t events) {
+    bool interrupt = false;
+
+    while (events) {
+        // jump straight to whichever comes first: the wrap, the compare, or the end of the step
+        uint32_t to_wrap = 0x10000 - counter->count;
+        uint32_t to_compare = (uint16_t)((uint16_t)counter->deadline - counter->count);
+        if (to_compare == 0) to_compare = 0x10000;
+        uint32_t step = events;
+        if (step > to_wrap) step = to_wrap;
+        if (step > to_compare) step = to_compare;
+
+        counter->count += step;
+        events -= step;
+        if (step == to_wrap) {
+            // on the watch, the handler would have carried the last wrap long before this one
+            if (counter->overflowed) counter->upper++;
+            counter->overflowed = true;
+            interrupt = true;
+        }
+        if (step == to_compare) {
+            counter->compare_matched = true;
+            interrupt = interrupt || counter->armed;
+        }
+    }
+
+    return interrupt;
+}
+
+uint32_t watch_timestamp_counter_read(const watch_timestamp_counter_t *counter) {
+    uint16_t upper = counter->upper;
+    if (counter->overflowed) upper++;
+    return ((uint32_t)upper << 16) | counter->count;
+}
+
+bool watch_timestamp_counter_set_deadline(watch_timestamp_counter_t *counter, uint32_t ticks) {
+    counter->deadline = ticks;
+    counter->compare_matched = false;
+    counter->armed = true;
+    // if the deadline passed while we were setting it, the compare won't match for another 512 seconds.
+    return (int32_t)(watch_timestamp_counter_read(counter) - ticks) >= 0;
+}
+
+void watch_timestamp_counter_clear_deadline(watch_timestamp_counter_t *counter) {
+    counter->armed = false;
+}
+
+bool watch_timestamp_counter_handle(watch_timestamp_counter_t *counter) {
+    if (counter->overflowed) {
+        counter->upper++;
+        counter->overflowed = false;
+    }
+    counter->compare_matched = false;
+    // the compare matches the lower half only, so check the whole count before calling back.
+    if (counter->armed && (int32_t)(watch_timestamp_counter_read(counter) - counter->deadline) >= 0) {
+        counter->armed = false;
+        return true;
+    }
+    return false;
+}
+
+uint32_t watch_timestamp_counter_events_to_deadline(const watch_timestamp_counter_t *counter) {
+    if (!counter->armed) return 0;
+    int32_t remaining = counter->deadline - watch_timestamp_counter_read(counter);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PRIVATE_TIMESTAMP_H_INCLUDED
+#define _WATCH_PRIVATE_TIMESTAMP_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The simulator's stand-in for TC2, which counts timestamp ticks on the watch (see watch_rtc.c).
+ *
+ * Like TC2, it has a 16-bit counter that wraps every 512 seconds and raises an overflow that the
+ * interrupt handler carries into the upper half, and a compare on the lower half that calls back
+ * at a deadline once the whole count has reached it. Reads and the handler follow the hardware
+ * driver step for step. Instead of the RTC's 128 Hz event, time moves when the owner steps the
+ * counter: the simulator steps it from the browser's clock, and the host tests step it by hand.
+ */
+
+typedef struct {
+    uint16_t count;         // TC2's COUNT
+    uint16_t upper;         // the carried overflows; _timestamp_upper on the watch
+    bool overflowed;        // INTFLAG.OVF: the counter wrapped, and the handler hasn't carried it yet
+    bool compare_matched;   // INTFLAG.MC0: the counter passed the deadline's lower half
+    bool armed;             // INTEN.MC0: there's a deadline to call back at
+    uint32_t deadline;
+} watch_timestamp_counter_t;
+
+/// Resets the counter to zero, with no deadline.
+void watch_timestamp_counter_init(watch_timestamp_counter_t *counter);
+
+/// Counts some 128 Hz events. Returns true if the counter raised an interrupt, and its handler is due.
+bool watch_timestamp_counter_step(watch_timestamp_counter_t *counter, uint32_t events);
+
+/// Reads the whole count, as watch_rtc_get_timestamp_ticks does: a pending overflow counts as carried.
+uint32_t watch_timestamp_counter_read(const watch_timestamp_counter_t *counter);
+
+/// Arms the deadline. Returns true if it has already passed, and the handler is due now.
+bool watch_timestamp_counter_set_deadline(watch_timestamp_counter_t *counter, uint32_t ticks);
+
+/// Disarms the deadline, if there is one.
+void watch_timestamp_counter_clear_deadline(watch_timestamp_counter_t *counter);
+
+/// The interrupt handler: carries an overflow, and returns true, disarming it, if the deadline has come.
+bool watch_timestamp_counter_handle(watch_timestamp_counter_t *counter);
+
+/// How many events until the deadline, or 0 if there's none or it has passed.
+uint32_t watch_timestamp_counter_events_to_deadline(const watch_timestamp_counter_t *counter);
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _WATCH_PROFILER_H_INCLUDED
+#define _WATCH_PROFILER_H_INCLUDED
+////< @file watch_profiler.h
+
+#ifdef WATCH_PROFILER
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "watch_private_profiler.h"
+
+/** @addtogroup profiler Profiler
+  * @brief This section covers the sampling profiler, which shows where the CPU spends its time. It is only
+  *        built when you pass PROFILER=1 to make; otherwise none of these functions exist.
+  * @details While the profiler runs, TC3 interrupts at a steady rate, and each interrupt bins the address
+  *          the CPU was at into a histogram in RAM. The timer stops in standby, so samples are only taken
+  *          while the watch is awake, and the histogram shows what the CPU is doing when it runs, not how
+  *          much it sleeps. The "prof" shell command starts and stops the profiler and prints the histogram,
+  *          and utils/profiler/symbolize.py turns what it printed into function names using the ELF file.
+  *          TC3 also plays buzzer sequences; starting one stops the profiler, and the profiler won't start
+  *          while one is playing. The simulator has no program counter to sample, so there it never starts.
+  */
+/// @{
+
+/** @brief Empties the histogram and starts sampling.
+  * @param frequency Samples per second, from 1 to 16384. A few hundred to a few thousand are good rates;
+  *                  a full bin stops sampling, and that comes sooner at higher rates.
+  * @return false if the frequency is out of range, or a buzzer sequence is using TC3.
+  */
+bool watch_profiler_start(uint16_t frequency);
+
+/// @brief Stops sampling; the histogram keeps what it has until the next start.
+void watch_profiler_stop(void);
+
+/// @brief Returns true if the profiler is taking samples.
+bool watch_profiler_is_running(void);
+
+/// @brief Returns the histogram, for printing.
+const watch_profiler_histogram_t *watch_profiler_get_histogram(void);
+
+/// @}
+#endif // WATCH_PROFILER
+
+#endif
@@ -41,6 +41,9 @@
 
 #define WATCH_RTC_REFERENCE_YEAR (2020)
 
+/// The rate of watch_rtc_get_timestamp_ticks, in ticks per second.
+#define WATCH_RTC_TIMESTAMP_TICKS_PER_SECOND (128)
+
 typedef union {
     struct {
         uint32_t second : 6;    // 0-59
@@ -81,6 +84,61 @@ void watch_rtc_set_date_time(watch_date_time date_time);
   */
 watch_date_time watch_rtc_get_date_time(void);
 
+/** @brief Returns the date and time like watch_rtc_get_date_time, but reads the RTC at most once between two
+  *        RTC interrupts.
+  * @details Reading the RTC means waiting for its registers to synchronize. Every RTC interrupt (ticks, the
+  *          alarm, the RTC-driven wake pins) refreshes a saved copy of the time: on the watch, the interrupt
+  *          handler reads the RTC before calling back, so calls just return the copy until the next interrupt.
+  *          (The simulator, where reads cost nothing, leaves the read to the first call after the interrupt.)
+  *          Code woken by an RTC interrupt can call this as often as it likes for the cost of one read.
+  *          Between interrupts the copy does not advance, so after a wait, or when you will write the time
+  *          back with watch_rtc_set_date_time, use watch_rtc_get_date_time.
+  */
+watch_date_time watch_rtc_get_cached_date_time(void);
+
+/// Returns how many times the RTC has been read with a sync by watch_rtc_get_date_time, or by a cached read that
+/// found its copy stale. The interrupt handler's own refresh doesn't count.
+uint32_t watch_rtc_get_uncached_read_count(void);
+
+/** @brief Starts counting timestamp ticks, if nobody else has already.
+  * @details Calls nest: the counter keeps running until watch_rtc_disable_timestamp_ticks has been called as
+  *          many times as this function. It runs in standby, and wakes the watch once every 512 seconds to
+  *          carry its upper half. Timestamp ticks use TC2, which counts the RTC's 128 Hz periodic event over an
+  *          event system channel; while they run, TC2 is not available to you.
+  */
+void watch_rtc_enable_timestamp_ticks(void);
+
+/** @brief Stops counting timestamp ticks, once every caller of watch_rtc_enable_timestamp_ticks is done.
+  */
+void watch_rtc_disable_timestamp_ticks(void);
+
+/// Returns true if anyone has the timestamp ticks counting. The counter stops in backup mode.
+bool watch_rtc_timestamp_ticks_enabled(void);
+
+/** @brief Returns a count that advances WATCH_RTC_TIMESTAMP_TICKS_PER_SECOND times a second.
+  * @details The count says nothing about the time of day, and starts over each time the counter is started; only
+  *          the difference between two readings means anything. It wraps after 388 days, which unsigned subtraction
+  *          takes care of. Where you would otherwise request a fast tick and count the callbacks, take a reading
+  *          when you start, and another whenever you need the elapsed time; then tick only as fast as the display
+  *          needs to change.
+  * @return The count, or 0 if the counter is not running.
+  */
+uint32_t watch_rtc_get_timestamp_ticks(void);
+
+/** @brief Calls a function once watch_rtc_get_timestamp_ticks reaches a count, without waking the watch before
+  *        then. There is one such callback; registering another replaces it.
+  * @details The counter has to be running. Where you would otherwise count fast ticks until something is due,
+  *          register a callback for when it's due: the watch sleeps through the ticks in between.
+  * @param callback The function to call, from an interrupt.
+  * @param ticks The count to call it at, no more than 512 seconds from now. If it has already passed, the
+  *              callback comes right away.
+  */
+void watch_rtc_register_timestamp_callback(ext_irq_cb_t callback, uint32_t ticks);
+
+/** @brief Cancels the callback registered with watch_rtc_register_timestamp_callback, if it hasn't been called.
+  */
+void watch_rtc_disable_timestamp_callback(void);
+
 /** @brief Registers an alarm callback that will be called when the RTC time matches the target time, as masked
   *        by the provided mask.
   * @param callback The function you wish to have called when the alarm fires. If this value is NULL, the alarm
@@ -128,7 +186,8 @@ void watch_rtc_disable_tick_callback(void);
   *
   *       Also note that the RTC peripheral does not have sub-second resolution, so even if you set a 2 or 4 Hz interval,
   *       the system will not have any way of telling you where you are within a given second; watch_rtc_get_date_time
-  *       will return the exact same timestamp until the second ticks over.
+  *       will return the exact same timestamp until the second ticks over. To measure time more finely than that,
+  *       use watch_rtc_get_timestamp_ticks.
   */
 void watch_rtc_register_periodic_callback(ext_irq_cb_t callback, uint8_t frequency);
 
@@ -52,6 +52,9 @@
   *          in this area. The region is laid out as 32 rows consisting of 4 pages of 64 bytes.
   *          32*4*64 = 8192 bytes. The area can be written one page at a time, but it can only be
   *          erased one row at a time. You can read at arbitrary word-aligned offsets within a row.
+  *          Writes and erases are queued and completed from the NVM controller's interrupt; the
+  *          blocking versions idle the CPU while they wait, and the _async versions return as soon
+  *          as the operation is queued. Reads always see every write queued before them.
   *
   *                 ┌──────────────┬──────────────┬──────────────┬──────────────┐
   *          Row 0  │   64 bytes   │   64 bytes   │   64 bytes   │   64 bytes   │
@@ -85,8 +88,38 @@ bool watch_storage_write(uint32_t row, uint32_t offset, const uint8_t *buffer, u
   */
 bool watch_storage_erase(uint32_t row);
 
-/** @brief Waits for any pending writes to complete.
+/** @brief Queues a page write and returns without waiting for it. The buffer may be reused as soon as
+  *        this returns. If the queue is full, waits for a slot first.
+  * @param row The row containing the page you want to write.
+  * @param offset The offset from the beginning of the row. Must be a multiple of 64.
+  * @param buffer The buffer containing the bytes you wish to set.
+  * @param size The number of bytes you wish to write, at most 64.
+  * @return false if the address or size is invalid. Errors while writing are reported by watch_storage_sync.
+  */
+bool watch_storage_write_async(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size);
+
+/** @brief Queues a row erase and returns without waiting for it.
+  * @param row The row you want to erase.
+  * @return false if the row is invalid. Errors while erasing are reported by watch_storage_sync.
+  */
+bool watch_storage_erase_async(uint32_t row);
+
+/** @brief Waits for any pending writes and erases to complete, and reports whether any of them failed.
+  *        The library waits for the queue on its own before sleeping, without consuming errors, so a
+  *        failed _async operation is reported here until someone calls this.
+  * @return false if any queued write or erase failed since the last call.
   */
 bool watch_storage_sync(void);
+
+/** @brief Returns a pointer to a location in the memory-mapped storage area, for reading it without a copy
+  *        through watch_storage_read. Like watch_storage_read, this first waits for every queued write and
+  *        erase to finish, since the area can't be read while one is in progress; it doesn't consume their
+  *        errors, which are still reported by watch_storage_sync. Don't hold on to the pointer across
+  *        another write or erase.
+  * @param row The row you want to read.
+  * @param offset The offset from the beginning of the row.
+  * @return A pointer to the byte at that location, or NULL if it is outside the storage area.
+  */
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset);
 /// @}
 #endif
@@ -25,6 +25,45 @@
 #include <math.h>
 #include "watch_utility.h"
 
+// Seconds from the UNIX epoch to midnight UTC on January 1 of each year the RTC can hold (2020 to 2083), plus 2084.
+static const uint32_t _year_start[64 + 1] = {
+    1577836800u, 1609459200u, 1640995200u, 1672531200u, 1704067200u,
+    1735689600u, 1767225600u, 1798761600u, 1830297600u, 1861920000u,
+    1893456000u, 1924992000u, 1956528000u, 1988150400u, 2019686400u,
+    2051222400u, 2082758400u, 2114380800u, 2145916800u, 2177452800u,
+    2208988800u, 2240611200u, 2272147200u, 2303683200u, 2335219200u,
+    2366841600u, 2398377600u, 2429913600u, 2461449600u, 2493072000u,
+    2524608000u, 2556144000u, 2587680000u, 2619302400u, 2650838400u,
+    2682374400u, 2713910400u, 2745532800u, 2777068800u, 2808604800u,
+    2840140800u, 2871763200u, 2903299200u, 2934835200u, 2966371200u,
+    2997993600u, 3029529600u, 3061065600u, 3092601600u, 3124224000u,
+    3155760000u, 3187296000u, 3218832000u, 3250454400u, 3281990400u,
+    3313526400u, 3345062400u, 3376684800u, 3408220800u, 3439756800u,
+    3471292800u, 3502915200u, 3534451200u, 3565987200u, 3597523200u,
+};
+
+// Days before the first of each month, in common and leap years.
+static const uint16_t _days_before_month[2][12] = {
+    { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 },
+    { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335 },
+};
+
+// Between 2020 and 2083, every fourth year starting with 2020 is a leap year.
+static inline uint8_t _is_leap_rtc_year(uint8_t rtc_year) {
+    return (rtc_year & 3) == 0;
+}
+
+// The Cortex-M0+ has no divide instruction, so these divide by a multiply and a shift instead. Each one
+// is exact only up to the limit noted; the host tests in test/ run every value in range through them.
+static inline uint32_t _div_675(uint32_t x) { return (x * 3107) >> 21; }    // x < 20925
+static inline uint32_t _div_225(uint32_t x) { return (x * 4661) >> 20; }    // x <= 5400
+static inline uint32_t _div_60(uint32_t x) { return (x * 2185) >> 17; }     // x < 3600
+static inline uint32_t _mod_7(uint32_t x) { return x - ((x * 293) >> 11) * 7; } // x <= 500
+
+static inline bool _is_rtc_date(uint16_t year, uint8_t month) {
+    return year >= WATCH_RTC_REFERENCE_YEAR && year < WATCH_RTC_REFERENCE_YEAR + 64 && month >= 1 && month <= 12;
+}
+
 const char * watch_utility_get_weekday(watch_date_time date_time) {
     static const char weekdays[7][3] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
     return weekdays[watch_utility_get_iso8601_weekday_number(date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day) - 1];
@@ -32,6 +71,14 @@ const char * watch_utility_get_weekday(watch_date_time date_time) {
 
 // Per ISO8601 week starts on Monday with index 1
 uint8_t watch_utility_get_iso8601_weekday_number(uint16_t year, uint8_t month, uint8_t day) {
+    if (_is_rtc_date(year, month)) {
+        // January 1, 2020 was a Wednesday, and every year moves the weekday on by one (365 = 52 * 7 + 1),
+        // or two after a leap year. The sum tops out at 446.
+        uint8_t y = year - WATCH_RTC_REFERENCE_YEAR;
+        uint32_t days = y + ((y + 3) >> 2) + _days_before_month[_is_leap_rtc_year(y)][month - 1] + day - 1;
+        return _mod_7(days + 2) + 1;
+    }
+
     year -= WATCH_RTC_REFERENCE_YEAR;
     year += 20;
     if (month <= 2) {
@@ -84,22 +131,7 @@ uint8_t is_leap(uint16_t y)
 }
 
 uint16_t watch_utility_days_since_new_year(uint16_t year, uint8_t month, uint8_t day) {
-    uint16_t DAYS_SO_FAR[] = {
-        0,   // Jan
-        31,  // Feb
-        59,  // March
-        90,  // April
-        120, // May
-        151, // June
-        181, // July
-        212, // August
-        243, // September
-        273, // October
-        304, // November
-        334  // December
-    };
-
-    return (is_leap(year) && (month > 2) ? 1 : 0) + DAYS_SO_FAR[month - 1] + day;
+    return (is_leap(year) && (month > 2) ? 1 : 0) + _days_before_month[0][month - 1] + day;
 }
 
 // Function taken from `src/time/__year_to_secs.c` of musl libc
@@ -168,6 +200,13 @@ static int __month_to_secs(int month, int is_leap)
 // Function adapted from `src/time/__tm_to_secs.c` of musl libc
 // https://musl.libc.org
 uint32_t watch_utility_convert_to_unix_time(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint32_t utc_offset) {
+    if (_is_rtc_date(year, month)) {
+        uint8_t y = year - WATCH_RTC_REFERENCE_YEAR;
+        uint32_t days = _days_before_month[_is_leap_rtc_year(y)][month - 1] + day - 1;
+        return _year_start[y] + days * 86400 + hour * 3600 + minute * 60 + second - utc_offset;
+    }
+
+    // musl's general conversion, for dates the RTC can't hold
     int is_leap;
 
     // POSIX tm struct starts year at 1900 and month at 0
@@ -189,85 +228,154 @@ uint32_t watch_utility_date_time_to_unix_time(watch_date_time date_time, uint32_
     return watch_utility_convert_to_unix_time(date_time.unit.year + WATCH_RTC_REFERENCE_YEAR, date_time.unit.month, date_time.unit.day, date_time.unit.hour, date_time.unit.minute, date_time.unit.second, utc_offset);
 }
 
-#define LEAPOCH (946684800LL + 86400*(31+29))
-
-#define DAYS_PER_400Y (365*400 + 97)
-#define DAYS_PER_100Y (365*100 + 24)
-#define DAYS_PER_4Y   (365*4   + 1)
-
 watch_date_time watch_utility_date_time_from_unix_time(uint32_t timestamp, uint32_t utc_offset) {
     watch_date_time retval;
     retval.reg = 0;
-    int32_t days, secs;
-    int32_t remdays, remsecs, remyears;
-    int32_t qc_cycles, c_cycles, q_cycles;
-    int32_t years, months;
-    int32_t wday, yday, leap;
-    static const int8_t days_in_month[] = {31,30,31,30,31,31,30,31,30,31,31,29};
-    timestamp += utc_offset;
 
-    secs = timestamp - LEAPOCH;
-    days = secs / 86400;
-    remsecs = secs % 86400;
-    if (remsecs < 0) {
-        remsecs += 86400;
-        days--;
+    timestamp += utc_offset;
+    if (timestamp < _year_start[0] || timestamp >= _year_start[64]) return retval;
+
+    // binary search for the year: _year_start[year] <= timestamp < _year_start[next]
+    uint8_t year = 0, next = 64;
+    while (next - year > 1) {
+        uint8_t mid = (year + next) >> 1;
+        if (timestamp >= _year_start[mid]) year = mid;
+        else next = mid;
     }
+    uint32_t secs = timestamp - _year_start[year];
+
+    const uint16_t *days_before_month = _days_before_month[_is_leap_rtc_year(year)];
+    uint8_t month = 11;
+    while (secs < days_before_month[month] * 86400u) month--;
+    secs -= days_before_month[month] * 86400u;
+
+    // secs is now less than 31 days, so the 128 * 675 split of 86400 stays in range
+    uint32_t day = _div_675(secs >> 7);
+    secs -= day * 86400;
+    uint32_t hour = _div_225(secs >> 4);
+    secs -= hour * 3600;
+    uint32_t minute = _div_60(secs);
+
+    retval.unit.year = year;
+    retval.unit.month = month + 1;
+    retval.unit.day = day + 1;
+    retval.unit.hour = hour;
+    retval.unit.minute = minute;
+    retval.unit.second = secs - minute * 60;
 
-    wday = (3+days)%7;
-    if (wday < 0) wday += 7;
+    return retval;
+}
+
+watch_date_time watch_utility_date_time_convert_zone(watch_date_time date_time, uint32_t origin_utc_offset, uint32_t destination_utc_offset) {
+    uint32_t timestamp = watch_utility_date_time_to_unix_time(date_time, origin_utc_offset);
+    return watch_utility_date_time_from_unix_time(timestamp, destination_utc_offset);
+}
 
-    qc_cycles = (int)(days / DAYS_PER_400Y);
-    remdays = days % DAYS_PER_400Y;
-    if (remdays < 0) {
-        remdays += DAYS_PER_400Y;
-        qc_cycles--;
+void watch_utility_clock_update(watch_utility_clock_t *clock, watch_date_time local, int32_t utc_offset) {
+    watch_date_time previous = clock->local;
+
+    // year through hour live above the minute and second fields; if they match, only minutes and seconds moved
+    if (previous.reg != 0 && utc_offset == clock->utc_offset && (local.reg >> 12) == (previous.reg >> 12)) {
+        int32_t delta = ((int32_t)local.unit.minute - previous.unit.minute) * 60 + ((int32_t)local.unit.second - previous.unit.second);
+        if (delta >= 0) {
+            // UTC offsets are whole minutes, so UTC's seconds are the RTC's, and UTC's minutes moved as
+            // many times as the RTC's did; only the carry into the hour needs handling.
+            uint32_t minute = clock->utc.unit.minute + (local.unit.minute - previous.unit.minute);
+            uint32_t hour = clock->utc.unit.hour;
+            if (minute >= 60) {
+                minute -= 60;
+                hour++;
+            }
+            // the UTC date rolling over isn't worth handling here
+            if (hour < 24) {
+                clock->utc.unit.hour = hour;
+                clock->utc.unit.minute = minute;
+                clock->utc.unit.second = local.unit.second;
+                clock->local = local;
+                clock->timestamp += delta;
+                clock->local_timestamp += delta;
+                return;
+            }
+        }
     }
 
-    c_cycles = remdays / DAYS_PER_100Y;
-    if (c_cycles == 4) c_cycles--;
-    remdays -= c_cycles * DAYS_PER_100Y;
+    clock->local = local;
+    clock->utc_offset = utc_offset;
+    clock->timestamp = watch_utility_date_time_to_unix_time(local, utc_offset);
+    clock->local_timestamp = clock->timestamp + utc_offset;
+    clock->utc = watch_utility_date_time_from_unix_time(clock->timestamp, 0);
+}
 
-    q_cycles = remdays / DAYS_PER_4Y;
-    if (q_cycles == 25) q_cycles--;
-    remdays -= q_cycles * DAYS_PER_4Y;
+watch_date_time watch_utility_date_time_add_days(watch_date_time date_time, uint32_t days) {
+    if (days >= 28) {
+        return watch_utility_date_time_from_unix_time(watch_utility_date_time_to_unix_time(date_time, 0) + days * 86400, 0);
+    }
 
-    remyears = remdays / 365;
-    if (remyears == 4) remyears--;
-    remdays -= remyears * 365;
+    // fewer than 28 days crosses at most one month boundary
+    uint8_t month = date_time.unit.month;
+    uint8_t year = date_time.unit.year;
+    uint32_t day = date_time.unit.day + days;
+    uint8_t leap = _is_leap_rtc_year(year);
+    uint8_t days_in_month = (month == 12 ? 31 : _days_before_month[leap][month] - _days_before_month[leap][month - 1]);
+    if (day > days_in_month) {
+        day -= days_in_month;
+        if (++month > 12) {
+            month = 1;
+            if (++year > 63) {
+                date_time.reg = 0;
+                return date_time;
+            }
+        }
+    }
+    date_time.unit.year = year;
+    date_time.unit.month = month;
+    date_time.unit.day = day;
 
-    leap = !remyears && (q_cycles || !c_cycles);
-    yday = remdays + 31 + 28 + leap;
-    if (yday >= 365+leap) yday -= 365+leap;
+    return date_time;
+}
 
-    years = remyears + 4*q_cycles + 100*c_cycles + 400*qc_cycles;
+watch_date_time watch_utility_date_time_add_minutes(watch_date_time date_time, uint32_t minutes) {
+    if (minutes >= 60) {
+        return watch_utility_date_time_from_unix_time(watch_utility_date_time_to_unix_time(date_time, 0) + minutes * 60, 0);
+    }
 
-    for (months=0; days_in_month[months] <= remdays; months++)
-        remdays -= days_in_month[months];
+    uint32_t minute = date_time.unit.minute + minutes;
+    if (minute < 60) {
+        date_time.unit.minute = minute;
+        return date_time;
+    }
+    date_time.unit.minute = minute - 60;
+    if (date_time.unit.hour < 23) {
+        date_time.unit.hour++;
+        return date_time;
+    }
+    date_time.unit.hour = 0;
 
-    years += 2000;
+    return watch_utility_date_time_add_days(date_time, 1);
+}
 
-    months += 2;
-    if (months >= 12) {
-        months -=12;
-        years++;
+watch_date_time watch_utility_date_time_add_seconds(watch_date_time date_time, uint32_t seconds) {
+    if (seconds >= 60) {
+        return watch_utility_date_time_from_unix_time(watch_utility_date_time_to_unix_time(date_time, 0) + seconds, 0);
     }
 
-    if (years < 2020 || years > 2083) return retval;
-    retval.unit.year = years - WATCH_RTC_REFERENCE_YEAR;
-    retval.unit.month = months + 1;
-    retval.unit.day = remdays + 1;
+    uint32_t second = date_time.unit.second + seconds;
+    if (second < 60) {
+        date_time.unit.second = second;
+        return date_time;
+    }
+    date_time.unit.second = second - 60;
 
-    retval.unit.hour = remsecs / 3600;
-    retval.unit.minute = remsecs / 60 % 60;
-    retval.unit.second = remsecs % 60;
+    return watch_utility_date_time_add_minutes(date_time, 1);
+}
 
-    return retval;
+int8_t watch_utility_date_time_compare(watch_date_time a, watch_date_time b) {
+    // the fields are packed from year down to second, so the raw register values sort chronologically
+    return (a.reg > b.reg) - (a.reg < b.reg);
 }
 
-watch_date_time watch_utility_date_time_convert_zone(watch_date_time date_time, uint32_t origin_utc_offset, uint32_t destination_utc_offset) {
-    uint32_t timestamp = watch_utility_date_time_to_unix_time(date_time, origin_utc_offset);
-    return watch_utility_date_time_from_unix_time(timestamp, destination_utc_offset);
+int32_t watch_utility_date_time_diff(watch_date_time a, watch_date_time b) {
+    return (int32_t)(watch_utility_date_time_to_unix_time(a, 0) - watch_utility_date_time_to_unix_time(b, 0));
 }
 
 watch_duration_t watch_utility_seconds_to_duration(uint32_t seconds) {
@@ -45,6 +45,15 @@ typedef struct {
     uint32_t days;    // 0-4294967295
 } watch_duration_t;
 
+/// The same instant as the RTC's local date and time, in UTC and as UNIX timestamps.
+typedef struct {
+    watch_date_time local;      // the raw RTC value; the RTC keeps local time
+    watch_date_time utc;        // the same instant, broken down in UTC
+    uint32_t timestamp;         // UNIX time
+    uint32_t local_timestamp;   // UNIX time plus the UTC offset, for arithmetic in local time
+    int32_t utc_offset;         // seconds from UTC
+} watch_utility_clock_t;
+
 /** @brief Returns a two-letter weekday for the given timestamp, suitable for display
   *        in positions 0-1 of the watch face
   * @param date_time The watch_date_time whose weekday you want.
@@ -90,6 +99,7 @@ uint8_t is_leap(uint16_t year);
   * @return A UNIX timestamp for the given date/time and UTC offset.
   * @note Implemented by Wesley Ellis (tahnok) and based on BSD-licensed code by Josh Haberman:
   *       https://blog.reverberate.org/2020/05/12/optimizing-date-algorithms.html
+  *       Dates from 2020 to 2083 are converted with a table of year start times and no division.
   */
 uint32_t watch_utility_convert_to_unix_time(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint32_t utc_offset);
 
@@ -111,8 +121,8 @@ watch_duration_t watch_utility_seconds_to_duration(uint32_t seconds);
   * @param utc_offset The number of seconds that you wish date_time to be offset from UTC.
   * @return A watch_date_time for the given UNIX timestamp and UTC offset, or if outside the range that
   *         watch_date_time can represent, a watch_date_time with all fields set to 0.
-  * @note Adapted from MIT-licensed code from musl, Copyright © 2005-2014 Rich Felker, et al.:
-  *       https://github.com/esmil/musl/blob/1cc81f5cb0df2b66a795ff0c26d7bbc4d16e13c6/src/time/__secs_to_tm.c
+  * @note Looks the year up in a table of year start times, and divides by multiplying and shifting,
+  *       since the Cortex-M0+ has no divide instruction.
   */
 watch_date_time watch_utility_date_time_from_unix_time(uint32_t timestamp, uint32_t utc_offset);
 
@@ -135,11 +145,37 @@ bool watch_utility_convert_to_12_hour(watch_date_time *date_time);
   * @param destination_utc_offset The number of seconds from UTC in the destination time zone
   * @return A watch_date_time for the given UNIX timestamp and UTC offset, or if outside the range that
   *         watch_date_time can represent, a watch_date_time with all fields set to 0.
-  * @note Adapted from MIT-licensed code from musl, Copyright © 2005-2014 Rich Felker, et al.:
-  *       https://github.com/esmil/musl/blob/1cc81f5cb0df2b66a795ff0c26d7bbc4d16e13c6/src/time/__secs_to_tm.c
   */
 watch_date_time watch_utility_date_time_convert_zone(watch_date_time date_time, uint32_t origin_utc_offset, uint32_t destination_utc_offset);
 
+/** @brief Moves a date and time forward by a number of days.
+  * @param date_time The watch_date_time to start from.
+  * @param days The number of days to add.
+  * @return The later date and time, or a watch_date_time with all fields set to 0 if it is past 2083.
+  * @note Up to 27 days, the month and year carry by hand; beyond that, this goes by way of a UNIX timestamp.
+  */
+watch_date_time watch_utility_date_time_add_days(watch_date_time date_time, uint32_t days);
+
+/** @brief Moves a date and time forward by a number of minutes. Under an hour, the carry into the
+  *        hour and day is done by hand.
+  * @return The later date and time, or a watch_date_time with all fields set to 0 if it is past 2083.
+  */
+watch_date_time watch_utility_date_time_add_minutes(watch_date_time date_time, uint32_t minutes);
+
+/** @brief Moves a date and time forward by a number of seconds. Under a minute, the carry is done by hand.
+  * @return The later date and time, or a watch_date_time with all fields set to 0 if it is past 2083.
+  */
+watch_date_time watch_utility_date_time_add_seconds(watch_date_time date_time, uint32_t seconds);
+
+/** @brief Compares two date/times.
+  * @return A negative number if a is earlier than b, a positive number if it is later, or 0 if they are the same.
+  */
+int8_t watch_utility_date_time_compare(watch_date_time a, watch_date_time b);
+
+/** @brief Returns the number of seconds from b to a; negative if a is earlier than b. Both must be valid dates.
+  */
+int32_t watch_utility_date_time_diff(watch_date_time a, watch_date_time b);
+
 /** @brief Returns a temperature in degrees Celsius for a given thermistor voltage divider circuit.
   * @param value The raw analog reading from the thermistor pin (0-65535)
   * @param highside True if the thermistor is connected to VCC and the series resistor is connected
@@ -156,6 +192,17 @@ watch_date_time watch_utility_date_time_convert_zone(watch_date_time date_time,
   */
 float watch_utility_thermistor_temperature(uint16_t value, bool highside, float b_coefficient, float nominal_temperature, float nominal_resistance, float series_resistance);
 
+/** @brief Brings a watch_utility_clock_t up to date with a new reading of the RTC.
+  * @param clock The clock to update. Zero it before the first update.
+  * @param local The date and time just read from the RTC.
+  * @param utc_offset The number of seconds that local time is offset from UTC.
+  * @details When the new reading is later in the same hour as the last one and the offset hasn't changed,
+  *          which is the case on almost every tick, the clock is advanced by the difference with a few
+  *          additions. Anything else (a new hour, a new offset, the time being set back) falls back to a full
+  *          conversion with watch_utility_date_time_to_unix_time and watch_utility_date_time_from_unix_time.
+  */
+void watch_utility_clock_update(watch_utility_clock_t *clock, watch_date_time local, int32_t utc_offset);
+
 /** @brief Offset a timestamp by a given amount
  * @param now Timestamp to offset from
  * @param hours Number of hours to offset
@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Sensor Watch contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "watch_evsys.h"
+#include "watch_private_evsys.h"
+
+// Nothing in the simulator acts on events, but the routes are kept just as on the hardware, so that
+// whatever sets them up can be checked.
+static watch_evsys_routes_t _routes;
+static bool _routes_initialized;
+
+int8_t watch_evsys_connect(watch_evsys_generator_t generator, watch_evsys_user_t user) {
+    if (!_routes_initialized) {
+        watch_evsys_routes_init(&_routes);
+        _routes_initialized = true;
+    }
+
+    bool new_channel;
+    return watch_evsys_routes_connect(&_routes, generator, user, &new_channel);
+}
+
+void watch_evsys_disconnect(watch_evsys_user_t user) {
+    if (!_routes_initialized) return;
+    watch_evsys_routes_disconnect(&_routes, user);
+}
+
+watch_evsys_generator_t watch_evsys_get_generator(watch_evsys_user_t user) {
+    if (!_routes_initialized || user >= WATCH_EVSYS_NUM_USERS) return WATCH_EVSYS_GEN_NONE;
+    int8_t channel = _routes.user_channel[user];
+
+    return channel == -1 ? WATCH_EVSYS_GEN_NONE : _routes.channel_generator[channel];
+}
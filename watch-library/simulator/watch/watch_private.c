@@ -24,7 +24,9 @@
 
 #include "watch_private.h"
 #include "watch_utility.h"
+#include <string.h>
 #include <sys/time.h>
+#include <emscripten.h>
 
 void _watch_init(void) {
     // External wake depends on RTC; calendar is a required module.
@@ -57,8 +59,69 @@ void _watch_disable_tcc(void) {}
 
 void _watch_enable_usb(void) {}
 
+static watch_performance_level_t _performance_level = WATCH_PERFORMANCE_NORMAL;
+
+void watch_set_performance_level(watch_performance_level_t level) {
+    _performance_level = level;
+}
+
+watch_performance_level_t watch_get_performance_level(void) {
+    return _performance_level;
+}
+
+static bool _active_time_enabled = false;
+
+void watch_enable_active_time(void) {
+    _active_time_enabled = true;
+}
+
+uint32_t watch_get_active_time(void) {
+    if (!_active_time_enabled) return 0;
+    // performance.now() is in milliseconds; go through 64 bits so the count wraps like the hardware's.
+    return (uint32_t)(uint64_t)(emscripten_get_now() * 1000.0);
+}
+
+void watch_get_memory_stats(watch_memory_stats_t *stats) {
+    // Emscripten's heap and stack are nothing like the watch's, so there's nothing useful to report.
+    memset(stats, 0, sizeof(watch_memory_stats_t));
+}
+
 void watch_disable_TRNG() {}
 
+// The simulated TRNG is xorshift32, seeded from Module.trngSeed if the page sets it, so a run can be
+// replayed exactly; otherwise from Math.random, so each run gets different words.
+static uint32_t _trng_state = 0;
+
+static uint32_t _watch_trng_next(void) {
+    if (_trng_state == 0) {
+        _trng_state = EM_ASM_INT({
+            return Module['trngSeed'] !== undefined ? Module['trngSeed'] : Math.random() * 4294967296;
+        });
+        if (_trng_state == 0) _trng_state = 1;
+    }
+    _trng_state ^= _trng_state << 13;
+    _trng_state ^= _trng_state >> 17;
+    _trng_state ^= _trng_state << 5;
+
+    return _trng_state;
+}
+
+bool watch_trng_fill(uint32_t *words, uint8_t count, ext_irq_cb_t callback) {
+    if (count == 0) return false;
+    watch_trng_read(words, count);
+    if (callback) callback();
+
+    return true;
+}
+
+bool watch_trng_is_busy(void) {
+    return false;
+}
+
+void watch_trng_read(uint32_t *words, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) words[i] = _watch_trng_next();
+}
+
 // this function ends up getting called by printf to log stuff to the USB console.
 int _write(int file, char *ptr, int len) {
     // TODO: (a2) hook to UI
@@ -69,3 +132,7 @@ int _read(int file, char *ptr, int len) {
     // TODO: hook to UI
     return 0;
 }
+
+void watch_cdc_get_stats(watch_cdc_stats_t *stats) {
+    memset(stats, 0, sizeof(watch_cdc_stats_t));
+}
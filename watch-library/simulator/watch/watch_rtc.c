@@ -24,6 +24,7 @@
 
 #include "watch_rtc.h"
 #include "watch_main_loop.h"
+#include "watch_private_timestamp.h"
 
 #include <emscripten.h>
 #include <emscripten/html5.h>
@@ -39,6 +40,13 @@ ext_irq_cb_t btn_alarm_callback;
 ext_irq_cb_t a2_callback;
 ext_irq_cb_t a4_callback;
 
+// The simulator runs callbacks one at a time, so the cached time needs no sequence counter here;
+// an interrupt count is enough to mark it stale.
+static uint32_t _rtc_interrupt_count;
+static uint32_t _rtc_shadow_interrupt_count = UINT32_MAX;
+static watch_date_time _rtc_shadow;
+static uint32_t _rtc_uncached_reads;
+
 bool _watch_rtc_is_enabled(void) {
     return true;
 }
@@ -57,6 +65,8 @@ void watch_rtc_set_date_time(watch_date_time date_time) {
         const date = new Date(year, month - 1, day, hour, minute, second);
         return date - Date.now();
     }, date_time.reg);
+    _rtc_shadow = date_time;
+    _rtc_shadow_interrupt_count = _rtc_interrupt_count;
 }
 
 watch_date_time watch_rtc_get_date_time(void) {
@@ -70,9 +80,117 @@ watch_date_time watch_rtc_get_date_time(void) {
             ((date.getMonth() + 1) << 22) |
             ((date.getFullYear() - 2020) << 26);
     }, time_offset);
+    _rtc_uncached_reads++;
     return retval;
 }
 
+watch_date_time watch_rtc_get_cached_date_time(void) {
+    if (_rtc_shadow_interrupt_count != _rtc_interrupt_count) {
+        _rtc_shadow = watch_rtc_get_date_time();
+        _rtc_shadow_interrupt_count = _rtc_interrupt_count;
+    }
+    return _rtc_shadow;
+}
+
+uint32_t watch_rtc_get_uncached_read_count(void) {
+    return _rtc_uncached_reads;
+}
+
+// Timestamp ticks are counted by a model of the watch's TC2, stepped from performance.now(), which never
+// jumps; the Date behind the simulated RTC does, whenever the time is set.
+static uint8_t _timestamp_users;
+static watch_timestamp_counter_t _timestamp_counter;
+static double _timestamp_host_ticks;
+static ext_irq_cb_t _timestamp_callback;
+static long _timestamp_timeout_id = -1;
+
+static double _watch_rtc_host_ticks(void) {
+    return EM_ASM_DOUBLE({
+        return Math.floor(performance.now() * $0 / 1000);
+    }, WATCH_RTC_TIMESTAMP_TICKS_PER_SECOND);
+}
+
+// TC2_Handler, more or less
+static void _watch_rtc_handle_timestamp_counter(void) {
+    if (watch_timestamp_counter_handle(&_timestamp_counter)) {
+        ext_irq_cb_t callback = _timestamp_callback;
+        _timestamp_callback = NULL;
+        callback();
+        resume_main_loop();
+    }
+}
+
+// Brings the counter up to the host's clock, taking any interrupt that came due on the way.
+static void _watch_rtc_step_timestamp_counter(void) {
+    double now = _watch_rtc_host_ticks();
+    uint32_t events = now - _timestamp_host_ticks;
+    _timestamp_host_ticks = now;
+    if (watch_timestamp_counter_step(&_timestamp_counter, events)) _watch_rtc_handle_timestamp_counter();
+}
+
+static void _watch_rtc_schedule_timestamp_callback(void);
+
+static void watch_invoke_timestamp_callback(void *userData) {
+    (void) userData;
+    _timestamp_timeout_id = -1;
+    _watch_rtc_step_timestamp_counter();
+    // the timeout can land a little before the host clock reaches the deadline
+    _watch_rtc_schedule_timestamp_callback();
+}
+
+static void _watch_rtc_schedule_timestamp_callback(void) {
+    // nothing to wait for, or the callback already set a new deadline and is waiting for it
+    if (_timestamp_callback == NULL || _timestamp_timeout_id != -1) return;
+    uint32_t events = watch_timestamp_counter_events_to_deadline(&_timestamp_counter);
+    _timestamp_timeout_id = emscripten_set_timeout(watch_invoke_timestamp_callback, events * 1000.0 / WATCH_RTC_TIMESTAMP_TICKS_PER_SECOND, NULL);
+}
+
+void watch_rtc_enable_timestamp_ticks(void) {
+    if (_timestamp_users++) return;
+
+    watch_timestamp_counter_init(&_timestamp_counter);
+    _timestamp_host_ticks = _watch_rtc_host_ticks();
+    _timestamp_callback = NULL;
+    watch_evsys_connect(WATCH_EVSYS_GEN_RTC_PER_0, WATCH_EVSYS_USER_TC2_EVU);
+}
+
+void watch_rtc_disable_timestamp_ticks(void) {
+    if (_timestamp_users == 0 || --_timestamp_users) return;
+
+    watch_rtc_disable_timestamp_callback();
+    watch_evsys_disconnect(WATCH_EVSYS_USER_TC2_EVU);
+}
+
+bool watch_rtc_timestamp_ticks_enabled(void) {
+    return _timestamp_users != 0;
+}
+
+uint32_t watch_rtc_get_timestamp_ticks(void) {
+    if (!_timestamp_users) return 0;
+
+    _watch_rtc_step_timestamp_counter();
+    return watch_timestamp_counter_read(&_timestamp_counter);
+}
+
+void watch_rtc_register_timestamp_callback(ext_irq_cb_t callback, uint32_t ticks) {
+    if (!_timestamp_users) return;
+
+    watch_rtc_disable_timestamp_callback();
+    _watch_rtc_step_timestamp_counter();
+    _timestamp_callback = callback;
+    if (watch_timestamp_counter_set_deadline(&_timestamp_counter, ticks)) _watch_rtc_handle_timestamp_counter();
+    _watch_rtc_schedule_timestamp_callback();
+}
+
+void watch_rtc_disable_timestamp_callback(void) {
+    watch_timestamp_counter_clear_deadline(&_timestamp_counter);
+    _timestamp_callback = NULL;
+    if (_timestamp_timeout_id != -1) {
+        emscripten_clear_timeout(_timestamp_timeout_id);
+        _timestamp_timeout_id = -1;
+    }
+}
+
 void watch_rtc_register_tick_callback(ext_irq_cb_t callback) {
     watch_rtc_register_periodic_callback(callback, 1);
 }
@@ -83,6 +201,7 @@ void watch_rtc_disable_tick_callback(void) {
 
 static void watch_invoke_periodic_callback(void *userData) {
     ext_irq_cb_t callback = userData;
+    _rtc_interrupt_count++;
     callback();
     resume_main_loop();
 }
@@ -126,10 +245,12 @@ void watch_rtc_disable_all_periodic_callbacks(void) {
 }
 
 static void watch_invoke_alarm_interval_callback(void *userData) {
+    _rtc_interrupt_count++;
     if (alarm_callback) alarm_callback();
 }
 
 static void watch_invoke_alarm_callback(void *userData) {
+    _rtc_interrupt_count++;
     if (alarm_callback) alarm_callback();
     alarm_interval_id = emscripten_set_interval(watch_invoke_alarm_interval_callback, alarm_interval, NULL);
 }
@@ -26,7 +26,21 @@ bool watch_storage_erase(uint32_t row) {
     return true;
 }
 
+bool watch_storage_write_async(uint32_t row, uint32_t offset, const uint8_t *buffer, uint32_t size) {
+    return watch_storage_write(row, offset, buffer, size);
+}
+
+bool watch_storage_erase_async(uint32_t row) {
+    return watch_storage_erase(row);
+}
+
 bool watch_storage_sync(void) {
     // nothing to do here!
     return true;
 }
+
+const uint8_t *watch_storage_get_mapped_address(uint32_t row, uint32_t offset) {
+    if (row * NVMCTRL_ROW_SIZE + offset >= sizeof(storage)) return NULL;
+
+    return storage + row * NVMCTRL_ROW_SIZE + offset;
+}